@@ -169,6 +169,283 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ManagedFreeBlock
     return (FALSE);
 }
 
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION MapFileBlock
+(
+    void ** pBuffer,
+    size_t * pSize,
+    const char * pPath
+)
+{
+#if defined _WIN32 || defined _WIN64
+
+    HANDLE lFile;
+    HANDLE lMapping;
+
+    LARGE_INTEGER lFileSize;
+
+    if (NULL == pBuffer || NULL != * pBuffer || NULL == pSize || NULL == pPath)
+    {
+        return (FALSE);
+    }
+
+    lFile = CreateFileA(pPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (INVALID_HANDLE_VALUE == lFile)
+    {
+        return (FALSE);
+    }
+
+    if (!GetFileSizeEx(lFile, &lFileSize) || 0 == lFileSize.QuadPart || (size_t) -1 < (unsigned long long) lFileSize.QuadPart)
+    {
+        CloseHandle(lFile);
+
+        return (FALSE);
+    }
+
+    lMapping = CreateFileMappingA(lFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    /*
+    ** the view holds its own references to the mapping and the file
+    */
+
+    CloseHandle(lFile);
+
+    if (NULL == lMapping)
+    {
+        return (FALSE);
+    }
+
+    * pBuffer = MapViewOfFile(lMapping, FILE_MAP_READ, 0, 0, 0);
+
+    CloseHandle(lMapping);
+
+    if (NULL == * pBuffer)
+    {
+        return (FALSE);
+    }
+
+    * pSize = (size_t) lFileSize.QuadPart;
+
+    return (TRUE);
+
+#else
+
+    int lFile;
+
+    struct stat lFileStatus;
+
+    void * lBuffer;
+
+    if (NULL == pBuffer || NULL != * pBuffer || NULL == pSize || NULL == pPath)
+    {
+        return (FALSE);
+    }
+
+    lFile = open(pPath, O_RDONLY);
+
+    if (0 > lFile)
+    {
+        return (FALSE);
+    }
+
+    if (0 != fstat(lFile, &lFileStatus) || 0 >= lFileStatus.st_size || (size_t) -1 < (unsigned long long) lFileStatus.st_size)
+    {
+        close(lFile);
+
+        return (FALSE);
+    }
+
+    lBuffer = mmap(NULL, (size_t) lFileStatus.st_size, PROT_READ, MAP_SHARED, lFile, 0);
+
+    /*
+    ** the mapping holds its own reference to the file
+    */
+
+    close(lFile);
+
+    if (MAP_FAILED == lBuffer)
+    {
+        return (FALSE);
+    }
+
+    * pBuffer = lBuffer;
+    * pSize = (size_t) lFileStatus.st_size;
+
+    return (TRUE);
+
+#endif
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION UnmapFileBlock
+(
+    void ** pBuffer,
+    size_t pSize
+)
+{
+    if (NULL == pBuffer || NULL == * pBuffer)
+    {
+        return (FALSE);
+    }
+
+#if defined _WIN32 || defined _WIN64
+
+    (void) pSize;
+
+    if (!UnmapViewOfFile(* pBuffer))
+    {
+        return (FALSE);
+    }
+
+#else
+
+    if (0 != munmap(* pBuffer, pSize))
+    {
+        return (FALSE);
+    }
+
+#endif
+
+    * pBuffer = NULL;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReserveBlock
+(
+    void ** pBlock,
+    size_t pSize
+)
+{
+#if defined _WIN32 || defined _WIN64
+
+    if (NULL == pBlock || NULL != * pBlock || 0 == pSize)
+    {
+        return (FALSE);
+    }
+
+    * pBlock = VirtualAlloc(NULL, pSize, MEM_RESERVE, PAGE_NOACCESS);
+
+    if (NULL == * pBlock)
+    {
+        return (FALSE);
+    }
+
+    return (TRUE);
+
+#else
+
+    void * lBlock;
+
+#if !defined MAP_ANONYMOUS
+
+    int lFile;
+
+#endif
+
+    if (NULL == pBlock || NULL != * pBlock || 0 == pSize)
+    {
+        return (FALSE);
+    }
+
+#if defined MAP_ANONYMOUS
+
+    lBlock = mmap(NULL, pSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+#else
+
+    /*
+    ** a private mapping of the zero device stands in for an anonymous one
+    */
+
+    lFile = open("/dev/zero", O_RDWR);
+
+    if (0 > lFile)
+    {
+        return (FALSE);
+    }
+
+    lBlock = mmap(NULL, pSize, PROT_NONE, MAP_PRIVATE, lFile, 0);
+
+    close(lFile);
+
+#endif
+
+    if (MAP_FAILED == lBlock)
+    {
+        return (FALSE);
+    }
+
+    * pBlock = lBlock;
+
+    return (TRUE);
+
+#endif
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION CommitBlock
+(
+    void * pAddress,
+    size_t pSize
+)
+{
+    if (NULL == pAddress || 0 == pSize)
+    {
+        return (FALSE);
+    }
+
+#if defined _WIN32 || defined _WIN64
+
+    if (NULL == VirtualAlloc(pAddress, pSize, MEM_COMMIT, PAGE_READWRITE))
+    {
+        return (FALSE);
+    }
+
+#else
+
+    if (0 != mprotect(pAddress, pSize, PROT_READ | PROT_WRITE))
+    {
+        return (FALSE);
+    }
+
+#endif
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReleaseBlock
+(
+    void ** pBlock,
+    size_t pSize
+)
+{
+    if (NULL == pBlock || NULL == * pBlock)
+    {
+        return (FALSE);
+    }
+
+#if defined _WIN32 || defined _WIN64
+
+    (void) pSize;
+
+    if (!VirtualFree(* pBlock, 0, MEM_RELEASE))
+    {
+        return (FALSE);
+    }
+
+#else
+
+    if (0 != munmap(* pBlock, pSize))
+    {
+        return (FALSE);
+    }
+
+#endif
+
+    * pBlock = NULL;
+
+    return (TRUE);
+}
+
 EXPORT_STORAGE_CLASS success CALLING_CONVENTION CopyBlock
 (
     void * pDestination,
@@ -55,6 +55,23 @@
 #define Realloc(pObjHandle, pSize) realloc(pObjHandle, pSize)
 #define Free(pObjHandle)           free(pObjHandle)
 
+/*
+** file mapping and reserved address space
+*/
+
+#if defined _WIN32 || defined _WIN64
+
+#include <windows.h>
+
+#else
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#endif
+
 /*----------------------------------------------------------------------------
   Private data types
   ----------------------------------------------------------------------------*/
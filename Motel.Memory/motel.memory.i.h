@@ -299,6 +299,168 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ManagedFreeBlock
     size_t * pAllocated
 );
 
+/*----------------------------------------------------------------------------
+  MapFileBlock()
+  ----------------------------------------------------------------------------
+  Maps the contents of a file into memory for reading.
+  ----------------------------------------------------------------------------
+  Parameters:
+  
+  pBuffer     - (I/O) The address of a memory pointer to hold the address of
+                      the mapped file contents
+  pSize       - (O)   The number of bytes mapped (the size of the file)
+  pPath       - (I)   The path of the file to map
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - File was successfully mapped
+
+  False - File was not successfully mapped due to one of the following:
+
+          1. The buffer pointer pointer or size pointer was NULL.
+          2. The buffer pointer pointed to be the buffer pointer pointer was
+             not initialized to NULL.
+          3. The file could not be opened or was empty.
+          4. The operating system could not map the file.
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The mapping is read-only and shared, so the pages of a file mapped by
+  several processes are held in memory once, and are read from the file only
+  as they are first touched. The file may be closed or removed while it is
+  mapped. The mapping begins on a page boundary.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION MapFileBlock
+(
+    void ** pBuffer,
+    size_t * pSize,
+    const char * pPath
+);
+
+/*----------------------------------------------------------------------------
+  UnmapFileBlock()
+  ----------------------------------------------------------------------------
+  Unmaps the contents of a file mapped by MapFileBlock().
+  ----------------------------------------------------------------------------
+  Parameters:
+  
+  pBuffer     - (I/O) The address of the memory pointer holding the address
+                      of the mapped file contents
+  pSize       - (I)   The number of bytes mapped
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - File was successfully unmapped
+
+  False - File was not successfully unmapped due to one of the following:
+
+          1. The buffer pointer pointer or the buffer pointer was NULL.
+          2. The operating system could not unmap the file.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION UnmapFileBlock
+(
+    void ** pBuffer,
+    size_t pSize
+);
+
+/*----------------------------------------------------------------------------
+  ReserveBlock()
+  ----------------------------------------------------------------------------
+  Reserves a range of address space without memory to back it.
+  ----------------------------------------------------------------------------
+  Parameters:
+  
+  pBlock      - (I/O) The address of a memory pointer to hold the address of
+                      the reserved range
+  pSize       - (I)   The number of bytes to reserve
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Address space was successfully reserved
+
+  False - Address space was not successfully reserved due to one of the
+          following:
+
+          1. The block pointer pointer was NULL or the size was 0.
+          2. The block pointer pointed to be the block pointer pointer was
+             not initialized to NULL.
+          3. The operating system could not reserve the address space.
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The range begins on a page boundary and cannot be touched until a part of
+  it is committed by CommitBlock(). The range is released by ReleaseBlock().
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReserveBlock
+(
+    void ** pBlock,
+    size_t pSize
+);
+
+/*----------------------------------------------------------------------------
+  CommitBlock()
+  ----------------------------------------------------------------------------
+  Commits memory to a part of a range reserved by ReserveBlock(), making it
+  readable and writable.
+  ----------------------------------------------------------------------------
+  Parameters:
+  
+  pAddress    - (I) The address of the part to commit, on a page boundary
+  pSize       - (I) The number of bytes to commit
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Memory was successfully committed
+
+  False - Memory was not successfully committed due to one of the
+          following:
+
+          1. The address was NULL or the size was 0.
+          2. The operating system could not commit the memory.
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Committed memory reads as zeros until it is written.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION CommitBlock
+(
+    void * pAddress,
+    size_t pSize
+);
+
+/*----------------------------------------------------------------------------
+  ReleaseBlock()
+  ----------------------------------------------------------------------------
+  Releases a range reserved by ReserveBlock() along with any memory committed
+  to it.
+  ----------------------------------------------------------------------------
+  Parameters:
+  
+  pBlock      - (I/O) The address of the memory pointer holding the address
+                      of the reserved range
+  pSize       - (I)   The number of bytes reserved
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Address space was successfully released
+
+  False - Address space was not successfully released due to one of the
+          following:
+
+          1. The block pointer pointer or the block pointer was NULL.
+          2. The operating system could not release the address space.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReleaseBlock
+(
+    void ** pBlock,
+    size_t pSize
+);
+
 /*----------------------------------------------------------------------------
   CopyBlock()
   ----------------------------------------------------------------------------
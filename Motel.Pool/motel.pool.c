@@ -479,6 +479,12 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetPoolMember
 
             return (TRUE);
 
+        case motelPoolMember_BlockSize:
+
+            * (size_t *) pValue = pMemoryHandle->blockSize;
+
+            return (TRUE);
+
         case motelPoolMember_PoolCount:
 
             * (size_t *) pValue = pMemoryHandle->poolCount;
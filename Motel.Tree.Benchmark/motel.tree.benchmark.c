@@ -0,0 +1,1230 @@
+/*----------------------------------------------------------------------------
+  Motel Tree Benchmark
+
+  executable implementation file
+  ---------------------------------------------------------------------------- 
+  Copyright 2010-2011 John L. Hart IV. All rights reserved.
+ 
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+ 
+  1. Redistributions of source code must retain all copyright notices,
+     this list of conditions and the following disclaimer.
+ 
+  2. Redistributions in binary form must reproduce all copyright
+     notices, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+ 
+  THIS SOFTWARE IS PROVIDED BY John L. Hart IV "AS IS" AND ANY EXPRESS OR
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+  NO EVENT SHALL John L. Hart IV OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+  DAMAGE.
+ 
+  The views and conclusions contained in the software and documentation are
+  those of the authors and should not be interpreted as representing official
+  policies, either expressed or implied, of John L Hart IV.
+  ----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------
+  Standard libraries
+  ----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined _WIN32 && !defined _WIN64
+#include <time.h>
+#endif
+
+/*----------------------------------------------------------------------------
+  Public data types
+  ----------------------------------------------------------------------------*/
+
+#include "../Motel/motel.compilation.t.h"
+#include "../Motel/motel.types.t.h"
+#include "../Motel/motel.results.t.h"
+#include "../Motel/motel.thread.t.h"
+
+#include "../Motel.Pool/motel.pool.t.h"
+
+#include "../Motel.Tree/motel.tree.t.h"
+
+/*----------------------------------------------------------------------------
+  Public functions
+  ----------------------------------------------------------------------------*/
+
+#include "../Motel.Memory/motel.memory.i.h"
+#include "../Motel.Pool/motel.pool.i.h"
+
+#include "../Motel.Tree/motel.tree.i.h"
+
+/*----------------------------------------------------------------------------
+  Private defines, data types and function prototypes
+  ----------------------------------------------------------------------------*/
+
+#include "motel.tree.benchmark.h"
+
+/*----------------------------------------------------------------------------
+  Embedded copyright
+  ----------------------------------------------------------------------------*/
+
+static const char *gCopyright = "@(#)motel.tree.benchmark.c - Copyright 2010-2011 John L. Hart IV - All rights reserved";
+
+/*----------------------------------------------------------------------------
+  Globals
+  ----------------------------------------------------------------------------*/
+
+static const char * gDistributionNames[benchmarkDistribution_] = {"sequential", "random", "zipfian", "duplicate"};
+static const char * gOperationNames[benchmarkOperation_] = {"insert", "select", "delete", "scan"};
+static const char * gFormatNames[benchmarkFormat_] = {"text", "json", "csv"};
+static const char * gBalanceModeNames[motelTreeBalanceMode_] = {"pivot", "double", "rebuild"};
+
+/*
+** configuration
+*/
+
+unsigned long gNodes = DEFAULT_NODES;
+unsigned long gOperations = DEFAULT_OPERATIONS;
+unsigned long gScanLength = DEFAULT_SCAN_LENGTH;
+
+bits64 gSeed = DEFAULT_SEED;
+
+benchmarkDistribution gDistribution = benchmarkDistribution_Random;
+benchmarkFormat gFormat = benchmarkFormat_Text;
+
+unsigned long gMix[benchmarkOperation_] = {0, 100, 0, 0}; /* percentages */
+
+size_t gPoolBlockSize = 0;
+
+boolean gCustomCompare = FALSE;
+
+motelTreeBalance gBalance = {DEFAULT_BALANCE_NUMERATOR, DEFAULT_BALANCE_DENOMINATOR, motelTreeBalanceMode_Pivot};
+
+const char * gLogPath = NULL;
+char * gCheckpointPath = NULL;
+
+unsigned long gLogCommit = DEFAULT_LOG_COMMIT;
+unsigned long gLogInterval = DEFAULT_LOG_INTERVAL;
+
+/*
+** workload
+*/
+
+motelTreeHandle gTree;
+
+bits64 gRandomState;
+
+integer64 gSequentialKey;
+
+unsigned long gKeySpace;
+
+double gZipfianZetaN;
+double gZipfianZeta2;
+double gZipfianAlpha;
+double gZipfianEta;
+
+integer64 * gLoadKeys;
+
+integer64 * gKeys;
+byte * gOperationCodes;
+
+double * gLatencies;
+
+char gData[DATA_ELEMENT_SIZE];
+
+double gLoadNanoseconds;
+double gRunNanoseconds;
+
+unsigned long gFinalLevels;
+unsigned long gFinalLevelBound;
+
+benchmarkStatistics gStatistics[benchmarkOperation_];
+
+/*----------------------------------------------------------------------------
+  Main
+  ----------------------------------------------------------------------------*/
+
+int main
+(
+    int pArgc,
+    char * pArgv[]
+)
+{
+    int lExitCode = EXIT_FAILURE;
+
+    if (!ParseArguments(pArgc, pArgv))
+    {
+        DisplayUsage();
+
+        return (EXIT_FAILURE);
+    }
+
+    gTree = (motelTreeHandle) NULL;
+
+    /*
+    ** every key and operation is generated before the clock starts so that
+    ** random number generation is not measured
+    */
+
+    if (GenerateWorkload() && LoadTree() && RunWorkload())
+    {
+        Summarize();
+
+        switch (gFormat)
+        {
+            case benchmarkFormat_Json:
+
+                OutputJson();
+                break;
+
+            case benchmarkFormat_Csv:
+
+                OutputCsv();
+                break;
+
+            default:
+
+                OutputText();
+                break;
+        }
+
+        lExitCode = EXIT_SUCCESS;
+    }
+
+    if (NULL != gTree)
+    {
+        DestructTree(&gTree);
+    }
+
+    free(gLoadKeys);
+    free(gKeys);
+    free(gOperationCodes);
+    free(gLatencies);
+
+    free(gCheckpointPath);
+
+    return (lExitCode);
+}
+
+/*----------------------------------------------------------------------------
+  Command line
+  ----------------------------------------------------------------------------*/
+
+boolean ParseArguments
+(
+    int pArgc,
+    char * pArgv[]
+)
+{
+    int lArgument;
+    int lIndex;
+
+    const char * lOption;
+    const char * lValue;
+
+    for (lArgument = 1; lArgument < pArgc; lArgument++)
+    {
+        lOption = pArgv[lArgument];
+
+        /*
+        ** every option takes a value
+        */
+
+        if ('-' != lOption[0] || '\0' == lOption[1] || '\0' != lOption[2] || lArgument + 1 >= pArgc)
+        {
+            return (FALSE);
+        }
+
+        lValue = pArgv[++lArgument];
+
+        switch (lOption[1])
+        {
+            case 'n': // nodes loaded before measuring
+
+                gNodes = strtoul(lValue, NULL, 10);
+                break;
+
+            case 'o': // operations measured
+
+                gOperations = strtoul(lValue, NULL, 10);
+                break;
+
+            case 'l': // nodes visited per scan
+
+                gScanLength = strtoul(lValue, NULL, 10);
+                break;
+
+            case 's': // random number seed
+
+                gSeed = (bits64) strtoul(lValue, NULL, 10);
+                break;
+
+            case 'p': // memory pool block size
+
+                gPoolBlockSize = (size_t) strtoul(lValue, NULL, 10);
+                break;
+
+            case 'k': // key distribution
+
+                for (lIndex = 0; lIndex < benchmarkDistribution_; lIndex++)
+                {
+                    if (0 == strcmp(lValue, gDistributionNames[lIndex]))
+                    {
+                        break;
+                    }
+                }
+
+                if (benchmarkDistribution_ == lIndex)
+                {
+                    return (FALSE);
+                }
+
+                gDistribution = (benchmarkDistribution) lIndex;
+                break;
+
+            case 'f': // output format
+
+                for (lIndex = 0; lIndex < benchmarkFormat_; lIndex++)
+                {
+                    if (0 == strcmp(lValue, gFormatNames[lIndex]))
+                    {
+                        break;
+                    }
+                }
+
+                if (benchmarkFormat_ == lIndex)
+                {
+                    return (FALSE);
+                }
+
+                gFormat = (benchmarkFormat) lIndex;
+                break;
+
+            case 'c': // key comparison
+
+                if (0 == strcmp(lValue, "custom"))
+                {
+                    gCustomCompare = TRUE;
+                }
+                else if (0 == strcmp(lValue, "typed"))
+                {
+                    gCustomCompare = FALSE;
+                }
+                else
+                {
+                    return (FALSE);
+                }
+
+                break;
+
+            case 'm': // operation mix
+
+                if (!ParseMix(lValue))
+                {
+                    return (FALSE);
+                }
+
+                break;
+
+            case 't': // rebalance threshold
+
+                if (!ParseThreshold(lValue))
+                {
+                    return (FALSE);
+                }
+
+                break;
+
+            case 'b': // balance mode
+
+                for (lIndex = 0; lIndex < motelTreeBalanceMode_; lIndex++)
+                {
+                    if (0 == strcmp(lValue, gBalanceModeNames[lIndex]))
+                    {
+                        break;
+                    }
+                }
+
+                if (motelTreeBalanceMode_ == lIndex)
+                {
+                    return (FALSE);
+                }
+
+                gBalance.mode = (motelTreeBalanceMode) lIndex;
+                break;
+
+            case 'w': // redo log
+
+                gLogPath = lValue;
+                break;
+
+            case 'g': // redo log group commit size
+
+                gLogCommit = strtoul(lValue, NULL, 10);
+                break;
+
+            case 'i': // redo log group commit interval
+
+                gLogInterval = strtoul(lValue, NULL, 10);
+                break;
+
+            default:
+
+                return (FALSE);
+        }
+    }
+
+    return (0 < gOperations);
+}
+
+boolean ParseMix
+(
+    const char * pMix
+)
+{
+    unsigned long lMix[benchmarkOperation_] = {0, 0, 0, 0};
+    unsigned long lTotal = 0;
+    unsigned long lPercentage;
+
+    size_t lLength;
+
+    char * lEnd;
+
+    int lIndex;
+
+    /*
+    ** a comma separated list of operation=percentage pairs totalling 100
+    */
+
+    while ('\0' != * pMix)
+    {
+        for (lIndex = 0; lIndex < benchmarkOperation_; lIndex++)
+        {
+            lLength = strlen(gOperationNames[lIndex]);
+
+            if (0 == strncmp(pMix, gOperationNames[lIndex], lLength) && '=' == pMix[lLength])
+            {
+                break;
+            }
+        }
+
+        if (benchmarkOperation_ == lIndex)
+        {
+            return (FALSE);
+        }
+
+        pMix += lLength + 1;
+
+        lPercentage = strtoul(pMix, &lEnd, 10);
+
+        if (lEnd == pMix)
+        {
+            return (FALSE);
+        }
+
+        lMix[lIndex] += lPercentage;
+        lTotal += lPercentage;
+
+        pMix = lEnd;
+
+        if (',' == * pMix)
+        {
+            pMix++;
+        }
+        else if ('\0' != * pMix)
+        {
+            return (FALSE);
+        }
+    }
+
+    if (100 != lTotal)
+    {
+        return (FALSE);
+    }
+
+    memcpy(gMix, lMix, sizeof(gMix));
+
+    return (TRUE);
+}
+
+boolean ParseThreshold
+(
+    const char * pThreshold
+)
+{
+    unsigned long lNumerator;
+    unsigned long lDenominator = 1;
+
+    char * lEnd;
+
+    /*
+    ** a whole ratio such as 3 or a fraction such as 5/2
+    */
+
+    lNumerator = strtoul(pThreshold, &lEnd, 10);
+
+    if (lEnd == pThreshold)
+    {
+        return (FALSE);
+    }
+
+    if ('/' == * lEnd)
+    {
+        pThreshold = lEnd + 1;
+
+        lDenominator = strtoul(pThreshold, &lEnd, 10);
+
+        if (lEnd == pThreshold)
+        {
+            return (FALSE);
+        }
+    }
+
+    if ('\0' != * lEnd)
+    {
+        return (FALSE);
+    }
+
+    gBalance.numerator = lNumerator;
+    gBalance.denominator = lDenominator;
+
+    return (TRUE);
+}
+
+void DisplayUsage
+(
+    void
+)
+{
+    fprintf(stderr,
+            "\n"
+            "Usage: motel.tree.benchmark [option value]...\n"
+            "\n"
+            "-n nodes       Nodes loaded before measuring (default %d)\n"
+            "-o operations  Operations measured (default %d)\n"
+            "-k keys        Key distribution: sequential, random, zipfian or duplicate (default random)\n"
+            "-m mix         Operation percentages, e.g. insert=20,select=60,delete=15,scan=5 (default select=100)\n"
+            "-l length      Nodes visited per scan (default %d)\n"
+            "-c compare     Key comparison: typed or custom (default typed)\n"
+            "-p size        Memory pool block size, 0 for the heap (default 0)\n"
+            "-t ratio       Branch weight ratio at which the tree rebalances, e.g. 3 or 5/2 (default %d)\n"
+            "-b balance     Balance mode: pivot, double or rebuild (default pivot)\n"
+            "-w log         Redo log of the measured changes, checkpointed to log" CHECKPOINT_SUFFIX " (default none)\n"
+            "-g records     Most changes committed to the redo log together (default %d)\n"
+            "-i interval    Milliseconds after a redo log commit from which the next change commits, 0 for none (default %d)\n"
+            "-s seed        Random number seed (default %d)\n"
+            "-f format      Output format: text, json or csv (default text)\n"
+            "\n",
+            DEFAULT_NODES, DEFAULT_OPERATIONS, DEFAULT_SCAN_LENGTH, DEFAULT_BALANCE_NUMERATOR, DEFAULT_LOG_COMMIT, DEFAULT_LOG_INTERVAL, DEFAULT_SEED);
+}
+
+/*----------------------------------------------------------------------------
+  Workload generation
+  ----------------------------------------------------------------------------*/
+
+boolean GenerateWorkload
+(
+    void
+)
+{
+    unsigned long lIndex;
+    unsigned long lOperation;
+    unsigned long lPercentile;
+    unsigned long lThreshold;
+
+    gRandomState = gSeed ? gSeed : DEFAULT_SEED;
+
+    gSequentialKey = 0;
+
+    /*
+    ** the number of distinct keys drawn from
+    */
+
+    switch (gDistribution)
+    {
+        case benchmarkDistribution_Duplicate:
+
+            gKeySpace = (gNodes + gOperations) / DUPLICATES_PER_KEY + 1;
+            break;
+
+        default:
+
+            gKeySpace = gNodes + gOperations;
+            break;
+    }
+
+    if (benchmarkDistribution_Zipfian == gDistribution)
+    {
+        PrepareZipfian(gKeySpace);
+    }
+
+    gLoadKeys = (integer64 *) malloc((gNodes + 1) * sizeof(integer64));
+    gKeys = (integer64 *) malloc(gOperations * sizeof(integer64));
+    gOperationCodes = (byte *) malloc(gOperations * sizeof(byte));
+    gLatencies = (double *) malloc(gOperations * sizeof(double));
+
+    if (NULL == gLoadKeys || NULL == gKeys || NULL == gOperationCodes || NULL == gLatencies)
+    {
+        fprintf(stderr, "Workload could not be allocated\n");
+
+        return (FALSE);
+    }
+
+    for (lIndex = 0; lIndex < gNodes; lIndex++)
+    {
+        gLoadKeys[lIndex] = NextKey();
+    }
+
+    for (lIndex = 0; lIndex < gOperations; lIndex++)
+    {
+        /*
+        ** choose the operation by its share of the mix
+        */
+
+        lPercentile = (unsigned long) (NextRandom() % 100);
+
+        lThreshold = 0;
+
+        for (lOperation = 0; lOperation < benchmarkOperation_ - 1; lOperation++)
+        {
+            lThreshold += gMix[lOperation];
+
+            if (lPercentile < lThreshold)
+            {
+                break;
+            }
+        }
+
+        /*
+        ** skip past operations without a share of the mix
+        */
+
+        while (0 == gMix[lOperation])
+        {
+            lOperation = (lOperation + 1) % benchmarkOperation_;
+        }
+
+        gOperationCodes[lIndex] = (byte) lOperation;
+
+        gKeys[lIndex] = NextKey();
+    }
+
+    memset(gData, '*', sizeof(gData));
+
+    return (TRUE);
+}
+
+integer64 NextKey
+(
+    void
+)
+{
+    switch (gDistribution)
+    {
+        case benchmarkDistribution_Sequential:
+
+            return (gSequentialKey++);
+
+        case benchmarkDistribution_Zipfian:
+
+            /*
+            ** scatter the popular keys rather than clustering them at the least keys
+            */
+
+            return ((integer64) ((NextZipfian() * (bits64) 0x9E3779B97F4A7C15) % gKeySpace));
+
+        default:
+
+            return ((integer64) (NextRandom() % gKeySpace));
+    }
+}
+
+bits64 NextRandom
+(
+    void
+)
+{
+    /*
+    ** xorshift64* - the same sequence on every platform
+    */
+
+    gRandomState ^= gRandomState >> 12;
+    gRandomState ^= gRandomState << 25;
+    gRandomState ^= gRandomState >> 27;
+
+    return (gRandomState * (bits64) 0x2545F4914F6CDD1D);
+}
+
+double NextUniform
+(
+    void
+)
+{
+    return ((double) (NextRandom() >> 11) * (1.0 / 9007199254740992.0));
+}
+
+void PrepareZipfian
+(
+    unsigned long pItems
+)
+{
+    unsigned long lItem;
+
+    /*
+    ** Gray et al, "Quickly Generating Billion-Record Synthetic Databases"
+    */
+
+    gZipfianZetaN = 0.0;
+
+    for (lItem = 1; lItem <= pItems; lItem++)
+    {
+        gZipfianZetaN += 1.0 / pow((double) lItem, ZIPFIAN_THETA);
+    }
+
+    gZipfianZeta2 = 1.0 + 1.0 / pow(2.0, ZIPFIAN_THETA);
+
+    gZipfianAlpha = 1.0 / (1.0 - ZIPFIAN_THETA);
+
+    gZipfianEta = (1.0 - pow(2.0 / (double) pItems, 1.0 - ZIPFIAN_THETA)) / (1.0 - gZipfianZeta2 / gZipfianZetaN);
+}
+
+unsigned long NextZipfian
+(
+    void
+)
+{
+    double lUniform;
+    double lUniformZeta;
+
+    unsigned long lItem;
+
+    lUniform = NextUniform();
+    lUniformZeta = lUniform * gZipfianZetaN;
+
+    if (1.0 > lUniformZeta)
+    {
+        return (0);
+    }
+
+    if (1.0 + pow(0.5, ZIPFIAN_THETA) > lUniformZeta)
+    {
+        return (1);
+    }
+
+    lItem = (unsigned long) ((double) gKeySpace * pow(gZipfianEta * lUniform - gZipfianEta + 1.0, gZipfianAlpha));
+
+    return (lItem < gKeySpace ? lItem : gKeySpace - 1);
+}
+
+/*----------------------------------------------------------------------------
+  Measurement
+  ----------------------------------------------------------------------------*/
+
+boolean LoadTree
+(
+    void
+)
+{
+    motelTreeKeyType lKeyType = motelTreeKeyType_Signed64;
+
+    unsigned long lIndex;
+
+    double lStart;
+
+    if (!ConstructTree(&gTree, (size_t) 0, (size_t) DATA_ELEMENT_SIZE, sizeof(integer64), gCustomCompare ? _compare : NULL))
+    {
+        fprintf(stderr, "Tree could not be constructed\n");
+
+        return (FALSE);
+    }
+
+    if (!gCustomCompare && !SetTreeMember(gTree, motelTreeMember_KeyType, &lKeyType))
+    {
+        fprintf(stderr, "Key type could not be set\n");
+
+        return (FALSE);
+    }
+
+    if (0 != gPoolBlockSize && !SetTreeMember(gTree, motelTreeMember_MemoryPool, &gPoolBlockSize))
+    {
+        fprintf(stderr, "Memory pool could not be set\n");
+
+        return (FALSE);
+    }
+
+    if (!SetTreeMember(gTree, motelTreeMember_Balance, &gBalance))
+    {
+        fprintf(stderr, "Balance could not be set\n");
+
+        return (FALSE);
+    }
+
+    lStart = GetNanoseconds();
+
+    for (lIndex = 0; lIndex < gNodes; lIndex++)
+    {
+        if (!InsertTreeNode(gTree, gData, &gLoadKeys[lIndex]))
+        {
+            fprintf(stderr, "Node could not be loaded\n");
+
+            return (FALSE);
+        }
+    }
+
+    gLoadNanoseconds = GetNanoseconds() - lStart;
+
+    /*
+    ** the measured changes are logged behind a checkpoint of the loaded tree
+    */
+
+    if (NULL != gLogPath)
+    {
+        if (!SetTreeMember(gTree, motelTreeMember_LogCommit, &gLogCommit))
+        {
+            fprintf(stderr, "Log commit size could not be set\n");
+
+            return (FALSE);
+        }
+
+        SetTreeMember(gTree, motelTreeMember_LogInterval, &gLogInterval);
+
+        gCheckpointPath = (char *) malloc(strlen(gLogPath) + sizeof(CHECKPOINT_SUFFIX));
+
+        if (NULL == gCheckpointPath)
+        {
+            fprintf(stderr, "Checkpoint path could not be allocated\n");
+
+            return (FALSE);
+        }
+
+        strcpy(gCheckpointPath, gLogPath);
+        strcat(gCheckpointPath, CHECKPOINT_SUFFIX);
+
+        if (!LogTree(gTree, gLogPath, gCheckpointPath))
+        {
+            fprintf(stderr, "Redo log could not be started\n");
+
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
+boolean RunWorkload
+(
+    void
+)
+{
+    unsigned long lIndex;
+    unsigned long lVisited;
+
+    boolean lHit;
+
+    double lStart;
+    double lOperationStart;
+    double lOperationEnd;
+
+#if defined TREE_STATISTICS
+
+    motelTreeStatistics lTreeStatistics;
+
+    /*
+    ** the tree's counts cover the measured operations alone
+    */
+
+    memset(&lTreeStatistics, 0, sizeof(lTreeStatistics));
+
+    SetTreeMember(gTree, motelTreeMember_Statistics, &lTreeStatistics);
+
+#endif
+
+    memset(gStatistics, 0, sizeof(gStatistics));
+
+    lStart = GetNanoseconds();
+
+    lOperationEnd = lStart;
+
+    for (lIndex = 0; lIndex < gOperations; lIndex++)
+    {
+        lOperationStart = lOperationEnd;
+
+        switch (gOperationCodes[lIndex])
+        {
+            case benchmarkOperation_Insert:
+
+                lHit = InsertTreeNode(gTree, gData, &gKeys[lIndex]);
+                break;
+
+            case benchmarkOperation_Select:
+
+                lHit = SelectTreeNode(gTree, &gKeys[lIndex], 0);
+                break;
+
+            case benchmarkOperation_Delete:
+
+                lHit = SelectTreeNode(gTree, &gKeys[lIndex], 0) && DeleteTreeNode(gTree);
+                break;
+
+            default: // benchmarkOperation_Scan
+
+                lVisited = 0;
+
+                ScanTreeRange(gTree, &gKeys[lIndex], NULL, CountScannedNode, &lVisited);
+
+                lHit = 0 < lVisited;
+                break;
+        }
+
+        /*
+        ** each operation ends where the next begins, halving the timer reads
+        */
+
+        lOperationEnd = GetNanoseconds();
+
+        gLatencies[lIndex] = lOperationEnd - lOperationStart;
+
+        if (lHit)
+        {
+            gStatistics[gOperationCodes[lIndex]].hits++;
+        }
+    }
+
+    gRunNanoseconds = GetNanoseconds() - lStart;
+
+    return (ValidateTree(gTree));
+}
+
+boolean CountScannedNode
+(
+    void * pContext,
+    const void * pKey,
+    const void * pData,
+    unsigned long pInstance
+)
+{
+    (void) pKey;
+    (void) pData;
+    (void) pInstance;
+
+    return (++(* (unsigned long *) pContext) < gScanLength);
+}
+
+/*----------------------------------------------------------------------------
+  Reporting
+  ----------------------------------------------------------------------------*/
+
+void Summarize
+(
+    void
+)
+{
+    double * lSorted;
+
+    unsigned long lIndex;
+    unsigned long lCount;
+
+    int lOperation;
+
+    lSorted = (double *) malloc(gOperations * sizeof(double));
+
+    for (lOperation = 0; lOperation < benchmarkOperation_; lOperation++)
+    {
+        /*
+        ** gather the latencies of one kind of operation
+        */
+
+        lCount = 0;
+
+        gStatistics[lOperation].totalNanoseconds = 0.0;
+
+        for (lIndex = 0; lIndex < gOperations; lIndex++)
+        {
+            if (lOperation == gOperationCodes[lIndex])
+            {
+                gStatistics[lOperation].totalNanoseconds += gLatencies[lIndex];
+
+                if (NULL != lSorted)
+                {
+                    lSorted[lCount] = gLatencies[lIndex];
+                }
+
+                lCount++;
+            }
+        }
+
+        gStatistics[lOperation].count = lCount;
+
+        if (0 == lCount || NULL == lSorted)
+        {
+            continue;
+        }
+
+        qsort(lSorted, lCount, sizeof(double), CompareLatencies);
+
+        gStatistics[lOperation].p50 = Percentile(lSorted, lCount, 0.50);
+        gStatistics[lOperation].p90 = Percentile(lSorted, lCount, 0.90);
+        gStatistics[lOperation].p99 = Percentile(lSorted, lCount, 0.99);
+        gStatistics[lOperation].p999 = Percentile(lSorted, lCount, 0.999);
+        gStatistics[lOperation].maximum = lSorted[lCount - 1];
+    }
+
+    free(lSorted);
+
+    /*
+    ** the depth is counted outside the timed run, and the tracked bound is
+    ** read first as counting the depth tightens it
+    */
+
+    GetTreeMember(gTree, motelTreeMember_LevelCount, &gFinalLevelBound);
+    GetTreeMember(gTree, motelTreeMember_ExactLevelCount, &gFinalLevels);
+}
+
+int CompareLatencies
+(
+    const void * pLatency1,
+    const void * pLatency2
+)
+{
+    double lLatency1 = * (const double *) pLatency1;
+    double lLatency2 = * (const double *) pLatency2;
+
+    return ((lLatency1 > lLatency2) - (lLatency1 < lLatency2));
+}
+
+double Percentile
+(
+    const double * pSorted,
+    unsigned long pCount,
+    double pFraction
+)
+{
+    unsigned long lIndex;
+
+    /*
+    ** nearest rank
+    */
+
+    lIndex = (unsigned long) ceil(pFraction * (double) pCount);
+
+    return (pSorted[(0 < lIndex ? lIndex : 1) - 1]);
+}
+
+void OutputText
+(
+    void
+)
+{
+    unsigned long lNodes = 0;
+
+    int lOperation;
+
+    GetTreeMember(gTree, motelTreeMember_Nodes, &lNodes);
+
+    printf("keys: %s  compare: %s  balance: %s %lu/%lu  loaded: %lu nodes in %.3f s  measured: %lu operations in %.3f s (%.0f ops/s)  final: %lu nodes in %lu levels (bounded at %lu)\n\n",
+           gDistributionNames[gDistribution], gCustomCompare ? "custom" : "typed",
+           gBalanceModeNames[gBalance.mode], gBalance.numerator, gBalance.denominator,
+           gNodes, gLoadNanoseconds / 1e9, gOperations, gRunNanoseconds / 1e9, (double) gOperations / (gRunNanoseconds / 1e9), lNodes, gFinalLevels, gFinalLevelBound);
+
+    printf("%-8s %10s %10s %10s %10s %10s %10s %10s %12s\n", "op", "count", "hits", "mean ns", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns");
+
+    for (lOperation = 0; lOperation < benchmarkOperation_; lOperation++)
+    {
+        if (0 == gStatistics[lOperation].count)
+        {
+            continue;
+        }
+
+        printf("%-8s %10lu %10lu %10.0f %10.0f %10.0f %10.0f %10.0f %12.0f\n",
+               gOperationNames[lOperation],
+               gStatistics[lOperation].count,
+               gStatistics[lOperation].hits,
+               gStatistics[lOperation].totalNanoseconds / (double) gStatistics[lOperation].count,
+               gStatistics[lOperation].p50,
+               gStatistics[lOperation].p90,
+               gStatistics[lOperation].p99,
+               gStatistics[lOperation].p999,
+               gStatistics[lOperation].maximum);
+    }
+
+#if defined TREE_STATISTICS
+
+    {
+        motelTreeStatistics lTreeStatistics;
+
+        int lDepth;
+
+        GetTreeMember(gTree, motelTreeMember_Statistics, &lTreeStatistics);
+
+        printf("\ncomparisons: %.0f  pivots: %.0f insert %.0f delete  rebuilds: %.0f insert %.0f delete  allocations: %.0f (%.0f bytes)  reseeks: %.0f\n",
+               (double) lTreeStatistics.comparisons,
+               (double) lTreeStatistics.insertPivots, (double) lTreeStatistics.deletePivots,
+               (double) lTreeStatistics.insertRebuilds, (double) lTreeStatistics.deleteRebuilds,
+               (double) lTreeStatistics.allocations, (double) lTreeStatistics.allocationBytes,
+               (double) lTreeStatistics.reseeks);
+
+        printf("descent depths:");
+
+        for (lDepth = 0; lDepth < TREE_STATISTICS_DEPTHS; lDepth++)
+        {
+            if (0 != lTreeStatistics.descents[lDepth])
+            {
+                printf(" %d:%.0f", lDepth, (double) lTreeStatistics.descents[lDepth]);
+            }
+        }
+
+        printf("\n");
+    }
+
+#endif
+}
+
+void OutputJson
+(
+    void
+)
+{
+    unsigned long lNodes = 0;
+
+    int lOperation;
+
+    boolean lFirst = TRUE;
+
+    GetTreeMember(gTree, motelTreeMember_Nodes, &lNodes);
+
+    printf("{\n");
+    printf("  \"distribution\": \"%s\",\n", gDistributionNames[gDistribution]);
+    printf("  \"compare\": \"%s\",\n", gCustomCompare ? "custom" : "typed");
+    printf("  \"pool_block_size\": %lu,\n", (unsigned long) gPoolBlockSize);
+    printf("  \"balance\": \"%s\",\n", gBalanceModeNames[gBalance.mode]);
+    printf("  \"threshold\": \"%lu/%lu\",\n", gBalance.numerator, gBalance.denominator);
+    printf("  \"seed\": %lu,\n", (unsigned long) gSeed);
+    printf("  \"scan_length\": %lu,\n", gScanLength);
+    printf("  \"load_nodes\": %lu,\n", gNodes);
+    printf("  \"load_ns\": %.0f,\n", gLoadNanoseconds);
+    printf("  \"operations\": %lu,\n", gOperations);
+    printf("  \"run_ns\": %.0f,\n", gRunNanoseconds);
+    printf("  \"final_nodes\": %lu,\n", lNodes);
+    printf("  \"final_levels\": %lu,\n", gFinalLevels);
+    printf("  \"final_level_bound\": %lu,\n", gFinalLevelBound);
+    printf("  \"results\": [");
+
+    for (lOperation = 0; lOperation < benchmarkOperation_; lOperation++)
+    {
+        if (0 == gStatistics[lOperation].count)
+        {
+            continue;
+        }
+
+        printf("%s\n    {\"op\": \"%s\", \"count\": %lu, \"hits\": %lu, \"mean_ns\": %.1f, \"p50_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, \"p999_ns\": %.0f, \"max_ns\": %.0f}",
+               lFirst ? "" : ",",
+               gOperationNames[lOperation],
+               gStatistics[lOperation].count,
+               gStatistics[lOperation].hits,
+               gStatistics[lOperation].totalNanoseconds / (double) gStatistics[lOperation].count,
+               gStatistics[lOperation].p50,
+               gStatistics[lOperation].p90,
+               gStatistics[lOperation].p99,
+               gStatistics[lOperation].p999,
+               gStatistics[lOperation].maximum);
+
+        lFirst = FALSE;
+    }
+
+    printf("\n  ]\n");
+    printf("}\n");
+}
+
+void OutputCsv
+(
+    void
+)
+{
+    int lOperation;
+
+    printf("distribution,compare,balance,threshold,load_nodes,operations,final_levels,final_level_bound,op,count,hits,mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n");
+
+    for (lOperation = 0; lOperation < benchmarkOperation_; lOperation++)
+    {
+        if (0 == gStatistics[lOperation].count)
+        {
+            continue;
+        }
+
+        printf("%s,%s,%s,%lu/%lu,%lu,%lu,%lu,%lu,%s,%lu,%lu,%.1f,%.0f,%.0f,%.0f,%.0f,%.0f\n",
+               gDistributionNames[gDistribution],
+               gCustomCompare ? "custom" : "typed",
+               gBalanceModeNames[gBalance.mode],
+               gBalance.numerator,
+               gBalance.denominator,
+               gNodes,
+               gOperations,
+               gFinalLevels,
+               gFinalLevelBound,
+               gOperationNames[lOperation],
+               gStatistics[lOperation].count,
+               gStatistics[lOperation].hits,
+               gStatistics[lOperation].totalNanoseconds / (double) gStatistics[lOperation].count,
+               gStatistics[lOperation].p50,
+               gStatistics[lOperation].p90,
+               gStatistics[lOperation].p99,
+               gStatistics[lOperation].p999,
+               gStatistics[lOperation].maximum);
+    }
+}
+
+/*----------------------------------------------------------------------------
+  Utilities
+  ----------------------------------------------------------------------------*/
+
+long _compare
+(
+    const void * pKey1,
+    const void * pKey2
+)
+{
+    integer64 lKey1 = * (const integer64 *) pKey1;
+    integer64 lKey2 = * (const integer64 *) pKey2;
+
+    return ((long) (lKey1 > lKey2) - (long) (lKey1 < lKey2));
+}
+
+double GetNanoseconds
+(
+    void
+)
+{
+#if defined _WIN32 || defined _WIN64
+
+    static LARGE_INTEGER lFrequency;
+
+    LARGE_INTEGER lCounter;
+
+    if (0 == lFrequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&lFrequency);
+    }
+
+    QueryPerformanceCounter(&lCounter);
+
+    return ((double) lCounter.QuadPart * (1e9 / (double) lFrequency.QuadPart));
+
+#else
+
+    struct timespec lTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &lTime);
+
+    return ((double) lTime.tv_sec * 1e9 + (double) lTime.tv_nsec);
+
+#endif
+}
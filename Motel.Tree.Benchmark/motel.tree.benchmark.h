@@ -0,0 +1,234 @@
+/*----------------------------------------------------------------------------
+  Motel Tree Benchmark
+
+  private header file
+  ----------------------------------------------------------------------------
+  Copyright 2010-2011 John L. Hart IV. All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain all copyright notices,
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce all copyright
+     notices, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY John L. Hart IV "AS IS" AND ANY EXPRESS OR
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+  NO EVENT SHALL John L. Hart IV OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+  DAMAGE.
+
+  The views and conclusions contained in the software and documentation are
+  those of the authors and should not be interpreted as representing official
+  policies, either expressed or implied, of John L Hart IV.
+  ----------------------------------------------------------------------------*/
+
+#ifndef MOTEL_TREE_BENCHMARK_H
+#define MOTEL_TREE_BENCHMARK_H
+
+#define DEFAULT_NODES 1000000
+#define DEFAULT_OPERATIONS 1000000
+#define DEFAULT_SCAN_LENGTH 100
+#define DEFAULT_SEED 1
+
+/* the tree's own rebalance threshold ratio */
+
+#define DEFAULT_BALANCE_NUMERATOR 3
+#define DEFAULT_BALANCE_DENOMINATOR 1
+
+/* the tree's own redo log group commit size and interval; the checkpoint is written beside the log */
+
+#define DEFAULT_LOG_COMMIT 65536
+#define DEFAULT_LOG_INTERVAL 100
+
+#define CHECKPOINT_SUFFIX ".checkpoint"
+
+#define DATA_ELEMENT_SIZE 64
+
+/* duplicate-heavy key sets hold this many nodes per distinct key on average */
+
+#define DUPLICATES_PER_KEY 100
+
+/* the skew of the zipfian key distribution */
+
+#define ZIPFIAN_THETA 0.99
+
+/*----------------------------------------------------------------------------
+  Private data types
+  ----------------------------------------------------------------------------*/
+
+typedef enum benchmarkDistribution benchmarkDistribution;
+
+enum benchmarkDistribution
+{
+    benchmarkDistribution_Sequential,
+    benchmarkDistribution_Random,
+    benchmarkDistribution_Zipfian,
+    benchmarkDistribution_Duplicate,
+    benchmarkDistribution_
+};
+
+typedef enum benchmarkOperation benchmarkOperation;
+
+enum benchmarkOperation
+{
+    benchmarkOperation_Insert,
+    benchmarkOperation_Select,
+    benchmarkOperation_Delete,
+    benchmarkOperation_Scan,
+    benchmarkOperation_
+};
+
+typedef enum benchmarkFormat benchmarkFormat;
+
+enum benchmarkFormat
+{
+    benchmarkFormat_Text,
+    benchmarkFormat_Json,
+    benchmarkFormat_Csv,
+    benchmarkFormat_
+};
+
+typedef struct benchmarkStatistics benchmarkStatistics;
+
+struct benchmarkStatistics
+{
+    unsigned long count;
+    unsigned long hits;
+
+    double totalNanoseconds;
+
+    double p50;
+    double p90;
+    double p99;
+    double p999;
+    double maximum;
+};
+
+/*----------------------------------------------------------------------------
+  Private function prototypes
+  ----------------------------------------------------------------------------*/
+
+boolean ParseArguments
+(
+    int pArgc,
+    char * pArgv[]
+);
+
+boolean ParseMix
+(
+    const char * pMix
+);
+
+boolean ParseThreshold
+(
+    const char * pThreshold
+);
+
+void DisplayUsage
+(
+    void
+);
+
+boolean GenerateWorkload
+(
+    void
+);
+
+integer64 NextKey
+(
+    void
+);
+
+bits64 NextRandom
+(
+    void
+);
+
+double NextUniform
+(
+    void
+);
+
+void PrepareZipfian
+(
+    unsigned long pItems
+);
+
+unsigned long NextZipfian
+(
+    void
+);
+
+boolean LoadTree
+(
+    void
+);
+
+boolean RunWorkload
+(
+    void
+);
+
+boolean CountScannedNode
+(
+    void * pContext,
+    const void * pKey,
+    const void * pData,
+    unsigned long pInstance
+);
+
+void Summarize
+(
+    void
+);
+
+int CompareLatencies
+(
+    const void * pLatency1,
+    const void * pLatency2
+);
+
+double Percentile
+(
+    const double * pSorted,
+    unsigned long pCount,
+    double pFraction
+);
+
+void OutputText
+(
+    void
+);
+
+void OutputJson
+(
+    void
+);
+
+void OutputCsv
+(
+    void
+);
+
+long _compare
+(
+    const void * pKey1,
+    const void * pKey2
+);
+
+double GetNanoseconds
+(
+    void
+);
+
+#endif
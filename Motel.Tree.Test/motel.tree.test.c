@@ -50,6 +50,7 @@
 #include "../Motel/motel.types.t.h"
 #include "../Motel/motel.results.t.h"
 #include "../Motel/motel.math.t.h"
+#include "../Motel/motel.thread.t.h"
 
 #include "../Motel.String/motel.string.t.h"
 #include "../Motel.Pool/motel.pool.t.h"
@@ -95,6 +96,23 @@ unsigned long gInstances[THOROUGH_TEST_NODES > PERFORMANCE_TEST_NODES ? THOROUGH
 
 unsigned long gNodeCount;
 
+boolean gCustomKeys;
+boolean gParentless;
+boolean gPooled;
+
+unsigned long gThreads = 1;
+
+unsigned long gCounts[SET_TEST_KEYS];
+unsigned long gOtherCounts[SET_TEST_KEYS];
+unsigned long gFoundCounts[SET_TEST_KEYS];
+unsigned long gVersionCounts[SNAPSHOT_TEST_VERSIONS][SNAPSHOT_TEST_KEYS];
+
+long gBatchKeys[BATCH_TEST_NODES];
+unsigned long gBatchInstances[BATCH_TEST_NODES];
+char gBatchData[BATCH_TEST_NODES][DATA_ELEMENT_SIZE];
+char gSelectedData[BATCH_TEST_NODES][DATA_ELEMENT_SIZE];
+boolean gBatchFound[BATCH_TEST_NODES];
+
 FILE *gFile;
 
 /*----------------------------------------------------------------------------
@@ -144,6 +162,59 @@ void main
                 Construct();
                 break;
 
+            case 'K': // toggle custom key comparison
+            case 'k':
+
+                gCustomKeys = !gCustomKeys;
+
+                printf("Keys are compared by %s\n\n", gCustomKeys ? "_compare()" : "key type");
+
+                Destruct();
+                Construct();
+                break;
+
+            case 'P': // toggle parentless trees
+            case 'p':
+
+                gParentless = !gParentless;
+
+                printf("Trees are %s\n\n", gParentless ? "parentless" : "linked to parents");
+
+                Destruct();
+                Construct();
+                break;
+
+            case 'M': // toggle pooled trees
+            case 'm':
+
+#if defined COMPACT_TREE_NODES
+
+                printf("Nodes are allocated from the tree's own arena\n\n");
+
+#else
+
+                gPooled = !gPooled;
+
+                printf("Nodes are allocated from %s\n\n", gPooled ? "a memory pool" : "the heap");
+
+                Destruct();
+                Construct();
+
+#endif
+
+                break;
+
+            case 'T': // toggle teardown and validation threads
+            case 't':
+
+                gThreads = (1 == gThreads) ? TREE_TEST_THREADS : 1;
+
+                printf("Trees are torn down and validated by %lu thread%s\n\n", gThreads, (1 == gThreads) ? "" : "s");
+
+                Destruct();
+                Construct();
+                break;
+
             case 'I': // insert
             case 'i':
 
@@ -178,6 +249,30 @@ void main
                 DeleteNode();
                 break;
 
+            case 'R': // select by rank
+            case 'r':
+
+                SelectRankedNode();
+                break;
+
+            case 'C': // count a key range
+            case 'c':
+
+                CountKeyRange();
+                break;
+
+            case 'L': // select a lower bound
+            case 'l':
+
+                SelectLowerBoundNode();
+                break;
+
+            case 'W': // scan a key range
+            case 'w':
+
+                ScanKeyRange();
+                break;
+
             case '[': // move to head
 
                 LeastNode();
@@ -258,6 +353,58 @@ void main
                 IteratedTest2();
                 break;
 
+            case '3':
+
+                IteratedTest3();
+                break;
+
+            case '4':
+
+                IteratedTest4();
+                break;
+
+            case '5':
+
+                IteratedTest5();
+                break;
+
+            case '6':
+
+                IteratedTest6();
+                break;
+
+            case '7':
+
+                IteratedTest7();
+                break;
+
+            case '8':
+
+                IteratedTest8();
+                break;
+
+            case '9':
+
+                IteratedTest9();
+                break;
+
+            case '0':
+
+                IteratedTest10();
+                break;
+
+            case 'V':
+            case 'v':
+
+                IteratedTest11();
+                break;
+
+            case 'B':
+            case 'b':
+
+                IteratedTest12();
+                break;
+
             case '!':
 
                 OutputTreeState();
@@ -265,7 +412,7 @@ void main
 
             default:
 
-                printf("Valid options are I,S,F,U,D,[,],>,<,{,},),(,A,Z,a,z,1,2,!,X,Q,?\n");
+                printf("Valid options are I,S,F,U,D,R,C,L,W,[,],>,<,{,},),(,A,Z,a,z,1,2,3,4,5,6,7,8,9,0,V,B,!,K,P,M,T,X,Q,?\n");
                 continue;
         }
     }
@@ -287,6 +434,11 @@ void DisplayOptions
            "U - Update the node at the cursor location\n"
            "D - Delete the node at the cursor location\n"
            "\n"
+           "R - Select a node by rank altering the cursor location\n"
+           "C - Count the nodes within a key range\n"
+           "L - Select the least node not less than a key altering the cursor location\n"
+           "W - Scan the nodes within a key range\n"
+           "\n"
            "[ - Move the cursor to the least node\n"
            "] - Move the cursor to the greatest node\n"
            "> - Move the cursor to the greater node\n"
@@ -307,9 +459,23 @@ void DisplayOptions
            "\n"
            "1 - Iterated performance test\n"
            "2 - Iterated thorough test\n"
+           "3 - Iterated duplicate key test\n"
+           "4 - Iterated split and join test\n"
+           "5 - Iterated union, intersection and difference test\n"
+           "6 - Iterated persistent snapshot test\n"
+           "7 - Iterated redo log recovery test\n"
+           "8 - Iterated multiple cursor test\n"
+           "9 - Iterated concurrent reader and writer test\n"
+           "0 - Iterated batch insert and select test\n"
+           "V - Iterated frozen and mapped snapshot test\n"
+           "B - Iterated bulk load test\n"
            "\n"
            "! - Display tree state\n"
            "\n"
+           "K - Toggle between key type and _compare() key comparison\n"
+           "P - Toggle between parent linked and parentless trees\n"
+           "M - Toggle between heap and memory pool node allocation\n"
+           "T - Toggle between one and several teardown and validation threads\n"
            "X - Reset tree\n"
            "\n"
            "Q - Quit\n"
@@ -323,14 +489,56 @@ void Validate
 )
 {
     unsigned long lNodes = 0;
+    unsigned long lInstance;
+    unsigned long lLevels;
+    unsigned long lExactLevels;
+
+    boolean lGrouped = FALSE;
+
+    long lKey;
+
+    char lData[DATA_ELEMENT_SIZE];
 
     if (!ValidateTree(gTree))
     {
         fprintf(gFile, "Tree self validation failed.\n\n");
         return;
     }
+
+    /*
+    ** the tracked level count may stand above the levels held, never below
+    */
+
+    GetTreeMember(gTree, motelTreeMember_LevelCount, (void **) &lLevels);
+    GetTreeMember(gTree, motelTreeMember_ExactLevelCount, (void **) &lExactLevels);
+
+    if (lLevels < lExactLevels)
+    {
+        fprintf(gFile, "Tree level bound of %ld is below the %ld levels held\n\n", lLevels, lExactLevels);
+        return;
+    }
     
-    GetTreeMember(gTree, motelTreeMember_Nodes, (void **) &lNodes);
+    GetTreeMember(gTree, motelTreeMember_GroupDuplicates, (void **) &lGrouped);
+
+    if (lGrouped)
+    {
+        /*
+        ** a grouped node holds every instance of its key, so count the instances one by one
+        */
+
+        if (PeekLeastTreeNode(gTree, lData, &lKey, &lInstance))
+        {
+            do
+            {
+                lNodes++;
+            }
+            while (PeekGreaterTreeNode(gTree, lData, &lKey, &lInstance));
+        }
+    }
+    else
+    {
+        GetTreeMember(gTree, motelTreeMember_Nodes, (void **) &lNodes);
+    }
 
     if (gNodeCount != lNodes)
     {
@@ -343,11 +551,53 @@ void Construct
     void
 )
 {
+    motelTreeKeyType lKeyType;
+
+    size_t lBlockSize;
+
     if (!ConstructTree(&gTree, (size_t) 0, (size_t) DATA_ELEMENT_SIZE, sizeof(gKey), _compare))
     {
         return;
     }
 
+    /*
+    ** compare the integer keys in place rather than through _compare() unless custom keys are chosen
+    */
+
+    if (!gCustomKeys)
+    {
+        lKeyType = (sizeof(integer32) == sizeof(gKey)) ? motelTreeKeyType_Signed32 : motelTreeKeyType_Signed64;
+
+        SetTreeMember(gTree, motelTreeMember_KeyType, &lKeyType);
+    }
+
+    /*
+    ** step without parent links when parentless trees are chosen
+    */
+
+    if (gParentless)
+    {
+        SetTreeMember(gTree, motelTreeMember_Parentless, &gParentless);
+    }
+
+    /*
+    ** allocate the nodes from a private memory pool when pooled trees are chosen
+    */
+
+    if (gPooled)
+    {
+        lBlockSize = POOL_TEST_BLOCK_SIZE;
+
+        SetTreeMember(gTree, motelTreeMember_MemoryPool, &lBlockSize);
+    }
+
+    /*
+    ** divide the teardown and validation of large trees among the chosen threads
+    */
+
+    SetTreeMember(gTree, motelTreeMember_TeardownThreads, &gThreads);
+    SetTreeMember(gTree, motelTreeMember_ValidateThreads, &gThreads);
+
     memset(&gKeys, 0, sizeof(gKeys));
     memset(&gInstances, 0, sizeof(gInstances));
 
@@ -555,6 +805,113 @@ void DeleteNode
     Validate();
 }
 
+void SelectRankedNode
+(
+    void
+)
+{
+    unsigned long lRank;
+
+    printf("\n");
+    printf("Enter rank of node to find: ");
+    scanf("%lu", &lRank);
+    printf("\n");
+
+    if (SelectTreeNodeByRank(gTree, lRank))
+    {
+        if (FetchTreeNode(gTree, (void *) gData, (void *) &gKey, &gInstance))
+        {
+            OutputNodeData();
+        }
+
+        if (GetTreeNodeRank(gTree, &lRank))
+        {
+            fprintf(gFile, "Rank: %lu\n\n", lRank);
+        }
+    }
+
+    OutputResult();
+
+    Validate();
+}
+
+void CountKeyRange
+(
+    void
+)
+{
+    long lLeastKey;
+    long lGreatestKey;
+
+    unsigned long lCount;
+
+    printf("\n");
+    printf("Enter integer key for start of range: ");
+    scanf("%ld", &lLeastKey);
+    printf("Enter integer key for end of range: ");
+    scanf("%ld", &lGreatestKey);
+    printf("\n");
+
+    if (CountTreeNodesInKeyRange(gTree, &lLeastKey, &lGreatestKey, &lCount))
+    {
+        fprintf(gFile, "Nodes in range: %lu\n\n", lCount);
+    }
+
+    OutputResult();
+
+    Validate();
+}
+
+void SelectLowerBoundNode
+(
+    void
+)
+{
+    printf("\n");
+    printf("Enter integer key of lower bound: ");
+    scanf("%ld", &gKey);
+    printf("\n");
+
+    if (SelectTreeNodeLowerBound(gTree, (void *) &gKey))
+    {
+        if (FetchTreeNode(gTree, (void *) gData, (void *) &gKey, &gInstance))
+        {
+            OutputNodeData();
+        }
+    }
+
+    OutputResult();
+
+    Validate();
+}
+
+void ScanKeyRange
+(
+    void
+)
+{
+    long lLeastKey;
+    long lGreatestKey;
+
+    unsigned long lCount = 0;
+
+    printf("\n");
+    printf("Enter integer key for start of range: ");
+    scanf("%ld", &lLeastKey);
+    printf("Enter integer key for end of range: ");
+    scanf("%ld", &lGreatestKey);
+    printf("\n");
+
+    if (ScanTreeRange(gTree, &lLeastKey, &lGreatestKey, OutputScannedNode, (void *) &lCount))
+    {
+        fprintf(gFile, "Nodes scanned: %lu\n\n", lCount);
+    }
+
+    OutputResult();
+
+    Validate();
+}
+
 void LeastNode
 (
     void
@@ -771,7 +1128,7 @@ void TreeDiagram
 
     boolean lPopulated;
 
-    GetTreeMember(gTree, motelTreeMember_LevelCount, &lLevels);
+    GetTreeMember(gTree, motelTreeMember_ExactLevelCount, &lLevels);
 
     /*
     ** print the tree a level at a time
@@ -1346,65 +1703,2465 @@ void IteratedTest2
     printf("\n\n");
 }
 
-void OutputTreeState
+void IteratedTest3
 (
     void
 )
 {
-    unsigned long lNodes;
-    unsigned long lLevels;
+    static const char * lModeNames[motelTreeBalanceMode_] = {"pivot       ", "double pivot", "rebuild     "};
 
-    size_t lSize;
+    unsigned long lIterations;
+    unsigned long lIteration;
 
-    GetTreeMember(gTree, motelTreeMember_Nodes, (void **) &lNodes);
-    GetTreeMember(gTree, motelTreeMember_LevelCount, &lLevels);
-    GetTreeMember(gTree, motelTreeMember_Size, (void **) &lSize);
+    motelTreeBalance lBalance;
 
-    fprintf(gFile, "Node Count = %ld\n", lNodes);
-    fprintf(gFile, "Tree Depth = %ld\n", lLevels);
-    fprintf(gFile, "\n");
-    fprintf(gFile, "Memory Allocated = %zd\n\n", lSize);
-}
+    unsigned int lMode;
 
-void GenerateInsertData
-(
-    void
-)
-{
-    static unsigned long lCreationOrdinal = 1;
+    boolean lGrouped;
 
-    sprintf(gData, "Insert Ordinal:%08ld", lCreationOrdinal++);
-}
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
 
-void GenerateUpdateData
-(
-    void
-)
-{
-    static unsigned long lUpdateOrdinal = 1;
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        /*
+        ** under each way of restoring balance, churn a tree of a node per instance, then a tree grouping
+        ** the instances of each key in one node, unless the nodes come from a pool, which grouped trees cannot use
+        */
 
-    sprintf(gData, "Update Ordinal:%08ld", lUpdateOrdinal++);
-}
+        for (lMode = motelTreeBalanceMode_Pivot; lMode < motelTreeBalanceMode_; lMode++)
+        {
+            for (lGrouped = FALSE; lGrouped <= TRUE; lGrouped++)
+            {
+                if (lGrouped && gPooled)
+                {
+                    continue;
+                }
 
-void OutputNodeData
-(
-    void
-)
-{
-    fprintf(gFile, "Key: \"%06ld:%03ld\"\n", gKey, gInstance);
+                printf("Iteration : %ld %s %s ", lIteration, lModeNames[lMode], lGrouped ? "grouped  " : "ungrouped");
+
+                Destruct();
+                Construct();
+
+                GetTreeMember(gTree, motelTreeMember_Balance, (void **) &lBalance);
+
+                lBalance.mode = (motelTreeBalanceMode) lMode;
+
+                if (!SetTreeMember(gTree, motelTreeMember_Balance, &lBalance) ||
+                    !SetTreeMember(gTree, motelTreeMember_GroupDuplicates, &lGrouped))
+                {
+                    OutputResult();
+
+                    return;
+                }
+
+                if (!ChurnTree(lGrouped ? "Grouped tree" : "Ungrouped tree"))
+                {
+                    return;
+                }
+
+                printf("\r");
+            }
+        }
+    }
+
+    printf("\n\n");
+}
+
+boolean ChurnTree
+(
+    const char * pName
+)
+{
+    unsigned long lOperation;
+    unsigned long lIndex;
+
+    boolean lInsert;
+
+    /*
+    ** churn a few key values so that most inserts and deletes meet duplicates
+    */
+
+    for (lOperation = 0; lOperation < THOROUGH_TEST_NODES; lOperation++)
+    {
+        lInsert = 0 == gNodeCount || (THOROUGH_TEST_NODES > gNodeCount && 0 == rand() % 2);
+
+        if (lInsert)
+        {
+            gKey = rand() % DUPLICATE_TEST_KEYS;
+            sprintf(gData, "Entry #%06lu", lOperation + 1);
+
+            InsertTreeNode(gTree, gData, &gKey);
+
+            FetchTreeNode(gTree, gData, &gKey, &gInstance);
+
+            gKeys[gNodeCount] = gKey;
+            gInstances[gNodeCount] = gInstance;
+
+            gNodeCount++;
+        }
+        else
+        {
+            lIndex = rand() % gNodeCount;
+
+            gKey = gKeys[lIndex];
+            gInstance = gInstances[lIndex];
+
+            SelectTreeNode(gTree, &gKey, gInstance);
+
+            DeleteTreeNode(gTree);
+
+            gNodeCount--;
+
+            gKeys[lIndex] = gKeys[gNodeCount];
+            gInstances[lIndex] = gInstances[gNodeCount];
+        }
+
+        if (!ValidateTree(gTree))
+        {
+            fprintf(gFile, "\n%s of (%ld:%03ld) failed validation after %ld operations\n", lInsert ? "Insert" : "Delete", gKey, gInstance, lOperation + 1);
+
+            OutputResult();
+
+            return (FALSE);
+        }
+
+        if (0 == lOperation % (THOROUGH_TEST_NODES / 100))
+        {
+            switch ((lOperation / (THOROUGH_TEST_NODES / 100)) % 4L)
+            {
+            case 0:
+                printf("-\b");
+                break;
+            case 1:
+                printf("\\\b");
+                break;
+            case 2:
+                printf("|\b");
+                break;
+            case 3:
+                printf("/\b");
+                break;
+            }
+        }
+    }
+
+    /*
+    ** the tree holds exactly the tracked instances of each key
+    */
+
+    memset(gCounts, 0, DUPLICATE_TEST_KEYS * sizeof(unsigned long));
+
+    for (lIndex = 0; lIndex < gNodeCount; lIndex++)
+    {
+        gCounts[gKeys[lIndex]]++;
+    }
+
+    if (!CheckTree(gTree, gCounts, DUPLICATE_TEST_KEYS, pName))
+    {
+        return (FALSE);
+    }
+
+    Validate();
+
+    return (TRUE);
+}
+
+void IteratedTest4
+(
+    void
+)
+{
+    motelTreeHandle lLesser;
+    motelTreeHandle lGreater;
+
+    unsigned long lIterations;
+    unsigned long lIteration;
+
+    unsigned long lNodeIndex;
+    unsigned long lKeyIndex;
+
+    long lSplitKey;
+
+    Destruct();
+    Construct();
+
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
+
+    /*
+    ** the nodes of a memory pool cannot leave it
+    */
+
+    if (gPooled)
+    {
+        printf("Pooled trees cannot be split or joined, test skipped\n\n");
+
+        return;
+    }
+
+    memset(gCounts, 0, sizeof(gCounts));
+
+    gNodeCount = FillTree(gTree, gCounts, SET_TEST_KEYS, 0, SET_TEST_KEYS, THOROUGH_TEST_NODES);
+
+#if defined COMPACT_TREE_NODES
+
+    /*
+    ** the nodes of a compact tree cannot leave its arena
+    */
+
+    lSplitKey = RandomKey(0, SET_TEST_KEYS);
+
+    lLesser = (motelTreeHandle) NULL;
+    lGreater = (motelTreeHandle) NULL;
+
+    if (!CheckCompactRejection(SplitTree(gTree, &lSplitKey, &lLesser, &lGreater), "Split"))
+    {
+        return;
+    }
+
+    if (!ConstructOtherTree(&lGreater))
+    {
+        fprintf(gFile, "\nThe other tree could not be constructed\n");
+
+        return;
+    }
+
+    if (CheckCompactRejection(JoinTrees(gTree, lGreater), "Join"))
+    {
+        printf("Compact trees cannot be split or joined, rejections checked\n\n");
+    }
+
+    DestructTree(&lGreater);
+
+    return;
+
+#endif
+
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        printf("Iteration : %ld ", lIteration);
+
+        /*
+        ** split the tree about a random key value
+        */
+
+        lSplitKey = RandomKey(0, SET_TEST_KEYS);
+
+        lLesser = (motelTreeHandle) NULL;
+        lGreater = (motelTreeHandle) NULL;
+
+        if (!SplitTree(gTree, &lSplitKey, &lLesser, &lGreater))
+        {
+            fprintf(gFile, "\nSplit about %ld failed\n", lSplitKey);
+
+            OutputResult();
+
+            return;
+        }
+
+        printf("/");
+
+        for (lKeyIndex = 0; lKeyIndex < SET_TEST_KEYS; lKeyIndex++)
+        {
+            gOtherCounts[lKeyIndex] = ((long) lKeyIndex < lSplitKey) ? 0 : gCounts[lKeyIndex];
+            gCounts[lKeyIndex] -= gOtherCounts[lKeyIndex];
+        }
+
+        if (!CheckTree(lLesser, gCounts, SET_TEST_KEYS, "Lesser split tree") ||
+            !CheckTree(lGreater, gOtherCounts, SET_TEST_KEYS, "Greater split tree"))
+        {
+            return;
+        }
+
+        /*
+        ** reshape each half within its own key range before joining them back together
+        */
+
+        for (lNodeIndex = 0; lNodeIndex < THOROUGH_TEST_NODES / 10; lNodeIndex++)
+        {
+            if (0 < lSplitKey)
+            {
+                FillTree(lLesser, gCounts, SET_TEST_KEYS, 0, lSplitKey, 1);
+            }
+
+            FillTree(lGreater, gOtherCounts, SET_TEST_KEYS, lSplitKey, SET_TEST_KEYS, 1);
+        }
+
+        printf("+");
+
+        if (!JoinTrees(gTree, lLesser) || !JoinTrees(gTree, lGreater))
+        {
+            fprintf(gFile, "\nJoin about %ld failed\n", lSplitKey);
+
+            OutputResult();
+
+            return;
+        }
+
+        printf("\\");
+
+        DestructTree(&lLesser);
+        DestructTree(&lGreater);
+
+        gNodeCount = 0;
+
+        for (lKeyIndex = 0; lKeyIndex < SET_TEST_KEYS; lKeyIndex++)
+        {
+            gCounts[lKeyIndex] += gOtherCounts[lKeyIndex];
+
+            gNodeCount += gCounts[lKeyIndex];
+        }
+
+        if (!CheckTree(gTree, gCounts, SET_TEST_KEYS, "Joined tree"))
+        {
+            return;
+        }
+
+        printf("\r");
+    }
+
+    Validate();
+
+    printf("\n\n");
+}
+
+void IteratedTest5
+(
+    void
+)
+{
+    motelTreeHandle lOther;
+
+    unsigned long lIterations;
+    unsigned long lIteration;
+
+    unsigned long lKeyIndex;
+    unsigned long lOtherNodes;
+    unsigned long lThreads;
+
+    boolean lCombined;
+
+    const char * lOperation;
+
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
+
+    /*
+    ** the nodes of a memory pool cannot leave it
+    */
+
+    if (gPooled)
+    {
+        printf("Pooled trees cannot be combined, test skipped\n\n");
+
+        return;
+    }
+
+#if defined COMPACT_TREE_NODES
+
+    /*
+    ** the nodes of a compact tree cannot leave its arena
+    */
+
+    Destruct();
+    Construct();
+
+    memset(gCounts, 0, sizeof(gCounts));
+    memset(gOtherCounts, 0, sizeof(gOtherCounts));
+
+    lOther = (motelTreeHandle) NULL;
+
+    if (!ConstructOtherTree(&lOther))
+    {
+        fprintf(gFile, "\nThe other tree could not be constructed\n");
+
+        return;
+    }
+
+    gNodeCount = FillTree(gTree, gCounts, SET_TEST_KEYS, 0, SET_TEST_KEYS, SET_TEST_NODES);
+    FillTree(lOther, gOtherCounts, SET_TEST_KEYS, 0, SET_TEST_KEYS, SET_TEST_NODES);
+
+    if (CheckCompactRejection(UnionTrees(gTree, lOther), "Union") &&
+        CheckCompactRejection(IntersectTrees(gTree, lOther), "Intersection") &&
+        CheckCompactRejection(DifferenceTrees(gTree, lOther), "Difference"))
+    {
+        printf("Compact trees cannot be combined, rejections checked\n\n");
+    }
+
+    DestructTree(&lOther);
+
+    return;
+
+#endif
+
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        printf("Iteration : %ld ", lIteration);
+
+        Destruct();
+        Construct();
+
+        /*
+        ** alternate between combining on one thread and dividing the work among several
+        */
+
+        lThreads = (0 == lIteration % 2) ? SET_TEST_THREADS : 1;
+
+        SetTreeMember(gTree, motelTreeMember_CombineThreads, &lThreads);
+
+        memset(gCounts, 0, sizeof(gCounts));
+        memset(gOtherCounts, 0, sizeof(gOtherCounts));
+
+        lOther = (motelTreeHandle) NULL;
+
+        if (!ConstructOtherTree(&lOther))
+        {
+            fprintf(gFile, "\nThe other tree could not be constructed\n");
+
+            return;
+        }
+
+        gNodeCount = FillTree(gTree, gCounts, SET_TEST_KEYS, 0, SET_TEST_KEYS, SET_TEST_NODES);
+        lOtherNodes = FillTree(lOther, gOtherCounts, SET_TEST_KEYS, 0, SET_TEST_KEYS, SET_TEST_NODES);
+
+        printf(">");
+
+        /*
+        ** combine the trees, working out the key counts the tree should be left with
+        */
+
+        switch (lIteration % 3)
+        {
+        case 0:
+
+            lOperation = "Union";
+            lCombined = UnionTrees(gTree, lOther);
+
+            for (lKeyIndex = 0; lKeyIndex < SET_TEST_KEYS; lKeyIndex++)
+            {
+                if (0 == gCounts[lKeyIndex])
+                {
+                    gCounts[lKeyIndex] = gOtherCounts[lKeyIndex];
+                }
+            }
+
+            break;
+
+        case 1:
+
+            lOperation = "Intersection";
+            lCombined = IntersectTrees(gTree, lOther);
+
+            for (lKeyIndex = 0; lKeyIndex < SET_TEST_KEYS; lKeyIndex++)
+            {
+                if (0 == gOtherCounts[lKeyIndex])
+                {
+                    gCounts[lKeyIndex] = 0;
+                }
+            }
+
+            break;
+
+        default:
+
+            lOperation = "Difference";
+            lCombined = DifferenceTrees(gTree, lOther);
+
+            for (lKeyIndex = 0; lKeyIndex < SET_TEST_KEYS; lKeyIndex++)
+            {
+                if (0 != gOtherCounts[lKeyIndex])
+                {
+                    gCounts[lKeyIndex] = 0;
+                }
+            }
+
+            break;
+        }
+
+        if (!lCombined)
+        {
+            fprintf(gFile, "\n%s of %ld and %ld nodes on %ld threads failed\n", lOperation, gNodeCount, lOtherNodes, lThreads);
+
+            OutputResult();
+
+            DestructTree(&lOther);
+
+            return;
+        }
+
+        printf("<");
+
+        gNodeCount = 0;
+
+        for (lKeyIndex = 0; lKeyIndex < SET_TEST_KEYS; lKeyIndex++)
+        {
+            gNodeCount += gCounts[lKeyIndex];
+        }
+
+        memset(gOtherCounts, 0, sizeof(gOtherCounts));
+
+        if (!CheckTree(gTree, gCounts, SET_TEST_KEYS, lOperation) ||
+            !CheckTree(lOther, gOtherCounts, SET_TEST_KEYS, "Emptied other tree"))
+        {
+            DestructTree(&lOther);
+
+            return;
+        }
+
+        DestructTree(&lOther);
+
+        printf("\r");
+    }
+
+    Validate();
+
+    printf("\n\n");
+}
+
+void IteratedTest6
+(
+    void
+)
+{
+    motelTreeHandle lVersions[SNAPSHOT_TEST_VERSIONS];
+
+    unsigned long lIterations;
+    unsigned long lIteration;
+
+    unsigned long lOperation;
+    unsigned long lIndex;
+    unsigned long lVersion;
+    unsigned long lVersionCount;
+
+    boolean lPersistent = TRUE;
+
+    char lName[32];
+
+    Destruct();
+    Construct();
+
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
+
+    /*
+    ** nodes shared among persistent versions cannot come from one version's memory pool
+    */
+
+    if (gPooled)
+    {
+        printf("Pooled trees cannot be persistent, test skipped\n\n");
+
+        return;
+    }
+
+#if defined COMPACT_TREE_NODES
+
+    /*
+    ** the nodes of a compact tree cannot be shared with other versions
+    */
+
+    if (CheckCompactRejection(SetTreeMember(gTree, motelTreeMember_Persistent, &lPersistent), "Persistence"))
+    {
+        printf("Compact trees cannot be persistent, rejection checked\n\n");
+    }
+
+    return;
+
+#endif
+
+    if (!SetTreeMember(gTree, motelTreeMember_Persistent, &lPersistent))
+    {
+        fprintf(gFile, "\nThe tree could not be made persistent\n");
+
+        OutputResult();
+
+        return;
+    }
+
+    memset(gCounts, 0, sizeof(gCounts));
+
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        printf("Iteration : %ld ", lIteration);
+
+        lVersionCount = 0;
+
+        /*
+        ** churn the tree, mostly growing it, taking versions along the way and noting
+        ** what each should hold
+        */
+
+        for (lOperation = 0; lOperation < THOROUGH_TEST_NODES; lOperation++)
+        {
+            if (0 == gNodeCount || (THOROUGH_TEST_NODES > gNodeCount && 0 != rand() % 3))
+            {
+                gKey = RandomKey(0, SNAPSHOT_TEST_KEYS);
+                sprintf(gData, "Entry #%06lu", lOperation + 1);
+
+                InsertTreeNode(gTree, gData, &gKey);
+
+                FetchTreeNode(gTree, gData, &gKey, &gInstance);
+
+                gKeys[gNodeCount] = gKey;
+                gInstances[gNodeCount] = gInstance;
+
+                gNodeCount++;
+
+                gCounts[gKey]++;
+            }
+            else
+            {
+                lIndex = rand() % gNodeCount;
+
+                SelectTreeNode(gTree, &gKeys[lIndex], gInstances[lIndex]);
+
+                DeleteTreeNode(gTree);
+
+                gCounts[gKeys[lIndex]]--;
+
+                gNodeCount--;
+
+                gKeys[lIndex] = gKeys[gNodeCount];
+                gInstances[lIndex] = gInstances[gNodeCount];
+            }
+
+            if (0 == (lOperation + 1) % (THOROUGH_TEST_NODES / SNAPSHOT_TEST_VERSIONS))
+            {
+                lVersions[lVersionCount] = (motelTreeHandle) NULL;
+
+                if (!SnapshotTree(gTree, &lVersions[lVersionCount]))
+                {
+                    fprintf(gFile, "\nSnapshot %ld failed\n", lVersionCount + 1);
+
+                    OutputResult();
+
+                    return;
+                }
+
+                memcpy(gVersionCounts[lVersionCount], gCounts, sizeof(gVersionCounts[lVersionCount]));
+
+                lVersionCount++;
+
+                printf(".");
+            }
+        }
+
+        /*
+        ** every version holds what the tree held when it was taken
+        */
+
+        for (lVersion = 0; lVersion < lVersionCount; lVersion++)
+        {
+            sprintf(lName, "Version %ld", lVersion + 1);
+
+            if (!CheckTree(lVersions[lVersion], gVersionCounts[lVersion], SNAPSHOT_TEST_KEYS, lName))
+            {
+                return;
+            }
+        }
+
+        /*
+        ** a version updated on its own leaves the tree and the other versions be
+        */
+
+        gKey = RandomKey(0, SNAPSHOT_TEST_KEYS);
+        sprintf(gData, "Version #%06lu", lIteration);
+
+        InsertTreeNode(lVersions[0], gData, &gKey);
+
+        gVersionCounts[0][gKey]++;
+
+        if (!CheckTree(lVersions[0], gVersionCounts[0], SNAPSHOT_TEST_KEYS, "Updated version") ||
+            !CheckTree(gTree, gCounts, SNAPSHOT_TEST_KEYS, "Tree"))
+        {
+            return;
+        }
+
+        printf(">");
+
+        /*
+        ** release the versions in a random order, the tree staying whole throughout
+        */
+
+        while (0 < lVersionCount)
+        {
+            lVersion = rand() % lVersionCount;
+
+            DestructTree(&lVersions[lVersion]);
+
+            lVersionCount--;
+
+            lVersions[lVersion] = lVersions[lVersionCount];
+            memcpy(gVersionCounts[lVersion], gVersionCounts[lVersionCount], sizeof(gVersionCounts[lVersion]));
+
+            if (!CheckTree(gTree, gCounts, SNAPSHOT_TEST_KEYS, "Tree"))
+            {
+                return;
+            }
+        }
+
+        printf("<");
+
+        printf("\r");
+    }
+
+    Validate();
+
+    printf("\n\n");
+}
+
+void IteratedTest7
+(
+    void
+)
+{
+    unsigned long lIterations;
+    unsigned long lIteration;
+
+    unsigned long lOperation;
+    unsigned long lIndex;
+    unsigned long lCommit;
+    unsigned long lCheckpoint;
+
+    motelTreeHandle lRecovered;
+
+    long lCommittedLength;
+    long lTornLength;
+
+    Destruct();
+    Construct();
+
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
+
+    remove(LOG_TEST_PATH);
+    remove(CHECKPOINT_TEST_PATH);
+
+    memset(gCounts, 0, sizeof(gCounts));
+
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        printf("Iteration : %ld ", lIteration);
+
+        /*
+        ** log the tree, resuming the log of the tree recovered by the last iteration
+        */
+
+        lCommit = 1 + rand() % LOG_TEST_COMMIT;
+        lCheckpoint = THOROUGH_TEST_NODES / 4;
+
+        SetTreeMember(gTree, motelTreeMember_LogCommit, &lCommit);
+        SetTreeMember(gTree, motelTreeMember_LogCheckpoint, &lCheckpoint);
+
+        if (!LogTree(gTree, LOG_TEST_PATH, CHECKPOINT_TEST_PATH))
+        {
+            fprintf(gFile, "\nLogging could not be started\n");
+
+            OutputResult();
+
+            return;
+        }
+
+        for (lOperation = 0; lOperation < THOROUGH_TEST_NODES; lOperation++)
+        {
+            lIndex = (0 == gNodeCount) ? 0 : rand() % gNodeCount;
+
+            if (0 == gNodeCount || (THOROUGH_TEST_NODES > gNodeCount && 0 == rand() % 2))
+            {
+                gKey = RandomKey(0, SET_TEST_KEYS);
+                sprintf(gData, "Entry #%06lu", lOperation + 1);
+
+                InsertTreeNode(gTree, gData, &gKey);
+
+                FetchTreeNode(gTree, gData, &gKey, &gInstance);
+
+                gKeys[gNodeCount] = gKey;
+                gInstances[gNodeCount] = gInstance;
+
+                gNodeCount++;
+
+                gCounts[gKey]++;
+            }
+            else if (0 == rand() % 2)
+            {
+                SelectTreeNode(gTree, &gKeys[lIndex], gInstances[lIndex]);
+
+                sprintf(gData, "Update #%06lu", lOperation + 1);
+
+                UpdateTreeNode(gTree, gData);
+            }
+            else
+            {
+                SelectTreeNode(gTree, &gKeys[lIndex], gInstances[lIndex]);
+
+                DeleteTreeNode(gTree);
+
+                gCounts[gKeys[lIndex]]--;
+
+                gNodeCount--;
+
+                gKeys[lIndex] = gKeys[gNodeCount];
+                gInstances[lIndex] = gInstances[gNodeCount];
+            }
+        }
+
+        printf(">");
+
+        /*
+        ** commit the changes, then log one last insertion whose record the crash will tear
+        */
+
+        lCheckpoint = 0;
+
+        SetTreeMember(gTree, motelTreeMember_LogCheckpoint, &lCheckpoint);
+
+        if (!CommitTree(gTree))
+        {
+            fprintf(gFile, "\nThe log could not be committed\n");
+
+            OutputResult();
+
+            return;
+        }
+
+        lCommittedLength = FileLength(LOG_TEST_PATH);
+
+        gKey = RandomKey(0, SET_TEST_KEYS);
+        sprintf(gData, "Torn #%06lu", lIteration);
+
+        InsertTreeNode(gTree, gData, &gKey);
+        CommitTree(gTree);
+
+        lTornLength = lCommittedLength + (FileLength(LOG_TEST_PATH) - lCommittedLength) / 2;
+
+        /*
+        ** the tree is lost, but not the nodes noted by the test, which the recovered tree keeps
+        */
+
+        lRecovered = (motelTreeHandle) NULL;
+
+        if (!ConstructOtherTree(&lRecovered))
+        {
+            fprintf(gFile, "\nThe recovered tree could not be constructed\n");
+
+            return;
+        }
+
+        DestructTree(&gTree);
+
+        gTree = lRecovered;
+
+        if (!TearFile(LOG_TEST_PATH, lTornLength))
+        {
+            fprintf(gFile, "\nThe log could not be torn\n");
+
+            return;
+        }
+
+        printf(":");
+
+        /*
+        ** recover everything but the torn insertion
+        */
+
+        if (!RecoverTree(gTree, LOG_TEST_PATH, CHECKPOINT_TEST_PATH))
+        {
+            fprintf(gFile, "\nRecovery failed\n");
+
+            OutputResult();
+
+            return;
+        }
+
+        if (!CheckTree(gTree, gCounts, SET_TEST_KEYS, "Recovered tree"))
+        {
+            return;
+        }
+
+        printf("<");
+
+        printf("\r");
+    }
+
+    Validate();
+
+    LogTree(gTree, (const char *) NULL, (const char *) NULL);
+
+    remove(LOG_TEST_PATH);
+    remove(CHECKPOINT_TEST_PATH);
+
+    printf("\n\n");
+}
+
+void IteratedTest8
+(
+    void
+)
+{
+    motelTreeCursorHandle lCursors[CURSOR_TEST_CURSORS];
+
+    unsigned long lPositions[CURSOR_TEST_CURSORS];
+
+    boolean lPlaced[CURSOR_TEST_CURSORS];
+
+    unsigned long lIterations;
+    unsigned long lIteration;
+
+    unsigned long lNodeIndex;
+    unsigned long lPosition;
+    unsigned long lCursor;
+    unsigned long lOther;
+    unsigned long lDeleted;
+    unsigned long lInstance;
+
+    long lKey;
+
+    char lData[DATA_ELEMENT_SIZE];
+
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
+
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        printf("Iteration : %ld ", lIteration);
+
+        Destruct();
+        Construct();
+
+        /*
+        ** fill the tree with duplicated keys, tracking the nodes in key and instance order
+        */
+
+        for (lNodeIndex = 0; lNodeIndex < CURSOR_TEST_NODES; lNodeIndex++)
+        {
+            gKey = rand() % CURSOR_TEST_KEYS;
+            sprintf(gData, "Entry #%06lu", lNodeIndex + 1);
+
+            if (!InsertTreeNode(gTree, gData, &gKey) || !FetchTreeNode(gTree, gData, &gKey, &gInstance))
+            {
+                OutputResult();
+
+                return;
+            }
+
+            for (lPosition = gNodeCount; 0 < lPosition && (gKeys[lPosition - 1] > gKey || (gKeys[lPosition - 1] == gKey && gInstances[lPosition - 1] > gInstance)); lPosition--)
+            {
+                gKeys[lPosition] = gKeys[lPosition - 1];
+                gInstances[lPosition] = gInstances[lPosition - 1];
+            }
+
+            gKeys[lPosition] = gKey;
+            gInstances[lPosition] = gInstance;
+
+            gNodeCount++;
+        }
+
+        for (lCursor = 0; lCursor < CURSOR_TEST_CURSORS; lCursor++)
+        {
+            lCursors[lCursor] = (motelTreeCursorHandle) NULL;
+
+            if (!ConstructTreeCursor(&lCursors[lCursor], gTree))
+            {
+                OutputResult();
+
+                return;
+            }
+
+            lPlaced[lCursor] = FALSE;
+        }
+
+        while (0 < gNodeCount)
+        {
+            /*
+            ** step some of the cursors forward, each to the node after the one it held
+            ** or, when it held none, to the least node
+            */
+
+            for (lCursor = 0; lCursor < CURSOR_TEST_CURSORS; lCursor++)
+            {
+                if (0 == rand() % 2)
+                {
+                    continue;
+                }
+
+                lPosition = lPlaced[lCursor] ? lPositions[lCursor] + 1 : 0;
+
+                if (PeekGreaterTreeCursorNode(lCursors[lCursor], lData, &lKey, &lInstance))
+                {
+                    if (gNodeCount <= lPosition || gKeys[lPosition] != lKey || gInstances[lPosition] != lInstance)
+                    {
+                        fprintf(gFile, "\nCursor %ld stepped to (%ld:%03ld) out of order\n\n", lCursor, lKey, lInstance);
+
+                        return;
+                    }
+
+                    lPlaced[lCursor] = TRUE;
+                    lPositions[lCursor] = lPosition;
+                }
+                else
+                {
+                    if (gNodeCount > lPosition)
+                    {
+                        fprintf(gFile, "\nCursor %ld failed to step to (%ld:%03ld)\n\n", lCursor, gKeys[lPosition], gInstances[lPosition]);
+
+                        return;
+                    }
+
+                    lPlaced[lCursor] = FALSE;
+                }
+            }
+
+            /*
+            ** gather a cursor onto the node of another so that deletes meet several cursors on one node
+            */
+
+            lCursor = rand() % CURSOR_TEST_CURSORS;
+            lOther = rand() % CURSOR_TEST_CURSORS;
+
+            if (lPlaced[lOther])
+            {
+                if (!SelectTreeCursorNode(lCursors[lCursor], &gKeys[lPositions[lOther]], gInstances[lPositions[lOther]]))
+                {
+                    fprintf(gFile, "\nCursor %ld failed to select (%ld:%03ld)\n\n", lCursor, gKeys[lPositions[lOther]], gInstances[lPositions[lOther]]);
+
+                    return;
+                }
+
+                lPlaced[lCursor] = TRUE;
+                lPositions[lCursor] = lPositions[lOther];
+            }
+
+            /*
+            ** delete through a placed cursor, first placing one on the least node when none is placed
+            */
+
+            lCursor = rand() % CURSOR_TEST_CURSORS;
+
+            for (lOther = 0; lOther < CURSOR_TEST_CURSORS && !lPlaced[lCursor]; lOther++)
+            {
+                lCursor = (lCursor + 1) % CURSOR_TEST_CURSORS;
+            }
+
+            if (!lPlaced[lCursor])
+            {
+                if (!PeekGreaterTreeCursorNode(lCursors[lCursor], NULL, NULL, NULL))
+                {
+                    fprintf(gFile, "\nCursor %ld failed to step to the least node\n\n", lCursor);
+
+                    return;
+                }
+
+                lPlaced[lCursor] = TRUE;
+                lPositions[lCursor] = 0;
+            }
+
+            lDeleted = lPositions[lCursor];
+
+            gKey = gKeys[lDeleted];
+            gInstance = gInstances[lDeleted];
+
+            if (!DeleteTreeCursorNode(lCursors[lCursor]))
+            {
+                fprintf(gFile, "\nCursor %ld failed to delete (%ld:%03ld)\n\n", lCursor, gKey, gInstance);
+
+                return;
+            }
+
+            gNodeCount--;
+
+            memmove(&gKeys[lDeleted], &gKeys[lDeleted + 1], (gNodeCount - lDeleted) * sizeof(gKeys[0]));
+            memmove(&gInstances[lDeleted], &gInstances[lDeleted + 1], (gNodeCount - lDeleted) * sizeof(gInstances[0]));
+
+            /*
+            ** the cursors on the deleted node are unset while the rest still hold their nodes
+            */
+
+            for (lCursor = 0; lCursor < CURSOR_TEST_CURSORS; lCursor++)
+            {
+                if (lPlaced[lCursor] && lDeleted == lPositions[lCursor])
+                {
+                    lPlaced[lCursor] = FALSE;
+                }
+                else if (lPlaced[lCursor] && lDeleted < lPositions[lCursor])
+                {
+                    lPositions[lCursor]--;
+                }
+
+                if (FetchTreeCursorNode(lCursors[lCursor], lData, &lKey, &lInstance))
+                {
+                    if (!lPlaced[lCursor] || gKeys[lPositions[lCursor]] != lKey || gInstances[lPositions[lCursor]] != lInstance)
+                    {
+                        fprintf(gFile, "\nCursor %ld holds (%ld:%03ld) after the delete of (%ld:%03ld)\n\n", lCursor, lKey, lInstance, gKey, gInstance);
+
+                        return;
+                    }
+                }
+                else if (lPlaced[lCursor])
+                {
+                    fprintf(gFile, "\nCursor %ld lost (%ld:%03ld) after the delete of (%ld:%03ld)\n\n", lCursor, gKeys[lPositions[lCursor]], gInstances[lPositions[lCursor]], gKey, gInstance);
+
+                    return;
+                }
+            }
+
+            if (!ValidateTree(gTree))
+            {
+                fprintf(gFile, "\nDelete of (%ld:%03ld) failed validation\n", gKey, gInstance);
+
+                OutputResult();
+
+                return;
+            }
+
+            if (0 == (CURSOR_TEST_NODES - gNodeCount) % (CURSOR_TEST_NODES / 100))
+            {
+                switch (((CURSOR_TEST_NODES - gNodeCount) / (CURSOR_TEST_NODES / 100)) % 4L)
+                {
+                case 0:
+                    printf("-\b");
+                    break;
+                case 1:
+                    printf("\\\b");
+                    break;
+                case 2:
+                    printf("|\b");
+                    break;
+                case 3:
+                    printf("/\b");
+                    break;
+                }
+            }
+        }
+
+        for (lCursor = 0; lCursor < CURSOR_TEST_CURSORS; lCursor++)
+        {
+            DestructTreeCursor(&lCursors[lCursor]);
+        }
+
+        printf("\r");
+    }
+
+    Validate();
+
+    printf("\n\n");
+}
+
+void IteratedTest9
+(
+    void
+)
+{
+    concurrentTestThread lWriters[CONCURRENT_TEST_WRITERS];
+    concurrentTestThread lReaders[CONCURRENT_TEST_READERS];
+
+    unsigned long lIterations;
+    unsigned long lIteration;
+
+    unsigned long lIndex;
+    unsigned long lStarted;
+    unsigned long lJoined;
+
+    boolean lConcurrent;
+    boolean lFailed;
+
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
+
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        printf("Iteration : %ld ", lIteration);
+
+        Destruct();
+        Construct();
+
+        memset(gCounts, 0, CONCURRENT_TEST_KEYS * sizeof(unsigned long));
+
+        FillTree(gTree, gCounts, CONCURRENT_TEST_KEYS, 0, CONCURRENT_TEST_KEYS, CONCURRENT_TEST_KEYS * 2);
+
+        lConcurrent = TRUE;
+
+        if (!SetTreeMember(gTree, motelTreeMember_Concurrent, &lConcurrent))
+        {
+            OutputResult();
+
+            return;
+        }
+
+        /*
+        ** start the writers and the lock-free readers side by side
+        */
+
+        memset(lWriters, 0, sizeof(lWriters));
+        memset(lReaders, 0, sizeof(lReaders));
+
+        lStarted = 0;
+
+        for (lIndex = 0; lIndex < CONCURRENT_TEST_WRITERS + CONCURRENT_TEST_READERS; lIndex++)
+        {
+            if (lIndex < CONCURRENT_TEST_WRITERS)
+            {
+                lWriters[lIndex].seed = (unsigned long) rand();
+
+                if (!StartThread(&lWriters[lIndex].thread, ConcurrentWriter, (void *) &lWriters[lIndex]))
+                {
+                    break;
+                }
+            }
+            else
+            {
+                lReaders[lIndex - CONCURRENT_TEST_WRITERS].seed = (unsigned long) rand();
+
+                if (!StartThread(&lReaders[lIndex - CONCURRENT_TEST_WRITERS].thread, ConcurrentReader, (void *) &lReaders[lIndex - CONCURRENT_TEST_WRITERS]))
+                {
+                    break;
+                }
+            }
+
+            lStarted++;
+        }
+
+        lJoined = 0;
+
+        for (lIndex = 0; lIndex < lStarted; lIndex++)
+        {
+            if (lIndex < CONCURRENT_TEST_WRITERS ? JoinThread(lWriters[lIndex].thread) : JoinThread(lReaders[lIndex - CONCURRENT_TEST_WRITERS].thread))
+            {
+                lJoined++;
+            }
+        }
+
+        if (CONCURRENT_TEST_WRITERS + CONCURRENT_TEST_READERS > lJoined)
+        {
+            fprintf(gFile, "\nOnly %ld of %ld threads could be started and joined\n\n", lJoined, (unsigned long) (CONCURRENT_TEST_WRITERS + CONCURRENT_TEST_READERS));
+
+            return;
+        }
+
+        lFailed = FALSE;
+
+        for (lIndex = 0; lIndex < CONCURRENT_TEST_WRITERS; lIndex++)
+        {
+            if (lWriters[lIndex].failed)
+            {
+                fprintf(gFile, "\nWriter %ld: %s\n", lIndex, lWriters[lIndex].failure);
+
+                lFailed = TRUE;
+            }
+        }
+
+        for (lIndex = 0; lIndex < CONCURRENT_TEST_READERS; lIndex++)
+        {
+            if (lReaders[lIndex].failed)
+            {
+                fprintf(gFile, "\nReader %ld: %s\n", lIndex, lReaders[lIndex].failure);
+
+                lFailed = TRUE;
+            }
+        }
+
+        if (lFailed)
+        {
+            return;
+        }
+
+        /*
+        ** once the threads are done, the tree holds exactly the instances the writers counted
+        */
+
+        lConcurrent = FALSE;
+
+        if (!SetTreeMember(gTree, motelTreeMember_Concurrent, &lConcurrent))
+        {
+            OutputResult();
+
+            return;
+        }
+
+        if (!CheckTree(gTree, gCounts, CONCURRENT_TEST_KEYS, "Concurrent tree"))
+        {
+            return;
+        }
+
+        for (gNodeCount = 0, lIndex = 0; lIndex < CONCURRENT_TEST_KEYS; lIndex++)
+        {
+            gNodeCount += gCounts[lIndex];
+        }
+
+        printf("\r");
+    }
+
+    Validate();
+
+    printf("\n\n");
+}
+
+motelThreadResult THREAD_CALLING_CONVENTION ConcurrentWriter
+(
+    void * pArgument
+)
+{
+    concurrentTestThread * lWriter = (concurrentTestThread *) pArgument;
+
+    motelResult lResultCode;
+
+    unsigned long lOperation;
+    unsigned long lChoice;
+
+    long lKey;
+
+    char lData[DATA_ELEMENT_SIZE];
+
+    for (lOperation = 0; lOperation < CONCURRENT_TEST_WRITES; lOperation++)
+    {
+        lKey = (long) (NextRandom(&lWriter->seed) % CONCURRENT_TEST_KEYS);
+        lChoice = NextRandom(&lWriter->seed) % 4;
+
+        sprintf(lData, "Key #%06ld %06lu:%06lu", lKey, lOperation, lOperation);
+
+        if (!LockTree(gTree))
+        {
+            sprintf(lWriter->failure, "the tree could not be locked");
+
+            lWriter->failed = TRUE;
+
+            break;
+        }
+
+        /*
+        ** insert an instance of the key half of the time, otherwise update or delete its least instance,
+        ** counting the instances while the lock is held
+        */
+
+        if (2 > lChoice)
+        {
+            lWriter->failed = !InsertTreeNode(gTree, lData, &lKey);
+
+            if (!lWriter->failed)
+            {
+                gCounts[lKey]++;
+            }
+        }
+        else if (0 < gCounts[lKey])
+        {
+            lWriter->failed = !SelectTreeNode(gTree, &lKey, 0) || !((2 == lChoice) ? UpdateTreeNode(gTree, lData) : DeleteTreeNode(gTree));
+
+            if (!lWriter->failed && 3 == lChoice)
+            {
+                gCounts[lKey]--;
+            }
+        }
+
+        if (lWriter->failed)
+        {
+            GetTreeMember(gTree, motelTreeMember_Result, (void **) &lResultCode);
+
+            sprintf(lWriter->failure, "%s of key %ld failed, Result Code: %ld", (2 > lChoice) ? "Insert" : (2 == lChoice) ? "Update" : "Delete", lKey, (long) lResultCode);
+        }
+
+        if (!UnlockTree(gTree) && !lWriter->failed)
+        {
+            sprintf(lWriter->failure, "the tree could not be unlocked");
+
+            lWriter->failed = TRUE;
+        }
+
+        if (lWriter->failed)
+        {
+            break;
+        }
+    }
+
+    return ((motelThreadResult) 0);
+}
+
+motelThreadResult THREAD_CALLING_CONVENTION ConcurrentReader
+(
+    void * pArgument
+)
+{
+    concurrentTestThread * lReader = (concurrentTestThread *) pArgument;
+
+    unsigned long lOperation;
+    unsigned long lInstance;
+
+    long lKey;
+
+    char lData[DATA_ELEMENT_SIZE];
+
+    for (lOperation = 0; lOperation < CONCURRENT_TEST_READS && !lReader->failed; lOperation++)
+    {
+        lKey = (long) (NextRandom(&lReader->seed) % CONCURRENT_TEST_KEYS);
+
+        /*
+        ** now and then scan a range of keys, checking their order and data along the way
+        */
+
+        if (0 == lOperation % CONCURRENT_TEST_SCAN_INTERVAL)
+        {
+            lReader->least = lKey;
+            lReader->greatest = lKey + (long) (NextRandom(&lReader->seed) % CONCURRENT_TEST_SCAN_KEYS);
+
+            lReader->previousKey = -1;
+            lReader->previousInstance = 0;
+
+            ScanTreeRange(gTree, &lReader->least, &lReader->greatest, CheckConcurrentNode, (void *) lReader);
+
+            continue;
+        }
+
+        /*
+        ** read the least instance or one of the first few of a key, checking that the data is the key's
+        */
+
+        lInstance = NextRandom(&lReader->seed) % 4;
+
+        if (ReadTreeNode(gTree, &lKey, lInstance, lData) && !IsKeyData(lKey, lData))
+        {
+            sprintf(lReader->failure, "read of (%ld:%03ld) returned \"%.*s\"", lKey, lInstance, DATA_ELEMENT_SIZE - 1, lData);
+
+            lReader->failed = TRUE;
+        }
+    }
+
+    return ((motelThreadResult) 0);
+}
+
+boolean CheckConcurrentNode
+(
+    void * pContext,
+    const void * pKey,
+    const void * pData,
+    unsigned long pInstance
+)
+{
+    concurrentTestThread * lReader = (concurrentTestThread *) pContext;
+
+    long lKey = * (const long *) pKey;
+
+    if (lKey < lReader->least || lKey > lReader->greatest ||
+        lKey < lReader->previousKey || (lKey == lReader->previousKey && pInstance <= lReader->previousInstance))
+    {
+        sprintf(lReader->failure, "scan of %ld to %ld visited (%ld:%03ld) after (%ld:%03ld)", lReader->least, lReader->greatest, lKey, pInstance, lReader->previousKey, lReader->previousInstance);
+
+        lReader->failed = TRUE;
+
+        return (FALSE);
+    }
+
+    if (!IsKeyData(lKey, (const char *) pData))
+    {
+        sprintf(lReader->failure, "scan visited (%ld:%03ld) holding \"%.*s\"", lKey, pInstance, DATA_ELEMENT_SIZE - 1, (const char *) pData);
+
+        lReader->failed = TRUE;
+
+        return (FALSE);
+    }
+
+    lReader->previousKey = lKey;
+    lReader->previousInstance = pInstance;
+
+    return (TRUE);
+}
+
+boolean IsKeyData
+(
+    long pKey,
+    const char * pData
+)
+{
+    char lPrefix[DATA_ELEMENT_SIZE];
+
+    size_t lLength;
+
+    unsigned long lFirst;
+    unsigned long lSecond;
+
+    /*
+    ** the data of every node begins with its key, as written by FillTree(), and a writer
+    ** follows it with its operation number twice so that a torn copy shows
+    */
+
+    sprintf(lPrefix, "Key #%06ld", pKey);
+
+    lLength = strlen(lPrefix);
+
+    if (0 != strncmp(pData, lPrefix, lLength))
+    {
+        return (FALSE);
+    }
+
+    if ('\0' == pData[lLength])
+    {
+        return (TRUE);
+    }
+
+    return (2 == sscanf(pData + lLength, " %lu:%lu", &lFirst, &lSecond) && lFirst == lSecond);
+}
+
+unsigned long NextRandom
+(
+    unsigned long * pSeed
+)
+{
+    /*
+    ** a private generator, as rand() may not be shared between threads
+    */
+
+    * pSeed = * pSeed * 1103515245UL + 12345UL;
+
+    return ((* pSeed >> 16) & 0x7FFFUL);
+}
+
+void IteratedTest10
+(
+    void
+)
+{
+    motelTreeHandle lReference;
+    motelTreeHandle lCapped;
+
+    motelTreeKeyType lKeyType;
+
+    motelResult lResultCode;
+
+    unsigned long lIterations;
+    unsigned long lIteration;
+
+    unsigned long lBatch;
+    unsigned long lCount;
+    unsigned long lIndex;
+    unsigned long lNodes;
+    unsigned long lInstance;
+
+    size_t lEmptySize;
+    size_t lSize;
+    size_t lNodeSize;
+
+    long lLeast;
+    long lLimit;
+
+    boolean lParentless;
+
+    char lData[DATA_ELEMENT_SIZE];
+
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
+
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        printf("Iteration : %ld ", lIteration);
+
+        Destruct();
+        Construct();
+
+        /*
+        ** the reference tree is given each batch one node at a time
+        */
+
+        lReference = (motelTreeHandle) NULL;
+
+        if (!ConstructOtherTree(&lReference))
+        {
+            fprintf(gFile, "\nThe reference tree could not be constructed\n\n");
+
+            return;
+        }
+
+        GetTreeMember(lReference, motelTreeMember_Size, &lEmptySize);
+
+        for (lBatch = 0; lBatch < BATCH_TEST_BATCHES; lBatch++)
+        {
+            /*
+            ** alternate between batches scattered over the key range and batches crowded into a
+            ** few key values, which outweigh the subtrees they land in and have them rebuilt
+            */
+
+            lCount = 1 + rand() % BATCH_TEST_NODES;
+
+            lLeast = (0 == lBatch % 2) ? 0 : RandomKey(0, BATCH_TEST_KEYS - BATCH_TEST_CROWD);
+            lLimit = (0 == lBatch % 2) ? BATCH_TEST_KEYS : lLeast + 1 + rand() % BATCH_TEST_CROWD;
+
+            GenerateBatch(lBatch, lCount, lLeast, lLimit);
+
+            if (!InsertTreeNodes(gTree, gBatchData, gBatchKeys, lCount))
+            {
+                fprintf(gFile, "\nBatch %ld of %ld nodes failed\n", lBatch, lCount);
+
+                OutputResult();
+
+                DestructTree(&lReference);
+
+                return;
+            }
+
+            for (lIndex = 0; lIndex < lCount; lIndex++)
+            {
+                InsertTreeNode(lReference, gBatchData[lIndex], &gBatchKeys[lIndex]);
+            }
+
+            /*
+            ** delete a few instances from both trees so that later batches number theirs after gaps
+            */
+
+            for (lIndex = 0; lIndex < lCount / 8; lIndex++)
+            {
+                gKey = RandomKey(0, BATCH_TEST_KEYS);
+
+                if (SelectTreeNode(lReference, &gKey, 0) && FetchTreeNode(lReference, NULL, NULL, &gInstance))
+                {
+                    DeleteTreeNode(lReference);
+
+                    if (!SelectTreeNode(gTree, &gKey, gInstance) || !DeleteTreeNode(gTree))
+                    {
+                        fprintf(gFile, "\nBatch %ld lacks (%ld:%03ld)\n\n", lBatch, gKey, gInstance);
+
+                        DestructTree(&lReference);
+
+                        return;
+                    }
+                }
+            }
+
+            if (!CompareTrees(gTree, lReference, "Batched tree") || !CheckSelectedNodes(gTree, 0 == lBatch % 2))
+            {
+                DestructTree(&lReference);
+
+                return;
+            }
+        }
+
+        /*
+        ** a batch that outgrows a tree's maximum size fails part way through constructing
+        ** its nodes, and must leave the tree as it was
+        */
+
+        GetTreeMember(lReference, motelTreeMember_Size, &lSize);
+        GetTreeMember(lReference, motelTreeMember_Nodes, &lNodes);
+
+        lNodeSize = (lSize - lEmptySize) / lNodes;
+
+        gNodeCount = lNodes;
+
+        DestructTree(&lReference);
+
+        lCapped = (motelTreeHandle) NULL;
+
+        if (!ConstructTree(&lCapped, lEmptySize + lNodeSize * (BATCH_TEST_NODES + BATCH_TEST_NODES / 2), (size_t) DATA_ELEMENT_SIZE, sizeof(gKey), _compare))
+        {
+            fprintf(gFile, "\nThe capped tree could not be constructed\n\n");
+
+            return;
+        }
+
+        GetTreeMember(gTree, motelTreeMember_KeyType, &lKeyType);
+        SetTreeMember(lCapped, motelTreeMember_KeyType, &lKeyType);
+
+        GetTreeMember(gTree, motelTreeMember_Parentless, &lParentless);
+        SetTreeMember(lCapped, motelTreeMember_Parentless, &lParentless);
+
+        GenerateBatch(lBatch, BATCH_TEST_NODES, 0, BATCH_TEST_KEYS);
+
+        InsertTreeNodes(lCapped, gBatchData, gBatchKeys, BATCH_TEST_NODES);
+
+        GetTreeMember(lCapped, motelTreeMember_Size, &lSize);
+
+        lCount = 0;
+
+        if (PeekLeastTreeNode(lCapped, lData, &gKeys[lCount], &gInstances[lCount]))
+        {
+            do
+            {
+                lCount++;
+            }
+            while (PeekGreaterTreeNode(lCapped, lData, &gKeys[lCount], &gInstances[lCount]));
+        }
+
+        GenerateBatch(lBatch + 1, BATCH_TEST_NODES, 0, BATCH_TEST_KEYS);
+
+        if (InsertTreeNodes(lCapped, gBatchData, gBatchKeys, BATCH_TEST_NODES))
+        {
+            fprintf(gFile, "\nA batch beyond the maximum size of a tree of %ld nodes succeeded\n\n", lCount);
+
+            DestructTree(&lCapped);
+
+            return;
+        }
+
+        GetTreeMember(lCapped, motelTreeMember_Result, (void **) &lResultCode);
+        GetTreeMember(lCapped, motelTreeMember_Nodes, &lNodes);
+
+        if (motelResult_MaximumSize != lResultCode || BATCH_TEST_NODES != lCount || lCount != lNodes || !ValidateTree(lCapped))
+        {
+            fprintf(gFile, "\nA failed batch left %ld of %ld nodes, Result Code: %ld\n\n", lNodes, lCount, (long) lResultCode);
+
+            DestructTree(&lCapped);
+
+            return;
+        }
+
+        GetTreeMember(lCapped, motelTreeMember_Size, &lNodeSize);
+
+        lIndex = 0;
+
+        if (PeekLeastTreeNode(lCapped, lData, &gKey, &lInstance))
+        {
+            do
+            {
+                if (lSize != lNodeSize || lCount <= lIndex || gKeys[lIndex] != gKey || gInstances[lIndex] != lInstance)
+                {
+                    fprintf(gFile, "\nA failed batch left (%ld:%03ld) in place of (%ld:%03ld)\n\n", gKey, lInstance, gKeys[lIndex], gInstances[lIndex]);
+
+                    DestructTree(&lCapped);
+
+                    return;
+                }
+
+                lIndex++;
+            }
+            while (PeekGreaterTreeNode(lCapped, lData, &gKey, &lInstance));
+        }
+
+        DestructTree(&lCapped);
+
+        printf("\r");
+    }
+
+    Validate();
+
+    printf("\n\n");
+}
+
+void GenerateBatch
+(
+    unsigned long pBatch,
+    unsigned long pCount,
+    long pLeast,
+    long pLimit
+)
+{
+    unsigned long lIndex;
+
+    for (lIndex = 0; lIndex < pCount; lIndex++)
+    {
+        gBatchKeys[lIndex] = RandomKey(pLeast, pLimit);
+
+        sprintf(gBatchData[lIndex], "Key #%06ld %06lu:%06lu", gBatchKeys[lIndex], pBatch, lIndex);
+    }
+}
+
+boolean CompareTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther,
+    const char * pName
+)
+{
+    unsigned long lInstance;
+    unsigned long lOtherInstance;
+
+    long lKey;
+    long lOtherKey;
+
+    boolean lPeeked;
+    boolean lOtherPeeked;
+
+    char lData[DATA_ELEMENT_SIZE];
+    char lOtherData[DATA_ELEMENT_SIZE];
+
+    if (!ValidateTree(pTree) || !ValidateTree(pOther))
+    {
+        fprintf(gFile, "\n%s or its reference failed validation\n\n", pName);
+
+        return (FALSE);
+    }
+
+    /*
+    ** the trees hold the same keys, instances and data in the same order
+    */
+
+    lPeeked = PeekLeastTreeNode(pTree, lData, &lKey, &lInstance);
+    lOtherPeeked = PeekLeastTreeNode(pOther, lOtherData, &lOtherKey, &lOtherInstance);
+
+    while (lPeeked || lOtherPeeked)
+    {
+        if (lPeeked != lOtherPeeked || lKey != lOtherKey || lInstance != lOtherInstance || 0 != strcmp(lData, lOtherData))
+        {
+            fprintf(gFile, "\n%s holds (%ld:%03ld) \"%s\" where its reference holds (%ld:%03ld) \"%s\"\n\n",
+                    pName, lPeeked ? lKey : -1L, lPeeked ? lInstance : 0UL, lPeeked ? lData : "",
+                    lOtherPeeked ? lOtherKey : -1L, lOtherPeeked ? lOtherInstance : 0UL, lOtherPeeked ? lOtherData : "");
+
+            return (FALSE);
+        }
+
+        lPeeked = PeekGreaterTreeNode(pTree, lData, &lKey, &lInstance);
+        lOtherPeeked = PeekGreaterTreeNode(pOther, lOtherData, &lOtherKey, &lOtherInstance);
+    }
+
+    return (TRUE);
+}
+
+boolean CheckSelectedNodes
+(
+    motelTreeHandle pTree,
+    boolean pInstances
+)
+{
+    unsigned long lCount;
+    unsigned long lIndex;
+
+    boolean lSelected;
+    boolean lAllSelected = TRUE;
+    boolean lFound;
+
+    char lData[DATA_ELEMENT_SIZE];
+
+    /*
+    ** look up keys and instances that may or may not be present, in one batch and then one by one
+    */
+
+    lCount = 1 + rand() % BATCH_TEST_NODES;
+
+    for (lIndex = 0; lIndex < lCount; lIndex++)
+    {
+        gBatchKeys[lIndex] = RandomKey(0, BATCH_TEST_KEYS + BATCH_TEST_KEYS / 8);
+        gBatchInstances[lIndex] = (0 == rand() % 3) ? 0 : 1 + rand() % 8;
+
+        sprintf(gSelectedData[lIndex], "Unselected");
+    }
+
+    lSelected = SelectTreeNodes(pTree, gBatchKeys, pInstances ? gBatchInstances : (unsigned long *) NULL, lCount, gSelectedData, gBatchFound);
+
+    for (lIndex = 0; lIndex < lCount; lIndex++)
+    {
+        lFound = SelectTreeNode(pTree, &gBatchKeys[lIndex], pInstances ? gBatchInstances[lIndex] : 0) && FetchTreeNode(pTree, lData, NULL, NULL);
+
+        if (lFound != gBatchFound[lIndex] || 0 != strcmp(lFound ? lData : "Unselected", gSelectedData[lIndex]))
+        {
+            fprintf(gFile, "\nSelectTreeNodes() found \"%s\" for (%ld:%03ld) where SelectTreeNode() found \"%s\"\n\n",
+                    gBatchFound[lIndex] ? gSelectedData[lIndex] : "nothing", gBatchKeys[lIndex], pInstances ? gBatchInstances[lIndex] : 0UL, lFound ? lData : "nothing");
+
+            return (FALSE);
+        }
+
+        lAllSelected = lAllSelected && lFound;
+    }
+
+    if (lSelected != lAllSelected)
+    {
+        fprintf(gFile, "\nSelectTreeNodes() reported %s of %ld nodes found\n\n", lSelected ? "all" : "not all", lCount);
+
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+void IteratedTest11
+(
+    void
+)
+{
+    motelTreeSnapshotHandle lFrozen;
+    motelTreeSnapshotHandle lMapped;
+
+    unsigned long lIterations;
+    unsigned long lIteration;
+
+    unsigned long lIndex;
+
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
+
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        printf("Iteration : %ld ", lIteration);
+
+        Destruct();
+        Construct();
+
+        /*
+        ** fill the tree with duplicated keys, then delete some instances to leave gaps in their numbering
+        */
+
+        memset(gCounts, 0, FROZEN_TEST_KEYS * sizeof(unsigned long));
+
+        FillTree(gTree, gCounts, FROZEN_TEST_KEYS, 0, FROZEN_TEST_KEYS, FROZEN_TEST_NODES);
+
+        for (lIndex = 0; lIndex < FROZEN_TEST_NODES / 8; lIndex++)
+        {
+            gKey = RandomKey(0, FROZEN_TEST_KEYS);
+
+            if (SelectTreeNode(gTree, &gKey, 0))
+            {
+                DeleteTreeNode(gTree);
+            }
+        }
+
+        GetTreeMember(gTree, motelTreeMember_Nodes, &gNodeCount);
+
+        lFrozen = (motelTreeSnapshotHandle) NULL;
+
+        if (!FreezeTree(gTree, &lFrozen))
+        {
+            OutputResult();
+
+            return;
+        }
+
+        if (!CheckSnapshot(lFrozen, "Frozen snapshot"))
+        {
+            DestructTreeSnapshot(&lFrozen);
+
+            return;
+        }
+
+        DestructTreeSnapshot(&lFrozen);
+
+        /*
+        ** save the tree and check the mapped file against it the same way
+        */
+
+        lMapped = (motelTreeSnapshotHandle) NULL;
+
+        if (!SaveTree(gTree, FROZEN_TEST_PATH) || !MapTree(&lMapped, FROZEN_TEST_PATH, _compare))
+        {
+            OutputResult();
+
+            remove(FROZEN_TEST_PATH);
+
+            return;
+        }
+
+        if (!CheckSnapshot(lMapped, "Mapped snapshot"))
+        {
+            DestructTreeSnapshot(&lMapped);
+
+            remove(FROZEN_TEST_PATH);
+
+            return;
+        }
+
+        DestructTreeSnapshot(&lMapped);
+
+        remove(FROZEN_TEST_PATH);
+
+        printf("\r");
+    }
+
+    Validate();
+
+    printf("\n\n");
+}
+
+boolean CheckSnapshot
+(
+    motelTreeSnapshotHandle pSnapshot,
+    const char * pName
+)
+{
+    unsigned long lNodes;
+    unsigned long lRank;
+    unsigned long lTreeRank;
+    unsigned long lSnapshotRank;
+    unsigned long lInstance;
+    unsigned long lSnapshotInstance;
+    unsigned long lProbe;
+    unsigned long lScanned;
+    unsigned long lSnapshotScanned;
+    unsigned long lIndex;
+
+    long lKey;
+    long lSnapshotKey;
+    long lLeast;
+    long lGreatest;
+
+    boolean lFound;
+
+    char lData[DATA_ELEMENT_SIZE];
+    char lSnapshotData[DATA_ELEMENT_SIZE];
+
+    GetTreeMember(gTree, motelTreeMember_Nodes, &lNodes);
+
+    /*
+    ** every node of the tree is found at its rank, and its rank and data from its key and instance
+    */
+
+    for (lRank = 1; lRank <= lNodes; lRank++)
+    {
+        if (!SelectTreeNodeByRank(gTree, lRank) || !FetchTreeNode(gTree, lData, &lKey, &lInstance))
+        {
+            fprintf(gFile, "\nThe tree of %ld nodes holds nothing at rank %ld\n\n", lNodes, lRank);
+
+            return (FALSE);
+        }
+
+        if (!ReadTreeSnapshotNodeByRank(pSnapshot, lRank, &lSnapshotKey, lSnapshotData, &lSnapshotInstance) ||
+            lKey != lSnapshotKey || lInstance != lSnapshotInstance || 0 != strcmp(lData, lSnapshotData))
+        {
+            fprintf(gFile, "\n%s differs from the tree's (%ld:%03ld) at rank %ld\n\n", pName, lKey, lInstance, lRank);
+
+            return (FALSE);
+        }
+
+        if (!GetTreeSnapshotNodeRank(pSnapshot, &lKey, lInstance, &lSnapshotRank) || lRank != lSnapshotRank ||
+            !ReadTreeSnapshotNode(pSnapshot, &lKey, lInstance, lSnapshotData) || 0 != strcmp(lData, lSnapshotData))
+        {
+            fprintf(gFile, "\n%s does not find (%ld:%03ld) at rank %ld\n\n", pName, lKey, lInstance, lRank);
+
+            return (FALSE);
+        }
+
+        if (!SelectTreeNode(gTree, &lKey, lInstance) || !GetTreeNodeRank(gTree, &lTreeRank) || lRank != lTreeRank)
+        {
+            fprintf(gFile, "\nThe tree does not find (%ld:%03ld) at rank %ld\n\n", lKey, lInstance, lRank);
+
+            return (FALSE);
+        }
+    }
+
+    if (ReadTreeSnapshotNodeByRank(pSnapshot, lNodes + 1, NULL, NULL, NULL))
+    {
+        fprintf(gFile, "\n%s holds more than the tree's %ld nodes\n\n", pName, lNodes);
+
+        return (FALSE);
+    }
+
+    /*
+    ** the least instance of a key, or its absence, is seen alike by the tree and the snapshot,
+    ** and neither holds an instance beyond the number of nodes ever inserted
+    */
+
+    for (lProbe = 0; lProbe < FROZEN_TEST_PROBES; lProbe++)
+    {
+        lKey = RandomKey(0, FROZEN_TEST_KEYS + FROZEN_TEST_KEYS / 8);
+
+        lFound = SelectTreeNodeLowerBound(gTree, &lKey) && FetchTreeNode(gTree, lData, &gKey, &lInstance) && lKey == gKey && GetTreeNodeRank(gTree, &lTreeRank);
+
+        if (lFound != ReadTreeSnapshotNode(pSnapshot, &lKey, 0, lSnapshotData) ||
+            lFound != GetTreeSnapshotNodeRank(pSnapshot, &lKey, 0, &lSnapshotRank) ||
+            (lFound && (0 != strcmp(lData, lSnapshotData) || lTreeRank != lSnapshotRank)) ||
+            ReadTreeSnapshotNode(pSnapshot, &lKey, FROZEN_TEST_NODES + 1, NULL))
+        {
+            fprintf(gFile, "\n%s and the tree disagree on the least instance of key %ld\n\n", pName, lKey);
+
+            return (FALSE);
+        }
+    }
+
+    /*
+    ** scans of a range visit the same nodes, the first scan covering every node
+    */
+
+    for (lProbe = 0; lProbe < FROZEN_TEST_SCANS; lProbe++)
+    {
+        lLeast = RandomKey(0, FROZEN_TEST_KEYS);
+        lGreatest = lLeast + RandomKey(0, FROZEN_TEST_SCAN_KEYS);
+
+        lScanned = 0;
+
+        ScanTreeRange(gTree, (0 == lProbe) ? NULL : &lLeast, (0 == lProbe) ? NULL : &lGreatest, RecordScannedNode, (void *) &lScanned);
+
+        lSnapshotScanned = lScanned;
+
+        ScanTreeSnapshotRange(pSnapshot, (0 == lProbe) ? NULL : &lLeast, (0 == lProbe) ? NULL : &lGreatest, RecordScannedNode, (void *) &lSnapshotScanned);
+
+        for (lIndex = 0; lIndex < lScanned && 2 * lScanned == lSnapshotScanned; lIndex++)
+        {
+            if (gKeys[lIndex] != gKeys[lScanned + lIndex] || gInstances[lIndex] != gInstances[lScanned + lIndex])
+            {
+                break;
+            }
+        }
+
+        if (lIndex < lScanned || 2 * lScanned != lSnapshotScanned || (0 == lProbe && lNodes != lScanned))
+        {
+            fprintf(gFile, "\n%s scans %ld nodes from %ld to %ld where the tree scans %ld\n\n", pName, lSnapshotScanned - lScanned, lLeast, lGreatest, lScanned);
+
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
+boolean RecordScannedNode
+(
+    void * pContext,
+    const void * pKey,
+    const void * pData,
+    unsigned long pInstance
+)
+{
+    unsigned long lIndex = (* (unsigned long *) pContext)++;
+
+    gKeys[lIndex] = * (const long *) pKey;
+    gInstances[lIndex] = pInstance;
+
+    return (IsKeyData(gKeys[lIndex], (const char *) pData));
+}
+
+void IteratedTest12
+(
+    void
+)
+{
+    motelTreeHandle lReference;
+    motelTreeHandle lOther;
+
+    unsigned long lIterations;
+    unsigned long lIteration;
+
+    unsigned long lCount;
+    unsigned long lIndex;
+    unsigned long lRank;
+    unsigned long lTreeRank;
+    unsigned long lReferenceRank;
+
+    long lKey;
+
+    boolean lGrouped = TRUE;
+
+    char lData[DATA_ELEMENT_SIZE];
+
+    printf("\n");
+    printf("Iterations: ");
+    scanf("%ld", &lIterations);
+
+    for (lIteration = 1; lIteration <= lIterations; lIteration++)
+    {
+        printf("Iteration : %ld ", lIteration);
+
+        Destruct();
+        Construct();
+
+        /*
+        ** sorted keys that repeat about as often as they advance, and now and then none at all
+        */
+
+        lCount = (unsigned long) rand() % (BATCH_TEST_NODES + 1);
+
+        lKey = RandomKey(0, BULK_TEST_STEP);
+
+        for (lIndex = 0; lIndex < lCount; lIndex++)
+        {
+            lKey += (0 == lIndex) ? 0 : RandomKey(0, BULK_TEST_STEP);
+
+            gBatchKeys[lIndex] = lKey;
+
+            sprintf(gBatchData[lIndex], "Key #%06ld bulk:%06lu", lKey, lIndex);
+        }
+
+        /*
+        ** an array with one pair of keys out of order fails wherever the pair falls, and leaves
+        ** none of the nodes built before it in the tree
+        */
+
+        if (1 < lCount && gBatchKeys[0] != gBatchKeys[lCount - 1])
+        {
+            lIndex = (unsigned long) rand() % (lCount - 1);
+
+            while (gBatchKeys[lIndex] == gBatchKeys[lIndex + 1])
+            {
+                lIndex = (lIndex + 1) % (lCount - 1);
+            }
+
+            lKey = gBatchKeys[lIndex];
+            gBatchKeys[lIndex] = gBatchKeys[lIndex + 1];
+            gBatchKeys[lIndex + 1] = lKey;
+
+            if (!CheckRejectedLoad(gTree, lCount, motelResult_InvalidValue, "Out of order load"))
+            {
+                return;
+            }
+
+            gBatchKeys[lIndex + 1] = gBatchKeys[lIndex];
+            gBatchKeys[lIndex] = lKey;
+        }
+
+        if (!BulkLoadTree(gTree, gBatchData, gBatchKeys, lCount))
+        {
+            fprintf(gFile, "\nLoading %ld nodes failed\n", lCount);
+
+            OutputResult();
+
+            return;
+        }
+
+        /*
+        ** the reference tree is given the same keys one node at a time
+        */
+
+        lReference = (motelTreeHandle) NULL;
+
+        if (!ConstructOtherTree(&lReference))
+        {
+            fprintf(gFile, "\nThe reference tree could not be constructed\n\n");
+
+            return;
+        }
+
+        for (lIndex = 0; lIndex < lCount; lIndex++)
+        {
+            InsertTreeNode(lReference, gBatchData[lIndex], &gBatchKeys[lIndex]);
+        }
+
+        if (!CompareTrees(gTree, lReference, "Loaded tree"))
+        {
+            DestructTree(&lReference);
+
+            return;
+        }
+
+        /*
+        ** the node of each rank is the array element of the same index, and both trees rank it there
+        */
+
+        for (lRank = 1; lRank <= lCount; lRank++)
+        {
+            if (!SelectTreeNodeByRank(gTree, lRank) || !FetchTreeNode(gTree, lData, &gKey, &gInstance) ||
+                gBatchKeys[lRank - 1] != gKey || 0 != strcmp(gBatchData[lRank - 1], lData) ||
+                !SelectTreeNode(gTree, &gKey, gInstance) || !GetTreeNodeRank(gTree, &lTreeRank) ||
+                !SelectTreeNode(lReference, &gKey, gInstance) || !GetTreeNodeRank(lReference, &lReferenceRank) ||
+                lRank != lTreeRank || lRank != lReferenceRank)
+            {
+                fprintf(gFile, "\nThe loaded tree's node of rank %ld is not \"%s\"\n\n", lRank, gBatchData[lRank - 1]);
+
+                DestructTree(&lReference);
+
+                return;
+            }
+        }
+
+        /*
+        ** later insertions of the loaded keys number their instances after the loaded ones
+        */
+
+        for (lIndex = 0; lIndex < lCount / 8; lIndex++)
+        {
+            gKey = gBatchKeys[(unsigned long) rand() % lCount];
+
+            sprintf(gData, "Key #%06ld later:%06lu", gKey, lIndex);
+
+            InsertTreeNode(gTree, gData, &gKey);
+            InsertTreeNode(lReference, gData, &gKey);
+        }
+
+        if (!CompareTrees(gTree, lReference, "Loaded and inserted tree"))
+        {
+            DestructTree(&lReference);
+
+            return;
+        }
+
+        GetTreeMember(gTree, motelTreeMember_Nodes, &gNodeCount);
+
+        DestructTree(&lReference);
+
+        /*
+        ** a tree that groups duplicates, or one that is logged, refuses to be loaded
+        */
+
+        lOther = (motelTreeHandle) NULL;
+
+        if (!ConstructOtherTree(&lOther) || !SetTreeMember(lOther, motelTreeMember_GroupDuplicates, &lGrouped))
+        {
+            fprintf(gFile, "\nThe grouped tree could not be constructed\n\n");
+
+            DestructTree(&lOther);
+
+            return;
+        }
+
+        if (!CheckRejectedLoad(lOther, lCount, motelResult_Incompatible, "Grouped load"))
+        {
+            DestructTree(&lOther);
+
+            return;
+        }
+
+        DestructTree(&lOther);
+
+        if (!ConstructOtherTree(&lOther) || !LogTree(lOther, BULK_TEST_LOG_PATH, BULK_TEST_CHECKPOINT_PATH))
+        {
+            fprintf(gFile, "\nThe logged tree could not be constructed\n\n");
+
+            DestructTree(&lOther);
+
+            return;
+        }
+
+        lIndex = CheckRejectedLoad(lOther, lCount, motelResult_Incompatible, "Logged load");
+
+        LogTree(lOther, (const char *) NULL, (const char *) NULL);
+
+        DestructTree(&lOther);
+
+        remove(BULK_TEST_LOG_PATH);
+        remove(BULK_TEST_CHECKPOINT_PATH);
+
+        if (!lIndex)
+        {
+            return;
+        }
+
+        printf("\r");
+    }
+
+    Validate();
+
+    printf("\n\n");
+}
+
+boolean CheckRejectedLoad
+(
+    motelTreeHandle pTree,
+    unsigned long pCount,
+    motelResult pResult,
+    const char * pName
+)
+{
+    motelResult lResultCode;
+
+    unsigned long lNodes;
+
+    size_t lEmptySize;
+    size_t lSize;
+
+    GetTreeMember(pTree, motelTreeMember_Size, &lEmptySize);
+
+    if (BulkLoadTree(pTree, gBatchData, gBatchKeys, pCount))
+    {
+        fprintf(gFile, "\n%s of %ld nodes succeeded\n\n", pName, pCount);
+
+        return (FALSE);
+    }
+
+    GetTreeMember(pTree, motelTreeMember_Result, (void **) &lResultCode);
+    GetTreeMember(pTree, motelTreeMember_Nodes, &lNodes);
+    GetTreeMember(pTree, motelTreeMember_Size, &lSize);
+
+    if (pResult != lResultCode || 0 != lNodes || lEmptySize != lSize || !ValidateTree(pTree))
+    {
+        fprintf(gFile, "\n%s of %ld nodes left %ld nodes and %ld of %ld bytes, Result Code: %ld\n\n",
+                pName, pCount, lNodes, (long) lSize, (long) lEmptySize, (long) lResultCode);
+
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+boolean CheckCompactRejection
+(
+    boolean pSucceeded,
+    const char * pName
+)
+{
+    motelResult lResultCode;
+
+    unsigned long lNodes;
+
+    GetTreeMember(gTree, motelTreeMember_Result, (void **) &lResultCode);
+    GetTreeMember(gTree, motelTreeMember_Nodes, &lNodes);
+
+    if (pSucceeded || motelResult_Incompatible != lResultCode || gNodeCount != lNodes || !ValidateTree(gTree))
+    {
+        fprintf(gFile, "\n%s of a compact tree of %ld nodes was not rejected, %ld nodes left, Result Code: %ld\n\n",
+                pName, gNodeCount, lNodes, (long) lResultCode);
+
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+void OutputTreeState
+(
+    void
+)
+{
+    unsigned long lNodes;
+    unsigned long lLevels;
+    unsigned long lExactLevels;
+
+    size_t lSize;
+
+    GetTreeMember(gTree, motelTreeMember_Nodes, (void **) &lNodes);
+    GetTreeMember(gTree, motelTreeMember_LevelCount, &lLevels);
+    GetTreeMember(gTree, motelTreeMember_ExactLevelCount, &lExactLevels);
+    GetTreeMember(gTree, motelTreeMember_Size, (void **) &lSize);
+
+    fprintf(gFile, "Node Count = %ld\n", lNodes);
+    fprintf(gFile, "Tree Depth = %ld (bounded at %ld)\n", lExactLevels, lLevels);
+    fprintf(gFile, "\n");
+    fprintf(gFile, "Memory Allocated = %zd\n\n", lSize);
+}
+
+void GenerateInsertData
+(
+    void
+)
+{
+    static unsigned long lCreationOrdinal = 1;
+
+    sprintf(gData, "Insert Ordinal:%08ld", lCreationOrdinal++);
+}
+
+void GenerateUpdateData
+(
+    void
+)
+{
+    static unsigned long lUpdateOrdinal = 1;
+
+    sprintf(gData, "Update Ordinal:%08ld", lUpdateOrdinal++);
+}
+
+void OutputNodeData
+(
+    void
+)
+{
+    fprintf(gFile, "Key: \"%06ld:%03ld\"\n", gKey, gInstance);
     fprintf(gFile, "Data: \"%s\"\n\n", gData);
 }
 
+boolean OutputScannedNode
+(
+    void * pContext,
+    const void * pKey,
+    const void * pData,
+    unsigned long pInstance
+)
+{
+    (* (unsigned long *) pContext)++;
+
+    fprintf(gFile, "Key: \"%06ld:%03ld\"\n", * (const long *) pKey, pInstance);
+    fprintf(gFile, "Data: \"%s\"\n\n", (const char *) pData);
+
+    return (TRUE);
+}
+
 void OutputResult
 (
     void
 )
 {
-    long lResultCode;
+    motelResult lResultCode;
 
     if (GetTreeMember(gTree, motelTreeMember_Result, (void **) &lResultCode))
     {
-        fprintf(gFile, "Result Code: %ld\n\n", lResultCode);
+        fprintf(gFile, "Result Code: %ld\n\n", (long) lResultCode);
     }
     else
     {
@@ -1412,6 +4169,219 @@ void OutputResult
     }
 }
 
+boolean ConstructOtherTree
+(
+    motelTreeHandle * pTree
+)
+{
+    motelTreeKeyType lKeyType;
+
+    boolean lParentless;
+
+    /*
+    ** the other tree compares its keys and keeps its parent links as the test tree does
+    */
+
+    if (!ConstructTree(pTree, (size_t) 0, (size_t) DATA_ELEMENT_SIZE, sizeof(gKey), _compare))
+    {
+        return (FALSE);
+    }
+
+    GetTreeMember(gTree, motelTreeMember_KeyType, &lKeyType);
+    SetTreeMember(* pTree, motelTreeMember_KeyType, &lKeyType);
+
+    GetTreeMember(gTree, motelTreeMember_Parentless, &lParentless);
+    SetTreeMember(* pTree, motelTreeMember_Parentless, &lParentless);
+
+    return (TRUE);
+}
+
+long RandomKey
+(
+    long pLeast,
+    long pLimit
+)
+{
+    unsigned long lRandom;
+
+    /*
+    ** combine two draws so that the key range may exceed RAND_MAX
+    */
+
+    lRandom = (unsigned long) rand() * ((unsigned long) RAND_MAX + 1) + (unsigned long) rand();
+
+    return (pLeast + (long) (lRandom % (unsigned long) (pLimit - pLeast)));
+}
+
+unsigned long FillTree
+(
+    motelTreeHandle pTree,
+    unsigned long * pCounts,
+    unsigned long pKeys,
+    long pLeast,
+    long pLimit,
+    unsigned long pNodes
+)
+{
+    unsigned long lNodeIndex;
+    unsigned long lInserted = 0;
+
+    for (lNodeIndex = 0; lNodeIndex < pNodes; lNodeIndex++)
+    {
+        gKey = RandomKey(pLeast, pLimit);
+        sprintf(gData, "Key #%06ld", gKey);
+
+        if (InsertTreeNode(pTree, gData, &gKey) && 0 <= gKey && (unsigned long) gKey < pKeys)
+        {
+            pCounts[gKey]++;
+
+            lInserted++;
+        }
+    }
+
+    return (lInserted);
+}
+
+boolean CheckTree
+(
+    motelTreeHandle pTree,
+    const unsigned long * pCounts,
+    unsigned long pKeys,
+    const char * pName
+)
+{
+    motelResult lResultCode;
+
+    unsigned long lKeyIndex;
+    unsigned long lInstance;
+
+    long lKey;
+    long lPreviousKey;
+
+    char lData[DATA_ELEMENT_SIZE];
+
+    if (!ValidateTree(pTree))
+    {
+        GetTreeMember(pTree, motelTreeMember_Result, (void **) &lResultCode);
+
+        fprintf(gFile, "\n%s failed validation, Result Code: %ld\n\n", pName, (long) lResultCode);
+
+        return (FALSE);
+    }
+
+    /*
+    ** count every key value from least to greatest
+    */
+
+    memset(gFoundCounts, 0, pKeys * sizeof(unsigned long));
+
+    lPreviousKey = 0;
+
+    if (PeekLeastTreeNode(pTree, lData, &lKey, &lInstance))
+    {
+        do
+        {
+            if (0 > lKey || pKeys <= (unsigned long) lKey || lKey < lPreviousKey)
+            {
+                fprintf(gFile, "\n%s holds key %ld out of place\n\n", pName, lKey);
+
+                return (FALSE);
+            }
+
+            gFoundCounts[lKey]++;
+
+            lPreviousKey = lKey;
+        }
+        while (PeekGreaterTreeNode(pTree, lData, &lKey, &lInstance));
+    }
+
+    for (lKeyIndex = 0; lKeyIndex < pKeys; lKeyIndex++)
+    {
+        if (pCounts[lKeyIndex] != gFoundCounts[lKeyIndex])
+        {
+            fprintf(gFile, "\n%s holds %ld instances of key %ld rather than %ld\n\n", pName, gFoundCounts[lKeyIndex], lKeyIndex, pCounts[lKeyIndex]);
+
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
+long FileLength
+(
+    const char * pPath
+)
+{
+    FILE * lFile;
+
+    long lLength;
+
+    lFile = fopen(pPath, "rb");
+
+    if (NULL == lFile)
+    {
+        return (0);
+    }
+
+    fseek(lFile, 0, SEEK_END);
+
+    lLength = ftell(lFile);
+
+    fclose(lFile);
+
+    return (lLength);
+}
+
+boolean TearFile
+(
+    const char * pPath,
+    long pLength
+)
+{
+    FILE * lFile;
+
+    char * lBuffer;
+
+    boolean lTorn;
+
+    /*
+    ** keep only the file's first pLength bytes, as a crash mid-write would
+    */
+
+    lBuffer = (char *) malloc((size_t) pLength + 1);
+
+    if (NULL == lBuffer)
+    {
+        return (FALSE);
+    }
+
+    lFile = fopen(pPath, "rb");
+
+    lTorn = NULL != lFile && (size_t) pLength == fread(lBuffer, 1, (size_t) pLength, lFile);
+
+    if (NULL != lFile)
+    {
+        fclose(lFile);
+    }
+
+    if (lTorn)
+    {
+        lFile = fopen(pPath, "wb");
+
+        lTorn = NULL != lFile && (size_t) pLength == fwrite(lBuffer, 1, (size_t) pLength, lFile);
+
+        if (NULL != lFile && 0 != fclose(lFile))
+        {
+            lTorn = FALSE;
+        }
+    }
+
+    free(lBuffer);
+
+    return (lTorn);
+}
+
 long _compare
 (
     const void * pKey1,
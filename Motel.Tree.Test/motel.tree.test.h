@@ -38,6 +38,40 @@
 #define TEST_DURATION 3
 #define THOROUGH_TEST_NODES 10000
 #define PERFORMANCE_TEST_NODES THOROUGH_TEST_NODES * 250
+#define DUPLICATE_TEST_KEYS 51
+#define SET_TEST_KEYS 131072
+#define SET_TEST_NODES 100000
+#define SET_TEST_THREADS 4
+#define TREE_TEST_THREADS 4
+#define POOL_TEST_BLOCK_SIZE 65536
+#define SNAPSHOT_TEST_KEYS 4096
+#define SNAPSHOT_TEST_VERSIONS 8
+#define LOG_TEST_COMMIT 64
+#define LOG_TEST_PATH "motel.tree.test.log"
+#define CHECKPOINT_TEST_PATH "motel.tree.test.checkpoint"
+#define CURSOR_TEST_KEYS 256
+#define CURSOR_TEST_NODES 2000
+#define CURSOR_TEST_CURSORS 8
+#define CONCURRENT_TEST_KEYS 1024
+#define CONCURRENT_TEST_WRITERS 2
+#define CONCURRENT_TEST_READERS 4
+#define CONCURRENT_TEST_WRITES 20000
+#define CONCURRENT_TEST_READS 50000
+#define CONCURRENT_TEST_SCAN_INTERVAL 16
+#define CONCURRENT_TEST_SCAN_KEYS 64
+#define BATCH_TEST_KEYS 4096
+#define BATCH_TEST_NODES 1000
+#define BATCH_TEST_BATCHES 16
+#define BATCH_TEST_CROWD 16
+#define FROZEN_TEST_KEYS 8192
+#define FROZEN_TEST_NODES 20000
+#define FROZEN_TEST_PROBES 10000
+#define FROZEN_TEST_SCANS 64
+#define FROZEN_TEST_SCAN_KEYS 256
+#define FROZEN_TEST_PATH "motel.tree.test.frozen"
+#define BULK_TEST_STEP 3
+#define BULK_TEST_LOG_PATH "motel.tree.test.bulk.log"
+#define BULK_TEST_CHECKPOINT_PATH "motel.tree.test.bulk.checkpoint"
 
 #define DATA_ELEMENT_SIZE 64
 
@@ -47,6 +81,31 @@
 #define TEST_SEED 1
 #endif
 
+/*----------------------------------------------------------------------------
+  Private data types
+  ----------------------------------------------------------------------------*/
+
+/* A writer or lock-free reader thread of the concurrent test and what it found. */
+
+typedef struct concurrentTestThread concurrentTestThread;
+
+struct concurrentTestThread
+{
+    motelThread thread;
+
+    unsigned long seed;
+
+    long least;
+    long greatest;
+
+    long previousKey;
+    unsigned long previousInstance;
+
+    boolean failed;
+
+    char failure[DATA_ELEMENT_SIZE * 4];
+};
+
 /*----------------------------------------------------------------------------
   Private function prototypes
   ----------------------------------------------------------------------------*/
@@ -101,6 +160,26 @@ void DeleteNode
     void
 );
 
+void SelectRankedNode
+(
+    void
+);
+
+void CountKeyRange
+(
+    void
+);
+
+void SelectLowerBoundNode
+(
+    void
+);
+
+void ScanKeyRange
+(
+    void
+);
+
 void LeastNode
 (
     void
@@ -181,6 +260,139 @@ void IteratedTest2
     void
 );
 
+void IteratedTest3
+(
+    void
+);
+
+void IteratedTest4
+(
+    void
+);
+
+boolean ChurnTree
+(
+    const char * pName
+);
+
+void IteratedTest5
+(
+    void
+);
+
+void IteratedTest6
+(
+    void
+);
+
+void IteratedTest7
+(
+    void
+);
+
+void IteratedTest8
+(
+    void
+);
+
+void IteratedTest9
+(
+    void
+);
+
+motelThreadResult THREAD_CALLING_CONVENTION ConcurrentWriter
+(
+    void * pArgument
+);
+
+motelThreadResult THREAD_CALLING_CONVENTION ConcurrentReader
+(
+    void * pArgument
+);
+
+boolean CheckConcurrentNode
+(
+    void * pContext,
+    const void * pKey,
+    const void * pData,
+    unsigned long pInstance
+);
+
+boolean IsKeyData
+(
+    long pKey,
+    const char * pData
+);
+
+unsigned long NextRandom
+(
+    unsigned long * pSeed
+);
+
+void IteratedTest10
+(
+    void
+);
+
+void GenerateBatch
+(
+    unsigned long pBatch,
+    unsigned long pCount,
+    long pLeast,
+    long pLimit
+);
+
+boolean CompareTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther,
+    const char * pName
+);
+
+boolean CheckSelectedNodes
+(
+    motelTreeHandle pTree,
+    boolean pInstances
+);
+
+void IteratedTest11
+(
+    void
+);
+
+boolean CheckSnapshot
+(
+    motelTreeSnapshotHandle pSnapshot,
+    const char * pName
+);
+
+boolean RecordScannedNode
+(
+    void * pContext,
+    const void * pKey,
+    const void * pData,
+    unsigned long pInstance
+);
+
+void IteratedTest12
+(
+    void
+);
+
+boolean CheckRejectedLoad
+(
+    motelTreeHandle pTree,
+    unsigned long pCount,
+    motelResult pResult,
+    const char * pName
+);
+
+boolean CheckCompactRejection
+(
+    boolean pSucceeded,
+    const char * pName
+);
+
 void OutputTreeState
 (
     void
@@ -201,11 +413,59 @@ void OutputNodeData
     void
 );
 
+boolean OutputScannedNode
+(
+    void * pContext,
+    const void * pKey,
+    const void * pData,
+    unsigned long pInstance
+);
+
 void OutputResult
 (
     void
 );
 
+boolean ConstructOtherTree
+(
+    motelTreeHandle * pTree
+);
+
+long RandomKey
+(
+    long pLeast,
+    long pLimit
+);
+
+unsigned long FillTree
+(
+    motelTreeHandle pTree,
+    unsigned long * pCounts,
+    unsigned long pKeys,
+    long pLeast,
+    long pLimit,
+    unsigned long pNodes
+);
+
+boolean CheckTree
+(
+    motelTreeHandle pTree,
+    const unsigned long * pCounts,
+    unsigned long pKeys,
+    const char * pName
+);
+
+long FileLength
+(
+    const char * pPath
+);
+
+boolean TearFile
+(
+    const char * pPath,
+    long pLength
+);
+
 long _compare
 (
     const void * pKey1,
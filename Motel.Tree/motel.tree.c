@@ -51,6 +51,17 @@
 
 static const char *gCopyright = "@(#)motel.tree.c - Copyright 2010-2011 John L. Hart IV - All rights reserved";
 
+/*----------------------------------------------------------------------------
+  Globals
+  ----------------------------------------------------------------------------*/
+
+/*
+** the last identity given to a persistent version; identities are never
+** reused, so a node left charged to a destructed version is charged to none
+*/
+
+static motelAtomic gPersistentVersions = 0;
+
 /*----------------------------------------------------------------------------
   Public functions
   ----------------------------------------------------------------------------*/
@@ -60,6 +71,8 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ValidateTree
     motelTreeHandle pTree
 )
 {
+    motelTreeValidation lValidation;
+
     /*
     ** there is no tree
     */
@@ -75,25 +88,61 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ValidateTree
     ** there are no nodes in the tree
     */
 
-    if (NULL == pTree->root)
+    if (NULL == TreeRoot(pTree))
     {
         return (TRUE);
     }
 
+    lValidation.tree = pTree;
+    lValidation.root = TreeRoot(pTree);
+    lValidation.subtree = TRUE;
+
     /*
-    ** validate the root subtree
+    ** the root has no parent
     */
 
-    if (!ValidateSubtree(pTree, pTree->root))
+    if (!pTree->parentless && NULL != NodeParent(pTree, TreeRoot(pTree)))
     {
-        return (FALSE); // pass through result code
+        lValidation.failure = TreeRoot(pTree);
+        lValidation.result = motelResult_Structure;
+    }
+
+    /*
+    ** divide the walk of a large tree among several threads, or walk it whole
+    */
+
+    else if (1 < pTree->validateThreads && PARALLEL_VALIDATE_NODES <= TreeRoot(pTree)->lesserNullNodes + TreeRoot(pTree)->greaterNullNodes - 1)
+    {
+        ValidateTreeInParallel(pTree, &lValidation);
+    }
+    else
+    {
+        ValidateSubtree((void *) &lValidation);
     }
 
     /*
     ** the tree is valid
     */
 
-    return (TRUE);
+    if (motelResult_OK == lValidation.result)
+    {
+        return (TRUE);
+    }
+
+    /*
+    ** leave the node cursor on the first node to fail
+    */
+
+    if (NULL != lValidation.failure)
+    {
+        pTree->cursor = lValidation.failure;
+
+        SetCursorOccurrence(pTree, FALSE);
+    }
+
+    pTree->result = lValidation.result;
+
+    return (FALSE); // set breakpoint here for debugging
 }
 
 EXPORT_STORAGE_CLASS success CALLING_CONVENTION ConstructTree
@@ -105,15 +154,6 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ConstructTree
     long (* pCompareKeyFunction)(const void * pKey1, const void * pKey2)
 )
 {
-    /*
-    ** no key comparision function was provided
-    */
-
-    if (NULL == pCompareKeyFunction)
-    {
-        return (FALSE);
-    }
-
     /*
     ** the maximum size is too small to even create the tree control structure
     */
@@ -140,16 +180,96 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ConstructTree
 
     (* pTree)->compareKeyFunction = pCompareKeyFunction;
 
+    /*
+    ** without a key comparison function the key objects are compared as bytes
+    */
+
+    if (NULL == pCompareKeyFunction)
+    {
+        (* pTree)->keyType = motelTreeKeyType_Bytes;
+    }
+    else
+    {
+        (* pTree)->keyType = motelTreeKeyType_Custom;
+    }
+
     (* pTree)->maximumSize = pTreeMaximumSize;
     (* pTree)->size = sizeof(motelTree);
 
     (* pTree)->keySize = pKeySize;
     (* pTree)->dataSize = pDataSize;
 
-    (* pTree)->root = (motelTreeNodeHandle) NULL;
+    (* pTree)->nodeSize = TreeNodeSize + AlignedNodeSize(pKeySize) + AlignedNodeSize(pDataSize);
+
+    (* pTree)->pool = (motelMemoryHandle) NULL;
+
+#if defined COMPACT_TREE_NODES
+
+    (* pTree)->arena.base = (byte *) NULL;
+    (* pTree)->arena.reserved = 0;
+    (* pTree)->arena.committed = 0;
+    (* pTree)->arena.used = 0;
+    (* pTree)->arena.free = 0;
+
+    (* pTree)->greatestInstance = 1;
+
+#endif
+
+    SetTreeRoot(* pTree, (motelTreeNodeHandle) NULL);
+
+    (* pTree)->levels = 0;
+    (* pTree)->levelScale = LevelScale(REBALANCE_THRESHOLD, 1);
 
     (* pTree)->cursor = (motelTreeNodeHandle) NULL;
 
+    (* pTree)->cursors = (motelTreeCursorHandle) NULL;
+
+    (* pTree)->concurrent = FALSE;
+
+    (* pTree)->retired[0] = (motelTreeNodeHandle) NULL;
+    (* pTree)->retired[1] = (motelTreeNodeHandle) NULL;
+
+    (* pTree)->teardownThreads = 1;
+    (* pTree)->combineThreads = 1;
+    (* pTree)->validateThreads = 1;
+
+#if defined PARENTLESS_TREE_NODES
+
+    (* pTree)->parentless = TRUE;
+
+#else
+
+    (* pTree)->parentless = FALSE;
+
+#endif
+
+    (* pTree)->groupDuplicates = FALSE;
+
+    (* pTree)->occurrence = 0;
+
+    (* pTree)->balance.numerator = REBALANCE_THRESHOLD;
+    (* pTree)->balance.denominator = 1;
+    (* pTree)->balance.mode = motelTreeBalanceMode_Pivot;
+
+    (* pTree)->persistent = FALSE;
+    (* pTree)->persistentParentless = FALSE;
+
+    (* pTree)->version = 0;
+
+    (* pTree)->log = (motelTreeLogHandle) NULL;
+
+    (* pTree)->logCommitRecords = DEFAULT_LOG_COMMIT_RECORDS;
+    (* pTree)->logCommitMilliseconds = DEFAULT_LOG_COMMIT_MILLISECONDS;
+    (* pTree)->logCheckpointRecords = DEFAULT_LOG_CHECKPOINT_RECORDS;
+
+    (* pTree)->logSequence = 0;
+
+#if defined TREE_STATISTICS
+
+    memset((void *) &(* pTree)->statistics, 0, sizeof(motelTreeStatistics));
+
+#endif
+
     return (TRUE);
 }
 
@@ -158,6 +278,8 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION DestructTree
     motelTreeHandle * pTree
 )
 {
+    motelTreeCursorHandle lCursor;
+
     /*
     ** there is no tree
     */
@@ -167,13 +289,126 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION DestructTree
         return (FALSE);
     }
 
-    if (!PruneSubtree(* pTree, (* pTree)->root))
+    /*
+    ** orphan any cursors that remain constructed over the tree
+    */
+
+    while (NULL != (* pTree)->cursors)
+    {
+        lCursor = (* pTree)->cursors;
+
+        (* pTree)->cursors = lCursor->next;
+
+        lCursor->tree = (motelTreeHandle) NULL;
+        lCursor->node = (motelTreeNodeHandle) NULL;
+        lCursor->next = (motelTreeCursorHandle) NULL;
+    }
+
+    /*
+    ** commit the changes still pending in the redo log; the tree is
+    ** destructed whether or not they can be committed
+    */
+
+    if (NULL != (* pTree)->log)
+    {
+        CloseLog(* pTree);
+    }
+
+    /*
+    ** release the nodes awaiting reclamation along with the lock
+    */
+
+    if ((* pTree)->concurrent)
+    {
+        if (!ReclaimRetiredNodes(* pTree, TRUE))
+        {
+            return (FALSE); // pass through result code
+        }
+
+        DeleteLock(&(* pTree)->lock);
+
+        (* pTree)->concurrent = FALSE;
+    }
+
+    if ((* pTree)->persistent)
+    {
+        /*
+        ** release the version's hold on its nodes, destructing those no other version holds
+        */
+
+        if (!ReleaseNode(* pTree, TreeRoot(* pTree)))
+        {
+            (* pTree)->result = motelResult_NodeDestruction;
+
+            return (FALSE);
+        }
+    }
+    else if (NULL != (* pTree)->pool)
+    {
+        /*
+        ** release every node at once by releasing the memory pool
+        */
+
+        if (!DestructPool(&(* pTree)->pool))
+        {
+            (* pTree)->result = motelResult_MemoryDeallocation;
+
+            return (FALSE);
+        }
+
+        SetTreeRoot(* pTree, (motelTreeNodeHandle) NULL);
+        (* pTree)->cursor = (motelTreeNodeHandle) NULL;
+    }
+
+#if defined COMPACT_TREE_NODES
+
+    else if (!(* pTree)->groupDuplicates)
+    {
+        /*
+        ** every node is released at once along with the arena below
+        */
+
+        SetTreeRoot(* pTree, (motelTreeNodeHandle) NULL);
+        (* pTree)->cursor = (motelTreeNodeHandle) NULL;
+    }
+
+#else
+
+    else if (1 < (* pTree)->teardownThreads && !(* pTree)->parentless && !(* pTree)->groupDuplicates && NULL != TreeRoot(* pTree) &&
+             PARALLEL_TEARDOWN_NODES <= TreeRoot(* pTree)->lesserNullNodes + TreeRoot(* pTree)->greaterNullNodes - 1)
+    {
+        /*
+        ** divide the release of a large tree's nodes among several threads
+        */
+
+        if (!PruneTreeInParallel(* pTree))
+        {
+            (* pTree)->result = motelResult_NodeDestruction;
+
+            return (FALSE);
+        }
+    }
+
+#endif
+
+    else if (!PruneSubtree(* pTree, TreeRoot(* pTree)))
     {
         (* pTree)->result = motelResult_NodeDestruction;
 
         return (FALSE);
     }
 
+#if defined COMPACT_TREE_NODES
+
+    if (NULL != (* pTree)->arena.base && !ReleaseBlock((void **) &(* pTree)->arena.base, (* pTree)->arena.reserved))
+    {
+        (* pTree)->result = motelResult_MemoryDeallocation;
+
+        return (FALSE);
+    }
+
+#endif
+
     if (!SafeFreeBlock((void **) pTree))
     {
         (* pTree)->result = motelResult_MemoryDeallocation;
@@ -191,6 +426,10 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SetTreeMember
     const void * pValue
 )
 {
+    const motelTreeBalance * lBalance;
+
+    boolean lValid;
+
     /*
     ** there is no tree object
     */
@@ -227,6 +466,8 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SetTreeMember
 
             pTree->cursor = GetLeastNode(pTree);
 
+            SetCursorOccurrence(pTree, FALSE);
+
             if (NULL == pTree->cursor)
             {
                 return (FALSE);
@@ -238,6 +479,8 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SetTreeMember
 
             pTree->cursor = GetGreatestNode(pTree);
 
+            SetCursorOccurrence(pTree, TRUE);
+
             if (NULL == pTree->cursor)
             {
                 return (FALSE);
@@ -262,6 +505,8 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SetTreeMember
 
             pTree->cursor = GetRootNode(pTree);
 
+            SetCursorOccurrence(pTree, FALSE);
+
             if (NULL == pTree->cursor)
             {
                 return (FALSE);
@@ -280,6 +525,8 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SetTreeMember
 
             pTree->cursor = lCurrentNode;
 
+            SetCursorOccurrence(pTree, FALSE);
+
             return (TRUE);
 
         case motelTreeMember_LesserChild:
@@ -293,6 +540,8 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SetTreeMember
 
             pTree->cursor = lCurrentNode;
 
+            SetCursorOccurrence(pTree, FALSE);
+
             return (TRUE);
 
         case motelTreeMember_GreaterChild:
@@ -306,6 +555,8 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SetTreeMember
 
             pTree->cursor = lCurrentNode;
 
+            SetCursorOccurrence(pTree, FALSE);
+
             return (TRUE);
     }
 
@@ -318,107 +569,8207 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SetTreeMember
 
     switch (pMember)
     {
-    }
-
-    pTree->result = motelResult_InvalidMember;
+        case motelTreeMember_MemoryPool:
 
-    return (FALSE);
-}
-
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetTreeMember
-(
-    motelTreeHandle pTree,
-    motelTreeMember pMember,
-    void * pValue
-)
-{
-    motelTreeNodeHandle lRoot;
+            /*
+            ** nodes cannot be moved between the heap and a memory pool
+            */
 
-    /*
-    ** there is no tree object
-    */
+            if (NULL != TreeRoot(pTree))
+            {
+                pTree->result = motelResult_InvalidState;
 
-    if (NULL == pTree)
-    {
-        return (FALSE);
-    }
+                return (FALSE);
+            }
 
-    /*
-    ** no return parameter
-    */
+            /*
+            ** the occurrence lists of grouped keys are not allocated from the pool, and
+            ** nodes shared among persistent versions may be released by any thread
+            */
 
-    if (NULL == pValue)
-    {
-        return (FALSE);
-    }
+            if (pTree->groupDuplicates || pTree->persistent)
+            {
+                pTree->result = motelResult_Incompatible;
 
-    /*
-    ** result code is a special case because we want to set a result code for GetTreeMember()
-    */
+                return (FALSE);
+            }
 
-    if (motelTreeMember_Result == pMember)
-    {
-        * (motelResult *) pValue = pTree->result;
+#if defined COMPACT_TREE_NODES
 
-        return (TRUE);
-    }
+            /*
+            ** a compact tree's nodes come from its own arena
+            */
 
-    /*
-    ** get member
-    */
+            if (0 != * (size_t *) pValue)
+            {
+                pTree->result = motelResult_Incompatible;
 
-    pTree->result = motelResult_OK;
+                return (FALSE);
+            }
 
-    switch (pMember)
-    {
-        case motelTreeMember_Size:
+#endif
 
-            * (size_t *) pValue = pTree->size;
+            /*
+            ** a pool block must hold at least one node
+            */
 
-            return (TRUE);
+            if (0 != * (size_t *) pValue && pTree->nodeSize > * (size_t *) pValue)
+            {
+                pTree->result = motelResult_InvalidValue;
 
-        case motelTreeMember_Nodes:
+                return (FALSE);
+            }
 
-            lRoot = pTree->root;
+            /*
+            ** replace any existing memory pool
+            */
 
-            if (NULL == lRoot)
+            if (NULL != pTree->pool && !DestructPool(&pTree->pool))
             {
-                * (unsigned long *) pValue = 0L;
+                pTree->result = motelResult_MemoryDeallocation;
+
+                return (FALSE);
             }
-            else
+
+            if (0 != * (size_t *) pValue && !ConstructPool(&pTree->pool, * (size_t *) pValue))
             {
-                * (unsigned long *) pValue = lRoot->lesserNullNodes + lRoot->greaterNullNodes - 1L;
+                pTree->result = motelResult_MemoryAllocation;
+
+                return (FALSE);
             }
 
             return (TRUE);
 
-        case motelTreeMember_LevelCount:
+        case motelTreeMember_KeyType:
 
-            * (unsigned long *) pValue = GetTreeLevelCount(pTree);
+            /*
+            ** the nodes are ordered by the existing key type
+            */
 
-            return (TRUE);
-    }
+            if (NULL != TreeRoot(pTree))
+            {
+                pTree->result = motelResult_InvalidState;
 
-    pTree->result = motelResult_InvalidMember;
+                return (FALSE);
+            }
 
-    return (FALSE);
-}
+            /*
+            ** the key type must suit the key size
+            */
 
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION InsertTreeNode
-(
-    motelTreeHandle pTree,
-    void * pData,
-    void * pKey
-)
-{
-    motelTreeNodeHandle lInsertNode;
+            switch (* (motelTreeKeyType *) pValue)
+            {
+                case motelTreeKeyType_Custom:
 
-    motelTreeNodeHandle lNode;
-    motelTreeNodeHandle lChild;
+                    lValid = NULL != pTree->compareKeyFunction;
+                    break;
 
-    long lComparisonResult;
+                case motelTreeKeyType_Signed32:
+                case motelTreeKeyType_Unsigned32:
 
-    unsigned int lRebalanceThreshold = REBALANCE_THRESHOLD;
+                    lValid = sizeof(bits32) == pTree->keySize;
+                    break;
+
+                case motelTreeKeyType_Signed64:
+                case motelTreeKeyType_Unsigned64:
+
+                    lValid = sizeof(bits64) == pTree->keySize;
+                    break;
+
+                case motelTreeKeyType_Bytes:
+
+                    lValid = TRUE;
+                    break;
+
+                default:
+
+                    lValid = FALSE;
+                    break;
+            }
+
+            if (!lValid)
+            {
+                pTree->result = motelResult_InvalidValue;
+
+                return (FALSE);
+            }
+
+            pTree->keyType = * (motelTreeKeyType *) pValue;
+
+            return (TRUE);
+
+        case motelTreeMember_Concurrent:
+
+            if (* (boolean *) pValue == pTree->concurrent)
+            {
+                return (TRUE);
+            }
+
+            /*
+            ** lock-free readers cannot follow occurrence lists that move as they grow,
+            ** and a persistent tree's nodes are never changed in place
+            */
+
+            if (pTree->groupDuplicates || pTree->persistent)
+            {
+                pTree->result = motelResult_Incompatible;
+
+                return (FALSE);
+            }
+
+            if (* (boolean *) pValue)
+            {
+                InitializeLock(&pTree->lock);
+
+                pTree->sequence = 0;
+
+                pTree->epoch = 0;
+                pTree->readers[0] = 0;
+                pTree->readers[1] = 0;
+
+                pTree->concurrent = TRUE;
+            }
+            else
+            {
+                /*
+                ** there must be no readers once the tree is no longer concurrent
+                */
+
+                if (!ReclaimRetiredNodes(pTree, TRUE))
+                {
+                    return (FALSE); // pass through result code
+                }
+
+                DeleteLock(&pTree->lock);
+
+                pTree->concurrent = FALSE;
+            }
+
+            return (TRUE);
+
+        case motelTreeMember_TeardownThreads:
+
+            if (1 > * (unsigned long *) pValue || MAXIMUM_TEARDOWN_THREADS < * (unsigned long *) pValue)
+            {
+                pTree->result = motelResult_InvalidValue;
+
+                return (FALSE);
+            }
+
+            pTree->teardownThreads = * (unsigned long *) pValue;
+
+            return (TRUE);
+
+        case motelTreeMember_CombineThreads:
+
+            if (1 > * (unsigned long *) pValue || MAXIMUM_COMBINE_THREADS < * (unsigned long *) pValue)
+            {
+                pTree->result = motelResult_InvalidValue;
+
+                return (FALSE);
+            }
+
+            pTree->combineThreads = * (unsigned long *) pValue;
+
+            return (TRUE);
+
+        case motelTreeMember_ValidateThreads:
+
+            if (1 > * (unsigned long *) pValue || MAXIMUM_VALIDATE_THREADS < * (unsigned long *) pValue)
+            {
+                pTree->result = motelResult_InvalidValue;
+
+                return (FALSE);
+            }
+
+            pTree->validateThreads = * (unsigned long *) pValue;
+
+            return (TRUE);
+
+        case motelTreeMember_Parentless:
+
+            if (* (boolean *) pValue == pTree->parentless)
+            {
+                return (TRUE);
+            }
+
+#if defined PARENTLESS_TREE_NODES
+
+            /*
+            ** the nodes were built without parent links
+            */
+
+            pTree->result = motelResult_Incompatible;
+
+            return (FALSE);
+
+#endif
+
+            /*
+            ** the parent links of existing nodes cannot be restored
+            */
+
+            if (NULL != TreeRoot(pTree))
+            {
+                pTree->result = motelResult_InvalidState;
+
+                return (FALSE);
+            }
+
+            /*
+            ** a node shared among persistent versions has no one parent
+            */
+
+            if (pTree->persistent)
+            {
+                pTree->result = motelResult_Incompatible;
+
+                return (FALSE);
+            }
+
+            pTree->parentless = * (boolean *) pValue;
+
+            return (TRUE);
+
+        case motelTreeMember_GroupDuplicates:
+
+            if (* (boolean *) pValue == pTree->groupDuplicates)
+            {
+                return (TRUE);
+            }
+
+            /*
+            ** the existing nodes hold their data rather than occurrence lists
+            */
+
+            if (NULL != TreeRoot(pTree))
+            {
+                pTree->result = motelResult_InvalidState;
+
+                return (FALSE);
+            }
+
+            /*
+            ** the occurrence lists are allocated from the heap, may move under
+            ** lock-free readers, are not tracked by registered cursors, would
+            ** be shared by the copies of a persistent tree's nodes and cannot
+            ** be held by a logged tree's checkpoints
+            */
+
+            if (NULL != pTree->pool || pTree->concurrent || NULL != pTree->cursors || pTree->persistent || NULL != pTree->log)
+            {
+                pTree->result = motelResult_Incompatible;
+
+                return (FALSE);
+            }
+
+            pTree->groupDuplicates = * (boolean *) pValue;
+
+#if defined COMPACT_TREE_NODES
+
+            /*
+            ** the released nodes of the former size cannot hold the new ones
+            */
+
+            pTree->arena.used = NODE_ALIGNMENT;
+            pTree->arena.free = 0;
+
+#endif
+
+            /*
+            ** a grouped node holds the handle of its occurrence list in place of its data
+            */
+
+            if (pTree->groupDuplicates)
+            {
+                pTree->nodeSize = TreeNodeSize + AlignedNodeSize(pTree->keySize) + AlignedNodeSize(sizeof(motelTreeOccurrences *));
+            }
+            else
+            {
+                pTree->nodeSize = TreeNodeSize + AlignedNodeSize(pTree->keySize) + AlignedNodeSize(pTree->dataSize);
+            }
+
+            return (TRUE);
+
+        case motelTreeMember_Balance:
+
+            lBalance = (const motelTreeBalance *) pValue;
+
+            /*
+            ** the threshold ratio must lie within the limits and the mode must be known
+            */
+
+            if (1 > lBalance->denominator || MAXIMUM_BALANCE_DENOMINATOR < lBalance->denominator ||
+                MINIMUM_BALANCE_THRESHOLD * lBalance->denominator > lBalance->numerator ||
+                MAXIMUM_BALANCE_THRESHOLD * lBalance->denominator < lBalance->numerator ||
+                motelTreeBalanceMode_ <= (unsigned int) lBalance->mode)
+            {
+                pTree->result = motelResult_InvalidValue;
+
+                return (FALSE);
+            }
+
+            /*
+            ** a rebuild would change nodes that persistent versions share
+            */
+
+            if (motelTreeBalanceMode_Rebuild == lBalance->mode && pTree->persistent)
+            {
+                pTree->result = motelResult_Incompatible;
+
+                return (FALSE);
+            }
+
+            /*
+            ** the existing nodes are brought into the new balance by later inserts and deletes,
+            ** so until the tree is emptied its branches are bounded by the looser ratio
+            */
+
+            pTree->balance = * lBalance;
+
+            if (NULL == TreeRoot(pTree) || pTree->levelScale < LevelScale(lBalance->numerator, lBalance->denominator))
+            {
+                pTree->levelScale = LevelScale(lBalance->numerator, lBalance->denominator);
+            }
+
+            return (TRUE);
+
+        case motelTreeMember_Persistent:
+
+            if (* (boolean *) pValue == pTree->persistent)
+            {
+                return (TRUE);
+            }
+
+            /*
+            ** the existing nodes hold no reference counts
+            */
+
+            if (NULL != TreeRoot(pTree))
+            {
+                pTree->result = motelResult_InvalidState;
+
+                return (FALSE);
+            }
+
+            /*
+            ** nodes shared among versions may be released by any thread, so they
+            ** come from the heap and are not charged against a maximum size, and
+            ** are never changed in place by lock-free writers, grouped occurrence
+            ** lists or rebuilds
+            */
+
+            if (NULL != pTree->pool || 0 != pTree->maximumSize || pTree->concurrent || pTree->groupDuplicates ||
+                motelTreeBalanceMode_Rebuild == pTree->balance.mode)
+            {
+                pTree->result = motelResult_Incompatible;
+
+                return (FALSE);
+            }
+
+#if defined COMPACT_TREE_NODES
+
+            /*
+            ** a compact tree's nodes are linked within its own arena, so they
+            ** cannot be shared with the versions' trees
+            */
+
+            pTree->result = motelResult_Incompatible;
+
+            return (FALSE);
+
+#endif
+
+            pTree->persistent = * (boolean *) pValue;
+
+            /*
+            ** a persistent node's reference count and owner follow its data, and
+            ** the tree's own parentless setting returns with persistence turned off
+            */
+
+            if (pTree->persistent)
+            {
+                pTree->persistentParentless = pTree->parentless;
+                pTree->parentless = TRUE;
+
+                pTree->version = AtomicIncrement(&gPersistentVersions);
+
+                pTree->nodeSize = TreeNodeSize + AlignedNodeSize(pTree->keySize) + AlignedNodeSize(pTree->dataSize) + 2 * AlignedNodeSize(sizeof(motelAtomic));
+            }
+            else
+            {
+                pTree->parentless = pTree->persistentParentless;
+
+                pTree->version = 0;
+
+                pTree->nodeSize = TreeNodeSize + AlignedNodeSize(pTree->keySize) + AlignedNodeSize(pTree->dataSize);
+            }
+
+            return (TRUE);
+
+        case motelTreeMember_LogCommit:
+
+            if (1 > * (unsigned long *) pValue)
+            {
+                pTree->result = motelResult_InvalidValue;
+
+                return (FALSE);
+            }
+
+            pTree->logCommitRecords = * (unsigned long *) pValue;
+
+            return (TRUE);
+
+        case motelTreeMember_LogInterval:
+
+            pTree->logCommitMilliseconds = * (unsigned long *) pValue;
+
+            return (TRUE);
+
+        case motelTreeMember_LogCheckpoint:
+
+            pTree->logCheckpointRecords = * (unsigned long *) pValue;
+
+            return (TRUE);
+
+        case motelTreeMember_Statistics:
+
+#if defined TREE_STATISTICS
+
+            pTree->statistics = * (motelTreeStatistics *) pValue;
+
+            return (TRUE);
+
+#else
+
+            pTree->result = motelResult_Unimplemented;
+
+            return (FALSE);
+
+#endif
+    }
+
+    pTree->result = motelResult_InvalidMember;
+
+    return (FALSE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetTreeMember
+(
+    motelTreeHandle pTree,
+    motelTreeMember pMember,
+    void * pValue
+)
+{
+    motelTreeNodeHandle lRoot;
+
+    /*
+    ** there is no tree object
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** no return parameter
+    */
+
+    if (NULL == pValue)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** result code is a special case because we want to set a result code for GetTreeMember()
+    */
+
+    if (motelTreeMember_Result == pMember)
+    {
+        * (motelResult *) pValue = pTree->result;
+
+        return (TRUE);
+    }
+
+    /*
+    ** get member
+    */
+
+    pTree->result = motelResult_OK;
+
+    switch (pMember)
+    {
+        case motelTreeMember_Size:
+
+            * (size_t *) pValue = pTree->size;
+
+            return (TRUE);
+
+        case motelTreeMember_Nodes:
+
+            lRoot = TreeRoot(pTree);
+
+            if (NULL == lRoot)
+            {
+                * (unsigned long *) pValue = 0L;
+            }
+            else
+            {
+                * (unsigned long *) pValue = lRoot->lesserNullNodes + lRoot->greaterNullNodes - 1L;
+            }
+
+            return (TRUE);
+
+        case motelTreeMember_LevelCount:
+
+            * (unsigned long *) pValue = GetTreeLevelCount(pTree);
+
+            return (TRUE);
+
+        case motelTreeMember_ExactLevelCount:
+
+            * (unsigned long *) pValue = GetSubtreeLevelCount(pTree, TreeRoot(pTree));
+
+            /*
+            ** the count is the tightest bound the tree can keep
+            */
+
+            pTree->levels = * (unsigned long *) pValue;
+
+            return (TRUE);
+
+        case motelTreeMember_MemoryPool:
+
+            if (NULL == pTree->pool)
+            {
+                * (size_t *) pValue = 0;
+            }
+            else
+            {
+                GetPoolMember(pTree->pool, motelPoolMember_BlockSize, pValue);
+            }
+
+            return (TRUE);
+
+        case motelTreeMember_KeyType:
+
+            * (motelTreeKeyType *) pValue = pTree->keyType;
+
+            return (TRUE);
+
+        case motelTreeMember_Concurrent:
+
+            * (boolean *) pValue = pTree->concurrent;
+
+            return (TRUE);
+
+        case motelTreeMember_TeardownThreads:
+
+            * (unsigned long *) pValue = pTree->teardownThreads;
+
+            return (TRUE);
+
+        case motelTreeMember_CombineThreads:
+
+            * (unsigned long *) pValue = pTree->combineThreads;
+
+            return (TRUE);
+
+        case motelTreeMember_ValidateThreads:
+
+            * (unsigned long *) pValue = pTree->validateThreads;
+
+            return (TRUE);
+
+        case motelTreeMember_Parentless:
+
+            * (boolean *) pValue = pTree->parentless;
+
+            return (TRUE);
+
+        case motelTreeMember_GroupDuplicates:
+
+            * (boolean *) pValue = pTree->groupDuplicates;
+
+            return (TRUE);
+
+        case motelTreeMember_Balance:
+
+            * (motelTreeBalance *) pValue = pTree->balance;
+
+            return (TRUE);
+
+        case motelTreeMember_Persistent:
+
+            * (boolean *) pValue = pTree->persistent;
+
+            return (TRUE);
+
+        case motelTreeMember_LogCommit:
+
+            * (unsigned long *) pValue = pTree->logCommitRecords;
+
+            return (TRUE);
+
+        case motelTreeMember_LogInterval:
+
+            * (unsigned long *) pValue = pTree->logCommitMilliseconds;
+
+            return (TRUE);
+
+        case motelTreeMember_LogCheckpoint:
+
+            * (unsigned long *) pValue = pTree->logCheckpointRecords;
+
+            return (TRUE);
+
+        case motelTreeMember_Statistics:
+
+#if defined TREE_STATISTICS
+
+            * (motelTreeStatistics *) pValue = pTree->statistics;
+
+            return (TRUE);
+
+#else
+
+            pTree->result = motelResult_Unimplemented;
+
+            return (FALSE);
+
+#endif
+    }
+
+    pTree->result = motelResult_InvalidMember;
+
+    return (FALSE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION InsertTreeNode
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKey
+)
+{
+    motelTreeNodeHandle lInsertNode;
+
+    motelTreeNodeHandle lNode;
+
+    motelTreeLink * lRebuildLink;
+
+    unsigned long lDepth;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** there is no data object
+    */
+
+    if (NULL == pData)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there is no key object
+    */
+
+    if (NULL == pKey)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** a logged tree makes no change that its log cannot hold
+    */
+
+    if (NULL != pTree->log && pTree->log->failed)
+    {
+        pTree->result = motelResult_Writing;
+
+        return (FALSE);
+    }
+
+    /*
+    ** a key already within a tree that groups duplicates gains an occurrence
+    ** rather than a node (every grouped node is its key's first instance)
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        lNode = FindEqualNode(pTree, (const void *) pKey, 1);
+
+        if (NULL != lNode)
+        {
+            if (!AddOccurrence(pTree, lNode, pData))
+            {
+                return (FALSE); // pass through result code
+            }
+
+            pTree->cursor = lNode;
+            pTree->occurrence = NodeOccurrences(pTree, lNode)->count - 1;
+
+            return (TRUE);
+        }
+    }
+
+    /*
+    ** a persistent tree copies the nodes it will change that other versions share
+    */
+
+    if (pTree->persistent && !OwnKeyPath(pTree, (const void *) pKey))
+    {
+        return (FALSE); // pass through result code
+    }
+
+#if defined COMPACT_TREE_NODES
+
+    /*
+    ** a compact node's instance cannot follow one already holding the
+    ** greatest 32-bit count
+    */
+
+    if (MAXIMUM_COMPACT_INSTANCE == pTree->greatestInstance && NULL != FindEqualNode(pTree, (const void *) pKey, MAXIMUM_COMPACT_INSTANCE))
+    {
+        pTree->result = motelResult_MaximumSize;
+
+        return (FALSE);
+    }
+
+#endif
+
+    /*
+    ** construct a new node
+    */
+
+    if (!ConstructNode(pTree, pKey, pData, &lInsertNode))
+    {
+        return (FALSE); // pass through result code
+    }
+
+    /*
+    ** set the new node as the current node
+    */
+
+    pTree->cursor = lInsertNode;
+
+    SetCursorOccurrence(pTree, FALSE);
+
+    /*
+    ** add a root node when the tree is empty
+    */
+
+    lNode = TreeRoot(pTree);
+
+    if (NULL == lNode)
+    {
+        SetTreeRoot(pTree, lInsertNode);
+
+        pTree->levels = 1;
+        pTree->levelScale = LevelScale(pTree->balance.numerator, pTree->balance.denominator);
+
+        CountTreeDescent(pTree, 0);
+
+        if (NULL != pTree->log)
+        {
+            FillLogRecord(pTree, motelTreeLogOperation_Insert, NodeKey(lInsertNode), lInsertNode->instance, NodeData(pTree, lInsertNode));
+
+            return (AppendLogRecord(pTree)); // pass through result code
+        }
+
+        return (TRUE);
+    }
+
+    /*
+    ** descend to the insertion point with the comparison of the tree's key
+    ** type expanded in place
+    */
+
+    lRebuildLink = (motelTreeLink *) NULL;
+
+    switch (pTree->keyType)
+    {
+        case motelTreeKeyType_Signed32:
+
+            lDepth = DescendInsertNode(pTree, lInsertNode, &lRebuildLink, motelTreeKeyType_Signed32);
+            break;
+
+        case motelTreeKeyType_Unsigned32:
+
+            lDepth = DescendInsertNode(pTree, lInsertNode, &lRebuildLink, motelTreeKeyType_Unsigned32);
+            break;
+
+        case motelTreeKeyType_Signed64:
+
+            lDepth = DescendInsertNode(pTree, lInsertNode, &lRebuildLink, motelTreeKeyType_Signed64);
+            break;
+
+        case motelTreeKeyType_Unsigned64:
+
+            lDepth = DescendInsertNode(pTree, lInsertNode, &lRebuildLink, motelTreeKeyType_Unsigned64);
+            break;
+
+        case motelTreeKeyType_Bytes:
+
+            lDepth = DescendInsertNode(pTree, lInsertNode, &lRebuildLink, motelTreeKeyType_Bytes);
+            break;
+
+        default:
+
+            lDepth = DescendInsertNode(pTree, lInsertNode, &lRebuildLink, motelTreeKeyType_Custom);
+            break;
+    }
+
+    CountTreeDescent(pTree, lDepth);
+
+#if defined COMPACT_TREE_NODES
+
+    if (pTree->greatestInstance < lInsertNode->instance)
+    {
+        pTree->greatestInstance = lInsertNode->instance;
+    }
+
+#endif
+
+    /*
+    ** the new node is a level below the last node passed
+    */
+
+    if (pTree->levels <= lDepth)
+    {
+        pTree->levels = lDepth + 1;
+    }
+
+    if (NULL != lRebuildLink)
+    {
+        CountTreeStatistic(pTree, insertRebuilds, 1);
+
+        RestoreSubtreeBalance(pTree, lRebuildLink);
+    }
+
+    /*
+    ** log the insertion once it has been made
+    */
+
+    if (NULL != pTree->log)
+    {
+        FillLogRecord(pTree, motelTreeLogOperation_Insert, NodeKey(lInsertNode), lInsertNode->instance, NodeData(pTree, lInsertNode));
+
+        return (AppendLogRecord(pTree)); // pass through result code
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION BulkLoadTree
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKeys,
+    unsigned long pCount
+)
+{
+    motelTreeLoad lLoad;
+
+    motelTreeNodeHandle lRoot;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** there are no data or key objects
+    */
+
+    if (NULL == pData || NULL == pKeys)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** a load constructs a node for every key object, equal or not, and is
+    ** not logged (a logged tree is loaded before LogTree() checkpoints it)
+    */
+
+    if (pTree->groupDuplicates || NULL != pTree->log)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** loading is only possible into an empty tree
+    */
+
+    if (NULL != TreeRoot(pTree))
+    {
+        pTree->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    /*
+    ** build the tree in key order
+    */
+
+    lLoad.data = (byte *) pData;
+    lLoad.keys = (byte *) pKeys;
+
+    lLoad.dataStride = pTree->dataSize;
+    lLoad.keyStride = pTree->keySize;
+
+    lLoad.instances = (byte *) NULL;
+    lLoad.instanceStride = 0;
+
+    lLoad.previous = (motelTreeNodeHandle) NULL;
+
+    if (!LoadSubtree(pTree, &lLoad, pCount, &lRoot))
+    {
+        return (FALSE); // pass through result code
+    }
+
+    SetTreeRoot(pTree, lRoot);
+    pTree->levels = GetLoadedLevelCount(pCount);
+
+    pTree->cursor = (motelTreeNodeHandle) NULL;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION InsertTreeNodes
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKeys,
+    unsigned long pCount
+)
+{
+    motelTreeNodeHandle * lNodes = (motelTreeNodeHandle *) NULL;
+    motelTreeNodeHandle * lScratch = (motelTreeNodeHandle *) NULL;
+
+    unsigned long lIndex;
+
+    motelResult lResult;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** there are no data or key objects
+    */
+
+    if (NULL == pData || NULL == pKeys)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** a batch constructs a node for every key object, equal or not, its
+    ** merge rebuilds subtrees that persistent versions may share, and it is
+    ** not logged
+    */
+
+    if (pTree->groupDuplicates || pTree->persistent || NULL != pTree->log)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there are no nodes to insert
+    */
+
+    if (0 == pCount)
+    {
+        return (TRUE);
+    }
+
+#if defined COMPACT_TREE_NODES
+
+    /*
+    ** each new node's instance may follow the greatest a node has held
+    */
+
+    if (MAXIMUM_COMPACT_INSTANCE - pTree->greatestInstance < pCount)
+    {
+        pTree->result = motelResult_MaximumSize;
+
+        return (FALSE);
+    }
+
+#endif
+
+    /*
+    ** the nodes are ordered through an array of their handles
+    */
+
+    if (!SafeMallocBlock((void **) &lNodes, pCount * sizeof(motelTreeNodeHandle)) ||
+        !SafeMallocBlock((void **) &lScratch, pCount * sizeof(motelTreeNodeHandle)))
+    {
+        SafeFreeBlock((void **) &lNodes);
+
+        pTree->result = motelResult_MemoryAllocation;
+
+        return (FALSE);
+    }
+
+    /*
+    ** construct every node before the tree is touched so that a failure leaves it unchanged
+    */
+
+    for (lIndex = 0; lIndex < pCount; lIndex++)
+    {
+        if (!ConstructNode(pTree, (void *) ((byte *) pKeys + lIndex * pTree->keySize), (void *) ((byte *) pData + lIndex * pTree->dataSize), &lNodes[lIndex]))
+        {
+            lResult = pTree->result;
+
+            while (0 < lIndex)
+            {
+                DestructNode(pTree, lNodes[--lIndex]);
+            }
+
+            SafeFreeBlock((void **) &lNodes);
+            SafeFreeBlock((void **) &lScratch);
+
+            pTree->result = lResult;
+
+            return (FALSE);
+        }
+    }
+
+    SortNodes(pTree, lNodes, lScratch, pCount);
+
+    /*
+    ** merge the ordered nodes into the tree from the root down
+    */
+
+    MergeSubtree(pTree, &pTree->root, (motelTreeNodeHandle) NULL, (motelTreeNodeHandle) NULL, lNodes, pCount);
+
+    pTree->levels = GetTreeLevelBound(pTree);
+
+    pTree->cursor = (motelTreeNodeHandle) NULL;
+
+    SafeFreeBlock((void **) &lNodes);
+    SafeFreeBlock((void **) &lScratch);
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNode
+(
+    motelTreeHandle pTree,
+    void * pKey,
+    unsigned long pInstance
+)
+{
+    motelTreeNodeHandle lRoot;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    lRoot = TreeRoot(pTree);
+
+    if (NULL == lRoot)
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** every node of a tree that groups duplicates is its key's first instance,
+    ** with the requested instance found among the node's occurrences
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        pTree->cursor = GetEqualNode(pTree, (const void *) pKey, 1);
+
+        if (NULL != pTree->cursor)
+        {
+            pTree->occurrence = FindOccurrence(pTree, pTree->cursor, pInstance);
+
+            if (NodeOccurrences(pTree, pTree->cursor)->count == pTree->occurrence)
+            {
+                pTree->cursor = (motelTreeNodeHandle) NULL;
+            }
+        }
+    }
+    else
+    {
+        pTree->cursor = GetEqualNode(pTree, (const void *) pKey, pInstance);
+    }
+
+    if (NULL == pTree->cursor)
+    {
+        pTree->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNodes
+(
+    motelTreeHandle pTree,
+    void * pKeys,
+    unsigned long * pInstances,
+    unsigned long pCount,
+    void * pData,
+    boolean * pFound
+)
+{
+    motelTreeNodeHandle lNodes[SELECT_LANES];
+    unsigned long lIndexes[SELECT_LANES];
+
+    motelTreeNodeHandle lNode;
+
+    const void * lKey;
+    unsigned long lInstance;
+
+    unsigned long lLanes;
+    unsigned long lLane;
+    unsigned long lNext;
+
+    long lComparisonResult;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** there are no key objects or nowhere to report the lookups
+    */
+
+    if (NULL == pKeys || NULL == pFound)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the lanes copy the data held within the nodes themselves
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** start a descent in each lane
+    */
+
+    for (lLanes = 0, lNext = 0; lLanes < SELECT_LANES && lNext < pCount; lLanes++, lNext++)
+    {
+        lNodes[lLanes] = TreeRoot(pTree);
+        lIndexes[lLanes] = lNext;
+    }
+
+    /*
+    ** advance every lane one level per pass so that each lane's next node is
+    ** being fetched while the other lanes compare
+    */
+
+    while (0 < lLanes)
+    {
+        lLane = 0;
+
+        while (lLane < lLanes)
+        {
+            lNode = lNodes[lLane];
+
+            lKey = (const void *) ((byte *) pKeys + lIndexes[lLane] * pTree->keySize);
+            lInstance = (NULL == pInstances ? 0 : pInstances[lIndexes[lLane]]);
+
+            lComparisonResult = MORE_THAN;
+
+            if (NULL != lNode)
+            {
+                lComparisonResult = CompareKeys(pTree, lKey, NodeKey(lNode));
+
+                if (0 == lComparisonResult)
+                {
+                    if (0 == lInstance)
+                    {
+                        /*
+                        ** find the least instance of a potential duplicate
+                        */
+
+                        while (NULL != NodeLesser(pTree, lNode) && 0 == CompareKeys(pTree, lKey, NodeKey(NodeLesser(pTree, lNode))))
+                        {
+                            lNode = NodeLesser(pTree, lNode);
+                        }
+                    }
+                    else if (lInstance < lNode->instance)
+                    {
+                        lComparisonResult = LESS_THAN;
+                    }
+                    else if (lInstance > lNode->instance)
+                    {
+                        lComparisonResult = MORE_THAN;
+                    }
+                }
+
+                if (0 != lComparisonResult)
+                {
+                    lNode = (0 > lComparisonResult ? NodeLesser(pTree, lNode) : NodeGreater(pTree, lNode));
+
+                    if (NULL != lNode)
+                    {
+                        PrefetchMemory(lNode);
+
+                        lNodes[lLane] = lNode;
+
+                        lLane++;
+
+                        continue;
+                    }
+                }
+            }
+
+            /*
+            ** the descent is over, report its outcome
+            */
+
+            if (0 == lComparisonResult)
+            {
+                pFound[lIndexes[lLane]] = TRUE;
+
+                if (NULL != pData)
+                {
+                    memcpy((void *) ((byte *) pData + lIndexes[lLane] * pTree->dataSize), NodeData(pTree, lNode), pTree->dataSize);
+                }
+            }
+            else
+            {
+                pFound[lIndexes[lLane]] = FALSE;
+
+                pTree->result = motelResult_NotFound;
+            }
+
+            /*
+            ** start the next lookup in the lane or retire the lane
+            */
+
+            if (lNext < pCount)
+            {
+                lNodes[lLane] = TreeRoot(pTree);
+                lIndexes[lLane] = lNext++;
+
+                lLane++;
+            }
+            else
+            {
+                lLanes--;
+
+                lNodes[lLane] = lNodes[lLanes];
+                lIndexes[lLane] = lIndexes[lLanes];
+            }
+        }
+    }
+
+    return (motelResult_OK == pTree->result);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION FetchTreeNode
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+)
+{
+    motelTreeNodeHandle lFetchNode = (motelTreeNodeHandle) NULL;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there is no node to fetch
+    */
+
+    lFetchNode = pTree->cursor;
+
+    if (NULL == lFetchNode)
+    {
+        pTree->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** copy the data value
+    */
+
+    if (NULL != pData)
+    {
+        memcpy((void *)pData, GetCursorData(pTree), pTree->dataSize);
+    }
+
+    /*
+    ** copy the key value
+    */
+
+    if (NULL != pKey)
+    {
+        memcpy((void *)pKey, NodeKey(lFetchNode), pTree->keySize);
+    }
+
+    /*
+    ** copy the instance value
+    */
+
+    if (NULL != pInstance)
+    {
+        * pInstance = GetCursorInstance(pTree);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION UpdateTreeNode
+(
+    motelTreeHandle pTree,
+    void * pData
+)
+{
+    motelTreeNodeHandle lUpdateNode = (motelTreeNodeHandle) NULL;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there is no data to update the node
+    */
+
+    if (NULL == pData)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there is no node to update
+    */
+
+    lUpdateNode = pTree->cursor;
+
+    if (NULL == lUpdateNode)
+    {
+        pTree->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    /*
+    ** a logged tree makes no change that its log cannot hold
+    */
+
+    if (NULL != pTree->log && pTree->log->failed)
+    {
+        pTree->result = motelResult_Writing;
+
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** a persistent tree updates its own copy of a node that other versions share
+    */
+
+    if (pTree->persistent && !OwnNodePath(pTree, &lUpdateNode, FALSE))
+    {
+        return (FALSE); // pass through result code
+    }
+
+    /*
+    ** set the data value
+    */
+
+    memcpy(GetCursorData(pTree), (const void *)pData, pTree->dataSize);
+
+    if (NULL != pTree->log)
+    {
+        FillLogRecord(pTree, motelTreeLogOperation_Update, NodeKey(pTree->cursor), GetCursorInstance(pTree), (const void *) pData);
+
+        return (AppendLogRecord(pTree)); // pass through result code
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION DeleteTreeNode
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeNodeHandle lDeleteNode;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there is no node to delete
+    */
+
+    lDeleteNode = pTree->cursor;
+
+    if (NULL == lDeleteNode)
+    {
+        pTree->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    /*
+    ** a grouped key's node goes only with its last occurrence
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        return (RemoveOccurrence(pTree, lDeleteNode, pTree->occurrence));
+    }
+
+    if (NULL != pTree->log)
+    {
+        if (pTree->log->failed)
+        {
+            pTree->result = motelResult_Writing;
+
+            return (FALSE);
+        }
+
+        /*
+        ** the node's key object is recorded before the node is destructed
+        */
+
+        FillLogRecord(pTree, motelTreeLogOperation_Delete, NodeKey(lDeleteNode), lDeleteNode->instance, NULL);
+
+        if (!DeleteNode(pTree, lDeleteNode))
+        {
+            return (FALSE); // pass through result code
+        }
+
+        return (AppendLogRecord(pTree)); // pass through result code
+    }
+
+    return (DeleteNode(pTree, lDeleteNode));
+}
+  
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekLeastTreeNode
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** position the cursor
+    */
+
+    pTree->cursor = GetLeastNode(pTree);
+
+    SetCursorOccurrence(pTree, FALSE);
+
+    if (NULL == pTree->cursor)
+    {
+        return (FALSE); // pass through result code
+    }
+
+    /*
+    ** copy the data value
+    */
+
+    if (NULL != pData)
+    {
+        memcpy((void *)pData, GetCursorData(pTree), pTree->dataSize);
+    }
+
+    /*
+    ** copy the key value
+    */
+
+    if (NULL != pKey)
+    {
+        memcpy((void *)pKey, NodeKey(pTree->cursor), pTree->keySize);
+    }
+
+    /*
+    ** copy the instance value
+    */
+
+    if (NULL != pInstance)
+    {
+        * pInstance = GetCursorInstance(pTree);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekGreatestTreeNode
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** position the cursor
+    */
+
+    pTree->cursor = GetGreatestNode(pTree);
+
+    SetCursorOccurrence(pTree, TRUE);
+
+    if (NULL == pTree->cursor)
+    {
+        return (FALSE); // pass through result code
+    }
+
+    /*
+    ** copy the data value
+    */
+
+    if (NULL != pData)
+    {
+        memcpy((void *)pData, GetCursorData(pTree), pTree->dataSize);
+    }
+
+    /*
+    ** copy the key value
+    */
+
+    if (NULL != pKey)
+    {
+        memcpy((void *)pKey, NodeKey(pTree->cursor), pTree->keySize);
+    }
+
+    /*
+    ** copy the instance value
+    */
+
+    if (NULL != pInstance)
+    {
+        * pInstance = GetCursorInstance(pTree);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekLesserTreeNode
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** when the cursor is not set, move forward from the greatest node
+    */
+
+    if (NULL == pTree->cursor)
+    {
+        pTree->cursor = GetGreatestNode(pTree);
+
+        SetCursorOccurrence(pTree, TRUE);
+    }
+    else
+    {
+        pTree->cursor = GetLesserNode(pTree);
+    }
+
+    if (NULL == pTree->cursor)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** copy the data value
+    */
+
+    if (NULL != pData)
+    {
+        memcpy((void *)pData, GetCursorData(pTree), pTree->dataSize);
+    }
+
+    /*
+    ** copy the key value
+    */
+
+    if (NULL != pKey)
+    {
+        memcpy((void *)pKey, NodeKey(pTree->cursor), pTree->keySize);
+    }
+
+    /*
+    ** copy the instance value
+    */
+
+    if (NULL != pInstance)
+    {
+        * pInstance = GetCursorInstance(pTree);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekGreaterTreeNode
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** when the cursor is not set, move forward from the least node
+    */
+
+    if (NULL == pTree->cursor)
+    {
+        pTree->cursor = GetLeastNode(pTree);
+
+        SetCursorOccurrence(pTree, FALSE);
+    }
+    else
+    {
+        pTree->cursor = GetGreaterNode(pTree);
+    }
+
+    if (NULL == pTree->cursor)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** copy the data value
+    */
+
+    if (NULL != pData)
+    {
+        memcpy((void *)pData, GetCursorData(pTree), pTree->dataSize);
+    }
+
+    /*
+    ** copy the key value
+    */
+
+    if (NULL != pKey)
+    {
+        memcpy((void *)pKey, NodeKey(pTree->cursor), pTree->keySize);
+    }
+
+    /*
+    ** copy the instance value
+    */
+
+    if (NULL != pInstance)
+    {
+        * pInstance = GetCursorInstance(pTree);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNodeByRank
+(
+    motelTreeHandle pTree,
+    unsigned long pRank
+)
+{
+    motelTreeNodeHandle lRankNode;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** the weights of a tree that groups duplicates count keys rather than instances
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there is no node at the requested position
+    */
+
+    lRankNode = GetRankNode(pTree, pRank);
+
+    if (NULL == lRankNode)
+    {
+        pTree->result = motelResult_OutOfBounds;
+
+        return (FALSE);
+    }
+
+    pTree->cursor = lRankNode;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetTreeNodeRank
+(
+    motelTreeHandle pTree,
+    unsigned long * pRank
+)
+{
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lAncestor;
+
+    unsigned long lRank;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** no return parameter
+    */
+
+    if (NULL == pRank)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the weights of a tree that groups duplicates count keys rather than instances
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there is no node to rank
+    */
+
+    lNode = pTree->cursor;
+
+    if (NULL == lNode)
+    {
+        pTree->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** the rank of the node within its own subtree
+    */
+
+    lRank = lNode->lesserNullNodes;
+
+    /*
+    ** every ancestor reached through a greater branch precedes the node along
+    ** with its entire lesser branch
+    */
+
+    if (pTree->parentless)
+    {
+        for (lAncestor = TreeRoot(pTree); lNode != lAncestor; )
+        {
+            if (0 > NodeCompare(pTree, lNode, lAncestor))
+            {
+                lAncestor = NodeLesser(pTree, lAncestor);
+            }
+            else
+            {
+                lRank += lAncestor->lesserNullNodes;
+
+                lAncestor = NodeGreater(pTree, lAncestor);
+            }
+        }
+    }
+    else
+    {
+        while (NULL != NodeParent(pTree, lNode))
+        {
+            if (lNode == NodeGreater(pTree, NodeParent(pTree, lNode)))
+            {
+                lRank += NodeParent(pTree, lNode)->lesserNullNodes;
+            }
+
+            lNode = NodeParent(pTree, lNode);
+        }
+    }
+
+    * pRank = lRank;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION CountTreeNodesInKeyRange
+(
+    motelTreeHandle pTree,
+    void * pLeast,
+    void * pGreatest,
+    unsigned long * pCount
+)
+{
+    unsigned long lLesserNodes;
+    unsigned long lThroughNodes;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** no return parameter
+    */
+
+    if (NULL == pCount)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** the weights of a tree that groups duplicates count keys rather than instances
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        * pCount = 0;
+
+        return (TRUE);
+    }
+
+    /*
+    ** count the nodes preceding the range and the nodes through the end of the range
+    */
+
+    if (NULL == pLeast)
+    {
+        lLesserNodes = 0;
+    }
+    else
+    {
+        lLesserNodes = CountLesserNodes(pTree, (const void *) pLeast, FALSE);
+    }
+
+    if (NULL == pGreatest)
+    {
+        lThroughNodes = TreeRoot(pTree)->lesserNullNodes + TreeRoot(pTree)->greaterNullNodes - 1;
+    }
+    else
+    {
+        lThroughNodes = CountLesserNodes(pTree, (const void *) pGreatest, TRUE);
+    }
+
+    /*
+    ** an inverted range contains no nodes
+    */
+
+    if (lThroughNodes < lLesserNodes)
+    {
+        * pCount = 0;
+    }
+    else
+    {
+        * pCount = lThroughNodes - lLesserNodes;
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNodeLowerBound
+(
+    motelTreeHandle pTree,
+    void * pKey
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** there is no key
+    */
+
+    if (NULL == pKey)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    pTree->cursor = GetBoundNode(pTree, (const void *) pKey, TRUE);
+
+    SetCursorOccurrence(pTree, FALSE);
+
+    if (NULL == pTree->cursor)
+    {
+        return (FALSE); // pass through result code
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNodeUpperBound
+(
+    motelTreeHandle pTree,
+    void * pKey
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** there is no key
+    */
+
+    if (NULL == pKey)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        pTree->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    pTree->cursor = GetBoundNode(pTree, (const void *) pKey, FALSE);
+
+    SetCursorOccurrence(pTree, FALSE);
+
+    if (NULL == pTree->cursor)
+    {
+        return (FALSE); // pass through result code
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ScanTreeRange
+(
+    motelTreeHandle pTree,
+    void * pLeast,
+    void * pGreatest,
+    boolean (* pScanFunction)(void * pContext, const void * pKey, const void * pData, unsigned long pInstance),
+    void * pContext
+)
+{
+    motelTreeNodeHandle lNode;
+
+    motelTreePath lPath;
+
+    unsigned long lLesserNodes;
+    unsigned long lThroughNodes;
+
+    unsigned long lCount;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** lock-free readers must not disturb the tree
+    */
+
+    if (pTree->concurrent)
+    {
+        return (ScanConcurrentRange(pTree, (const void *) pLeast, (const void *) pGreatest, pScanFunction, pContext));
+    }
+
+    /*
+    ** there is no scan function
+    */
+
+    if (NULL == pScanFunction)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pTree))
+    {
+        return (TRUE);
+    }
+
+    /*
+    ** find the first node of the range and the number of nodes within it so
+    ** that the walk needs no further key comparisons
+    */
+
+    if (NULL == pLeast)
+    {
+        lNode = GetLeastNode(pTree);
+
+        lLesserNodes = 0;
+    }
+    else
+    {
+        lNode = GetBoundNode(pTree, (const void *) pLeast, TRUE);
+
+        lLesserNodes = CountLesserNodes(pTree, (const void *) pLeast, FALSE);
+    }
+
+    if (NULL == pGreatest)
+    {
+        lThroughNodes = TreeRoot(pTree)->lesserNullNodes + TreeRoot(pTree)->greaterNullNodes - 1;
+    }
+    else
+    {
+        lThroughNodes = CountLesserNodes(pTree, (const void *) pGreatest, TRUE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** an inverted range contains no nodes
+    */
+
+    if (lThroughNodes <= lLesserNodes)
+    {
+        return (TRUE);
+    }
+
+    /*
+    ** walk the range in key order until it is exhausted or the scan function
+    ** declines to continue
+    */
+
+    lCount = lThroughNodes - lLesserNodes;
+
+    SeekPath(pTree, &lPath, lNode);
+
+    while (NULL != lNode && 0 < lCount--)
+    {
+        if (pTree->groupDuplicates)
+        {
+            if (!ScanOccurrences(pTree, lNode, pScanFunction, pContext))
+            {
+                break;
+            }
+        }
+        else if (!pScanFunction(pContext, (const void *) NodeKey(lNode), (const void *) NodeData(pTree, lNode), lNode->instance))
+        {
+            break;
+        }
+
+        lNode = StepPathGreater(pTree, &lPath, lNode);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION LockTree
+(
+    motelTreeHandle pTree
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** only a concurrent tree has a lock
+    */
+
+    if (!pTree->concurrent)
+    {
+        pTree->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    AcquireLock(&pTree->lock);
+
+    /*
+    ** an odd write sequence number holds off lock-free readers
+    */
+
+    AtomicIncrement(&pTree->sequence);
+
+    pTree->result = motelResult_OK;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION UnlockTree
+(
+    motelTreeHandle pTree
+)
+{
+    boolean lReclaimed;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** only a concurrent tree has a lock
+    */
+
+    if (!pTree->concurrent)
+    {
+        pTree->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    /*
+    ** an even write sequence number releases lock-free readers
+    */
+
+    AtomicIncrement(&pTree->sequence);
+
+    /*
+    ** destruct any deleted nodes that lock-free readers can no longer reach
+    */
+
+    lReclaimed = ReclaimRetiredNodes(pTree, FALSE);
+
+    ReleaseLock(&pTree->lock);
+
+    return (lReclaimed);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReadTreeNode
+(
+    motelTreeHandle pTree,
+    void * pKey,
+    unsigned long pInstance,
+    void * pData
+)
+{
+    motelTreeNodeHandle lNode;
+
+    unsigned long lInstance;
+    unsigned long lEpoch;
+    unsigned long lSequence;
+
+    boolean lFound;
+
+    /*
+    ** there is no tree or key
+    */
+
+    if (NULL == pTree || NULL == pKey)
+    {
+        return (FALSE);
+    }
+
+    lEpoch = EnterTreeEpoch(pTree);
+
+    for (;;)
+    {
+        lSequence = BeginTreeRead(pTree);
+
+        /*
+        ** find the least node at or after the requested instance
+        */
+
+        if (!ReadBoundNode(pTree, (const void *) pKey, (0 == pInstance) ? 0 : pInstance - 1, lSequence, &lNode))
+        {
+            continue;
+        }
+
+        lFound = NULL != lNode && 0 == CompareReadKeys(pTree, (const void *) pKey, NodeKey(lNode));
+
+        if (lFound)
+        {
+            CopyReadNode(pTree, lNode, NULL, pData, &lInstance);
+
+            lFound = 0 == pInstance || pInstance == lInstance;
+        }
+
+        /*
+        ** repeat the read when a writer intervened
+        */
+
+        if (EndTreeRead(pTree, lSequence))
+        {
+            break;
+        }
+    }
+
+    ExitTreeEpoch(pTree, lEpoch);
+
+    return (lFound);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ConstructTreeCursor
+(
+    motelTreeCursorHandle * pCursor,
+    motelTreeHandle pTree
+)
+{
+    /*
+    ** there is no cursor handle
+    */
+
+    if (NULL == pCursor)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** registered cursors do not track the occurrences of grouped keys
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** allocate the cursor control structure
+    */
+
+    if (!SafeMallocBlock((void **) pCursor, sizeof(motelTreeCursor)))
+    {
+        pTree->result = motelResult_MemoryAllocation;
+
+        return (FALSE);
+    }
+
+    /*
+    ** initialize the cursor control structure
+    */
+
+    (* pCursor)->result = motelResult_OK;
+
+    (* pCursor)->tree = pTree;
+
+    (* pCursor)->node = (motelTreeNodeHandle) NULL;
+
+    /*
+    ** register the cursor with the tree so that node deletions can reach it
+    */
+
+    (* pCursor)->next = pTree->cursors;
+
+    pTree->cursors = * pCursor;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION DestructTreeCursor
+(
+    motelTreeCursorHandle * pCursor
+)
+{
+    motelTreeCursorHandle * lLink;
+
+    /*
+    ** there is no cursor
+    */
+
+    if (NULL == pCursor || NULL == * pCursor)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** unregister the cursor from its tree
+    */
+
+    if (NULL != (* pCursor)->tree)
+    {
+        for (lLink = &(* pCursor)->tree->cursors; NULL != * lLink; lLink = &(* lLink)->next)
+        {
+            if (* pCursor == * lLink)
+            {
+                * lLink = (* pCursor)->next;
+
+                break;
+            }
+        }
+    }
+
+    if (!SafeFreeBlock((void **) pCursor))
+    {
+        (* pCursor)->result = motelResult_MemoryDeallocation;
+
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeCursorNode
+(
+    motelTreeCursorHandle pCursor,
+    void * pKey,
+    unsigned long pInstance
+)
+{
+    /*
+    ** there is no cursor
+    */
+
+    if (NULL == pCursor)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree has been destructed out from under the cursor
+    */
+
+    if (NULL == pCursor->tree)
+    {
+        pCursor->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pCursor->tree))
+    {
+        pCursor->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    pCursor->result = motelResult_OK;
+
+    pCursor->node = FindEqualNode(pCursor->tree, (const void *) pKey, pInstance);
+
+    if (NULL == pCursor->node)
+    {
+        pCursor->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION FetchTreeCursorNode
+(
+    motelTreeCursorHandle pCursor,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+)
+{
+    /*
+    ** there is no cursor
+    */
+
+    if (NULL == pCursor)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree has been destructed out from under the cursor
+    */
+
+    if (NULL == pCursor->tree)
+    {
+        pCursor->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pCursor->tree))
+    {
+        pCursor->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there is no node to fetch
+    */
+
+    if (NULL == pCursor->node)
+    {
+        pCursor->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    pCursor->result = motelResult_OK;
+
+    /*
+    ** copy the data value
+    */
+
+    if (NULL != pData)
+    {
+        memcpy((void *)pData, NodeData(pCursor->tree, pCursor->node), pCursor->tree->dataSize);
+    }
+
+    /*
+    ** copy the key value
+    */
+
+    if (NULL != pKey)
+    {
+        memcpy((void *)pKey, NodeKey(pCursor->node), pCursor->tree->keySize);
+    }
+
+    /*
+    ** copy the instance value
+    */
+
+    if (NULL != pInstance)
+    {
+        * pInstance = pCursor->node->instance;
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekLesserTreeCursorNode
+(
+    motelTreeCursorHandle pCursor,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+)
+{
+    motelTreeNodeHandle lNode;
+
+    /*
+    ** there is no cursor
+    */
+
+    if (NULL == pCursor)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree has been destructed out from under the cursor
+    */
+
+    if (NULL == pCursor->tree)
+    {
+        pCursor->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pCursor->tree))
+    {
+        pCursor->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** when the cursor is not set, move backward from the greatest node
+    */
+
+    if (NULL == pCursor->node)
+    {
+        for (lNode = TreeRoot(pCursor->tree); NULL != NodeGreater(pCursor->tree, lNode); lNode = NodeGreater(pCursor->tree, lNode));
+    }
+    else
+    {
+        lNode = SeekLesserNode(pCursor->tree, pCursor->node);
+    }
+
+    pCursor->node = lNode;
+
+    if (NULL == pCursor->node)
+    {
+        pCursor->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    pCursor->result = motelResult_OK;
+
+    /*
+    ** copy the data value
+    */
+
+    if (NULL != pData)
+    {
+        memcpy((void *)pData, NodeData(pCursor->tree, pCursor->node), pCursor->tree->dataSize);
+    }
+
+    /*
+    ** copy the key value
+    */
+
+    if (NULL != pKey)
+    {
+        memcpy((void *)pKey, NodeKey(pCursor->node), pCursor->tree->keySize);
+    }
+
+    /*
+    ** copy the instance value
+    */
+
+    if (NULL != pInstance)
+    {
+        * pInstance = pCursor->node->instance;
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekGreaterTreeCursorNode
+(
+    motelTreeCursorHandle pCursor,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+)
+{
+    motelTreeNodeHandle lNode;
+
+    /*
+    ** there is no cursor
+    */
+
+    if (NULL == pCursor)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree has been destructed out from under the cursor
+    */
+
+    if (NULL == pCursor->tree)
+    {
+        pCursor->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pCursor->tree))
+    {
+        pCursor->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** when the cursor is not set, move forward from the least node
+    */
+
+    if (NULL == pCursor->node)
+    {
+        for (lNode = TreeRoot(pCursor->tree); NULL != NodeLesser(pCursor->tree, lNode); lNode = NodeLesser(pCursor->tree, lNode));
+    }
+    else
+    {
+        lNode = SeekGreaterNode(pCursor->tree, pCursor->node);
+    }
+
+    pCursor->node = lNode;
+
+    if (NULL == pCursor->node)
+    {
+        pCursor->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    pCursor->result = motelResult_OK;
+
+    /*
+    ** copy the data value
+    */
+
+    if (NULL != pData)
+    {
+        memcpy((void *)pData, NodeData(pCursor->tree, pCursor->node), pCursor->tree->dataSize);
+    }
+
+    /*
+    ** copy the key value
+    */
+
+    if (NULL != pKey)
+    {
+        memcpy((void *)pKey, NodeKey(pCursor->node), pCursor->tree->keySize);
+    }
+
+    /*
+    ** copy the instance value
+    */
+
+    if (NULL != pInstance)
+    {
+        * pInstance = pCursor->node->instance;
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION DeleteTreeCursorNode
+(
+    motelTreeCursorHandle pCursor
+)
+{
+    /*
+    ** there is no cursor
+    */
+
+    if (NULL == pCursor)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** the tree has been destructed out from under the cursor
+    */
+
+    if (NULL == pCursor->tree)
+    {
+        pCursor->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is empty
+    */
+
+    if (NULL == TreeRoot(pCursor->tree))
+    {
+        pCursor->result = motelResult_NoNode;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there is no node to delete
+    */
+
+    if (NULL == pCursor->node)
+    {
+        pCursor->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    /*
+    ** a logged tree makes no change that its log cannot hold
+    */
+
+    if (NULL != pCursor->tree->log && pCursor->tree->log->failed)
+    {
+        pCursor->result = motelResult_Writing;
+
+        return (FALSE);
+    }
+
+    if (NULL != pCursor->tree->log)
+    {
+        FillLogRecord(pCursor->tree, motelTreeLogOperation_Delete, NodeKey(pCursor->node), pCursor->node->instance, NULL);
+    }
+
+    /*
+    ** the deletion clears every cursor on the node, including this one
+    */
+
+    if (!DeleteNode(pCursor->tree, pCursor->node))
+    {
+        pCursor->result = pCursor->tree->result;
+
+        return (FALSE);
+    }
+
+    if (NULL != pCursor->tree->log && !AppendLogRecord(pCursor->tree))
+    {
+        pCursor->result = pCursor->tree->result;
+
+        return (FALSE);
+    }
+
+    pCursor->result = motelResult_OK;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SplitTree
+(
+    motelTreeHandle pTree,
+    void * pKey,
+    motelTreeHandle * pLesser,
+    motelTreeHandle * pGreater
+)
+{
+    motelTreeNodeHandle lRoot;
+
+    motelTreeNodeHandle lLesser;
+    motelTreeNodeHandle lGreater;
+
+    unsigned long lComparisons;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** there is no key object or no place for the new trees
+    */
+
+    if (NULL == pKey || NULL == pLesser || NULL == pGreater)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+#if defined COMPACT_TREE_NODES
+
+    /*
+    ** a compact tree's nodes are linked within its own arena, so they cannot
+    ** move to another tree
+    */
+
+    pTree->result = motelResult_Incompatible;
+
+    return (FALSE);
+
+#endif
+
+    /*
+    ** the nodes of a memory pool cannot leave it, a concurrent tree's nodes may be in use by readers,
+    ** a persistent tree's nodes may be shared with its versions and a logged tree's nodes cannot
+    ** leave it unlogged
+    */
+
+    if (NULL != pTree->pool || pTree->concurrent || pTree->persistent || pTree->groupDuplicates || NULL != pTree->log)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** construct the new trees alike to the tree
+    */
+
+    if (!ConstructTree(pLesser, pTree->maximumSize, pTree->dataSize, pTree->keySize, pTree->compareKeyFunction))
+    {
+        pTree->result = motelResult_MemoryAllocation;
+
+        return (FALSE);
+    }
+
+    if (!ConstructTree(pGreater, pTree->maximumSize, pTree->dataSize, pTree->keySize, pTree->compareKeyFunction))
+    {
+        DestructTree(pLesser);
+
+        pTree->result = motelResult_MemoryAllocation;
+
+        return (FALSE);
+    }
+
+    (* pLesser)->keyType = pTree->keyType;
+    (* pGreater)->keyType = pTree->keyType;
+
+    (* pLesser)->parentless = pTree->parentless;
+    (* pGreater)->parentless = pTree->parentless;
+
+    (* pLesser)->balance = pTree->balance;
+    (* pGreater)->balance = pTree->balance;
+
+    (* pLesser)->levelScale = pTree->levelScale;
+    (* pGreater)->levelScale = pTree->levelScale;
+
+    (* pLesser)->teardownThreads = pTree->teardownThreads;
+    (* pGreater)->teardownThreads = pTree->teardownThreads;
+
+    (* pLesser)->combineThreads = pTree->combineThreads;
+    (* pGreater)->combineThreads = pTree->combineThreads;
+
+    (* pLesser)->validateThreads = pTree->validateThreads;
+    (* pGreater)->validateThreads = pTree->validateThreads;
+
+    /*
+    ** divide the nodes about the key object, those with an equal key value going to the greater tree
+    */
+
+    lRoot = TreeRoot(pTree);
+
+    SetTreeRoot(pTree, (motelTreeNodeHandle) NULL);
+    pTree->levels = 0;
+
+    lComparisons = SplitSubtree(pTree, lRoot, (const void *) pKey, FALSE, &lLesser, &lGreater);
+
+    CountTreeStatistic(pTree, comparisons, lComparisons);
+
+    SetTreeRoot(* pLesser, lLesser);
+    (* pLesser)->levels = GetTreeLevelBound(* pLesser);
+    (* pLesser)->size += (SubtreeNullNodes(lLesser) - 1) * pTree->nodeSize;
+
+    SetTreeRoot(* pGreater, lGreater);
+    (* pGreater)->levels = GetTreeLevelBound(* pGreater);
+    (* pGreater)->size += (SubtreeNullNodes(lGreater) - 1) * pTree->nodeSize;
+
+    pTree->size = sizeof(motelTree);
+
+    ClearTreeCursors(pTree);
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION JoinTrees
+(
+    motelTreeHandle pLesser,
+    motelTreeHandle pGreater
+)
+{
+    motelTreeNodeHandle lGreatest;
+    motelTreeNodeHandle lLeast;
+    motelTreeNodeHandle lNode;
+
+    motelTreeNodeHandle lLesser;
+    motelTreeNodeHandle lGreater;
+
+    size_t lSize;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pLesser)
+    {
+        return (FALSE);
+    }
+
+    pLesser->result = motelResult_OK;
+
+    if (NULL == pGreater)
+    {
+        pLesser->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+#if defined COMPACT_TREE_NODES
+
+    /*
+    ** a compact tree's nodes are linked within its own arena, so they cannot
+    ** move to another tree
+    */
+
+    pLesser->result = motelResult_Incompatible;
+
+    return (FALSE);
+
+#endif
+
+    /*
+    ** the trees must be distinct and hold alike nodes ordered alike, whose parent links are kept alike
+    */
+
+    if (pLesser == pGreater ||
+        pLesser->keySize != pGreater->keySize || pLesser->dataSize != pGreater->dataSize ||
+        pLesser->keyType != pGreater->keyType || pLesser->compareKeyFunction != pGreater->compareKeyFunction ||
+        pLesser->parentless != pGreater->parentless)
+    {
+        pLesser->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the nodes of a memory pool cannot leave it, a concurrent tree's nodes may be in use by readers,
+    ** a persistent tree's nodes may be shared with its versions and a logged tree's nodes cannot
+    ** arrive or leave unlogged
+    */
+
+    if (NULL != pLesser->pool || NULL != pGreater->pool || pLesser->concurrent || pGreater->concurrent || pLesser->persistent || pGreater->persistent ||
+        pLesser->groupDuplicates || pGreater->groupDuplicates || NULL != pLesser->log || NULL != pGreater->log)
+    {
+        pLesser->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** there are no nodes to join
+    */
+
+    lGreater = TreeRoot(pGreater);
+
+    if (NULL == lGreater)
+    {
+        return (TRUE);
+    }
+
+    /*
+    ** the tree must be able to hold the joined nodes
+    */
+
+    lSize = (SubtreeNullNodes(lGreater) - 1) * pGreater->nodeSize;
+
+    if (pLesser->maximumSize > 0 && pLesser->maximumSize < pLesser->size + lSize)
+    {
+        pLesser->result = motelResult_MaximumSize;
+
+        return (FALSE);
+    }
+
+    lLesser = TreeRoot(pLesser);
+
+    if (NULL != lLesser)
+    {
+        /*
+        ** every key object of the greater tree must follow those of the lesser tree
+        */
+
+        for (lGreatest = lLesser; NULL != NodeGreater(pLesser, lGreatest); lGreatest = NodeGreater(pLesser, lGreatest));
+        for (lLeast = lGreater; NULL != NodeLesser(pGreater, lLeast); lLeast = NodeLesser(pGreater, lLeast));
+
+        if (0 > CompareKeys(pLesser, NodeKey(lLeast), NodeKey(lGreatest)))
+        {
+            pLesser->result = motelResult_InvalidValue;
+
+            return (FALSE);
+        }
+
+        /*
+        ** duplicates of the greatest key value continue its instance numbering
+        */
+
+        OffsetLeastInstances(pLesser, lGreater, NodeKey(lGreatest), lGreatest->instance);
+
+        /*
+        ** the least node of the greater tree becomes the joining node
+        */
+
+        lNode = UnlinkLeastNode(pGreater, &lGreater);
+
+        SetTreeRoot(pLesser, (motelTreeNodeHandle) NULL);
+
+        lLesser = JoinSubtrees(pLesser, lLesser, lNode, lGreater);
+    }
+    else
+    {
+        lLesser = lGreater;
+    }
+
+    /*
+    ** move the nodes from the greater tree
+    */
+
+    SetTreeRoot(pLesser, lLesser);
+    pLesser->size += lSize;
+
+    if (pLesser->levelScale < pGreater->levelScale)
+    {
+        pLesser->levelScale = pGreater->levelScale;
+    }
+
+    pLesser->levels = GetTreeLevelBound(pLesser);
+
+    pLesser->cursor = (motelTreeNodeHandle) NULL;
+
+    SetTreeRoot(pGreater, (motelTreeNodeHandle) NULL);
+    pGreater->levels = 0;
+    pGreater->size -= lSize;
+
+    ClearTreeCursors(pGreater);
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION UnionTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther
+)
+{
+    return (CombineTrees(pTree, pOther, motelTreeCombination_Union)); // pass through result code
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION IntersectTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther
+)
+{
+    return (CombineTrees(pTree, pOther, motelTreeCombination_Intersection)); // pass through result code
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION DifferenceTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther
+)
+{
+    return (CombineTrees(pTree, pOther, motelTreeCombination_Difference)); // pass through result code
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SnapshotTree
+(
+    motelTreeHandle pTree,
+    motelTreeHandle * pVersion
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** there is no version handle
+    */
+
+    if (NULL == pVersion)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** only a persistent tree's nodes may be shared
+    */
+
+    if (!pTree->persistent)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the version is a tree of its own that shares the tree's root
+    */
+
+    if (!SafeMallocBlock((void **) pVersion, sizeof(motelTree)))
+    {
+        pTree->result = motelResult_MemoryAllocation;
+
+        return (FALSE);
+    }
+
+    memcpy((void *) * pVersion, (const void *) pTree, sizeof(motelTree));
+
+    (* pVersion)->result = motelResult_OK;
+
+    /*
+    ** the version shares the tree's nodes, each still charged to the version
+    ** that constructed it
+    */
+
+    (* pVersion)->size = sizeof(motelTree);
+
+    (* pVersion)->version = AtomicIncrement(&gPersistentVersions);
+
+    (* pVersion)->cursor = (motelTreeNodeHandle) NULL;
+
+    (* pVersion)->cursors = (motelTreeCursorHandle) NULL;
+
+    (* pVersion)->occurrence = 0;
+
+    (* pVersion)->log = (motelTreeLogHandle) NULL;
+
+#if defined TREE_STATISTICS
+
+    memset((void *) &(* pVersion)->statistics, 0, sizeof(motelTreeStatistics));
+
+#endif
+
+    if (NULL != TreeRoot(pTree))
+    {
+        AtomicIncrement(NodeReferences(pTree, TreeRoot(pTree)));
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION FreezeTree
+(
+    motelTreeHandle pTree,
+    motelTreeSnapshotHandle * pSnapshot
+)
+{
+    motelTreeSnapshotHandle lSnapshot;
+
+    motelTreeNodeHandle lNode;
+
+    motelTreePath lPath;
+
+    unsigned long lNodes;
+    unsigned long lRank;
+
+    size_t lEntrySize;
+    size_t lRecordSize;
+    size_t lSize;
+
+    byte * lEntries;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** there is no snapshot handle
+    */
+
+    if (NULL == pSnapshot)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    lSnapshot = (motelTreeSnapshotHandle) NULL;
+
+    /*
+    ** a snapshot holds a single instance for each node
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the search entries hold a key, its instance and its rank; the records
+    ** hold a key, its instance and its data
+    */
+
+    lNodes = SubtreeNullNodes(TreeRoot(pTree)) - 1;
+
+    lEntrySize = SnapshotEntrySize(pTree->keySize);
+    lRecordSize = SnapshotRecordSize(pTree->keySize, pTree->dataSize);
+
+    lSize = AlignedNodeSize(sizeof(motelTreeSnapshot)) + CACHE_LINE_SIZE + (lNodes + 1) * lEntrySize + lNodes * lRecordSize;
+
+    /*
+    ** allocate the snapshot, its entries and its records as one block; it is
+    ** cleared so that the padding SaveTree() writes holds no stray bytes
+    */
+
+    if (!SafeCallocBlock((void **) &lSnapshot, lSize))
+    {
+        pTree->result = motelResult_MemoryAllocation;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the entries are indexed from 1 so that entry 0 begins on a cache line
+    */
+
+    lEntries = (byte *) lSnapshot + AlignedNodeSize(sizeof(motelTreeSnapshot));
+    lEntries += (CACHE_LINE_SIZE - (size_t) lEntries % CACHE_LINE_SIZE) % CACHE_LINE_SIZE;
+
+    lSnapshot->size = lSize;
+
+    lSnapshot->compareKeyFunction = pTree->compareKeyFunction;
+
+    lSnapshot->keyType = pTree->keyType;
+
+    lSnapshot->keySize = pTree->keySize;
+    lSnapshot->dataSize = pTree->dataSize;
+
+    lSnapshot->entrySize = lEntrySize;
+    lSnapshot->recordSize = lRecordSize;
+
+    lSnapshot->nodes = lNodes;
+
+    lSnapshot->entries = lEntries;
+    lSnapshot->records = lEntries + (lNodes + 1) * lEntrySize;
+
+    lSnapshot->mapping = NULL;
+
+    /*
+    ** copy the nodes in key order
+    */
+
+    if (0 < lNodes)
+    {
+        lNode = GetLeastNode(pTree);
+
+        SeekPath(pTree, &lPath, lNode);
+
+        lRank = 1;
+
+        FillSnapshot(lSnapshot, pTree, 1, &lPath, &lNode, &lRank);
+    }
+
+    * pSnapshot = lSnapshot;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION DestructTreeSnapshot
+(
+    motelTreeSnapshotHandle * pSnapshot
+)
+{
+    /*
+    ** there is no snapshot
+    */
+
+    if (NULL == pSnapshot || NULL == * pSnapshot)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** release the file mapped by MapTree()
+    */
+
+    if (NULL != (* pSnapshot)->mapping)
+    {
+        if (!UnmapFileBlock(&(* pSnapshot)->mapping, (* pSnapshot)->size))
+        {
+            return (FALSE);
+        }
+    }
+
+    return (SafeFreeBlock((void **) pSnapshot)); // pass through result code
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReadTreeSnapshotNode
+(
+    motelTreeSnapshotHandle pSnapshot,
+    void * pKey,
+    unsigned long pInstance,
+    void * pData
+)
+{
+    unsigned long lRank;
+
+    /*
+    ** there is no snapshot or key
+    */
+
+    if (NULL == pSnapshot || NULL == pKey)
+    {
+        return (FALSE);
+    }
+
+    lRank = FindSnapshotRecord(pSnapshot, (const void *) pKey, pInstance);
+
+    /*
+    ** the node is not in the snapshot
+    */
+
+    if (0 == lRank)
+    {
+        return (FALSE);
+    }
+
+    if (NULL != pData)
+    {
+        memcpy(pData, RecordData(pSnapshot, lRank), pSnapshot->dataSize);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetTreeSnapshotNodeRank
+(
+    motelTreeSnapshotHandle pSnapshot,
+    void * pKey,
+    unsigned long pInstance,
+    unsigned long * pRank
+)
+{
+    unsigned long lRank;
+
+    /*
+    ** there is no snapshot, key or return parameter
+    */
+
+    if (NULL == pSnapshot || NULL == pKey || NULL == pRank)
+    {
+        return (FALSE);
+    }
+
+    lRank = FindSnapshotRecord(pSnapshot, (const void *) pKey, pInstance);
+
+    /*
+    ** the node is not in the snapshot
+    */
+
+    if (0 == lRank)
+    {
+        return (FALSE);
+    }
+
+    * pRank = lRank;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReadTreeSnapshotNodeByRank
+(
+    motelTreeSnapshotHandle pSnapshot,
+    unsigned long pRank,
+    void * pKey,
+    void * pData,
+    unsigned long * pInstance
+)
+{
+    /*
+    ** there is no snapshot
+    */
+
+    if (NULL == pSnapshot)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** there is no node at the requested position
+    */
+
+    if (0 == pRank || pSnapshot->nodes < pRank)
+    {
+        return (FALSE);
+    }
+
+    if (NULL != pKey)
+    {
+        memcpy(pKey, RecordKey(pSnapshot, pRank), pSnapshot->keySize);
+    }
+
+    if (NULL != pData)
+    {
+        memcpy(pData, RecordData(pSnapshot, pRank), pSnapshot->dataSize);
+    }
+
+    if (NULL != pInstance)
+    {
+        * pInstance = RecordInstance(pSnapshot, pRank);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ScanTreeSnapshotRange
+(
+    motelTreeSnapshotHandle pSnapshot,
+    void * pLeast,
+    void * pGreatest,
+    boolean (* pScanFunction)(void * pContext, const void * pKey, const void * pData, unsigned long pInstance),
+    void * pContext
+)
+{
+    unsigned long lRank;
+    unsigned long lEndRank;
+
+    /*
+    ** there is no snapshot or scan function
+    */
+
+    if (NULL == pSnapshot || NULL == pScanFunction)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** bound the range by rank; instance 0 orders before, and the largest
+    ** instance after, every instance of a key value
+    */
+
+    lRank = NULL == pLeast ? 1 : FindSnapshotBound(pSnapshot, (const void *) pLeast, 0);
+    lEndRank = NULL == pGreatest ? pSnapshot->nodes + 1 : FindSnapshotBound(pSnapshot, (const void *) pGreatest, (unsigned long) -1);
+
+    /*
+    ** the records of the range lie side by side
+    */
+
+    for (; lRank < lEndRank; lRank++)
+    {
+        if (!pScanFunction(pContext, RecordKey(pSnapshot, lRank), RecordData(pSnapshot, lRank), RecordInstance(pSnapshot, lRank)))
+        {
+            break;
+        }
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SaveTree
+(
+    motelTreeHandle pTree,
+    const char * pPath
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    /*
+    ** there is no file
+    */
+
+    if (NULL == pPath)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    return (WriteTreeFile(pTree, pPath, pTree->logSequence, FALSE)); // pass through result code
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION MapTree
+(
+    motelTreeSnapshotHandle * pSnapshot,
+    const char * pPath,
+    long (* pCompareKeyFunction)(const void * pKey1, const void * pKey2)
+)
+{
+    void * lMapping;
+
+    size_t lSize;
+
+    const motelTreeFile * lFile;
+
+    /*
+    ** there is no snapshot handle or file
+    */
+
+    if (NULL == pSnapshot || NULL == pPath)
+    {
+        return (FALSE);
+    }
+
+    lMapping = NULL;
+
+    if (!MapFileBlock(&lMapping, &lSize, pPath))
+    {
+        return (FALSE);
+    }
+
+    lFile = (const motelTreeFile *) lMapping;
+
+    /*
+    ** the file was not saved by SaveTree() on a compatible machine, or it has
+    ** been truncated or altered; the sizes are checked in an order that lets
+    ** no sum wrap and no division be by zero:
+    **
+    ** - neither object may be larger than the file, which keeps the sums of
+    **   the entry and record sizes well short of wrapping
+    ** - the entry and record sizes must be those of the key and data sizes,
+    **   and so are never zero
+    ** - the entries must fit within the file before the records' offset is
+    **   checked against their end, which then cannot wrap either
+    */
+
+    if (sizeof(motelTreeFile) > lSize ||
+        TREE_FILE_SIGNATURE != lFile->signature ||
+        TREE_FILE_VERSION != lFile->version ||
+        sizeof(unsigned long) != lFile->instanceSize ||
+        motelTreeKeyType_ <= lFile->keyType ||
+        (motelTreeKeyType_Custom == lFile->keyType && NULL == pCompareKeyFunction) ||
+        0 == lFile->keySize ||
+        lSize < lFile->keySize ||
+        lSize < lFile->dataSize ||
+        SnapshotEntrySize((size_t) lFile->keySize) != lFile->entrySize ||
+        SnapshotRecordSize((size_t) lFile->keySize, (size_t) lFile->dataSize) != lFile->recordSize ||
+        0 == lFile->entrySize ||
+        0 == lFile->recordSize ||
+        TREE_FILE_ENTRIES != lFile->entries ||
+        TREE_FILE_ENTRIES > lSize ||
+        (lSize - lFile->entries) / lFile->entrySize <= lFile->nodes ||
+        lFile->entries + (lFile->nodes + 1) * lFile->entrySize != lFile->records ||
+        (lSize - lFile->records) / lFile->recordSize < lFile->nodes)
+    {
+        UnmapFileBlock(&lMapping, lSize);
+
+        return (FALSE);
+    }
+
+    /*
+    ** the snapshot refers to the entries and records in place
+    */
+
+    * pSnapshot = (motelTreeSnapshotHandle) NULL;
+
+    if (!SafeMallocBlock((void **) pSnapshot, sizeof(motelTreeSnapshot)))
+    {
+        UnmapFileBlock(&lMapping, lSize);
+
+        return (FALSE);
+    }
+
+    (* pSnapshot)->size = lSize;
+
+    (* pSnapshot)->compareKeyFunction = pCompareKeyFunction;
+
+    (* pSnapshot)->keyType = (motelTreeKeyType) lFile->keyType;
+
+    (* pSnapshot)->keySize = (size_t) lFile->keySize;
+    (* pSnapshot)->dataSize = (size_t) lFile->dataSize;
+
+    (* pSnapshot)->entrySize = (size_t) lFile->entrySize;
+    (* pSnapshot)->recordSize = (size_t) lFile->recordSize;
+
+    (* pSnapshot)->nodes = (unsigned long) lFile->nodes;
+
+    (* pSnapshot)->entries = (byte *) lMapping + lFile->entries;
+    (* pSnapshot)->records = (byte *) lMapping + lFile->records;
+
+    (* pSnapshot)->mapping = lMapping;
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION LogTree
+(
+    motelTreeHandle pTree,
+    const char * pLogPath,
+    const char * pCheckpointPath
+)
+{
+    motelTreeLogHandle lLog;
+
+    size_t lLength;
+
+    motelResult lResult;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** stop logging the tree
+    */
+
+    if (NULL == pLogPath && NULL == pCheckpointPath)
+    {
+        if (NULL == pTree->log)
+        {
+            return (TRUE);
+        }
+
+        return (CloseLog(pTree)); // pass through result code
+    }
+
+    /*
+    ** there is no log or checkpoint file
+    */
+
+    if (NULL == pLogPath || NULL == pCheckpointPath)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the tree is already logged
+    */
+
+    if (NULL != pTree->log)
+    {
+        pTree->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    /*
+    ** a checkpoint holds a single instance for each node
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    /*
+    ** the log holds copies of the paths, the path beside the checkpoint to
+    ** which the next checkpoint is written, and room for the largest record
+    */
+
+    lLog = (motelTreeLogHandle) NULL;
+
+    if (!SafeCallocBlock((void **) &lLog, sizeof(motelTreeLog)))
+    {
+        pTree->result = motelResult_MemoryAllocation;
+
+        return (FALSE);
+    }
+
+    pTree->log = lLog;
+
+    lLength = strlen(pCheckpointPath);
+
+    if (!SafeMallocBlock((void **) &lLog->path, strlen(pLogPath) + 1) ||
+        !SafeMallocBlock((void **) &lLog->checkpointPath, lLength + 1) ||
+        !SafeMallocBlock((void **) &lLog->temporaryPath, lLength + sizeof(".new")) ||
+        !SafeMallocBlock((void **) &lLog->buffer, LOG_BUFFER_SIZE + LogRecordSize(pTree, motelTreeLogOperation_Insert)))
+    {
+        CloseLog(pTree);
+
+        pTree->result = motelResult_MemoryAllocation;
+
+        return (FALSE);
+    }
+
+    lLog->capacity = LOG_BUFFER_SIZE + LogRecordSize(pTree, motelTreeLogOperation_Insert);
+
+    strcpy(lLog->path, pLogPath);
+    strcpy(lLog->checkpointPath, pCheckpointPath);
+
+    strcpy(lLog->temporaryPath, pCheckpointPath);
+    strcpy(lLog->temporaryPath + lLength, ".new");
+
+    /*
+    ** the changes in a log left by another tree must not be replayed onto
+    ** this tree's checkpoint should a crash interrupt it; a tree recovered
+    ** by RecoverTree() numbers its changes after those already logged, so
+    ** its log is kept until the checkpoint replaces it
+    */
+
+    if (0 == pTree->logSequence)
+    {
+        remove(pLogPath);
+    }
+
+    /*
+    ** the log begins with a checkpoint of the tree
+    */
+
+    if (!WriteCheckpoint(pTree))
+    {
+        lResult = pTree->result;
+
+        CloseLog(pTree);
+
+        pTree->result = lResult;
+
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION CommitTree
+(
+    motelTreeHandle pTree
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** the tree is not logged
+    */
+
+    if (NULL == pTree->log)
+    {
+        pTree->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    return (CommitLog(pTree)); // pass through result code
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION CheckpointTree
+(
+    motelTreeHandle pTree
+)
+{
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** the tree is not logged
+    */
+
+    if (NULL == pTree->log)
+    {
+        pTree->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    return (WriteCheckpoint(pTree)); // pass through result code
+}
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION RecoverTree
+(
+    motelTreeHandle pTree,
+    const char * pLogPath,
+    const char * pCheckpointPath
+)
+{
+    motelTreeSnapshotHandle lSnapshot;
+
+    motelTreeLoad lLoad;
+
+    motelTreeNodeHandle lRoot;
+
+    FILE * lStream;
+
+    bits64 lSequence;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** there is no log or checkpoint file
+    */
+
+    if (NULL == pLogPath || NULL == pCheckpointPath)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (FALSE);
+    }
+
+    /*
+    ** recovery is only possible into an empty tree that is not logged
+    */
+
+    if (NULL != TreeRoot(pTree) || NULL != pTree->log)
+    {
+        pTree->result = motelResult_InvalidState;
+
+        return (FALSE);
+    }
+
+    /*
+    ** a checkpoint holds a single instance for each node
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
+
+    lSequence = 0;
+
+    /*
+    ** load the checkpoint, if there is one, keeping the instances of its
+    ** nodes so that the logged changes find the nodes they name
+    */
+
+    lStream = fopen(pCheckpointPath, "rb");
+
+    if (NULL != lStream)
+    {
+        fclose(lStream);
+
+        lSnapshot = (motelTreeSnapshotHandle) NULL;
+
+        if (!MapTree(&lSnapshot, pCheckpointPath, pTree->compareKeyFunction))
+        {
+            pTree->result = motelResult_Reading;
+
+            return (FALSE);
+        }
+
+        if (lSnapshot->keyType != pTree->keyType || lSnapshot->keySize != pTree->keySize || lSnapshot->dataSize != pTree->dataSize)
+        {
+            DestructTreeSnapshot(&lSnapshot);
+
+            pTree->result = motelResult_InvalidValue;
+
+            return (FALSE);
+        }
+
+        lSequence = ((const motelTreeFile *) lSnapshot->mapping)->sequence;
+
+        lLoad.data = (byte *) RecordData(lSnapshot, 1);
+        lLoad.keys = (byte *) RecordKey(lSnapshot, 1);
+
+        lLoad.dataStride = lSnapshot->recordSize;
+        lLoad.keyStride = lSnapshot->recordSize;
+
+        lLoad.instances = (byte *) &RecordInstance(lSnapshot, 1);
+        lLoad.instanceStride = lSnapshot->recordSize;
+
+        lLoad.previous = (motelTreeNodeHandle) NULL;
+
+        if (!LoadSubtree(pTree, &lLoad, lSnapshot->nodes, &lRoot))
+        {
+            DestructTreeSnapshot(&lSnapshot);
+
+            return (FALSE); // pass through result code
+        }
+
+        SetTreeRoot(pTree, lRoot);
+        pTree->levels = GetLoadedLevelCount(lSnapshot->nodes);
+
+        DestructTreeSnapshot(&lSnapshot);
+    }
+
+    /*
+    ** make the changes logged since the checkpoint
+    */
+
+    if (!ReplayLog(pTree, pLogPath, &lSequence))
+    {
+        return (FALSE); // pass through result code
+    }
+
+    pTree->cursor = (motelTreeNodeHandle) NULL;
+
+    /*
+    ** the tree's next logged change follows the last one recovered
+    */
+
+    pTree->logSequence = lSequence;
+
+    return (TRUE);
+}
+
+/*----------------------------------------------------------------------------
+  Private functions
+  ----------------------------------------------------------------------------*/
+
+static motelThreadResult THREAD_CALLING_CONVENTION ValidateSubtree
+(
+    void * pValidation
+)
+{
+    motelTreeValidation * lValidation;
+    motelTreeNodeHandle * lPath;
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lPrevious;
+
+    unsigned long lCapacity;
+    unsigned long lDepth;
+    unsigned long lNodes;
+    unsigned long lVisited;
+
+    lValidation = (motelTreeValidation *) pValidation;
+
+    lValidation->least = (motelTreeNodeHandle) NULL;
+    lValidation->greatest = (motelTreeNodeHandle) NULL;
+    lValidation->failure = (motelTreeNodeHandle) NULL;
+    lValidation->result = motelResult_OK;
+
+    /*
+    ** a lone node is checked by the caller against its neighbours
+    */
+
+    if (!lValidation->subtree || NULL == lValidation->root)
+    {
+        return ((motelThreadResult) 0);
+    }
+
+    lPath = (motelTreeNodeHandle *) NULL;
+    lCapacity = VALIDATE_PATH_NODES;
+
+    if (!SafeMallocBlock((void **) &lPath, lCapacity * sizeof(motelTreeNodeHandle)))
+    {
+        lValidation->result = motelResult_MemoryAllocation;
+
+        return ((motelThreadResult) 0);
+    }
+
+    /*
+    ** no sound walk passes more nodes than the root's weight claims
+    */
+
+    lNodes = lValidation->root->lesserNullNodes + lValidation->root->greaterNullNodes - 1;
+
+    lNode = lValidation->root;
+    lPrevious = (motelTreeNodeHandle) NULL;
+
+    lDepth = 0;
+    lVisited = 0;
+
+    for (;;)
+    {
+        /*
+        ** descend lesser, keeping the ancestors still to be visited
+        */
+
+        while (NULL != lNode)
+        {
+            if (lNodes <= lDepth)
+            {
+                lValidation->failure = lNode;
+                lValidation->result = motelResult_Structure;
+
+                SafeFreeBlock((void **) &lPath);
+
+                return ((motelThreadResult) 0);
+            }
+
+            if (lCapacity == lDepth)
+            {
+                lCapacity *= 2;
+
+                if (!SafeReallocBlock((void **) &lPath, lCapacity * sizeof(motelTreeNodeHandle)))
+                {
+                    lValidation->result = motelResult_MemoryAllocation;
+
+                    SafeFreeBlock((void **) &lPath);
+
+                    return ((motelThreadResult) 0);
+                }
+            }
+
+            lPath[lDepth++] = lNode;
+
+            lNode = NodeLesser(lValidation->tree, lNode);
+        }
+
+        if (0 == lDepth)
+        {
+            break;
+        }
+
+        /*
+        ** visit the nearest ancestor, then walk its greater branch
+        */
+
+        lNode = lPath[--lDepth];
+
+        if (lNodes <= lVisited++)
+        {
+            lValidation->failure = lNode;
+            lValidation->result = motelResult_Structure;
+
+            break;
+        }
+
+        if (!ValidateNode(lValidation->tree, lNode, lPrevious, &lValidation->result))
+        {
+            lValidation->failure = lNode;
+
+            break;
+        }
+
+        if (NULL == lPrevious)
+        {
+            lValidation->least = lNode;
+        }
+
+        lPrevious = lNode;
+
+        lNode = NodeGreater(lValidation->tree, lNode);
+    }
+
+    lValidation->greatest = lPrevious;
+
+    SafeFreeBlock((void **) &lPath);
+
+    return ((motelThreadResult) 0);
+}
+
+static boolean ValidateTreeInParallel
+(
+    motelTreeHandle pTree,
+    motelTreeValidation * pValidation
+)
+{
+    motelTreeValidation lValidations[2 * MAXIMUM_VALIDATE_THREADS + 1];
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lPrevious;
+    unsigned long lValidationCount;
+    unsigned long lSubtreeCount;
+    unsigned long lLargest;
+    unsigned long lIndex;
+
+    lValidations[0] = * pValidation;
+    lValidationCount = 1;
+    lSubtreeCount = 1;
+
+    /*
+    ** split the largest subtree about its root, which is left to be checked alone,
+    ** until there is a subtree for every thread; the entries are kept in key order
+    */
+
+    while (lSubtreeCount < pTree->validateThreads)
+    {
+        lLargest = lValidationCount;
+
+        for (lIndex = 0; lIndex < lValidationCount; lIndex++)
+        {
+            if (lValidations[lIndex].subtree && (lValidationCount == lLargest ||
+                lValidations[lLargest].root->lesserNullNodes + lValidations[lLargest].root->greaterNullNodes <
+                lValidations[lIndex].root->lesserNullNodes + lValidations[lIndex].root->greaterNullNodes))
+            {
+                lLargest = lIndex;
+            }
+        }
+
+        lNode = lValidations[lLargest].root;
+
+        if (NULL == NodeLesser(pTree, lNode) || NULL == NodeGreater(pTree, lNode))
+        {
+            break;
+        }
+
+        memmove(&lValidations[lLargest + 3], &lValidations[lLargest + 1], (lValidationCount - lLargest - 1) * sizeof(motelTreeValidation));
+
+        lValidations[lLargest].root = NodeLesser(pTree, lNode);
+
+        lValidations[lLargest + 1] = lValidations[lLargest];
+        lValidations[lLargest + 1].root = lNode;
+        lValidations[lLargest + 1].subtree = FALSE;
+
+        lValidations[lLargest + 2] = lValidations[lLargest];
+        lValidations[lLargest + 2].root = NodeGreater(pTree, lNode);
+
+        lValidationCount += 2;
+        lSubtreeCount++;
+    }
+
+    /*
+    ** each thread walks one subtree, leaving the tree object untouched
+    */
+
+    for (lIndex = 0; lIndex < lValidationCount; lIndex++)
+    {
+        lValidations[lIndex].started = 0 < lIndex && lValidations[lIndex].subtree &&
+                                       StartThread(&lValidations[lIndex].thread, ValidateSubtree, (void *) &lValidations[lIndex]);
+    }
+
+    /*
+    ** the calling thread walks the first subtree and any subtree whose thread did not start
+    */
+
+    for (lIndex = 0; lIndex < lValidationCount; lIndex++)
+    {
+        if (!lValidations[lIndex].started)
+        {
+            ValidateSubtree((void *) &lValidations[lIndex]);
+        }
+    }
+
+    /*
+    ** a walk whose thread could not be joined cannot vouch for its subtree
+    */
+
+    for (lIndex = 0; lIndex < lValidationCount; lIndex++)
+    {
+        if (lValidations[lIndex].started && !JoinThread(lValidations[lIndex].thread) && motelResult_OK == lValidations[lIndex].result)
+        {
+            lValidations[lIndex].result = motelResult_Undefined;
+        }
+    }
+
+    /*
+    ** check the lone nodes and the boundaries between the subtrees in key order,
+    ** so that the first failure is the one a single walk would have found
+    */
+
+    lPrevious = (motelTreeNodeHandle) NULL;
+
+    for (lIndex = 0; lIndex < lValidationCount; lIndex++)
+    {
+        if (!lValidations[lIndex].subtree)
+        {
+            lNode = lValidations[lIndex].root;
+
+            if (!ValidateNode(pTree, lNode, lPrevious, &pValidation->result))
+            {
+                pValidation->failure = lNode;
+
+                return (FALSE);
+            }
+
+            lPrevious = lNode;
+
+            continue;
+        }
+
+        lNode = lValidations[lIndex].least;
+
+        if (NULL != lNode && NULL != lPrevious && !ValidateNode(pTree, lNode, lPrevious, &pValidation->result))
+        {
+            pValidation->failure = lNode;
+
+            return (FALSE);
+        }
+
+        if (motelResult_OK != lValidations[lIndex].result)
+        {
+            pValidation->failure = lValidations[lIndex].failure;
+            pValidation->result = lValidations[lIndex].result;
+
+            return (FALSE);
+        }
+
+        lPrevious = lValidations[lIndex].greatest;
+    }
+
+    pValidation->failure = (motelTreeNodeHandle) NULL;
+    pValidation->result = motelResult_OK;
+
+    return (TRUE);
+}
+
+static boolean ValidateNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    motelTreeNodeHandle pPrevious,
+    motelResult * pResult
+)
+{
+    motelTreeOccurrences * lList;
+
+    unsigned long lIndex;
+
+    long lComparisonResult;
+
+    * pResult = motelResult_Structure;
+
+    /*
+    ** validate that a grouped key's occurrences are present and in instance order
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        lList = NodeOccurrences(pTree, pNode);
+
+        if (NULL == lList || 0 == lList->count || lList->capacity < lList->count)
+        {
+            return (FALSE);
+        }
+
+        for (lIndex = 1; lIndex < lList->count; lIndex++)
+        {
+            if (OccurrenceInstance(pTree, lList, lIndex - 1) >= OccurrenceInstance(pTree, lList, lIndex))
+            {
+                return (FALSE);
+            }
+        }
+    }
+
+    /*
+    ** validate that the node's value follows that of the node before it
+    */
+
+    if (NULL != pPrevious)
+    {
+        lComparisonResult = CompareKeyObjects(pTree->keyType, pTree->keySize, pTree->compareKeyFunction, NodeKey(pPrevious), NodeKey(pNode));
+
+        if (0 == lComparisonResult)
+        {
+            lComparisonResult = (pPrevious->instance < pNode->instance) ? LESS_THAN : (pPrevious->instance > pNode->instance) ? MORE_THAN : EQUAL_TO;
+        }
+
+        if (0 < lComparisonResult)
+        {
+            return (FALSE);
+        }
+    }
+
+    /*
+    ** validate that the children lead back to the node
+    */
+
+    if (!pTree->parentless)
+    {
+        if ((NULL != NodeLesser(pTree, pNode) && pNode != NodeParent(pTree, NodeLesser(pTree, pNode))) ||
+            (NULL != NodeGreater(pTree, pNode) && pNode != NodeParent(pTree, NodeGreater(pTree, pNode))))
+        {
+            return (FALSE);
+        }
+    }
+
+    /*
+    ** validate that the node weights are correct, an empty branch weighing one
+    */
+
+    * pResult = motelResult_NodeCount;
+
+    if (pNode->lesserNullNodes != (NULL == NodeLesser(pTree, pNode) ? 1 : NodeLesser(pTree, pNode)->lesserNullNodes + NodeLesser(pTree, pNode)->greaterNullNodes) ||
+        pNode->greaterNullNodes != (NULL == NodeGreater(pTree, pNode) ? 1 : NodeGreater(pTree, pNode)->lesserNullNodes + NodeGreater(pTree, pNode)->greaterNullNodes))
+    {
+        return (FALSE);
+    }
+
+    * pResult = motelResult_OK;
+
+    return (TRUE);
+}
+
+#if defined COMPACT_TREE_NODES
+
+static FORCE_INLINE motelTreeNodeHandle ArenaNode
+(
+    motelTreeHandle pTree,
+    motelTreeLink pLink
+)
+{
+    if (0 == pLink)
+    {
+        return ((motelTreeNodeHandle) NULL);
+    }
+
+    return ((motelTreeNodeHandle) (pTree->arena.base + (size_t) pLink * NODE_ALIGNMENT));
+}
+
+static FORCE_INLINE motelTreeLink ArenaLink
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+)
+{
+    if (NULL == pNode)
+    {
+        return (0);
+    }
+
+    return ((motelTreeLink) (((byte *) pNode - pTree->arena.base) / NODE_ALIGNMENT));
+}
+
+static boolean AllocateArenaNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pNode
+)
+{
+    size_t lCommit;
+
+    /*
+    ** a released node is reused ahead of extending the arena
+    */
+
+    if (0 != pTree->arena.free)
+    {
+        * pNode = ArenaNode(pTree, pTree->arena.free);
+
+        pTree->arena.free = (* pNode)->lesser;
+
+        return (TRUE);
+    }
+
+    /*
+    ** the arena is reserved along with the first node, its first unit left
+    ** unused so that no node's link is 0
+    */
+
+    if (NULL == pTree->arena.base)
+    {
+        if (!ReserveBlock((void **) &pTree->arena.base, TREE_ARENA_SIZE))
+        {
+            pTree->result = motelResult_MemoryAllocation;
+
+            return (FALSE);
+        }
+
+        pTree->arena.reserved = TREE_ARENA_SIZE;
+        pTree->arena.committed = 0;
+        pTree->arena.used = NODE_ALIGNMENT;
+    }
+
+    /*
+    ** no link reaches beyond the reserved address space
+    */
+
+    if (pTree->arena.reserved - pTree->arena.used < pTree->nodeSize)
+    {
+        pTree->result = motelResult_MaximumSize;
+
+        return (FALSE);
+    }
+
+    /*
+    ** commit as many steps of the arena as the node needs
+    */
+
+    if (pTree->arena.committed < pTree->arena.used + pTree->nodeSize)
+    {
+        lCommit = ((pTree->arena.used + pTree->nodeSize - pTree->arena.committed + TREE_ARENA_COMMIT_SIZE - 1) / TREE_ARENA_COMMIT_SIZE) * TREE_ARENA_COMMIT_SIZE;
+
+        if (lCommit > pTree->arena.reserved - pTree->arena.committed)
+        {
+            lCommit = pTree->arena.reserved - pTree->arena.committed;
+        }
+
+        if (!CommitBlock((void *) (pTree->arena.base + pTree->arena.committed), lCommit))
+        {
+            pTree->result = motelResult_MemoryAllocation;
+
+            return (FALSE);
+        }
+
+        pTree->arena.committed += lCommit;
+    }
+
+    * pNode = (motelTreeNodeHandle) (pTree->arena.base + pTree->arena.used);
+
+    pTree->arena.used += pTree->nodeSize;
+
+    return (TRUE);
+}
+
+static void ReleaseArenaNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+)
+{
+    pNode->lesser = pTree->arena.free;
+
+    pTree->arena.free = ArenaLink(pTree, pNode);
+}
+
+#endif
+
+static boolean ConstructNode
+(
+    motelTreeHandle pTree,
+    void * pKey,
+    void * pData,
+    motelTreeNodeHandle * pNode
+)
+{
+    motelTreeNodeHandle lNode = (motelTreeNodeHandle) NULL;
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** there isn't room for a new node
+    */
+
+    if (pTree->maximumSize > 0 && pTree->maximumSize < pTree->size + pTree->nodeSize)
+    {
+        pTree->result = motelResult_MaximumSize;
+
+        * pNode = (motelTreeNodeHandle) NULL;
+
+        return (FALSE);
+    }
+
+    /*
+    ** allocate memory for the node, its key and its data as a single block
+    */
+
+#if defined COMPACT_TREE_NODES
+
+    if (!AllocateArenaNode(pTree, &lNode))
+    {
+        * pNode = (motelTreeNodeHandle) NULL;
+
+        return (FALSE); // pass through result code
+    }
+
+    pTree->size += pTree->nodeSize;
+
+#else
+
+    if (NULL != pTree->pool)
+    {
+        if (!AllocatePoolMemory(pTree->pool, (motelMemoryObjectHandle *) &lNode, pTree->nodeSize))
+        {
+            pTree->result = motelResult_MemoryAllocation;
+
+            * pNode = (motelTreeNodeHandle) NULL;
+
+            return (FALSE);
+        }
+
+        pTree->size += pTree->nodeSize;
+    }
+    else if (pTree->persistent)
+    {
+        /*
+        ** a node that versions share may be destructed by whichever of them
+        ** lets go of it last, so it comes from the heap and is charged to the
+        ** version that constructs it
+        */
+
+        if (!SafeMallocBlock((void **) &lNode, pTree->nodeSize))
+        {
+            pTree->result = motelResult_MemoryAllocation;
+
+            * pNode = (motelTreeNodeHandle) NULL;
+
+            return (FALSE);
+        }
+
+        * NodeReferences(pTree, lNode) = 1;
+        * NodeOwner(pTree, lNode) = pTree->version;
+
+        pTree->size += pTree->nodeSize;
+    }
+    else if (!ManagedMallocBlock((void **) &lNode, pTree->nodeSize, &pTree->size))
+    {
+        pTree->result = motelResult_MemoryAllocation;
+
+        * pNode = (motelTreeNodeHandle) NULL;
+
+        return (FALSE);
+    }
+
+#endif
+
+    CountTreeStatistic(pTree, allocations, 1);
+    CountTreeStatistic(pTree, allocationBytes, pTree->nodeSize);
+
+    /*
+    ** copy the key and data into the new node
+    */
+
+    memcpy(NodeKey(lNode), (const void *) pKey, pTree->keySize);
+
+    if (pTree->groupDuplicates)
+    {
+        /*
+        ** a grouped key's data is held by its first occurrence
+        */
+
+        NodeOccurrences(pTree, lNode) = (motelTreeOccurrences *) NULL;
+
+        if (!AddOccurrence(pTree, lNode, pData))
+        {
+#if defined COMPACT_TREE_NODES
+
+            ReleaseArenaNode(pTree, lNode);
+
+            pTree->size -= pTree->nodeSize;
+
+#else
+
+            ManagedFreeBlock((void **) &lNode, pTree->nodeSize, &pTree->size);
+
+#endif
+
+            * pNode = (motelTreeNodeHandle) NULL;
+
+            return (FALSE); // pass through result code
+        }
+    }
+    else
+    {
+        memcpy(NodeData(pTree, lNode), (const void *) pData, pTree->dataSize);
+    }
+
+    /*
+    ** initialize the node
+    */
+
+    lNode->instance = 1;
+
+    SetNodeParent(pTree, lNode, (motelTreeNodeHandle) NULL);
+    
+    SetNodeLesser(pTree, lNode, (motelTreeNodeHandle) NULL);
+    lNode->lesserNullNodes = 1;
+    
+    SetNodeGreater(pTree, lNode, (motelTreeNodeHandle) NULL);
+    lNode->greaterNullNodes = 1;
+
+    /*
+    ** a lock-free reader must never see the node linked into the tree ahead of
+    ** its initialization
+    */
+
+    if (pTree->concurrent)
+    {
+        MemoryFence();
+    }
+
+    /*
+    ** return the new node
+    */
+
+    * pNode = lNode;
+
+    return (TRUE);
+}
+
+static boolean DestructNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+)
+{
+    motelTreeNodeHandle lCurrentNode;
+
+    motelTreeOccurrences * lList;
+
+    /*
+    ** there is no tree
+    */
+
+    if (NULL == pTree)
+    {
+        return (FALSE);
+    }
+
+    pTree->result = motelResult_OK;
+
+    if (NULL == pNode)
+    {
+        pTree->result = motelResult_NotFound;
+
+        return (FALSE);
+    }
+
+    lCurrentNode = pNode;
+
+    /*
+    ** a grouped key's occurrences are released ahead of its node
+    */
+
+    if (pTree->groupDuplicates)
+    {
+        lList = NodeOccurrences(pTree, lCurrentNode);
+
+        if (!ManagedFreeBlock((void **) &lList, OccurrenceListSize(pTree, lList->capacity), &pTree->size))
+        {
+            pTree->result = motelResult_MemoryDeallocation;
+
+            return (FALSE);
+        }
+    }
+
+    /*
+    ** the key and data are released along with the node
+    */
+
+#if defined COMPACT_TREE_NODES
+
+    ReleaseArenaNode(pTree, lCurrentNode);
+
+    pTree->size -= pTree->nodeSize;
+
+#else
+
+    if (NULL != pTree->pool)
+    {
+        if (!DeallocatePoolMemory(pTree->pool, (motelMemoryObjectHandle *) &lCurrentNode))
+        {
+            pTree->result = motelResult_MemoryDeallocation;
+
+            return (FALSE);
+        }
+
+        pTree->size -= pTree->nodeSize;
+    }
+    else if (pTree->persistent)
+    {
+        if (pTree->version == AtomicRead(NodeOwner(pTree, lCurrentNode)))
+        {
+            pTree->size -= pTree->nodeSize;
+        }
+
+        if (!SafeFreeBlock((void **) &lCurrentNode))
+        {
+            pTree->result = motelResult_MemoryDeallocation;
+
+            return (FALSE);
+        }
+    }
+    else if (!ManagedFreeBlock((void **) &lCurrentNode, pTree->nodeSize, &pTree->size))
+    {
+        pTree->result = motelResult_MemoryDeallocation;
+
+        return (FALSE);
+    }
+
+#endif
+
+    return (TRUE);
+}
+
+static boolean DeleteNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pDeleteNode
+)
+{
+    motelTreeNodeHandle lRoot;
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lChild;
+
+    motelTreeLink * lLink;
+    motelTreeLink * lDeleteLink;
+    motelTreeLink * lRebuildLink;
+
+    motelTreeCursorHandle lCursor;
+
+    long lComparisonResult;
+
+    unsigned long lPivots;
+    unsigned long lDepth = 1;
+
+    boolean lNodeToDeleteFound = FALSE;
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** a persistent tree copies the nodes it will change that other versions share
+    */
+
+    if (pTree->persistent && !OwnNodePath(pTree, &pDeleteNode, TRUE))
+    {
+        return (FALSE); // pass through result code
+    }
+
+    lRoot = TreeRoot(pTree);
+
+    /*
+    ** traverse the tree to find a suitable substitute leaf or twig node 
+    ** to be promoted into the position of node being deleted and rebalance
+    ** the tree along the way, keeping the links to the current node and to
+    ** the node being deleted
+    */
+    
+    lNode = lRoot;
+
+    lLink = &pTree->root;
+    lDeleteLink = (motelTreeLink *) NULL;
+    lRebuildLink = (motelTreeLink *) NULL;
+
+    for (;;)
+    {
+        /*
+        ** decide which branch to follow
+        */
+
+        lComparisonResult = NodeCompare(pTree, pDeleteNode, lNode);
+
+        if (0 == lComparisonResult)
+        {
+            lNodeToDeleteFound = TRUE;
+
+            lDeleteLink = lLink;
+
+            if (NULL != NodeLesser(pTree, lNode))
+            {
+                lComparisonResult = LESS_THAN;
+            }
+            else
+            {
+                lComparisonResult = MORE_THAN;
+            }
+        }
+
+        /*
+        ** follow branch
+        */
+
+        if (0 > lComparisonResult)
+        {
+            /*
+            ** traverse lesser
+            */
+
+            lChild = NodeLesser(pTree, lNode);
+
+            if (NULL == lChild)
+            {
+                break;
+            }
+
+            if (OutOfBalance(pTree, lNode->greaterNullNodes, lNode->lesserNullNodes - 1))
+            {
+                if (motelTreeBalanceMode_Rebuild != pTree->balance.mode)
+                {
+                    lPivots = RebalanceGreaterToLesser(pTree, &lNode, lDepth);
+
+                    if (0 < lPivots)
+                    {
+                        CountTreeStatistic(pTree, deletePivots, lPivots);
+
+                        lChild = NodeLesser(pTree, lNode);
+
+                        SetLinkedNode(pTree, lLink, lNode);
+                    }
+                }
+                else if (NULL == lRebuildLink)
+                {
+                    /*
+                    ** only the highest subtree out of balance is rebuilt; the
+                    ** links below the node to delete leave with it, so the
+                    ** subtree rooted at the node's position is taken instead
+                    */
+
+                    lRebuildLink = lNodeToDeleteFound ? lDeleteLink : lLink;
+                }
+            }
+
+            lNode->lesserNullNodes -= 1;
+
+            lLink = &lNode->lesser;
+        }
+        else // (0 < lComparisonResult)
+        {
+            /*
+            ** traverse greater
+            */
+
+            lChild = NodeGreater(pTree, lNode);
+
+            if (NULL == lChild)
+            {
+                break;
+            }
+
+            if (OutOfBalance(pTree, lNode->lesserNullNodes, lNode->greaterNullNodes - 1))
+            {
+                if (motelTreeBalanceMode_Rebuild != pTree->balance.mode)
+                {
+                    lPivots = RebalanceLesserToGreater(pTree, &lNode, lDepth);
+
+                    if (0 < lPivots)
+                    {
+                        CountTreeStatistic(pTree, deletePivots, lPivots);
+
+                        lChild = NodeGreater(pTree, lNode);
+
+                        SetLinkedNode(pTree, lLink, lNode);
+                    }
+                }
+                else if (NULL == lRebuildLink)
+                {
+                    /*
+                    ** only the highest subtree out of balance is rebuilt; the
+                    ** links below the node to delete leave with it, so the
+                    ** subtree rooted at the node's position is taken instead
+                    */
+
+                    lRebuildLink = lNodeToDeleteFound ? lDeleteLink : lLink;
+                }
+            }
+
+            lNode->greaterNullNodes -= 1;
+
+            lLink = &lNode->greater;
+        }
+
+        lNode = lChild;
+
+        lDepth += 1;
+    }
+
+    CountTreeDescent(pTree, lDepth);
+
+    /*
+    ** node to delete was not encountered in the tree during traversal
+    */
+
+    if (!lNodeToDeleteFound)
+    {
+        pTree->result = motelResult_NotFound;
+
+        return (FALSE); /* branch weights are messed up now! */
+    }
+
+    /*
+    ** delete the node
+    */
+
+    if (pDeleteNode == lNode)
+    {
+        /*
+        ** the node to be deleted is a leaf node therefore there's no
+        ** need for promotion, just disconnect it from its parent
+        */
+
+        SetLinkedNode(pTree, lLink, (motelTreeNodeHandle) NULL);
+    }
+    else // (pDeleteNode != lNode)
+    {
+        /*
+        ** promote a leaf or twig node
+        */
+
+        /*
+        ** when a lesser or greater child branch is attached to the node to promote
+        ** move the child branch up to take the place of the to be promoted node
+        */
+
+        lChild = NULL != NodeLesser(pTree, lNode) ? NodeLesser(pTree, lNode) : NodeGreater(pTree, lNode);
+
+        SetLinkedNode(pTree, lLink, lChild);
+
+        if (NULL != lChild && !pTree->parentless)
+        {
+            SetNodeParent(pTree, lChild, NodeParent(pTree, lNode));
+        }
+
+        /*
+        ** make the found node assume the position of the node about to be deleted within the tree
+        */
+
+        SetLinkedNode(pTree, lDeleteLink, lNode);
+
+        SetNodeLesser(pTree, lNode, NodeLesser(pTree, pDeleteNode));
+        lNode->lesserNullNodes = pDeleteNode->lesserNullNodes;
+
+        SetNodeGreater(pTree, lNode, NodeGreater(pTree, pDeleteNode));
+        lNode->greaterNullNodes = pDeleteNode->greaterNullNodes;
+
+        /*
+        ** connect the promoted node to its new parent and children
+        */
+
+        if (!pTree->parentless)
+        {
+            SetNodeParent(pTree, lNode, NodeParent(pTree, pDeleteNode));
+
+            if (NULL != NodeLesser(pTree, lNode))
+            {
+                SetNodeParent(pTree, NodeLesser(pTree, lNode), lNode);
+            }
+
+            if (NULL != NodeGreater(pTree, lNode))
+            {
+                SetNodeParent(pTree, NodeGreater(pTree, lNode), lNode);
+            }
+        }
+    }
+
+    if (NULL != lRebuildLink && NULL != LinkedNode(pTree, lRebuildLink))
+    {
+        CountTreeStatistic(pTree, deleteRebuilds, 1);
+
+        RestoreSubtreeBalance(pTree, lRebuildLink);
+    }
+
+    /*
+    ** no cursor may be left on the disconnected node
+    */
+
+    if (pDeleteNode == pTree->cursor)
+    {
+        pTree->cursor = (motelTreeNodeHandle) NULL;
+    }
+
+    for (lCursor = pTree->cursors; NULL != lCursor; lCursor = lCursor->next)
+    {
+        if (pDeleteNode == lCursor->node)
+        {
+            lCursor->node = (motelTreeNodeHandle) NULL;
+        }
+    }
+
+    /*
+    ** destruct the disconnected node, once any lock-free readers are done with it
+    */
+    
+    if (pTree->concurrent)
+    {
+        RetireNode(pTree, pDeleteNode);
+    }
+    else if (!DestructNode(pTree, pDeleteNode))
+    {
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+static boolean AddOccurrence
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    void * pData
+)
+{
+    motelTreeOccurrences * lList;
+
+    unsigned long lCapacity;
+    unsigned long lInstance;
+
+    size_t lGrowth;
+
+    pTree->result = motelResult_OK;
+
+    lList = NodeOccurrences(pTree, pNode);
+
+    /*
+    ** the occurrence follows the greatest instance of the key
+    */
+
+    if (NULL == lList)
+    {
+        lInstance = 1;
+    }
+    else
+    {
+        lInstance = OccurrenceInstance(pTree, lList, lList->count - 1) + 1;
+    }
+
+    /*
+    ** construct a new list, or double the capacity of a full one
+    */
+
+    if (NULL == lList || lList->capacity == lList->count)
+    {
+        if (NULL == lList)
+        {
+            lCapacity = 1;
+
+            lGrowth = OccurrenceListSize(pTree, 1);
+        }
+        else
+        {
+            lCapacity = 2 * lList->capacity;
+
+            lGrowth = lList->capacity * OccurrenceSize(pTree);
+        }
+
+        /*
+        ** there isn't room for the larger list
+        */
+
+        if (pTree->maximumSize > 0 && pTree->maximumSize < pTree->size + lGrowth)
+        {
+            pTree->result = motelResult_MaximumSize;
+
+            return (FALSE);
+        }
+
+        /*
+        ** the node keeps its existing list should the reallocation fail
+        */
+
+        if (!SafeReallocBlock((void **) &lList, OccurrenceListSize(pTree, lCapacity)))
+        {
+            pTree->result = motelResult_MemoryAllocation;
+
+            return (FALSE);
+        }
+
+        CountTreeStatistic(pTree, allocations, 1);
+        CountTreeStatistic(pTree, allocationBytes, OccurrenceListSize(pTree, lCapacity));
+
+        if (NULL == NodeOccurrences(pTree, pNode))
+        {
+            lList->count = 0;
+        }
+
+        lList->capacity = lCapacity;
+
+        NodeOccurrences(pTree, pNode) = lList;
+
+        pTree->size += lGrowth;
+    }
+
+    /*
+    ** append the occurrence
+    */
+
+    OccurrenceInstance(pTree, lList, lList->count) = lInstance;
+
+    memcpy(OccurrenceData(pTree, lList, lList->count), (const void *) pData, pTree->dataSize);
+
+    lList->count += 1;
+
+    return (TRUE);
+}
+
+static boolean RemoveOccurrence
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    unsigned long pOccurrence
+)
+{
+    motelTreeOccurrences * lList;
+    motelTreeOccurrences * lShrunkList;
+
+    unsigned long lCapacity;
+
+    lList = NodeOccurrences(pTree, pNode);
+
+    /*
+    ** the key's last occurrence takes the node with it
+    */
+
+    if (1 == lList->count)
+    {
+        return (DeleteNode(pTree, pNode));
+    }
+
+    pTree->result = motelResult_OK;
+
+    /*
+    ** close the gap left by the occurrence
+    */
+
+    lList->count -= 1;
+
+    memmove(Occurrence(pTree, lList, pOccurrence), Occurrence(pTree, lList, pOccurrence + 1), (lList->count - pOccurrence) * OccurrenceSize(pTree));
+
+    /*
+    ** give back half of a list that has fallen to a quarter of its capacity,
+    ** keeping the whole list should the reallocation fail
+    */
+
+    if (lList->count <= lList->capacity / 4)
+    {
+        lCapacity = lList->capacity / 2;
+
+        lShrunkList = lList;
+
+        if (SafeReallocBlock((void **) &lShrunkList, OccurrenceListSize(pTree, lCapacity)))
+        {
+            CountTreeStatistic(pTree, allocations, 1);
+            CountTreeStatistic(pTree, allocationBytes, OccurrenceListSize(pTree, lCapacity));
+
+            pTree->size -= (lShrunkList->capacity - lCapacity) * OccurrenceSize(pTree);
+
+            lShrunkList->capacity = lCapacity;
+
+            NodeOccurrences(pTree, pNode) = lShrunkList;
+        }
+    }
+
+    /*
+    ** no cursor may be left on the removed occurrence
+    */
+
+    if (pNode == pTree->cursor)
+    {
+        pTree->cursor = (motelTreeNodeHandle) NULL;
+    }
+
+    return (TRUE);
+}
+
+static unsigned long FindOccurrence
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    unsigned long pInstance
+)
+{
+    motelTreeOccurrences * lList;
+
+    unsigned long lLow;
+    unsigned long lHigh;
+    unsigned long lMiddle;
+
+    lList = NodeOccurrences(pTree, pNode);
+
+    if (0 == pInstance)
+    {
+        return (0);
+    }
+
+    /*
+    ** binary search the ascending instances
+    */
+
+    lLow = 0;
+    lHigh = lList->count;
+
+    while (lLow < lHigh)
+    {
+        lMiddle = lLow + (lHigh - lLow) / 2;
+
+        if (OccurrenceInstance(pTree, lList, lMiddle) < pInstance)
+        {
+            lLow = lMiddle + 1;
+        }
+        else
+        {
+            lHigh = lMiddle;
+        }
+    }
+
+    if (lLow < lList->count && OccurrenceInstance(pTree, lList, lLow) == pInstance)
+    {
+        return (lLow);
+    }
+
+    return (lList->count);
+}
+
+static boolean ScanOccurrences
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    boolean (* pScanFunction)(void * pContext, const void * pKey, const void * pData, unsigned long pInstance),
+    void * pContext
+)
+{
+    motelTreeOccurrences * lList;
+
+    unsigned long lIndex;
+
+    lList = NodeOccurrences(pTree, pNode);
+
+    for (lIndex = 0; lIndex < lList->count; lIndex++)
+    {
+        if (!pScanFunction(pContext, (const void *) NodeKey(pNode), (const void *) OccurrenceData(pTree, lList, lIndex), OccurrenceInstance(pTree, lList, lIndex)))
+        {
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
+static void SetCursorOccurrence
+(
+    motelTreeHandle pTree,
+    boolean pGreatest
+)
+{
+    if (pGreatest && pTree->groupDuplicates && NULL != pTree->cursor)
+    {
+        pTree->occurrence = NodeOccurrences(pTree, pTree->cursor)->count - 1;
+    }
+    else
+    {
+        pTree->occurrence = 0;
+    }
+}
+
+static void * GetCursorData
+(
+    motelTreeHandle pTree
+)
+{
+    if (pTree->groupDuplicates)
+    {
+        return (OccurrenceData(pTree, NodeOccurrences(pTree, pTree->cursor), pTree->occurrence));
+    }
+
+    return (NodeData(pTree, pTree->cursor));
+}
+
+static unsigned long GetCursorInstance
+(
+    motelTreeHandle pTree
+)
+{
+    if (pTree->groupDuplicates)
+    {
+        return (OccurrenceInstance(pTree, NodeOccurrences(pTree, pTree->cursor), pTree->occurrence));
+    }
+
+    return (pTree->cursor->instance);
+}
+
+static motelTreeNodeHandle OwnNode
+(
+    motelTreeHandle pTree,
+    motelTreeLink * pLink
+)
+{
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lCopy = (motelTreeNodeHandle) NULL;
+
+    motelTreeCursorHandle lCursor;
+
+    lNode = LinkedNode(pTree, pLink);
+
+    /*
+    ** a node held by the link alone is already private, and is charged to the
+    ** tree should the version that constructed it have let go of it; a
+    ** version released by another thread while the count is read only costs
+    ** an extra copy
+    */
+
+    if (1 == AtomicRead(NodeReferences(pTree, lNode)))
+    {
+        if (pTree->version != AtomicRead(NodeOwner(pTree, lNode)))
+        {
+            * NodeOwner(pTree, lNode) = pTree->version;
+
+            pTree->size += pTree->nodeSize;
+        }
+
+        return (lNode);
+    }
+
+    if (!SafeMallocBlock((void **) &lCopy, pTree->nodeSize))
+    {
+        pTree->result = motelResult_MemoryAllocation;
+
+        return ((motelTreeNodeHandle) NULL);
+    }
+
+    CountTreeStatistic(pTree, allocations, 1);
+    CountTreeStatistic(pTree, allocationBytes, pTree->nodeSize);
+
+    memcpy((void *) lCopy, (const void *) lNode, pTree->nodeSize);
+
+    * NodeReferences(pTree, lCopy) = 1;
+    * NodeOwner(pTree, lCopy) = pTree->version;
+
+    pTree->size += pTree->nodeSize;
+
+    /*
+    ** the copy shares the node's children
+    */
+
+    if (NULL != NodeLesser(pTree, lCopy))
+    {
+        AtomicIncrement(NodeReferences(pTree, NodeLesser(pTree, lCopy)));
+    }
+
+    if (NULL != NodeGreater(pTree, lCopy))
+    {
+        AtomicIncrement(NodeReferences(pTree, NodeGreater(pTree, lCopy)));
+    }
+
+    /*
+    ** the cursors follow the node into the copy, as the original may be
+    ** destructed once the other versions release it
+    */
+
+    if (lNode == pTree->cursor)
+    {
+        pTree->cursor = lCopy;
+    }
+
+    for (lCursor = pTree->cursors; NULL != lCursor; lCursor = lCursor->next)
+    {
+        if (lNode == lCursor->node)
+        {
+            lCursor->node = lCopy;
+        }
+    }
+
+    SetLinkedNode(pTree, pLink, lCopy);
+
+    ReleaseNode(pTree, lNode);
+
+    return (lCopy);
+}
+
+static boolean OwnKeyPath
+(
+    motelTreeHandle pTree,
+    const void * pKey
+)
+{
+    motelTreeNodeHandle lNode;
+
+    motelTreeLink * lLink;
+
+    /*
+    ** an insertion descends greater past equal key values
+    */
+
+    for (lLink = &pTree->root; NULL != LinkedNode(pTree, lLink); )
+    {
+        lNode = OwnNode(pTree, lLink);
+
+        if (NULL == lNode)
+        {
+            return (FALSE); // pass through result code
+        }
+
+        if (0 > CompareKeys(pTree, pKey, NodeKey(lNode)))
+        {
+            lLink = &lNode->lesser;
+        }
+        else
+        {
+            lLink = &lNode->greater;
+        }
+    }
+
+    return (TRUE);
+}
+
+static boolean OwnNodePath
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pNode,
+    boolean pPromotion
+)
+{
+    motelTreeNodeHandle lNode;
+
+    motelTreeLink * lLink;
+
+    long lComparisonResult;
+
+    for (lLink = &pTree->root; NULL != LinkedNode(pTree, lLink); )
+    {
+        /*
+        ** compare ahead of the copy, which may destruct the original node
+        */
+
+        lComparisonResult = NodeCompare(pTree, * pNode, LinkedNode(pTree, lLink));
+
+        lNode = OwnNode(pTree, lLink);
+
+        if (NULL == lNode)
+        {
+            return (FALSE); // pass through result code
+        }
+
+        if (0 == lComparisonResult)
+        {
+            * pNode = lNode;
+
+            if (!pPromotion)
+            {
+                break;
+            }
+
+            /*
+            ** continue on as DeleteNode() would to the node it promotes
+            */
+
+            lComparisonResult = NULL != NodeLesser(pTree, lNode) ? LESS_THAN : MORE_THAN;
+        }
+
+        if (0 > lComparisonResult)
+        {
+            lLink = &lNode->lesser;
+        }
+        else
+        {
+            lLink = &lNode->greater;
+        }
+    }
+
+    return (TRUE);
+}
+
+static boolean ReleaseNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+)
+{
+    motelTreeNodeHandle lGreater;
+
+    /*
+    ** a node is destructed by whichever version lets go of it last, releasing
+    ** its lesser branch by recursion and its greater branch by iteration; the
+    ** version that constructed the node drops its charge as it lets go, ahead
+    ** of the count, so that the node is charged to none of the versions that
+    ** go on holding it until one of them holds it alone and changes it
+    */
+
+    while (NULL != pNode)
+    {
+        if (pTree->version == AtomicRead(NodeOwner(pTree, pNode)))
+        {
+            * NodeOwner(pTree, pNode) = 0;
+
+            pTree->size -= pTree->nodeSize;
+        }
+
+        if (0 != AtomicDecrement(NodeReferences(pTree, pNode)))
+        {
+            break;
+        }
+
+        if (!ReleaseNode(pTree, NodeLesser(pTree, pNode)))
+        {
+            return (FALSE);
+        }
+
+        lGreater = NodeGreater(pTree, pNode);
+
+        if (!DestructNode(pTree, pNode))
+        {
+            return (FALSE); // pass through result code
+        }
+
+        pNode = lGreater;
+    }
+
+    return (TRUE);
+}
+
+static motelTreeNodeHandle GetEqualNode
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    unsigned long pInstance
+)
+{
+    motelTreeNodeHandle lNode;
+
+    pTree->result = motelResult_NotFound;
+
+    lNode = FindEqualNode(pTree, pKey, pInstance);
+
+    if (NULL != lNode)
+    {
+        pTree->result = motelResult_OK;
+    }
+
+    return (lNode);
+}
+
+static FORCE_INLINE unsigned long DescendInsertNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pInsertNode,
+    motelTreeLink ** pRebuildLink,
+    motelTreeKeyType pKeyType
+)
+{
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lChild;
+
+    motelTreeLink * lLink;
+
+    long lComparisonResult;
+
+    unsigned long lRebalanceThreshold;
+    unsigned long lPivots;
+    unsigned long lDepth = 1;
+
+    /*
+    ** traverse the tree to find the insertion point, keeping the link to the
+    ** current node for a parentless tree's pivots
+    */
+
+    lNode = TreeRoot(pTree);
+    lLink = &pTree->root;
+
+    lRebalanceThreshold = pTree->balance.numerator;
+
+    for (;;)
+    {
+        lComparisonResult = CompareTypedKeys(pTree, pKeyType, NodeKey(pInsertNode), NodeKey(lNode));
+
+        if (0 == lComparisonResult)
+        {
+            pInsertNode->instance = lNode->instance + 1;
+
+            lComparisonResult = MORE_THAN;
+        }
+
+        if (0 > lComparisonResult)
+        {
+            /*
+            ** traverse lesser
+            */
+
+            if (ReachesThreshold(lNode->lesserNullNodes, lNode->greaterNullNodes, lRebalanceThreshold, pTree->balance.denominator))
+            {
+                if (motelTreeBalanceMode_Rebuild != pTree->balance.mode)
+                {
+                    lPivots = RebalanceLesserToGreater(pTree, &lNode, lDepth);
+
+                    if (0 < lPivots)
+                    {
+                        CountTreeStatistic(pTree, insertPivots, lPivots);
+
+                        SetLinkedNode(pTree, lLink, lNode);
+
+                        lRebalanceThreshold += pTree->balance.denominator; /* prevents rebalance hysteresis */
+
+                        continue;
+                    }
+                }
+                else if (NULL == * pRebuildLink)
+                {
+                    /*
+                    ** only the highest subtree out of balance is rebuilt
+                    */
+
+                    * pRebuildLink = lLink;
+                }
+            }
+
+            lNode->lesserNullNodes += 1;
+
+            lChild = NodeLesser(pTree, lNode);
+
+            if (NULL == lChild)
+            {
+                if (!pTree->parentless)
+                {
+                    SetNodeParent(pTree, pInsertNode, lNode);
+                }
+
+                SetNodeLesser(pTree, lNode, pInsertNode);
+                break;
+            }
+
+            lLink = &lNode->lesser;
+        }
+        else // (0 < lComparisonResult)
+        {
+            /*
+            ** traverse greater
+            */
+
+            if (ReachesThreshold(lNode->greaterNullNodes, lNode->lesserNullNodes, lRebalanceThreshold, pTree->balance.denominator))
+            {
+                if (motelTreeBalanceMode_Rebuild != pTree->balance.mode)
+                {
+                    lPivots = RebalanceGreaterToLesser(pTree, &lNode, lDepth);
+
+                    if (0 < lPivots)
+                    {
+                        CountTreeStatistic(pTree, insertPivots, lPivots);
+
+                        SetLinkedNode(pTree, lLink, lNode);
+
+                        lRebalanceThreshold += pTree->balance.denominator; /* prevents rebalance hysteresis */
+
+                        continue;
+                    }
+                }
+                else if (NULL == * pRebuildLink)
+                {
+                    /*
+                    ** only the highest subtree out of balance is rebuilt
+                    */
+
+                    * pRebuildLink = lLink;
+                }
+            }
+
+            lNode->greaterNullNodes += 1;
+
+            lChild = NodeGreater(pTree, lNode);
+
+            if (NULL == lChild)
+            {
+                if (!pTree->parentless)
+                {
+                    SetNodeParent(pTree, pInsertNode, lNode);
+                }
+
+                SetNodeGreater(pTree, lNode, pInsertNode);
+                break;
+            }
+
+            lLink = &lNode->greater;
+        }
+
+        lNode = lChild;
+
+        lRebalanceThreshold = pTree->balance.numerator;
+
+        lDepth += 1;
+    }
+
+    return (lDepth);
+}
+
+static motelTreeNodeHandle FindEqualNode
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    unsigned long pInstance
+)
+{
+    /*
+    ** there is no key
+    */
+
+    if (NULL == pKey)
+    {
+        return (NULL);
+    }
+
+    /*
+    ** descend with the comparison of the tree's key type expanded in place
+    */
+
+    switch (pTree->keyType)
+    {
+        case motelTreeKeyType_Signed32:
+
+            return (DescendEqualNode(pTree, pKey, pInstance, motelTreeKeyType_Signed32));
+
+        case motelTreeKeyType_Unsigned32:
+
+            return (DescendEqualNode(pTree, pKey, pInstance, motelTreeKeyType_Unsigned32));
+
+        case motelTreeKeyType_Signed64:
+
+            return (DescendEqualNode(pTree, pKey, pInstance, motelTreeKeyType_Signed64));
+
+        case motelTreeKeyType_Unsigned64:
+
+            return (DescendEqualNode(pTree, pKey, pInstance, motelTreeKeyType_Unsigned64));
+
+        case motelTreeKeyType_Bytes:
+
+            return (DescendEqualNode(pTree, pKey, pInstance, motelTreeKeyType_Bytes));
+
+        default:
+
+            return (DescendEqualNode(pTree, pKey, pInstance, motelTreeKeyType_Custom));
+    }
+}
+
+static FORCE_INLINE motelTreeNodeHandle DescendEqualNode
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    unsigned long pInstance,
+    motelTreeKeyType pKeyType
+)
+{
+    motelTreeNodeHandle lNode;
+
+    long lComparisonResult;
+
+    /*
+    ** traverse towards the node that matches the key object value
+    */
+
+    lNode = TreeRoot(pTree);
+
+    while (NULL != lNode)
+    {
+        lComparisonResult = CompareTypedKeys(pTree, pKeyType, (const void *) pKey, NodeKey(lNode));
+
+        if (0 == lComparisonResult)
+        {
+            /*
+            ** find the least instance of a potential duplicate
+            */
+            
+            if (0 == pInstance)
+            {
+                while (NULL != NodeLesser(pTree, lNode) && 0 == CompareTypedKeys(pTree, pKeyType, (const void *) pKey, NodeKey(NodeLesser(pTree, lNode))))
+                {
+                    lNode = NodeLesser(pTree, lNode);
+                }
+
+                break;
+            }
+            else
+            {
+                lComparisonResult = (pInstance < lNode->instance) ? LESS_THAN : (pInstance > lNode->instance) ? MORE_THAN : EQUAL_TO;
+            }
+        }
+
+        if (0 > lComparisonResult)
+        {
+            lNode = NodeLesser(pTree, lNode); /* traverse lesser */
+        }
+        else if (0 < lComparisonResult)
+        {
+            lNode = NodeGreater(pTree, lNode); /* traverse greater */
+        }
+        else /* (0 == lComparisonResult) */
+        {
+            break;
+        }
+    }
+
+    return (lNode);
+}
+
+static FORCE_INLINE long CompareKeyObjects
+(
+    motelTreeKeyType pKeyType,
+    size_t pKeySize,
+    long (* pCompareKeyFunction)(const void * pKey1, const void * pKey2),
+    const void * pKey1,
+    const void * pKey2
+)
+{
+    switch (pKeyType)
+    {
+        case motelTreeKeyType_Signed32:
+
+            return ((long) (* (const integer32 *) pKey1 > * (const integer32 *) pKey2) - (long) (* (const integer32 *) pKey1 < * (const integer32 *) pKey2));
+
+        case motelTreeKeyType_Unsigned32:
+
+            return ((long) (* (const bits32 *) pKey1 > * (const bits32 *) pKey2) - (long) (* (const bits32 *) pKey1 < * (const bits32 *) pKey2));
+
+        case motelTreeKeyType_Signed64:
+
+            return ((long) (* (const integer64 *) pKey1 > * (const integer64 *) pKey2) - (long) (* (const integer64 *) pKey1 < * (const integer64 *) pKey2));
+
+        case motelTreeKeyType_Unsigned64:
+
+            return ((long) (* (const bits64 *) pKey1 > * (const bits64 *) pKey2) - (long) (* (const bits64 *) pKey1 < * (const bits64 *) pKey2));
+
+        case motelTreeKeyType_Bytes:
+
+            return ((long) memcmp(pKey1, pKey2, pKeySize));
+
+        default:
+
+            return (pCompareKeyFunction(pKey1, pKey2));
+    }
+}
+
+static INLINE long CompareKeys
+(
+    motelTreeHandle pTree,
+    const void * pKey1,
+    const void * pKey2
+)
+{
+    CountTreeStatistic(pTree, comparisons, 1);
+
+    return (CompareKeyObjects(pTree->keyType, pTree->keySize, pTree->compareKeyFunction, pKey1, pKey2));
+}
+
+static FORCE_INLINE long CompareTypedKeys
+(
+    motelTreeHandle pTree,
+    motelTreeKeyType pKeyType,
+    const void * pKey1,
+    const void * pKey2
+)
+{
+    CountTreeStatistic(pTree, comparisons, 1);
+
+    return (CompareKeyObjects(pKeyType, pTree->keySize, pTree->compareKeyFunction, pKey1, pKey2));
+}
+
+static INLINE long CompareReadKeys
+(
+    motelTreeHandle pTree,
+    const void * pKey1,
+    const void * pKey2
+)
+{
+    return (CompareKeyObjects(pTree->keyType, pTree->keySize, pTree->compareKeyFunction, pKey1, pKey2));
+}
+
+static long NodeCompare
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode1,
+    motelTreeNodeHandle pNode2
+)
+{
+    long lComparisonResult;
+
+    lComparisonResult = CompareKeys(pTree, NodeKey(pNode1), NodeKey(pNode2));
+
+    if (0 == lComparisonResult)
+    {
+        lComparisonResult = (pNode1->instance < pNode2->instance) ? LESS_THAN : (pNode1->instance > pNode2->instance) ? MORE_THAN : EQUAL_TO;
+    }
+
+    return (lComparisonResult);
+}
+
+static motelTreeNodeHandle GetLeastNode
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeNodeHandle lNode = (motelTreeNodeHandle) NULL;
+    motelTreeNodeHandle lChild;
+
+    pTree->result = motelResult_NotFound;
+
+    /*
+    ** traverse towards the most lesser leaf
+    */
+
+    lChild = TreeRoot(pTree);
+
+    while (NULL != lChild)
+    {
+        lNode = lChild;
+        lChild = NodeLesser(pTree, lNode);
+    }
+
+    if (NULL != lNode)
+    {
+        pTree->result = motelResult_OK;
+    }
+
+    return (lNode);
+}
+
+static motelTreeNodeHandle GetGreatestNode
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeNodeHandle lNode = (motelTreeNodeHandle) NULL;
+    motelTreeNodeHandle lChild;
+
+    pTree->result = motelResult_NotFound;
+
+    /*
+    ** traverse towards the most greater leaf
+    */
+
+    lChild = TreeRoot(pTree);
+
+    while (NULL != lChild)
+    {
+        lNode = lChild;
+        lChild = NodeGreater(pTree, lNode);
+    }
+
+    if (NULL != lNode)
+    {
+        pTree->result = motelResult_OK;
+    }
+
+    return (lNode);
+}
+
+static motelTreeNodeHandle GetLesserNode
+(
+    motelTreeHandle pTree
+)
+{ 
+    motelTreeNodeHandle lCurrentNode;
+
+    pTree->result = motelResult_NotFound;
+
+    lCurrentNode = pTree->cursor;
+
+    /*
+    ** there is no node
+    */
+
+    if (NULL == lCurrentNode)
+    {
+        return (NULL);
+    }
+
+    /*
+    ** step to the previous occurrence of a grouped key
+    */
+
+    if (pTree->groupDuplicates && 0 < pTree->occurrence)
+    {
+        pTree->occurrence -= 1;
+
+        pTree->result = motelResult_OK;
+
+        return (lCurrentNode);
+    }
+
+    /*
+    ** traverse to the next lesser node in the tree
+    */
+
+    lCurrentNode = SeekLesserNode(pTree, lCurrentNode);
+
+    /*
+    ** node not found
+    */
+
+    if (NULL != lCurrentNode)
+    {
+        pTree->result = motelResult_OK;
+
+        if (pTree->groupDuplicates)
+        {
+            pTree->occurrence = NodeOccurrences(pTree, lCurrentNode)->count - 1;
+        }
+    }
+
+    return (lCurrentNode);
+}
+
+static motelTreeNodeHandle GetGreaterNode
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeNodeHandle lCurrentNode;
+
+    pTree->result = motelResult_NotFound;
+
+    lCurrentNode = pTree->cursor;
+
+    /*
+    ** there is no node
+    */
+
+    if (NULL == lCurrentNode)
+    {
+        return (NULL);
+    }
+
+    /*
+    ** step to the next occurrence of a grouped key
+    */
+
+    if (pTree->groupDuplicates && pTree->occurrence + 1 < NodeOccurrences(pTree, lCurrentNode)->count)
+    {
+        pTree->occurrence += 1;
+
+        pTree->result = motelResult_OK;
+
+        return (lCurrentNode);
+    }
+
+    /*
+    ** traverse to the next greater node in the tree
+    */
+
+    lCurrentNode = SeekGreaterNode(pTree, lCurrentNode);
+
+    if (NULL != lCurrentNode)
+    {
+        pTree->result = motelResult_OK;
+
+        if (pTree->groupDuplicates)
+        {
+            pTree->occurrence = 0;
+        }
+    }
+
+    return (lCurrentNode);
+}
+
+static motelTreeNodeHandle StepLesserNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+)
+{ 
+    motelTreeNodeHandle lCurrentNode = pNode;
+
+    motelTreeNodeHandle lChild;
+
+    lChild = NodeLesser(pTree, lCurrentNode);
+
+    if (NULL != lChild)
+    {
+        /*
+        ** get the greater node of the lesser branch of the node passed
+        */
+
+        do
+        {
+            lCurrentNode = lChild;
+            lChild = NodeGreater(pTree, lCurrentNode); /* traverse towards a leaf */
+        } 
+        while (NULL != lChild);
+    }
+    else
+    {
+        /*
+        ** get the first ancestor of the node passed that references the node's
+        ** subtree via a greater branch
+        */
+
+        do
+        {
+            lChild = lCurrentNode;
+            lCurrentNode = NodeParent(pTree, lChild); /* traverse towards the root */
+        }
+        while (NULL != lCurrentNode && lChild != NodeGreater(pTree, lCurrentNode));
+    }
+
+    return (lCurrentNode);
+}
+
+static motelTreeNodeHandle StepGreaterNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+)
+{
+    motelTreeNodeHandle lCurrentNode = pNode;
+
+    motelTreeNodeHandle lChild;
+
+    lChild = NodeGreater(pTree, lCurrentNode);
+
+    if (NULL != lChild)
+    {
+        /*
+        ** get the lesser node of the greater branch of the node passed
+        */
+
+        do
+        {
+            lCurrentNode = lChild;
+            lChild = NodeLesser(pTree, lCurrentNode); /* traverse towards a leaf */
+        } 
+        while (NULL != lChild);
+    }
+    else
+    {
+        /*
+        ** get the first ancestor of the node passed that references the node's
+        ** subtree via a lesser branch
+        */
+
+        do
+        {
+            lChild = lCurrentNode;
+            lCurrentNode = NodeParent(pTree, lChild); /* traverse towards the root */
+        }
+        while (NULL != lCurrentNode && lChild != NodeLesser(pTree, lCurrentNode));
+    }
+
+    return (lCurrentNode);
+}
+
+static motelTreeNodeHandle SeekLesserNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+)
+{
+    motelTreeNodeHandle lLesserNode;
+    motelTreeNodeHandle lNode;
+
+    if (!pTree->parentless)
+    {
+        return (StepLesserNode(pTree, pNode));
+    }
+
+    /*
+    ** the greatest node of the lesser branch of the node passed
+    */
+
+    lNode = NodeLesser(pTree, pNode);
+
+    if (NULL != lNode)
+    {
+        while (NULL != NodeGreater(pTree, lNode))
+        {
+            lNode = NodeGreater(pTree, lNode);
+        }
+
+        return (lNode);
+    }
+
+    /*
+    ** otherwise the nearest ancestor whose greater branch holds the node passed
+    */
+
+    CountTreeStatistic(pTree, reseeks, 1);
+
+    lLesserNode = (motelTreeNodeHandle) NULL;
+
+    for (lNode = TreeRoot(pTree); pNode != lNode; )
+    {
+        if (0 > NodeCompare(pTree, pNode, lNode))
+        {
+            lNode = NodeLesser(pTree, lNode);
+        }
+        else
+        {
+            lLesserNode = lNode;
+
+            lNode = NodeGreater(pTree, lNode);
+        }
+    }
+
+    return (lLesserNode);
+}
+
+static motelTreeNodeHandle SeekGreaterNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+)
+{
+    motelTreeNodeHandle lGreaterNode;
+    motelTreeNodeHandle lNode;
+
+    if (!pTree->parentless)
+    {
+        return (StepGreaterNode(pTree, pNode));
+    }
+
+    /*
+    ** the least node of the greater branch of the node passed
+    */
+
+    lNode = NodeGreater(pTree, pNode);
+
+    if (NULL != lNode)
+    {
+        while (NULL != NodeLesser(pTree, lNode))
+        {
+            lNode = NodeLesser(pTree, lNode);
+        }
+
+        return (lNode);
+    }
+
+    /*
+    ** otherwise the nearest ancestor whose lesser branch holds the node passed
+    */
+
+    CountTreeStatistic(pTree, reseeks, 1);
+
+    lGreaterNode = (motelTreeNodeHandle) NULL;
+
+    for (lNode = TreeRoot(pTree); pNode != lNode; )
+    {
+        if (0 > NodeCompare(pTree, pNode, lNode))
+        {
+            lGreaterNode = lNode;
+
+            lNode = NodeLesser(pTree, lNode);
+        }
+        else
+        {
+            lNode = NodeGreater(pTree, lNode);
+        }
+    }
+
+    return (lGreaterNode);
+}
+
+static void SeekPath
+(
+    motelTreeHandle pTree,
+    motelTreePath * pPath,
+    motelTreeNodeHandle pNode
+)
+{
+    motelTreeNodeHandle lNode;
+
+    pPath->depth = 0;
+
+    if (!pTree->parentless || NULL == pNode)
+    {
+        return;
+    }
+
+    CountTreeStatistic(pTree, reseeks, 1);
+
+    for (lNode = TreeRoot(pTree); pNode != lNode; )
+    {
+        if (0 > NodeCompare(pTree, pNode, lNode))
+        {
+            /*
+            ** a path too deep to hold is abandoned for descents from the root
+            */
+
+            if (MAXIMUM_TREE_PATH == pPath->depth)
+            {
+                pPath->depth = MAXIMUM_TREE_PATH + 1;
+
+                return;
+            }
+
+            pPath->nodes[pPath->depth++] = lNode;
+
+            lNode = NodeLesser(pTree, lNode);
+        }
+        else
+        {
+            lNode = NodeGreater(pTree, lNode);
+        }
+    }
+}
+
+static motelTreeNodeHandle StepPathGreater
+(
+    motelTreeHandle pTree,
+    motelTreePath * pPath,
+    motelTreeNodeHandle pNode
+)
+{
+    motelTreeNodeHandle lNode;
+
+    if (!pTree->parentless || MAXIMUM_TREE_PATH < pPath->depth)
+    {
+        return (SeekGreaterNode(pTree, pNode));
+    }
+
+    lNode = NodeGreater(pTree, pNode);
+
+    /*
+    ** the next node is the one most recently passed on the way lesser
+    */
+
+    if (NULL == lNode)
+    {
+        return (0 == pPath->depth ? (motelTreeNodeHandle) NULL : pPath->nodes[--pPath->depth]);
+    }
+
+    /*
+    ** or else the least node of the greater branch
+    */
+
+    while (NULL != NodeLesser(pTree, lNode))
+    {
+        if (MAXIMUM_TREE_PATH == pPath->depth)
+        {
+            pPath->depth = MAXIMUM_TREE_PATH + 1;
+
+            return (SeekGreaterNode(pTree, pNode));
+        }
+
+        pPath->nodes[pPath->depth++] = lNode;
+
+        lNode = NodeLesser(pTree, lNode);
+    }
+
+    return (lNode);
+}
+
+static motelTreeNodeHandle GetRootNode
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeNodeHandle lNode;
+
+    pTree->result = motelResult_NotFound;
+
+    lNode = TreeRoot(pTree);
+
+    if (NULL != lNode)
+    {
+        pTree->result = motelResult_OK;
+    }
+
+    return (lNode);
+}
+
+static motelTreeNodeHandle GetParentNode
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeNodeHandle lCurrentNode;
+    motelTreeNodeHandle lParentNode;
+    motelTreeNodeHandle lNode;
+
+    pTree->result = motelResult_OK;
+
+    lCurrentNode = pTree->cursor;
+
+    /*
+    ** there is no node
+    */
+
+    if (NULL == lCurrentNode)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (NULL);
+    }
+
+    if (!pTree->parentless)
+    {
+        return (NodeParent(pTree, lCurrentNode));
+    }
+
+    /*
+    ** the parent of a parentless tree's node is the last node passed on the
+    ** way down to it
+    */
+
+    lParentNode = (motelTreeNodeHandle) NULL;
+
+    for (lNode = TreeRoot(pTree); lCurrentNode != lNode; lNode = 0 > NodeCompare(pTree, lCurrentNode, lNode) ? NodeLesser(pTree, lNode) : NodeGreater(pTree, lNode))
+    {
+        lParentNode = lNode;
+    }
+
+    return (lParentNode);
+}
+
+static motelTreeNodeHandle GetLesserChildNode
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeNodeHandle lCurrentNode;
+
+    pTree->result = motelResult_OK;
+
+    lCurrentNode = pTree->cursor;
+
+    /*
+    ** there is no node
+    */
+
+    if (NULL == lCurrentNode)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (NULL);
+    }
+
+    return (NodeLesser(pTree, lCurrentNode));
+}
+
+static motelTreeNodeHandle GetGreaterChildNode
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeNodeHandle lCurrentNode;
+
+    pTree->result = motelResult_OK;
+
+    lCurrentNode = pTree->cursor;
+
+    /*
+    ** there is no node
+    */
+
+    if (NULL == lCurrentNode)
+    {
+        pTree->result = motelResult_NullPointer;
+
+        return (NULL);
+    }
+
+    return (NodeGreater(pTree, lCurrentNode));
+}
+
+static unsigned long GetTreeLevelCount
+(
+    motelTreeHandle pTree
+)
+{  
+    unsigned long lBound;
+
+    if (NULL == pTree)
+    {
+        return (0);
+    }
+
+    if (NULL == TreeRoot(pTree))
+    {
+        return (0);
+    }  
+
+    /*
+    ** the tracked count is held to the bound the tree's weight allows, which
+    ** tightens it as deletions leave fewer nodes
+    */
+
+    lBound = GetTreeLevelBound(pTree);
+
+    if (0 == pTree->levels || lBound < pTree->levels)
+    {
+        pTree->levels = lBound;
+    }
+
+    return (pTree->levels);
+}
+
+static unsigned long GetTreeLevelBound
+(
+    motelTreeHandle pTree
+)
+{
+    unsigned long lNodes;
+    unsigned long lBound;
+
+    if (NULL == TreeRoot(pTree))
+    {
+        return (0);
+    }
+
+    /*
+    ** the tree is bounded as a branch of its weight, and is never deeper than
+    ** its number of nodes
+    */
+
+    lNodes = SubtreeNullNodes(TreeRoot(pTree)) - 1;
+
+    lBound = GetBranchLevelBound(pTree, lNodes + 1);
+
+    return ((lNodes < lBound) ? lNodes : lBound);
+}
+
+static unsigned long GetLoadedLevelCount
+(
+    unsigned long pCount
+)
+{
+    unsigned long lLevels;
+
+    /*
+    ** a load divides the nodes evenly at each level, filling every level but
+    ** the last, so the levels are the bits in the number of nodes
+    */
+
+    for (lLevels = 0; 0 != pCount; lLevels++)
+    {
+        pCount >>= 1;
+    }
+
+    return (lLevels);
+}
+
+static unsigned long GetSubtreeLevelCount
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot
+)
+{  
+    long lLesserDepth;
+    long lGreaterDepth;
+
+    if (NULL == pRoot)
+    {
+        return (0);
+    }  
+
+    lLesserDepth = GetSubtreeLevelCount(pTree, NodeLesser(pTree, pRoot));
+    lGreaterDepth = GetSubtreeLevelCount(pTree, NodeGreater(pTree, pRoot));
+
+    return ((lLesserDepth > lGreaterDepth) ? (1 + lLesserDepth) : (1 + lGreaterDepth));
+}
+
+static motelTreeNodeHandle GetRankNode
+(
+    motelTreeHandle pTree,
+    unsigned long pRank
+)
+{
+    motelTreeNodeHandle lNode;
+
+    pTree->result = motelResult_NotFound;
+
+    /*
+    ** traverse towards the node using the lesser branch weights as subtree ranks
+    */
+
+    lNode = TreeRoot(pTree);
+
+    while (NULL != lNode)
+    {
+        if (pRank < lNode->lesserNullNodes)
+        {
+            lNode = NodeLesser(pTree, lNode); /* traverse lesser */
+        }
+        else if (pRank > lNode->lesserNullNodes)
+        {
+            pRank -= lNode->lesserNullNodes;
+
+            lNode = NodeGreater(pTree, lNode); /* traverse greater */
+        }
+        else /* (pRank == lNode->lesserNullNodes) */
+        {
+            pTree->result = motelResult_OK;
+            break;
+        }
+    }
+
+    return (lNode);
+}
+
+static unsigned long CountLesserNodes
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    boolean pInclusive
+)
+{
+    motelTreeNodeHandle lNode;
+
+    long lComparisonResult;
+
+    unsigned long lCount = 0;
+
+    /*
+    ** traverse towards the key accumulating the nodes passed on the lesser side
+    */
+
+    lNode = TreeRoot(pTree);
+
+    while (NULL != lNode)
+    {
+        lComparisonResult = CompareKeys(pTree, pKey, NodeKey(lNode));
+
+        if (0 < lComparisonResult || (0 == lComparisonResult && pInclusive))
+        {
+            lCount += lNode->lesserNullNodes; /* the node and its lesser branch */
+
+            lNode = NodeGreater(pTree, lNode);
+        }
+        else
+        {
+            lNode = NodeLesser(pTree, lNode);
+        }
+    }
+
+    return (lCount);
+}
+
+static motelTreeNodeHandle GetBoundNode
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    boolean pInclusive
+)
+{
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lBoundNode = (motelTreeNodeHandle) NULL;
+
+    long lComparisonResult;
+
+    pTree->result = motelResult_NotFound;
+
+    /*
+    ** traverse towards the key remembering the last node passed on the greater side
+    */
+
+    lNode = TreeRoot(pTree);
+
+    while (NULL != lNode)
+    {
+        lComparisonResult = CompareKeys(pTree, pKey, NodeKey(lNode));
+
+        if (0 > lComparisonResult || (0 == lComparisonResult && pInclusive))
+        {
+            lBoundNode = lNode; /* the node is within the bound */
+
+            lNode = NodeLesser(pTree, lNode);
+        }
+        else
+        {
+            lNode = NodeGreater(pTree, lNode);
+        }
+    }
+
+    if (NULL != lBoundNode)
+    {
+        pTree->result = motelResult_OK;
+    }
+
+    return (lBoundNode);
+}
+
+static void PivotLesserToGreater
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pRoot
+)
+{
+    motelTreeNodeHandle lOldRoot = * pRoot;
+    motelTreeNodeHandle lNewRoot = NodeLesser(pTree, lOldRoot);
+
+    /*
+    ** the caller relinks the new root of a parentless tree's subtree
+    */
+
+    if (!pTree->parentless)
+    {
+        SetNodeParent(pTree, lNewRoot, NodeParent(pTree, lOldRoot));
+
+        /*
+        ** the root of a detached subtree has no parent to update
+        */
+
+        if (NULL == NodeParent(pTree, lOldRoot))
+        {
+            if (TreeRoot(pTree) == lOldRoot)
+            {
+                SetTreeRoot(pTree, lNewRoot);
+            }
+        }
+        else
+        {
+            if (NodeLesser(pTree, NodeParent(pTree, lOldRoot)) == lOldRoot)
+            {
+                SetNodeLesser(pTree, NodeParent(pTree, lOldRoot), lNewRoot);
+            }
+            else
+            {
+                SetNodeGreater(pTree, NodeParent(pTree, lOldRoot), lNewRoot);
+            }
+        }
+
+        SetNodeParent(pTree, lOldRoot, lNewRoot);
+
+        if (NULL != NodeGreater(pTree, lNewRoot))
+        {
+            SetNodeParent(pTree, NodeGreater(pTree, lNewRoot), lOldRoot);
+        }
+    }
+
+    SetNodeLesser(pTree, lOldRoot, NodeGreater(pTree, lNewRoot));
+
+    SetNodeGreater(pTree, lNewRoot, lOldRoot);
+
+    /*
+    ** update child node counts for the new and old parent working from lower to higher in the subtree
+    */
+
+    if (NULL == NodeLesser(pTree, lOldRoot))
+    {
+        lOldRoot->lesserNullNodes = 1;
+    }
+    else
+    {
+        lOldRoot->lesserNullNodes = NodeLesser(pTree, lOldRoot)->lesserNullNodes + NodeLesser(pTree, lOldRoot)->greaterNullNodes;
+    }
+
+    lNewRoot->greaterNullNodes = lOldRoot->lesserNullNodes + lOldRoot->greaterNullNodes;
+
+    /*
+    ** set the new parent in the calling function's variable so that in process tree traversals can continue
+    */
+
+    (* pRoot) = lNewRoot;
+}
+
+static void PivotGreaterToLesser
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pRoot
+)
+{
+    motelTreeNodeHandle lOldRoot = (* pRoot);
+    motelTreeNodeHandle lNewRoot = NodeGreater(pTree, lOldRoot);
+
+    /*
+    ** the caller relinks the new root of a parentless tree's subtree
+    */
+
+    if (!pTree->parentless)
+    {
+        SetNodeParent(pTree, lNewRoot, NodeParent(pTree, lOldRoot));
+
+        /*
+        ** the root of a detached subtree has no parent to update
+        */
+
+        if (NULL == NodeParent(pTree, lOldRoot))
+        {
+            if (TreeRoot(pTree) == lOldRoot)
+            {
+                SetTreeRoot(pTree, lNewRoot);
+            }
+        }
+        else
+        {
+            if (NodeLesser(pTree, NodeParent(pTree, lOldRoot)) == lOldRoot)
+            {
+                SetNodeLesser(pTree, NodeParent(pTree, lOldRoot), lNewRoot);
+            }
+            else
+            {
+                SetNodeGreater(pTree, NodeParent(pTree, lOldRoot), lNewRoot);
+            }
+        }
+
+        SetNodeParent(pTree, lOldRoot, lNewRoot);
+
+        if (NULL != NodeLesser(pTree, lNewRoot))
+        {
+            SetNodeParent(pTree, NodeLesser(pTree, lNewRoot), lOldRoot);
+        }
+    }
+
+    SetNodeGreater(pTree, lOldRoot, NodeLesser(pTree, lNewRoot));
+
+    SetNodeLesser(pTree, lNewRoot, lOldRoot);
+
+    /*
+    ** update child node counts for the new and old parent working from lower to higher in the subtree
+    */
+
+    if (NULL == NodeGreater(pTree, lOldRoot))
+    {
+        lOldRoot->greaterNullNodes = 1;
+    }
+    else
+    {
+        lOldRoot->greaterNullNodes = NodeGreater(pTree, lOldRoot)->lesserNullNodes + NodeGreater(pTree, lOldRoot)->greaterNullNodes;
+    }
+
+    lNewRoot->lesserNullNodes = lOldRoot->lesserNullNodes + lOldRoot->greaterNullNodes;
+
+    /*
+    ** set the new parent in the calling function's variable so that in process tree traversals can continue
+    */
+
+    (* pRoot) = lNewRoot;
+}
+
+static unsigned long RebalanceLesserToGreater
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pRoot,
+    unsigned long pLevel
+)
+{
+    motelTreeNodeHandle lLesser;
+
+    /*
+    ** a persistent tree pivots only its own copies of the nodes
+    */
+
+    if (pTree->persistent && NULL == OwnNode(pTree, &(* pRoot)->lesser))
+    {
+        return (0);
+    }
+
+    lLesser = NodeLesser(pTree, * pRoot);
+
+    /*
+    ** either way only the greater branch ends up a level lower
+    */
+
+    TrackPivotLevels(pTree, pLevel, NodeGreater(pTree, * pRoot));
+
+    /*
+    ** a heavier inner grandchild is pivoted up first so that it becomes the subtree root
+    */
+
+    if (motelTreeBalanceMode_DoublePivot == pTree->balance.mode && lLesser->greaterNullNodes > lLesser->lesserNullNodes &&
+        (!pTree->persistent || NULL != OwnNode(pTree, &lLesser->greater)))
+    {
+        PivotGreaterToLesser(pTree, &lLesser);
+
+        SetNodeLesser(pTree, * pRoot, lLesser);
+
+        PivotLesserToGreater(pTree, pRoot);
+
+        return (2);
+    }
+
+    PivotLesserToGreater(pTree, pRoot);
+
+    return (1);
+}
+
+static unsigned long RebalanceGreaterToLesser
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pRoot,
+    unsigned long pLevel
+)
+{
+    motelTreeNodeHandle lGreater;
+
+    /*
+    ** a persistent tree pivots only its own copies of the nodes
+    */
+
+    if (pTree->persistent && NULL == OwnNode(pTree, &(* pRoot)->greater))
+    {
+        return (0);
+    }
+
+    lGreater = NodeGreater(pTree, * pRoot);
+
+    /*
+    ** either way only the lesser branch ends up a level lower
+    */
+
+    TrackPivotLevels(pTree, pLevel, NodeLesser(pTree, * pRoot));
+
+    /*
+    ** a heavier inner grandchild is pivoted up first so that it becomes the subtree root
+    */
+
+    if (motelTreeBalanceMode_DoublePivot == pTree->balance.mode && lGreater->lesserNullNodes > lGreater->greaterNullNodes &&
+        (!pTree->persistent || NULL != OwnNode(pTree, &lGreater->lesser)))
+    {
+        PivotLesserToGreater(pTree, &lGreater);
+
+        SetNodeGreater(pTree, * pRoot, lGreater);
+
+        PivotGreaterToLesser(pTree, pRoot);
+
+        return (2);
+    }
+
+    PivotGreaterToLesser(pTree, pRoot);
+
+    return (1);
+}
+
+static void TrackPivotLevels
+(
+    motelTreeHandle pTree,
+    unsigned long pLevel,
+    motelTreeNodeHandle pBranch
+)
+{
+    unsigned long lNullNodes;
+    unsigned long lLevels;
+
+    /*
+    ** a tree whose nodes are detached for a split has its levels bounded
+    ** afresh once they are placed
+    */
+
+    if (0 == pTree->levels)
+    {
+        return;
+    }
+
+    /*
+    ** the lowered branch's root lands two levels below the pivoted node; a
+    ** branch with too few nodes to reach the deepest level is passed over
+    */
+
+    lNullNodes = SubtreeNullNodes(pBranch);
+
+    if (pTree->levels >= pLevel + lNullNodes)
+    {
+        return;
+    }
+
+    /*
+    ** a small branch is counted, while a larger one is bounded by its weight
+    ** rather than have its nodes walked, sinking no more than the one level
+    */
+
+    if (lNullNodes <= TRACKED_BRANCH_NODES)
+    {
+        lLevels = pLevel + 1 + GetSubtreeLevelCount(pTree, pBranch);
+    }
+    else
+    {
+        lLevels = pLevel + 1 + GetBranchLevelBound(pTree, lNullNodes);
+
+        if (pTree->levels + 1 < lLevels)
+        {
+            lLevels = pTree->levels + 1;
+        }
+    }
+
+    if (pTree->levels < lLevels)
+    {
+        pTree->levels = lLevels;
+    }
+}
+
+static unsigned long GetBranchLevelBound
+(
+    motelTreeHandle pTree,
+    unsigned long pNullNodes
+)
+{
+    unsigned long lBits;
+
+    for (lBits = 0; 0 != pNullNodes; lBits++)
+    {
+        pNullNodes >>= 1;
+    }
+
+    return ((lBits * pTree->levelScale + 19) / 20);
+}
+
+static boolean LoadSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeLoad * pLoad,
+    unsigned long pCount,
+    motelTreeNodeHandle * pRoot
+)
+{
+    motelTreeNodeHandle lNode;
+
+    motelTreeNodeHandle lLesser;
+    motelTreeNodeHandle lGreater;
+
+    unsigned long lLesserCount;
+    unsigned long lGreaterCount;
+
+    long lComparisonResult;
+
+    motelResult lResult;
+
+    * pRoot = (motelTreeNodeHandle) NULL;
+
+    if (0 == pCount)
+    {
+        return (TRUE);
+    }
+
+    /*
+    ** split the nodes evenly between the branches
+    */
+
+    lLesserCount = (pCount - 1) / 2;
+    lGreaterCount = (pCount - 1) - lLesserCount;
+
+    /*
+    ** build the lesser branch
+    */
+
+    if (!LoadSubtree(pTree, pLoad, lLesserCount, &lLesser))
+    {
+        return (FALSE); // pass through result code
+    }
+
+    /*
+    ** the key objects must be in order
+    */
+
+    if (NULL != pLoad->previous)
+    {
+        lComparisonResult = CompareKeys(pTree, (const void *) pLoad->keys, NodeKey(pLoad->previous));
+
+        if (0 > lComparisonResult)
+        {
+            PruneSubtree(pTree, lLesser);
+
+            pTree->result = motelResult_InvalidValue;
+
+            return (FALSE);
+        }
+    }
+    else
+    {
+        lComparisonResult = MORE_THAN;
+    }
+
+    /*
+    ** construct the subtree root
+    */
+
+    if (!ConstructNode(pTree, (void *) pLoad->keys, (void *) pLoad->data, &lNode))
+    {
+        lResult = pTree->result;
+
+        PruneSubtree(pTree, lLesser);
+
+        pTree->result = lResult;
+
+        return (FALSE);
+    }
+
+    if (NULL != pLoad->instances)
+    {
+#if defined COMPACT_TREE_NODES
+
+        /*
+        ** a compact node cannot hold an instance beyond 32 bits
+        */
+
+        if (MAXIMUM_COMPACT_INSTANCE < * (unsigned long *) pLoad->instances)
+        {
+            PruneSubtree(pTree, lLesser);
+            PruneSubtree(pTree, lNode);
+
+            pTree->result = motelResult_InvalidValue;
+
+            return (FALSE);
+        }
+
+#endif
+
+        lNode->instance = * (unsigned long *) pLoad->instances;
+
+        pLoad->instances += pLoad->instanceStride;
+    }
+    else if (0 == lComparisonResult)
+    {
+        lNode->instance = pLoad->previous->instance + 1;
+    }
+
+#if defined COMPACT_TREE_NODES
+
+    if (pTree->greatestInstance < lNode->instance)
+    {
+        pTree->greatestInstance = lNode->instance;
+    }
+
+#endif
+
+    pLoad->keys += pLoad->keyStride;
+    pLoad->data += pLoad->dataStride;
+
+    pLoad->previous = lNode;
+
+    /*
+    ** build the greater branch
+    */
+
+    if (!LoadSubtree(pTree, pLoad, lGreaterCount, &lGreater))
+    {
+        lResult = pTree->result;
+
+        PruneSubtree(pTree, lLesser);
+        PruneSubtree(pTree, lNode);
+
+        pTree->result = lResult;
+
+        return (FALSE);
+    }
+
+    /*
+    ** connect the branches to the subtree root
+    */
+
+    SetNodeLesser(pTree, lNode, lLesser);
+    lNode->lesserNullNodes = lLesserCount + 1;
+
+    if (NULL != lLesser)
+    {
+        SetNodeParent(pTree, lLesser, lNode);
+    }
+
+    SetNodeGreater(pTree, lNode, lGreater);
+    lNode->greaterNullNodes = lGreaterCount + 1;
+
+    if (NULL != lGreater)
+    {
+        SetNodeParent(pTree, lGreater, lNode);
+    }
+
+    * pRoot = lNode;
+
+    return (TRUE);
+}
+
+static boolean SortNodes
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pNodes,
+    motelTreeNodeHandle * pScratch,
+    unsigned long pCount
+)
+{
+    motelTreeNodeHandle * lSource;
+    motelTreeNodeHandle * lTarget;
+    motelTreeNodeHandle * lSwap;
+
+    unsigned long lWidth;
+    unsigned long lStart;
+    unsigned long lMiddle;
+    unsigned long lEnd;
+    unsigned long lLesser;
+    unsigned long lGreater;
+    unsigned long lIndex;
+
+    lSource = pNodes;
+    lTarget = pScratch;
+
+    /*
+    ** merge ever wider runs, taking from the lesser run on equal keys to keep the array order
+    */
+
+    for (lWidth = 1; lWidth < pCount; lWidth *= 2)
+    {
+        for (lStart = 0; lStart < pCount; lStart += 2 * lWidth)
+        {
+            lMiddle = (pCount - lStart < lWidth ? pCount : lStart + lWidth);
+            lEnd = (pCount - lMiddle < lWidth ? pCount : lMiddle + lWidth);
+
+            /*
+            ** runs that are already in order are copied without comparing every key
+            */
+
+            if (lMiddle == lEnd || 0 <= CompareKeys(pTree, NodeKey(lSource[lMiddle]), NodeKey(lSource[lMiddle - 1])))
+            {
+                memcpy(&lTarget[lStart], &lSource[lStart], (lEnd - lStart) * sizeof(motelTreeNodeHandle));
+
+                continue;
+            }
+
+            lLesser = lStart;
+            lGreater = lMiddle;
+
+            for (lIndex = lStart; lIndex < lEnd; lIndex++)
+            {
+                if (lGreater == lEnd || (lLesser < lMiddle && 0 >= CompareKeys(pTree, NodeKey(lSource[lLesser]), NodeKey(lSource[lGreater]))))
+                {
+                    lTarget[lIndex] = lSource[lLesser++];
+                }
+                else
+                {
+                    lTarget[lIndex] = lSource[lGreater++];
+                }
+            }
+        }
+
+        lSwap = lSource;
+        lSource = lTarget;
+        lTarget = lSwap;
+    }
+
+    if (lSource != pNodes)
+    {
+        memcpy(pNodes, lSource, pCount * sizeof(motelTreeNodeHandle));
+    }
+
+    return (TRUE);
+}
+
+static boolean MergeSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeLink * pSubtree,
+    motelTreeNodeHandle pParent,
+    motelTreeNodeHandle pPrevious,
+    motelTreeNodeHandle * pNodes,
+    unsigned long pCount
+)
+{
+    motelTreeMerge lMerge;
+
+    motelTreeNodeHandle lNode;
+
+    unsigned long lLesserNullNodes;
+    unsigned long lGreaterNullNodes;
+    unsigned long lSplit;
+    unsigned long lLow;
+    unsigned long lHigh;
+
+    unsigned long lRebalanceThreshold = pTree->balance.numerator;
+
+    if (0 == pCount)
+    {
+        return (TRUE);
+    }
+
+    for (lNode = LinkedNode(pTree, pSubtree); NULL != lNode; lNode = LinkedNode(pTree, pSubtree))
+    {
+        /*
+        ** new nodes with key values equal to the subtree root's follow it
+        */
+
+        lLow = 0;
+        lHigh = pCount;
+
+        while (lLow < lHigh)
+        {
+            lSplit = lLow + (lHigh - lLow) / 2;
+
+            if (0 > CompareKeys(pTree, NodeKey(pNodes[lSplit]), NodeKey(lNode)))
+            {
+                lLow = lSplit + 1;
+            }
+            else
+            {
+                lHigh = lSplit;
+            }
+        }
+
+        lSplit = lLow;
+
+        lLesserNullNodes = lNode->lesserNullNodes + lSplit;
+        lGreaterNullNodes = lNode->greaterNullNodes + (pCount - lSplit);
+
+        /*
+        ** a subtree that remains in balance passes each branch its share of the new nodes
+        */
+
+        if (!ReachesThreshold(lLesserNullNodes, lGreaterNullNodes, lRebalanceThreshold, pTree->balance.denominator) &&
+            !ReachesThreshold(lGreaterNullNodes, lLesserNullNodes, lRebalanceThreshold, pTree->balance.denominator))
+        {
+            lNode->lesserNullNodes = lLesserNullNodes;
+            lNode->greaterNullNodes = lGreaterNullNodes;
+
+            MergeSubtree(pTree, &lNode->lesser, lNode, pPrevious, pNodes, lSplit);
+            MergeSubtree(pTree, &lNode->greater, lNode, lNode, pNodes + lSplit, pCount - lSplit);
+
+            return (TRUE);
+        }
+
+        /*
+        ** a subtree much larger than the new nodes is pivoted toward balance as InsertTreeNode() would
+        */
+
+        if (pCount >= lNode->lesserNullNodes + lNode->greaterNullNodes)
+        {
+            break;
+        }
+
+        if (lLesserNullNodes > lGreaterNullNodes && NULL != NodeLesser(pTree, lNode))
+        {
+            PivotLesserToGreater(pTree, &lNode);
+        }
+        else if (lGreaterNullNodes > lLesserNullNodes && NULL != NodeGreater(pTree, lNode))
+        {
+            PivotGreaterToLesser(pTree, &lNode);
+        }
+        else
+        {
+            break;
+        }
+
+        SetLinkedNode(pTree, pSubtree, lNode);
+
+        lRebalanceThreshold += pTree->balance.denominator; /* prevents rebalance hysteresis */
+    }
+
+    /*
+    ** otherwise the subtree is rebuilt in balance from its own nodes merged with the new ones
+    */
+
+    lMerge.nodes = pNodes;
+    lMerge.count = pCount;
+
+    lMerge.previous = pPrevious;
+
+    if (NULL != lNode)
+    {
+        pCount += lNode->lesserNullNodes + lNode->greaterNullNodes - 1;
+    }
+
+    lMerge.vine = FlattenSubtree(pTree, lNode);
+
+    RebuildSubtree(pTree, &lMerge, pCount, &lNode);
+
+    SetLinkedNode(pTree, pSubtree, lNode);
+
+    SetNodeParent(pTree, lNode, pParent);
+
+    return (TRUE);
+}
+
+static motelTreeNodeHandle FlattenSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot
+)
+{
+    motelTreeNodeHandle lVine;
+    motelTreeNodeHandle lTail;
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lLesser;
+
+    lVine = (motelTreeNodeHandle) NULL;
+    lTail = (motelTreeNodeHandle) NULL;
+
+    lNode = pRoot;
+
+    while (NULL != lNode)
+    {
+        if (NULL == NodeLesser(pTree, lNode))
+        {
+            /*
+            ** the least remaining node joins the vine
+            */
+
+            if (NULL == lTail)
+            {
+                lVine = lNode;
+            }
+            else
+            {
+                SetNodeGreater(pTree, lTail, lNode);
+            }
+
+            lTail = lNode;
+
+            lNode = NodeGreater(pTree, lNode);
+        }
+        else
+        {
+            /*
+            ** rotate the lesser child up until the least remaining node is reached
+            */
+
+            lLesser = NodeLesser(pTree, lNode);
+
+            SetNodeLesser(pTree, lNode, NodeGreater(pTree, lLesser));
+            SetNodeGreater(pTree, lLesser, lNode);
+
+            lNode = lLesser;
+        }
+    }
+
+    return (lVine);
+}
+
+static boolean RebuildSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeMerge * pMerge,
+    unsigned long pCount,
+    motelTreeNodeHandle * pRoot
+)
+{
+    motelTreeNodeHandle lNode;
+
+    motelTreeNodeHandle lLesser;
+    motelTreeNodeHandle lGreater;
+
+    unsigned long lLesserCount;
+    unsigned long lGreaterCount;
+
+    * pRoot = (motelTreeNodeHandle) NULL;
+
+    if (0 == pCount)
+    {
+        return (TRUE);
+    }
+
+    /*
+    ** split the nodes evenly between the branches
+    */
+
+    lLesserCount = (pCount - 1) / 2;
+    lGreaterCount = (pCount - 1) - lLesserCount;
+
+    RebuildSubtree(pTree, pMerge, lLesserCount, &lLesser);
+
+    /*
+    ** take the lesser of the next vine and new nodes, the vine's on equal key values
+    */
+
+    if (NULL != pMerge->vine && (0 == pMerge->count || 0 >= CompareKeys(pTree, NodeKey(pMerge->vine), NodeKey(* pMerge->nodes))))
+    {
+        lNode = pMerge->vine;
+
+        pMerge->vine = NodeGreater(pTree, lNode);
+    }
+    else
+    {
+        lNode = * pMerge->nodes;
+
+        pMerge->nodes++;
+        pMerge->count--;
+
+        /*
+        ** a new node follows any node with an equal key value
+        */
+
+        if (NULL != pMerge->previous && 0 == CompareKeys(pTree, NodeKey(lNode), NodeKey(pMerge->previous)))
+        {
+            lNode->instance = pMerge->previous->instance + 1;
+
+#if defined COMPACT_TREE_NODES
+
+            if (pTree->greatestInstance < lNode->instance)
+            {
+                pTree->greatestInstance = lNode->instance;
+            }
+
+#endif
+        }
+    }
+
+    pMerge->previous = lNode;
+
+    RebuildSubtree(pTree, pMerge, lGreaterCount, &lGreater);
+
+    /*
+    ** connect the branches to the subtree root
+    */
+
+    SetNodeLesser(pTree, lNode, lLesser);
+    lNode->lesserNullNodes = lLesserCount + 1;
+
+    if (NULL != lLesser)
+    {
+        SetNodeParent(pTree, lLesser, lNode);
+    }
+
+    SetNodeGreater(pTree, lNode, lGreater);
+    lNode->greaterNullNodes = lGreaterCount + 1;
+
+    if (NULL != lGreater)
+    {
+        SetNodeParent(pTree, lGreater, lNode);
+    }
+
+    * pRoot = lNode;
+
+    return (TRUE);
+}
+
+static void RestoreSubtreeBalance
+(
+    motelTreeHandle pTree,
+    motelTreeLink * pSubtree
+)
+{
+    motelTreeMerge lMerge;
+
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lParent;
+
+    unsigned long lCount;
+
+    lNode = LinkedNode(pTree, pSubtree);
+
+    lParent = NodeParent(pTree, lNode);
+
+    lCount = lNode->lesserNullNodes + lNode->greaterNullNodes - 1;
+
+    /*
+    ** rebuild the subtree from its own nodes alone
+    */
+
+    lMerge.nodes = (motelTreeNodeHandle *) NULL;
+    lMerge.count = 0;
+
+    lMerge.previous = (motelTreeNodeHandle) NULL;
+
+    lMerge.vine = FlattenSubtree(pTree, lNode);
+
+    RebuildSubtree(pTree, &lMerge, lCount, &lNode);
+
+    SetLinkedNode(pTree, pSubtree, lNode);
+
+    SetNodeParent(pTree, lNode, lParent);
+}
+
+static unsigned long SplitSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot,
+    const void * pKey,
+    boolean pInclusive,
+    motelTreeNodeHandle * pLesser,
+    motelTreeNodeHandle * pGreater
+)
+{
+    motelTreeNodeHandle lLesser;
+    motelTreeNodeHandle lGreater;
+    motelTreeNodeHandle lSplit;
+
+    unsigned long lComparisons;
+
+    long lComparisonResult;
+
+    if (NULL == pRoot)
+    {
+        * pLesser = (motelTreeNodeHandle) NULL;
+        * pGreater = (motelTreeNodeHandle) NULL;
+
+        return (0);
+    }
+
+    /*
+    ** detach the subtree root from its branches
+    */
+
+    lLesser = NodeLesser(pTree, pRoot);
+    lGreater = NodeGreater(pTree, pRoot);
+
+    if (NULL != lLesser)
+    {
+        SetNodeParent(pTree, lLesser, (motelTreeNodeHandle) NULL);
+    }
+
+    if (NULL != lGreater)
+    {
+        SetNodeParent(pTree, lGreater, (motelTreeNodeHandle) NULL);
+    }
+
+    SetNodeParent(pTree, pRoot, (motelTreeNodeHandle) NULL);
+
+    SetNodeLesser(pTree, pRoot, (motelTreeNodeHandle) NULL);
+    pRoot->lesserNullNodes = 1;
+
+    SetNodeGreater(pTree, pRoot, (motelTreeNodeHandle) NULL);
+    pRoot->greaterNullNodes = 1;
+
+    /*
+    ** split the branch holding the key object and rejoin the subtree root to the other branch
+    */
+
+    lComparisonResult = CompareReadKeys(pTree, pKey, NodeKey(pRoot));
+
+    if (0 > lComparisonResult || (0 == lComparisonResult && !pInclusive))
+    {
+        lComparisons = SplitSubtree(pTree, lLesser, pKey, pInclusive, pLesser, &lSplit);
+
+        * pGreater = JoinSubtrees(pTree, lSplit, pRoot, lGreater);
+    }
+    else
+    {
+        lComparisons = SplitSubtree(pTree, lGreater, pKey, pInclusive, &lSplit, pGreater);
+
+        * pLesser = JoinSubtrees(pTree, lLesser, pRoot, lSplit);
+    }
+
+    return (lComparisons + 1);
+}
+
+static motelTreeNodeHandle JoinSubtrees
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pLesser,
+    motelTreeNodeHandle pNode,
+    motelTreeNodeHandle pGreater
+)
+{
+    motelTreePath lPath;
+
+    motelTreeNodeHandle lRoot;
+    motelTreeNodeHandle lParent;
+    motelTreeNodeHandle lNode;
+
+    unsigned long lLesserNullNodes;
+    unsigned long lGreaterNullNodes;
+    unsigned long lEdge;
+    unsigned long lAbove;
+    unsigned long lIndex;
+
+    boolean lGreaterEdge;
+
+    lLesserNullNodes = SubtreeNullNodes(pLesser);
+    lGreaterNullNodes = SubtreeNullNodes(pGreater);
+
+    lRoot = pNode;
+    lParent = (motelTreeNodeHandle) NULL;
+
+    lPath.depth = 0;
+
+    lEdge = 0;
+    lGreaterEdge = FALSE;
+
+    /*
+    ** descend the nearer edge of a much heavier subtree to a branch that balances the lighter one,
+    ** recording the nodes passed for the way back up
+    */
+
+    if (OutOfBalance(pTree, lLesserNullNodes, lGreaterNullNodes))
+    {
+        lRoot = pLesser;
+        lGreaterEdge = TRUE;
+
+        for (lParent = pLesser; ; lParent = NodeGreater(pTree, lParent))
+        {
+            if (MAXIMUM_TREE_PATH > lPath.depth)
+            {
+                lPath.nodes[lPath.depth++] = lParent;
+            }
+
+            lEdge += 1;
+
+            if (!OutOfBalance(pTree, SubtreeNullNodes(NodeGreater(pTree, lParent)), lGreaterNullNodes))
+            {
+                break;
+            }
+        }
+
+        pLesser = NodeGreater(pTree, lParent);
+
+        SetNodeGreater(pTree, lParent, pNode);
+    }
+    else if (OutOfBalance(pTree, lGreaterNullNodes, lLesserNullNodes))
+    {
+        lRoot = pGreater;
+
+        for (lParent = pGreater; ; lParent = NodeLesser(pTree, lParent))
+        {
+            if (MAXIMUM_TREE_PATH > lPath.depth)
+            {
+                lPath.nodes[lPath.depth++] = lParent;
+            }
+
+            lEdge += 1;
+
+            if (!OutOfBalance(pTree, SubtreeNullNodes(NodeLesser(pTree, lParent)), lLesserNullNodes))
+            {
+                break;
+            }
+        }
+
+        pGreater = NodeLesser(pTree, lParent);
+
+        SetNodeLesser(pTree, lParent, pNode);
+    }
+
+    /*
+    ** the node joins the branches
+    */
+
+    SetNodeParent(pTree, pNode, lParent);
+
+    SetNodeLesser(pTree, pNode, pLesser);
+    pNode->lesserNullNodes = SubtreeNullNodes(pLesser);
+
+    if (NULL != pLesser)
+    {
+        SetNodeParent(pTree, pLesser, pNode);
+    }
+
+    SetNodeGreater(pTree, pNode, pGreater);
+    pNode->greaterNullNodes = SubtreeNullNodes(pGreater);
+
+    if (NULL != pGreater)
+    {
+        SetNodeParent(pTree, pGreater, pNode);
+    }
+
+    /*
+    ** restore the weights back up the edge, pivoting where the joined branch has grown too heavy
+    */
+
+    while (0 < lEdge)
+    {
+        /*
+        ** an edge too long for the path is restored from its lower end a path's length at a time,
+        ** re-descending from the root to the part still to be restored
+        */
+
+        lAbove = (MAXIMUM_TREE_PATH < lEdge) ? lEdge - MAXIMUM_TREE_PATH : 0;
+        lParent = (motelTreeNodeHandle) NULL;
+
+        if (lEdge != lPath.depth)
+        {
+            lPath.depth = 0;
+
+            for (lNode = lRoot, lIndex = 0; lIndex < lEdge; lNode = lGreaterEdge ? NodeGreater(pTree, lNode) : NodeLesser(pTree, lNode), lIndex++)
+            {
+                if (lIndex < lAbove)
+                {
+                    lParent = lNode;
+                }
+                else
+                {
+                    lPath.nodes[lPath.depth++] = lNode;
+                }
+            }
+        }
+
+        while (0 < lPath.depth)
+        {
+            lNode = lPath.nodes[--lPath.depth];
+
+            lNode->lesserNullNodes = SubtreeNullNodes(NodeLesser(pTree, lNode));
+            lNode->greaterNullNodes = SubtreeNullNodes(NodeGreater(pTree, lNode));
+
+            if (OutOfBalance(pTree, lNode->greaterNullNodes, lNode->lesserNullNodes))
+            {
+                PivotGreaterToLesser(pTree, &lNode);
+            }
+            else if (OutOfBalance(pTree, lNode->lesserNullNodes, lNode->greaterNullNodes))
+            {
+                PivotLesserToGreater(pTree, &lNode);
+            }
+
+            /*
+            ** relink the pivoted node, which a parentless tree's pivot leaves to its caller
+            */
+
+            if (0 < lPath.depth)
+            {
+                if (lGreaterEdge)
+                {
+                    SetNodeGreater(pTree, lPath.nodes[lPath.depth - 1], lNode);
+                }
+                else
+                {
+                    SetNodeLesser(pTree, lPath.nodes[lPath.depth - 1], lNode);
+                }
+            }
+            else if (NULL != lParent)
+            {
+                if (lGreaterEdge)
+                {
+                    SetNodeGreater(pTree, lParent, lNode);
+                }
+                else
+                {
+                    SetNodeLesser(pTree, lParent, lNode);
+                }
+            }
+            else
+            {
+                lRoot = lNode;
+            }
+        }
+
+        lEdge = lAbove;
+    }
+
+    return (lRoot);
+}
+
+static motelTreeNodeHandle UnlinkLeastNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pRoot
+)
+{
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lParent;
+    motelTreeNodeHandle lGreater;
+
+    /*
+    ** descend to the least node, discounting it from each branch along the way
+    */
+
+    lParent = (motelTreeNodeHandle) NULL;
+
+    for (lNode = * pRoot; NULL != NodeLesser(pTree, lNode); lNode = NodeLesser(pTree, lNode))
+    {
+        lNode->lesserNullNodes -= 1;
+
+        lParent = lNode;
+    }
+
+    /*
+    ** the least node's greater branch takes its place
+    */
+
+    lGreater = NodeGreater(pTree, lNode);
+
+    if (NULL != lGreater)
+    {
+        SetNodeParent(pTree, lGreater, lParent);
+    }
+
+    if (NULL == lParent)
+    {
+        * pRoot = lGreater;
+    }
+    else
+    {
+        SetNodeLesser(pTree, lParent, lGreater);
+    }
+
+    SetNodeParent(pTree, lNode, (motelTreeNodeHandle) NULL);
+
+    SetNodeGreater(pTree, lNode, (motelTreeNodeHandle) NULL);
+    lNode->greaterNullNodes = 1;
+
+    return (lNode);
+}
+
+static void OffsetLeastInstances
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot,
+    const void * pKey,
+    unsigned long pOffset
+)
+{
+    /*
+    ** the instances of the key are the subtree's least nodes, so a node with a
+    ** greater key value has none of them in its greater branch
+    */
+
+    while (NULL != pRoot)
+    {
+        OffsetLeastInstances(pTree, NodeLesser(pTree, pRoot), pKey, pOffset);
+
+        if (0 != CompareKeys(pTree, pKey, NodeKey(pRoot)))
+        {
+            return;
+        }
+
+        pRoot->instance += pOffset;
+
+        pRoot = NodeGreater(pTree, pRoot);
+    }
+}
+
+static void ClearTreeCursors
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeCursorHandle lCursor;
+
+    pTree->cursor = (motelTreeNodeHandle) NULL;
+
+    for (lCursor = pTree->cursors; NULL != lCursor; lCursor = lCursor->next)
+    {
+        lCursor->node = (motelTreeNodeHandle) NULL;
+    }
+}
+
+static boolean CombineTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther,
+    motelTreeCombination pCombination
+)
+{
+    motelTreeCombine lCombine;
+
+    motelTreeNodeHandle lDiscard;
+    motelTreeNodeHandle lLeast;
+    motelTreeNodeHandle lNext;
+
+    size_t lSize;
+
+    boolean lCombined;
+    boolean lPruned;
 
     /*
     ** there is no tree
@@ -431,167 +8782,150 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION InsertTreeNode
 
     pTree->result = motelResult_OK;
 
-    /*
-    ** there is no data object
-    */
-
-    if (NULL == pData)
+    if (NULL == pOther)
     {
         pTree->result = motelResult_NullPointer;
 
         return (FALSE);
     }
 
+#if defined COMPACT_TREE_NODES
+
     /*
-    ** there is no key object
+    ** a compact tree's nodes are linked within its own arena, so they cannot
+    ** move to another tree
     */
 
-    if (NULL == pKey)
-    {
-        pTree->result = motelResult_NullPointer;
+    pTree->result = motelResult_Incompatible;
 
-        return (FALSE);
-    }
+    return (FALSE);
+
+#endif
 
     /*
-    ** construct a new node
+    ** the trees must be distinct and hold alike nodes ordered alike, whose parent links are kept alike
     */
 
-    if (!ConstructNode(pTree, pKey, pData, &lInsertNode))
+    if (pTree == pOther ||
+        pTree->keySize != pOther->keySize || pTree->dataSize != pOther->dataSize ||
+        pTree->keyType != pOther->keyType || pTree->compareKeyFunction != pOther->compareKeyFunction ||
+        pTree->parentless != pOther->parentless)
     {
-        return (FALSE); // pass through result code
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
     }
 
     /*
-    ** set the new node as the current node
+    ** the nodes of a memory pool cannot leave it, a concurrent tree's nodes may be in use by readers,
+    ** a persistent tree's nodes may be shared with its versions and a logged tree's nodes cannot
+    ** arrive or leave unlogged
     */
 
-    pTree->cursor = lInsertNode;
+    if (NULL != pTree->pool || NULL != pOther->pool || pTree->concurrent || pOther->concurrent || pTree->persistent || pOther->persistent ||
+        pTree->groupDuplicates || pOther->groupDuplicates || NULL != pTree->log || NULL != pOther->log)
+    {
+        pTree->result = motelResult_Incompatible;
+
+        return (FALSE);
+    }
 
     /*
-    ** add a root node when the tree is empty
+    ** the tree must be able to hold the other tree's nodes until those not kept are destructed
     */
 
-    lNode = pTree->root;
+    lSize = (SubtreeNullNodes(TreeRoot(pOther)) - 1) * pOther->nodeSize;
 
-    if (NULL == lNode)
+    if (pTree->maximumSize > 0 && pTree->maximumSize < pTree->size + lSize)
     {
-        pTree->root = lInsertNode;
-        return (TRUE);
+        pTree->result = motelResult_MaximumSize;
+
+        return (FALSE);
     }
 
     /*
-    ** traverse the tree to find the insertion point
+    ** take every node of the other tree
     */
 
-    for (;;)
-    {
-        lComparisonResult = pTree->compareKeyFunction((const void *) lInsertNode->key, (const void *) lNode->key);;
+    lCombine.tree = pTree;
+    lCombine.combination = pCombination;
 
-        if (0 == lComparisonResult)
-        {
-            lInsertNode->instance = lNode->instance + 1;
+    lCombine.root = TreeRoot(pTree);
+    lCombine.other = TreeRoot(pOther);
 
-            lComparisonResult = MORE_THAN;
-        }
+    lCombine.discards = (motelTreeNodeHandle) NULL;
+    lCombine.lastDiscard = (motelTreeNodeHandle) NULL;
 
-        if (0 > lComparisonResult)
-        {
-            /*
-            ** traverse lesser
-            */
+    lCombine.threads = pTree->combineThreads;
 
-            if (lRebalanceThreshold <= lNode->lesserNullNodes / lNode->greaterNullNodes)
-            {
-                PivotLesserToGreater(pTree, &lNode);
+    lCombine.comparisons = 0;
 
-                lRebalanceThreshold++; /* prevents rebalance hysteresis */
+    lCombine.success = TRUE;
 
-                continue;
-            }
+    SetTreeRoot(pTree, (motelTreeNodeHandle) NULL);
+    pTree->size += lSize;
 
-            lNode->lesserNullNodes += 1;
+    SetTreeRoot(pOther, (motelTreeNodeHandle) NULL);
+    pOther->size -= lSize;
 
-            lChild = lNode->lesser;
+    ClearTreeCursors(pOther);
 
-            if (NULL == lChild)
-            {
-                lInsertNode->parent = lNode;
-                lNode->lesser = lInsertNode;
-                return (TRUE);
-            }
-        }
-        else // (0 < lComparisonResult)
-        {
-            /*
-            ** traverse greater
-            */
+    /*
+    ** combine the nodes and destruct those not kept
+    */
 
-            if (lRebalanceThreshold <= lNode->greaterNullNodes / lNode->lesserNullNodes)
-            {
-                PivotGreaterToLesser(pTree, &lNode);
+    lCombined = CombineSubtrees(&lCombine);
 
-                lRebalanceThreshold++; /* prevents rebalance hysteresis */
+    CountTreeStatistic(pTree, comparisons, lCombine.comparisons);
 
-                continue;
-            }
+    SetTreeRoot(pTree, lCombine.root);
 
-            lNode->greaterNullNodes += 1;
+    if (pTree->levelScale < pOther->levelScale)
+    {
+        pTree->levelScale = pOther->levelScale;
+    }
 
-            lChild = lNode->greater;
+    pTree->levels = GetTreeLevelBound(pTree);
+    pTree->cursor = (motelTreeNodeHandle) NULL;
 
-            if (NULL == lChild)
-            {
-                lInsertNode->parent = lNode;
-                lNode->greater = lInsertNode;
-                return (TRUE);
-            }
-        }
+    lPruned = TRUE;
 
-        lNode = lChild;
+    for (lDiscard = lCombine.discards; NULL != lDiscard; lDiscard = lNext)
+    {
+        /*
+        ** the next discarded subtree hangs from the least node's lesser link
+        */
 
-        lRebalanceThreshold = REBALANCE_THRESHOLD;
-    }
-}
+        for (lLeast = lDiscard; 1 < lLeast->lesserNullNodes; lLeast = NodeLesser(pTree, lLeast));
 
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNode
-(
-    motelTreeHandle pTree,
-    void * pKey,
-    unsigned long pInstance
-)
-{
-    motelTreeNodeHandle lRoot;
+        lNext = NodeLesser(pTree, lLeast);
 
-    /*
-    ** there is no tree
-    */
+        SetNodeLesser(pTree, lLeast, (motelTreeNodeHandle) NULL);
 
-    if (NULL == pTree)
-    {
-        return (FALSE);
+        if (!PruneSubtree(pTree, lDiscard))
+        {
+            lPruned = FALSE;
+        }
     }
 
     /*
-    ** the tree is empty
+    ** the cursors over nodes that were destructed must not be used
     */
 
-    lRoot = pTree->root;
+    ClearTreeCursors(pTree);
 
-    if (NULL == lRoot)
+    pTree->result = motelResult_OK;
+
+    if (!lCombined)
     {
-        pTree->result = motelResult_NoNode;
+        pTree->result = motelResult_InvalidState;
 
         return (FALSE);
     }
 
-    pTree->result = motelResult_OK;
-
-    pTree->cursor = GetEqualNode(pTree, (const void *) pKey, pInstance);
-
-    if (NULL == pTree->cursor)
+    if (!lPruned)
     {
-        pTree->result = motelResult_NotFound;
+        pTree->result = motelResult_NodeDestruction;
 
         return (FALSE);
     }
@@ -599,1159 +8933,1506 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNode
     return (TRUE);
 }
 
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION FetchTreeNode
+static boolean CombineSubtrees
 (
-    motelTreeHandle pTree,
-    void * pData,
-    void * pKey,
-    unsigned long * pInstance
+    motelTreeCombine * pCombine
 )
 {
-    motelTreeNodeHandle lFetchNode = (motelTreeNodeHandle) NULL;
+    motelTreeCombine lLesser;
+    motelTreeCombine lGreater;
+
+    motelTreeNodeHandle lEqual;
+    motelTreeNodeHandle lOtherEqual;
+    motelTreeNodeHandle lSplit;
+
+    const void * lKey;
+
+    boolean lStarted;
 
     /*
-    ** there is no tree
+    ** a combination with an empty subtree needs no division
     */
 
-    if (NULL == pTree)
+    if (NULL == pCombine->other)
     {
-        return (FALSE);
+        if (motelTreeCombination_Intersection == pCombine->combination)
+        {
+            DiscardSubtree(pCombine, pCombine->root);
+
+            pCombine->root = (motelTreeNodeHandle) NULL;
+        }
+
+        return (TRUE);
+    }
+
+    if (NULL == pCombine->root)
+    {
+        if (motelTreeCombination_Union == pCombine->combination)
+        {
+            pCombine->root = pCombine->other;
+        }
+        else
+        {
+            DiscardSubtree(pCombine, pCombine->other);
+        }
+
+        pCombine->other = (motelTreeNodeHandle) NULL;
+
+        return (TRUE);
     }
 
     /*
-    ** the tree is empty
+    ** divide both subtrees about the other subtree root's key value into the
+    ** lesser nodes, the nodes with an equal key value and the greater nodes
+    */
+
+    lKey = NodeKey(pCombine->other);
+
+    lLesser = * pCombine;
+    lGreater = * pCombine;
+
+    lLesser.discards = (motelTreeNodeHandle) NULL;
+    lLesser.lastDiscard = (motelTreeNodeHandle) NULL;
+
+    lGreater.discards = (motelTreeNodeHandle) NULL;
+    lGreater.lastDiscard = (motelTreeNodeHandle) NULL;
+
+    lLesser.comparisons = 0;
+    lGreater.comparisons = 0;
+
+    pCombine->comparisons += SplitSubtree(pCombine->tree, pCombine->root, lKey, FALSE, &lLesser.root, &lSplit);
+    pCombine->comparisons += SplitSubtree(pCombine->tree, lSplit, lKey, TRUE, &lEqual, &lGreater.root);
+
+    pCombine->comparisons += SplitSubtree(pCombine->tree, pCombine->other, lKey, FALSE, &lLesser.other, &lSplit);
+    pCombine->comparisons += SplitSubtree(pCombine->tree, lSplit, lKey, TRUE, &lOtherEqual, &lGreater.other);
+
+    /*
+    ** combine the greater nodes on another thread while this thread combines the lesser nodes
     */
 
-    if (NULL == pTree->root)
+    lStarted = FALSE;
+
+    if (1 < pCombine->threads && PARALLEL_COMBINE_NODES <= SubtreeNullNodes(lGreater.root) + SubtreeNullNodes(lGreater.other))
     {
-        pTree->result = motelResult_NoNode;
+        lGreater.threads = pCombine->threads / 2;
+        lLesser.threads = pCombine->threads - lGreater.threads;
 
-        return (FALSE);
+        lStarted = StartThread(&lGreater.thread, CombineSubtreesThread, (void *) &lGreater);
+    }
+
+    CombineSubtrees(&lLesser);
+
+    if (!lStarted)
+    {
+        CombineSubtrees(&lGreater);
+    }
+    else if (!JoinThread(lGreater.thread))
+    {
+        pCombine->success = FALSE;
     }
 
     /*
-    ** there is no node to fetch
+    ** keep the nodes with an equal key value according to the combination
     */
 
-    lFetchNode = pTree->cursor;
+    switch (pCombine->combination)
+    {
+        case motelTreeCombination_Union:
 
-    if (NULL == lFetchNode)
+            if (NULL == lEqual)
+            {
+                lEqual = lOtherEqual;
+            }
+            else
+            {
+                DiscardSubtree(pCombine, lOtherEqual);
+            }
+
+            break;
+
+        case motelTreeCombination_Intersection:
+
+            if (NULL == lOtherEqual)
+            {
+                DiscardSubtree(pCombine, lEqual);
+
+                lEqual = (motelTreeNodeHandle) NULL;
+            }
+            else
+            {
+                DiscardSubtree(pCombine, lOtherEqual);
+            }
+
+            break;
+
+        case motelTreeCombination_Difference:
+
+            if (NULL != lOtherEqual)
+            {
+                DiscardSubtree(pCombine, lEqual);
+                DiscardSubtree(pCombine, lOtherEqual);
+
+                lEqual = (motelTreeNodeHandle) NULL;
+            }
+
+            break;
+    }
+
+    /*
+    ** concatenate the combined nodes in key order
+    */
+
+    pCombine->root = ConcatenateSubtrees(pCombine->tree, ConcatenateSubtrees(pCombine->tree, lLesser.root, lEqual), lGreater.root);
+    pCombine->other = (motelTreeNodeHandle) NULL;
+
+    /*
+    ** gather the nodes discarded within the branches
+    */
+
+    DiscardSubtrees(pCombine, &lLesser);
+    DiscardSubtrees(pCombine, &lGreater);
+
+    pCombine->success = pCombine->success && lLesser.success && lGreater.success;
+
+    /*
+    ** gather the comparisons counted by the branches, each of which may have run on its own thread
+    */
+
+    pCombine->comparisons += lLesser.comparisons + lGreater.comparisons;
+
+    return (pCombine->success);
+}
+
+static motelThreadResult THREAD_CALLING_CONVENTION CombineSubtreesThread
+(
+    void * pCombine
+)
+{
+    CombineSubtrees((motelTreeCombine *) pCombine);
+
+    return ((motelThreadResult) 0);
+}
+
+static motelTreeNodeHandle ConcatenateSubtrees
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pLesser,
+    motelTreeNodeHandle pGreater
+)
+{
+    motelTreeNodeHandle lNode;
+
+    if (NULL == pLesser)
     {
-        pTree->result = motelResult_NotFound;
+        return (pGreater);
+    }
 
-        return (FALSE);
+    if (NULL == pGreater)
+    {
+        return (pLesser);
     }
 
-    pTree->result = motelResult_OK;
+    lNode = UnlinkLeastNode(pTree, &pGreater);
 
-    /*
-    ** copy the data value
-    */
+    return (JoinSubtrees(pTree, pLesser, lNode, pGreater));
+}
 
-    if (NULL != pData)
+static void DiscardSubtree
+(
+    motelTreeCombine * pCombine,
+    motelTreeNodeHandle pRoot
+)
+{
+    if (NULL == pRoot)
     {
-        memcpy((void *)pData, (const void *) lFetchNode->data, pTree->dataSize);
+        return;
     }
 
     /*
-    ** copy the key value
+    ** discarded subtrees are chained through the lesser links of their least
+    ** nodes, which need no parent links to reach
     */
 
-    if (NULL != pKey)
+    if (NULL == pCombine->lastDiscard)
     {
-        memcpy((void *)pKey, (const void *) lFetchNode->key, pTree->keySize);
+        pCombine->discards = pRoot;
     }
-
-    /*
-    ** copy the instance value
-    */
-
-    if (NULL != pInstance)
+    else
     {
-        * pInstance = lFetchNode->instance;
+        SetNodeLesser(pCombine->tree, pCombine->lastDiscard, pRoot);
     }
 
-    return (TRUE);
+    for (pCombine->lastDiscard = pRoot; NULL != NodeLesser(pCombine->tree, pCombine->lastDiscard); pCombine->lastDiscard = NodeLesser(pCombine->tree, pCombine->lastDiscard));
 }
 
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION UpdateTreeNode
+static void DiscardSubtrees
 (
-    motelTreeHandle pTree,
-    void * pData
+    motelTreeCombine * pCombine,
+    motelTreeCombine * pBranch
 )
 {
-    motelTreeNodeHandle lUpdateNode = (motelTreeNodeHandle) NULL;
-
-    /*
-    ** there is no tree
-    */
-
-    if (NULL == pTree)
+    if (NULL == pBranch->discards)
     {
-        return (FALSE);
+        return;
     }
 
-    /*
-    ** the tree is empty
-    */
-
-    if (NULL == pTree->root)
+    if (NULL == pCombine->lastDiscard)
     {
-        pTree->result = motelResult_NoNode;
-
-        return (FALSE);
+        pCombine->discards = pBranch->discards;
+    }
+    else
+    {
+        SetNodeLesser(pCombine->tree, pCombine->lastDiscard, pBranch->discards);
     }
 
-    /*
-    ** there is no data to update the node
-    */
+    pCombine->lastDiscard = pBranch->lastDiscard;
+}
 
-    if (NULL == pData)
+static void FillSnapshot
+(
+    motelTreeSnapshotHandle pSnapshot,
+    motelTreeHandle pTree,
+    unsigned long pIndex,
+    motelTreePath * pPath,
+    motelTreeNodeHandle * pNode,
+    unsigned long * pRank
+)
+{
+    if (pSnapshot->nodes < pIndex)
     {
-        pTree->result = motelResult_NullPointer;
-
-        return (FALSE);
+        return;
     }
 
     /*
-    ** there is no node to update
+    ** the lesser subtree's entries precede this entry in key order
     */
 
-    lUpdateNode = pTree->cursor;
+    FillSnapshot(pSnapshot, pTree, 2 * pIndex, pPath, pNode, pRank);
 
-    if (NULL == lUpdateNode)
-    {
-        pTree->result = motelResult_NotFound;
+    memcpy(EntryKey(pSnapshot, pIndex), NodeKey(* pNode), pTree->keySize);
 
-        return (FALSE);
-    }
+    EntryInstance(pSnapshot, pIndex) = (* pNode)->instance;
+    EntryRank(pSnapshot, pIndex) = * pRank;
 
-    pTree->result = motelResult_OK;
+    memcpy(RecordKey(pSnapshot, * pRank), NodeKey(* pNode), pTree->keySize);
 
-    /*
-    ** set the data value
-    */
+    RecordInstance(pSnapshot, * pRank) = (* pNode)->instance;
 
-    memcpy((void *) lUpdateNode->data, (const void *)pData, pTree->dataSize);
+    memcpy(RecordData(pSnapshot, * pRank), NodeData(pTree, * pNode), pTree->dataSize);
 
-    return (TRUE);
+    * pNode = StepPathGreater(pTree, pPath, * pNode);
+
+    (* pRank)++;
+
+    FillSnapshot(pSnapshot, pTree, 2 * pIndex + 1, pPath, pNode, pRank);
 }
 
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION DeleteTreeNode
+static unsigned long GetRankLevel
 (
-    motelTreeHandle pTree
+    unsigned long pRank,
+    unsigned long pLevels,
+    unsigned long pNodes
 )
 {
-    motelTreeNodeHandle lDeleteNode = (motelTreeNodeHandle) NULL;
-
-    motelTreeNodeHandle lRoot;
-    motelTreeNodeHandle lNode;
-    motelTreeNodeHandle lChild;
-
-    long lComparisonResult;
-
-    boolean lNodeToDeleteFound = FALSE;
+    unsigned long lLastLevel;
+    unsigned long lPosition;
+    unsigned long lDepth;
 
     /*
-    ** there is no tree
+    ** the positions are all held up to the last of the last level's entries,
+    ** and only the even ones after it
     */
 
-    if (NULL == pTree)
-    {
-        return (FALSE);
-    }
+    lLastLevel = pNodes - (1UL << (pLevels - 1)) + 1;
+
+    lPosition = (pRank <= 2 * lLastLevel) ? pRank : 2 * pRank - 2 * lLastLevel;
 
     /*
-    ** the tree is empty
+    ** each trailing zero bit of the position raises the entry a level
     */
 
-    lRoot = pTree->root;
-
-    if (NULL == lRoot)
+    for (lDepth = pLevels - 1; 0 == (lPosition & 1); lDepth--)
     {
-        pTree->result = motelResult_NoNode;
-
-        return (FALSE);
+        lPosition >>= 1;
     }
 
-    /*
-    ** there is no node to delete
-    */
-
-    lDeleteNode = pTree->cursor;
-
-    if (NULL == lDeleteNode)
-    {
-        pTree->result = motelResult_NotFound;
+    return (lDepth);
+}
 
-        return (FALSE);
-    }
+static unsigned long FindSnapshotBound
+(
+    motelTreeSnapshotHandle pSnapshot,
+    const void * pKey,
+    unsigned long pInstance
+)
+{
+    unsigned long lIndex;
 
-    pTree->result = motelResult_OK;
+    long lComparisonResult;
 
-    /*
-    ** traverse the tree to find a suitable substitute leaf or twig node 
-    ** to be promoted into the position of node being deleted and rebalance
-    ** the tree along the way
-    */
-    
-    lNode = lRoot;
+    lIndex = 1;
 
-    for (;;)
+    while (pSnapshot->nodes >= lIndex)
     {
         /*
-        ** decide which branch to follow
+        ** the four grandchildren are side by side; fetch them while this
+        ** entry is compared
         */
 
-        lComparisonResult = NodeCompare(pTree, lDeleteNode, lNode);
-
-        if (0 == lComparisonResult)
+        if (pSnapshot->nodes >= 4 * lIndex + 3)
         {
-            lNodeToDeleteFound = TRUE;
-
-            if (NULL != lNode->lesser)
-            {
-                lComparisonResult = LESS_THAN;
-            }
-            else
-            {
-                lComparisonResult = MORE_THAN;
-            }
+            PrefetchMemory(EntryKey(pSnapshot, 4 * lIndex));
+            PrefetchMemory(EntryKey(pSnapshot, 4 * lIndex + 3));
         }
 
+        lComparisonResult = CompareKeyObjects(pSnapshot->keyType, pSnapshot->keySize, pSnapshot->compareKeyFunction, EntryKey(pSnapshot, lIndex), pKey);
+
         /*
-        ** follow branch
+        ** step to the greater child when the entry orders before the key
         */
 
-        if (0 > lComparisonResult)
-        {
-            /*
-            ** traverse lesser
-            */
+        lIndex = 2 * lIndex + (unsigned long) ((0 > lComparisonResult) | ((0 == lComparisonResult) & (EntryInstance(pSnapshot, lIndex) < pInstance)));
+    }
 
-            lChild = lNode->lesser;
+    /*
+    ** the bound is the entry at which the descent last stepped lesser: undo
+    ** the greater steps taken after it, then the lesser step itself
+    */
 
-            if (NULL == lChild)
-            {
-                break;
-            }
+    while (lIndex & 1)
+    {
+        lIndex >>= 1;
+    }
 
-            if (REBALANCE_THRESHOLD <= lNode->greaterNullNodes / (lNode->lesserNullNodes - 1))
-            {
-                PivotGreaterToLesser(pTree, &lNode);
-                lChild = lNode->lesser;
-            }
+    lIndex >>= 1;
 
-            lNode->lesserNullNodes -= 1;
-        }
-        else // (0 < lComparisonResult)
-        {
-            /*
-            ** traverse greater
-            */
+    return (0 == lIndex ? pSnapshot->nodes + 1 : EntryRank(pSnapshot, lIndex));
+}
 
-            lChild = lNode->greater;
+static unsigned long FindSnapshotRecord
+(
+    motelTreeSnapshotHandle pSnapshot,
+    const void * pKey,
+    unsigned long pInstance
+)
+{
+    unsigned long lRank;
 
-            if (NULL == lChild)
-            {
-                break;
-            }
+    lRank = FindSnapshotBound(pSnapshot, pKey, pInstance);
 
-            if (REBALANCE_THRESHOLD <= lNode->lesserNullNodes / (lNode->greaterNullNodes - 1))
-            {
-                PivotLesserToGreater(pTree, &lNode);
-                lChild = lNode->greater;
-            }
+    if (pSnapshot->nodes < lRank)
+    {
+        return (0);
+    }
 
-            lNode->greaterNullNodes -= 1;
-        }
+    if (0 != CompareKeyObjects(pSnapshot->keyType, pSnapshot->keySize, pSnapshot->compareKeyFunction, RecordKey(pSnapshot, lRank), pKey))
+    {
+        return (0);
+    }
 
-        lNode = lChild;
+    if (0 != pInstance && pInstance != RecordInstance(pSnapshot, lRank))
+    {
+        return (0);
     }
 
-    /*
-    ** node to delete was not encountered in the tree during traversal
-    */
+    return (lRank);
+}
 
-    if (!lNodeToDeleteFound)
-    {
-        pTree->result = motelResult_NotFound;
+static boolean WriteTreeFile
+(
+    motelTreeHandle pTree,
+    const char * pPath,
+    bits64 pSequence,
+    boolean pSync
+)
+{
+    motelTreeNodeHandle lNode;
 
-        return (FALSE); /* branch weights are messed up now! */
-    }
+    motelTreePath lPath;
 
-    /*
-    ** delete the node
-    */
+    motelTreeFile lFile;
 
-    if (lDeleteNode == lNode)
-    {
-        /*
-        ** the node to be deleted is a leaf node therefore there's no
-        ** need for promotion, just disconnect it from its parent
-        */
+    motelTreeFileBuffer lBuffers[8 * sizeof(unsigned long) + 1];
 
-        if (lRoot == lNode)
-        {
-            pTree->root = (motelTreeNodeHandle) NULL;
-        }
-        else if (lDeleteNode->parent->lesser == lNode)
-        {
-            lDeleteNode->parent->lesser = (motelTreeNodeHandle) NULL;
-        }
-        else // (lDeleteNode->parent->greater == lNode)
-        {
-            lDeleteNode->parent->greater = (motelTreeNodeHandle) NULL;
-        }
-    }
-    else // (lDeleteNode != lNode)
-    {
-        /*
-        ** promote a leaf or twig node
-        */
+    motelTreeFileBuffer * lRecords;
+    motelTreeFileBuffer * lEntries;
 
-        /*
-        ** when a lesser or greater child branch is attached to the node to promote
-        ** move the child branch up to take the place of the to be promoted node
-        */
+    FILE * lStream;
 
-        if (NULL != lNode->lesser)
-        {
-            if (lNode->parent->lesser == lNode)
-            {
-                lNode->parent->lesser = lNode->lesser;
-            }
-            else
-            {
-                lNode->parent->greater = lNode->lesser;
-            }
+    unsigned long lNodes;
+    unsigned long lLevels;
+    unsigned long lLevel;
+    unsigned long lRank;
 
-            lNode->lesser->parent = lNode->parent;
-        }
-        else if (NULL != lNode->greater)
-        {
-            if (lNode->parent->lesser == lNode)
-            {
-                lNode->parent->lesser = lNode->greater;
-            }
-            else
-            {
-                lNode->parent->greater = lNode->greater;
-            }
+    size_t lEntrySize;
+    size_t lRecordSize;
+    size_t lKeySize;
+    size_t lCapacity;
 
-            lNode->greater->parent = lNode->parent;
-        }
-        else
-        {
-            /*
-            ** disconnect the node being promoted from the old parent
-            */
+    byte * lBytes;
 
-            if (lNode == lNode->parent->lesser)
-            {
-                lNode->parent->lesser = (motelTreeNodeHandle) NULL;
-            }
-            else // (lNode == lNode->parent->greater)
-            {
-                lNode->parent->greater = (motelTreeNodeHandle) NULL;
-            }
-        }
+    boolean lWritten;
 
-        /*
-        ** make the found node assume the position of the node about to be deleted within the tree
-        */
+    /*
+    ** a file holds a single instance for each node
+    */
 
-        /*
-        ** connect the new parent to the node being promoted
-        */
+    if (pTree->groupDuplicates)
+    {
+        pTree->result = motelResult_Incompatible;
 
-        if (NULL == lDeleteNode->parent)
-        {
-            pTree->root = lNode;
-        }		
-        else if (lDeleteNode == lDeleteNode->parent->lesser)
-        {
-            lDeleteNode->parent->lesser = lNode;
-        }
-        else // (lDeleteNode == lDeleteNode->parent->greater)
-        {
-            lDeleteNode->parent->greater = lNode;
-        }
+        return (FALSE);
+    }
 
-        /*
-        ** connect the node being promoted to the new parent
-        */
+    lNodes = SubtreeNullNodes(TreeRoot(pTree)) - 1;
+    lLevels = GetLoadedLevelCount(lNodes);
 
-        lNode->parent = lDeleteNode->parent;
+    lKeySize = AlignedNodeSize(pTree->keySize);
 
-        /*
-        ** connect lesser child to the node being promoted
-        */
+    lEntrySize = SnapshotEntrySize(pTree->keySize);
+    lRecordSize = SnapshotRecordSize(pTree->keySize, pTree->dataSize);
 
-        if (lNode == lDeleteNode->lesser)
-        {
-            lNode->lesser = (motelTreeNodeHandle) NULL;
-        }
-        else
-        {
-            lNode->lesser = lDeleteNode->lesser;
+    memset(&lFile, 0, sizeof(motelTreeFile));
 
-            if (NULL != lNode->lesser)
-            {
-                lNode->lesser->parent = lNode;
-            }
-        }
+    lFile.signature = TREE_FILE_SIGNATURE;
+    lFile.version = TREE_FILE_VERSION;
 
-        lNode->lesserNullNodes = lDeleteNode->lesserNullNodes;
+    lFile.keyType = (bits32) pTree->keyType;
+    lFile.instanceSize = (bits32) sizeof(unsigned long);
 
-        /*
-        ** connect the greater child to the node being promoted
-        */
+    lFile.keySize = pTree->keySize;
+    lFile.dataSize = pTree->dataSize;
 
-        if (lNode == lDeleteNode->greater)
-        {
-            lNode->greater = (motelTreeNodeHandle) NULL;
-        }
-        else
-        {
-            lNode->greater = lDeleteNode->greater;
-            
-            if (NULL != lNode->greater)
-            {
-                lNode->greater->parent = lNode;
-            }
-        }
+    lFile.entrySize = lEntrySize;
+    lFile.recordSize = lRecordSize;
 
-        lNode->greaterNullNodes = lDeleteNode->greaterNullNodes;
-    }
+    lFile.nodes = lNodes;
+
+    lFile.entries = TREE_FILE_ENTRIES;
+    lFile.records = lFile.entries + (lFile.nodes + 1) * lFile.entrySize;
+
+    lFile.sequence = pSequence;
 
     /*
-    ** destruct the disconnected node
+    ** the records and each level of the entries share the buffer space, each
+    ** buffer holding at least one entry or record and beginning aligned so
+    ** that the instances and ranks are stored aligned
     */
-    
-    if (!DestructNode(pTree))
+
+    lCapacity = (TREE_FILE_BUFFER_SIZE / (lLevels + 1)) / NODE_ALIGNMENT * NODE_ALIGNMENT;
+
+    if (lCapacity < lEntrySize)
     {
-        return (FALSE);
+        lCapacity = lEntrySize;
     }
 
-    return (TRUE);
-}
-  
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekLeastTreeNode
-(
-    motelTreeHandle pTree,
-    void * pData,
-    void * pKey,
-    unsigned long * pInstance
-)
-{
-    /*
-    ** there is no tree
-    */
+    if (lCapacity < lRecordSize)
+    {
+        lCapacity = lRecordSize;
+    }
 
-    if (NULL == pTree)
+    lRecords = &lBuffers[0];
+    lEntries = &lBuffers[1];
+
+    lRecords->bytes = (byte *) NULL;
+
+    if (!SafeMallocBlock((void **) &lRecords->bytes, (lLevels + 1) * lCapacity))
     {
+        pTree->result = motelResult_MemoryAllocation;
+
         return (FALSE);
     }
 
-    /*
-    ** the tree is empty
-    */
+    lStream = fopen(pPath, "wb");
 
-    if (NULL == pTree->root)
+    if (NULL == lStream)
     {
-        pTree->result = motelResult_NoNode;
+        SafeFreeBlock((void **) &lRecords->bytes);
+
+        pTree->result = motelResult_Opening;
 
         return (FALSE);
     }
 
     /*
-    ** position the cursor
+    ** the entries of a level begin at the index of its first entry
     */
 
-    pTree->cursor = GetLeastNode(pTree);
+    for (lLevel = 0; lLevel <= lLevels; lLevel++)
+    {
+        lBuffers[lLevel].stream = lStream;
+        lBuffers[lLevel].bytes = lRecords->bytes + lLevel * lCapacity;
+        lBuffers[lLevel].capacity = lCapacity;
+        lBuffers[lLevel].used = 0;
+        lBuffers[lLevel].written = &lWritten;
+    }
 
-    if (NULL == pTree->cursor)
+    lRecords->offset = lFile.records;
+
+    for (lLevel = 0; lLevel < lLevels; lLevel++)
     {
-        return (FALSE); // pass through result code
+        lEntries[lLevel].offset = lFile.entries + (1UL << lLevel) * lEntrySize;
     }
 
     /*
-    ** copy the data value
+    ** the header is padded so that the entries begin on a cache line of the
+    ** page aligned mapping; the unused entry 0 begins the root's level, or
+    ** the records of an empty tree
     */
 
-    if (NULL != pData)
+    lWritten = 1 == fwrite(&lFile, sizeof(motelTreeFile), 1, lStream);
+
+    if (0 == lLevels)
+    {
+        lRecords->offset = lFile.entries;
+
+        StageFileBytes(lRecords, lEntrySize);
+    }
+    else
     {
-        memcpy((void *)pData, (const void *) pTree->cursor->data, pTree->dataSize);
+        lEntries[0].offset = lFile.entries;
+
+        StageFileBytes(&lEntries[0], lEntrySize);
     }
 
     /*
-    ** copy the key value
+    ** add each node's entry to its level and its record to the records
     */
 
-    if (NULL != pKey)
+    lNode = GetLeastNode(pTree);
+
+    SeekPath(pTree, &lPath, lNode);
+
+    for (lRank = 1; lRank <= lNodes; lRank++)
+    {
+        lBytes = StageFileBytes(&lEntries[GetRankLevel(lRank, lLevels, lNodes)], lEntrySize);
+
+        memcpy(lBytes, NodeKey(lNode), pTree->keySize);
+
+        * (unsigned long *) (lBytes + lKeySize) = lNode->instance;
+        * (unsigned long *) (lBytes + lKeySize + sizeof(unsigned long)) = lRank;
+
+        lBytes = StageFileBytes(lRecords, lRecordSize);
+
+        memcpy(lBytes, NodeKey(lNode), pTree->keySize);
+
+        * (unsigned long *) (lBytes + lKeySize) = lNode->instance;
+
+        memcpy(lBytes + lKeySize + sizeof(unsigned long), NodeData(pTree, lNode), pTree->dataSize);
+
+        lNode = StepPathGreater(pTree, &lPath, lNode);
+    }
+
+    for (lLevel = 0; lLevel <= lLevels; lLevel++)
     {
-        memcpy((void *)pKey, (const void *) pTree->cursor->key, pTree->keySize);
+        FlushFileBuffer(&lBuffers[lLevel]);
     }
 
-    /*
-    ** copy the instance value
-    */
+    SafeFreeBlock((void **) &lRecords->bytes);
 
-    if (NULL != pInstance)
+    lWritten = lWritten && (!pSync || SyncFileStream(lStream));
+
+    if (0 != fclose(lStream))
+    {
+        pTree->result = lWritten ? motelResult_Closing : motelResult_Writing;
+
+        return (FALSE);
+    }
+
+    if (!lWritten)
     {
-        * pInstance = pTree->cursor->instance;
+        pTree->result = motelResult_Writing;
+
+        return (FALSE);
     }
 
     return (TRUE);
 }
 
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekGreatestTreeNode
+static byte * StageFileBytes
 (
-    motelTreeHandle pTree,
-    void * pData,
-    void * pKey,
-    unsigned long * pInstance
+    motelTreeFileBuffer * pBuffer,
+    size_t pSize
 )
 {
-    /*
-    ** there is no tree
-    */
+    byte * lBytes;
 
-    if (NULL == pTree)
+    if (pBuffer->capacity - pBuffer->used < pSize)
     {
-        return (FALSE);
+        FlushFileBuffer(pBuffer);
     }
 
     /*
-    ** the tree is empty
+    ** the room is cleared so that the padding written holds no stray bytes
     */
 
-    if (NULL == pTree->root)
+    lBytes = pBuffer->bytes + pBuffer->used;
+
+    memset(lBytes, 0, pSize);
+
+    pBuffer->used += pSize;
+
+    return (lBytes);
+}
+
+static void FlushFileBuffer
+(
+    motelTreeFileBuffer * pBuffer
+)
+{
+    if (0 == pBuffer->used)
     {
-        pTree->result = motelResult_NoNode;
+        return;
+    }
 
-        return (FALSE);
+    * pBuffer->written = * pBuffer->written &&
+                         0 == fseek(pBuffer->stream, (long) pBuffer->offset, SEEK_SET) &&
+                         pBuffer->used == fwrite(pBuffer->bytes, 1, pBuffer->used, pBuffer->stream);
+
+    pBuffer->offset += pBuffer->used;
+    pBuffer->used = 0;
+}
+
+static void FillLogRecord
+(
+    motelTreeHandle pTree,
+    motelTreeLogOperation pOperation,
+    const void * pKey,
+    unsigned long pInstance,
+    const void * pData
+)
+{
+    motelTreeLogRecord * lRecord;
+
+    lRecord = (motelTreeLogRecord *) (pTree->log->buffer + pTree->log->used);
+
+    lRecord->instance = (bits64) pInstance;
+    lRecord->operation = (bits32) pOperation;
+
+    memcpy(LogRecordKey(lRecord), pKey, pTree->keySize);
+
+    if (motelTreeLogOperation_Delete != pOperation)
+    {
+        memcpy(LogRecordData(pTree, lRecord), pData, pTree->dataSize);
     }
 
+    pTree->log->length = LogRecordSize(pTree, pOperation);
+}
+
+static boolean AppendLogRecord
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeLogHandle lLog;
+
+    motelTreeLogRecord * lRecord;
+
+    lLog = pTree->log;
+
+    lRecord = (motelTreeLogRecord *) (lLog->buffer + lLog->used);
+
     /*
-    ** position the cursor
+    ** number and seal the record
     */
 
-    pTree->cursor = GetGreatestNode(pTree);
+    lRecord->sequence = pTree->logSequence + 1;
 
-    if (NULL == pTree->cursor)
+    lRecord->checksum = 0;
+    lRecord->checksum = LogChecksum((const byte *) lRecord, lLog->length);
+
+    pTree->logSequence += 1;
+
+    lLog->used += lLog->length;
+
+    lLog->pending += 1;
+    lLog->records += 1;
+
+    /*
+    ** the buffer is written once it has no room for another record, and
+    ** committed once it holds a group of changes or the commit interval has
+    ** passed
+    */
+
+    if (lLog->capacity - lLog->used < LogRecordSize(pTree, motelTreeLogOperation_Insert) && !WriteLogBuffer(pTree))
+    {
+        return (FALSE); // pass through result code
+    }
+
+    if ((pTree->logCommitRecords <= lLog->pending ||
+         (0 != pTree->logCommitMilliseconds && pTree->logCommitMilliseconds <= GetLogClock() - lLog->committed)) &&
+        !CommitLog(pTree))
     {
         return (FALSE); // pass through result code
     }
 
     /*
-    ** copy the data value
+    ** a failed checkpoint leaves the log holding every change, so the change
+    ** stands and the checkpoint waits for another interval
     */
 
-    if (NULL != pData)
+    if (0 != pTree->logCheckpointRecords && pTree->logCheckpointRecords <= lLog->records && !WriteCheckpoint(pTree))
     {
-        memcpy((void *)pData, (const void *) pTree->cursor->data, pTree->dataSize);
+        if (lLog->failed)
+        {
+            return (FALSE); // pass through result code
+        }
+
+        lLog->records = 0;
+
+        pTree->result = motelResult_OK;
     }
 
-    /*
-    ** copy the key value
-    */
+    return (TRUE);
+}
 
-    if (NULL != pKey)
+static boolean WriteLogBuffer
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeLogHandle lLog;
+
+    lLog = pTree->log;
+
+    if (NULL == lLog->stream || lLog->used != fwrite(lLog->buffer, 1, lLog->used, lLog->stream))
     {
-        memcpy((void *)pKey, (const void *) pTree->cursor->key, pTree->keySize);
+        lLog->failed = TRUE;
+
+        pTree->result = motelResult_Writing;
+
+        return (FALSE);
     }
 
-    /*
-    ** copy the instance value
-    */
+    lLog->used = 0;
 
-    if (NULL != pInstance)
+    return (TRUE);
+}
+
+static boolean CommitLog
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeLogHandle lLog;
+
+    lLog = pTree->log;
+
+    if (!WriteLogBuffer(pTree))
+    {
+        return (FALSE); // pass through result code
+    }
+
+    if (!SyncFileStream(lLog->stream))
     {
-        * pInstance = pTree->cursor->instance;
+        lLog->failed = TRUE;
+
+        pTree->result = motelResult_Writing;
+
+        return (FALSE);
     }
 
+    lLog->pending = 0;
+
+    lLog->committed = GetLogClock();
+
     return (TRUE);
 }
 
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekLesserTreeNode
+static boolean WriteCheckpoint
 (
-    motelTreeHandle pTree,
-    void * pData,
-    void * pKey,
-    unsigned long * pInstance
+    motelTreeHandle pTree
 )
 {
+    motelTreeLogHandle lLog;
+
+    motelTreeLogFile lFile;
+
+    lLog = pTree->log;
+
     /*
-    ** there is no tree
+    ** commit the logged changes, so that the log still holds them should the
+    ** checkpoint fail; a checkpoint that succeeds holds them anyway
     */
 
-    if (NULL == pTree)
+    if (NULL != lLog->stream && !lLog->failed)
     {
-        return (FALSE);
+        CommitLog(pTree);
     }
 
     /*
-    ** the tree is empty
+    ** write the checkpoint beside the previous one and then replace it
     */
 
-    if (NULL == pTree->root)
+    if (!WriteTreeFile(pTree, lLog->temporaryPath, pTree->logSequence, TRUE))
     {
-        pTree->result = motelResult_NoNode;
+        remove(lLog->temporaryPath);
+
+        return (FALSE); // pass through result code
+    }
+
+    if (!ReplaceFilePath(lLog->temporaryPath, lLog->checkpointPath))
+    {
+        remove(lLog->temporaryPath);
+
+        pTree->result = motelResult_Writing;
 
         return (FALSE);
     }
 
     /*
-    ** when the cursor is not set, move forward from the greatest node
+    ** start the log afresh; until it is, the tree makes no changes
     */
 
-    if (NULL == pTree->cursor)
+    lLog->failed = TRUE;
+
+    if (NULL != lLog->stream)
     {
-        pTree->cursor = GetGreatestNode(pTree);
+        fclose(lLog->stream);
     }
-    else
+
+    lLog->stream = fopen(lLog->path, "wb");
+
+    if (NULL == lLog->stream)
     {
-        pTree->cursor = GetLesserNode(pTree);
+        pTree->result = motelResult_Opening;
+
+        return (FALSE);
     }
 
-    if (NULL == pTree->cursor)
+    /*
+    ** the log gathers its records in its own buffer
+    */
+
+    setvbuf(lLog->stream, NULL, _IONBF, 0);
+
+    lLog->used = 0;
+
+    memset(&lFile, 0, sizeof(motelTreeLogFile));
+
+    lFile.signature = TREE_LOG_SIGNATURE;
+    lFile.version = TREE_LOG_VERSION;
+
+    lFile.keyType = (bits32) pTree->keyType;
+
+    lFile.keySize = pTree->keySize;
+    lFile.dataSize = pTree->dataSize;
+
+    if (1 != fwrite(&lFile, sizeof(motelTreeLogFile), 1, lLog->stream) || !SyncFileStream(lLog->stream))
     {
+        pTree->result = motelResult_Writing;
+
         return (FALSE);
     }
 
-    pTree->result = motelResult_OK;
+    lLog->pending = 0;
+    lLog->records = 0;
 
-    /*
-    ** copy the data value
-    */
+    lLog->committed = GetLogClock();
+
+    lLog->failed = FALSE;
+
+    return (TRUE);
+}
+
+static boolean CloseLog
+(
+    motelTreeHandle pTree
+)
+{
+    motelTreeLogHandle lLog;
+
+    boolean lClosed;
+
+    lLog = pTree->log;
 
-    if (NULL != pData)
+    lClosed = TRUE;
+
+    if (NULL != lLog->stream)
     {
-        memcpy((void *)pData, (const void *) pTree->cursor->data, pTree->dataSize);
-    }
+        if (!lLog->failed)
+        {
+            lClosed = CommitLog(pTree);
+        }
 
-    /*
-    ** copy the key value
-    */
+        if (0 != fclose(lLog->stream) && lClosed)
+        {
+            pTree->result = motelResult_Closing;
 
-    if (NULL != pKey)
-    {
-        memcpy((void *)pKey, (const void *) pTree->cursor->key, pTree->keySize);
+            lClosed = FALSE;
+        }
     }
 
-    /*
-    ** copy the instance value
-    */
+    SafeFreeBlock((void **) &lLog->path);
+    SafeFreeBlock((void **) &lLog->checkpointPath);
+    SafeFreeBlock((void **) &lLog->temporaryPath);
+    SafeFreeBlock((void **) &lLog->buffer);
 
-    if (NULL != pInstance)
-    {
-        * pInstance = pTree->cursor->instance;
-    }
+    SafeFreeBlock((void **) &pTree->log);
 
-    return (TRUE);
+    return (lClosed);
 }
 
-EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekGreaterTreeNode
+static boolean ReplayLog
 (
     motelTreeHandle pTree,
-    void * pData,
-    void * pKey,
-    unsigned long * pInstance
+    const char * pPath,
+    bits64 * pSequence
 )
 {
-    /*
-    ** there is no tree
-    */
+    FILE * lStream;
 
-    if (NULL == pTree)
-    {
-        return (FALSE);
-    }
+    motelTreeLogFile lFile;
+
+    motelTreeLogRecord * lRecord = (motelTreeLogRecord *) NULL;
+
+    size_t lLength;
+
+    bits32 lChecksum;
+
+    boolean lReplayed;
+
+    lStream = fopen(pPath, "rb");
 
     /*
-    ** the tree is empty
+    ** there have been no changes since the checkpoint
     */
 
-    if (NULL == pTree->root)
+    if (NULL == lStream)
     {
-        pTree->result = motelResult_NoNode;
-
-        return (FALSE);
+        return (TRUE);
     }
 
     /*
-    ** when the cursor is not set, move forward from the least node
+    ** a log whose header is torn holds no changes
     */
 
-    if (NULL == pTree->cursor)
-    {
-        pTree->cursor = GetLeastNode(pTree);
-    }
-    else
+    if (1 != fread(&lFile, sizeof(motelTreeLogFile), 1, lStream))
     {
-        pTree->cursor = GetGreaterNode(pTree);
-    }
+        fclose(lStream);
 
-    if (NULL == pTree->cursor)
-    {
-        return (FALSE);
+        return (TRUE);
     }
 
-    pTree->result = motelResult_OK;
+    if (TREE_LOG_SIGNATURE != lFile.signature ||
+        TREE_LOG_VERSION != lFile.version ||
+        (bits32) pTree->keyType != lFile.keyType ||
+        pTree->keySize != lFile.keySize ||
+        pTree->dataSize != lFile.dataSize)
+    {
+        fclose(lStream);
 
-    /*
-    ** copy the data value
-    */
+        pTree->result = motelResult_InvalidValue;
 
-    if (NULL != pData)
-    {
-        memcpy((void *)pData, (const void *) pTree->cursor->data, pTree->dataSize);
+        return (FALSE);
     }
 
-    /*
-    ** copy the key value
-    */
-
-    if (NULL != pKey)
+    if (!SafeMallocBlock((void **) &lRecord, LogRecordSize(pTree, motelTreeLogOperation_Insert)))
     {
-        memcpy((void *)pKey, (const void *) pTree->cursor->key, pTree->keySize);
-    }
+        fclose(lStream);
 
-    /*
-    ** copy the instance value
-    */
+        pTree->result = motelResult_MemoryAllocation;
 
-    if (NULL != pInstance)
-    {
-        * pInstance = pTree->cursor->instance;
+        return (FALSE);
     }
 
-    return (TRUE);
-}
-
-/*----------------------------------------------------------------------------
-  Private functions
-  ----------------------------------------------------------------------------*/
+    lReplayed = TRUE;
 
-static boolean ValidateSubtree
-(
-    motelTreeHandle pTree,
-    motelTreeNodeHandle pRoot
-)
-{
-    if (NULL != pRoot->lesser)
+    while (lReplayed && 1 == fread(lRecord, sizeof(motelTreeLogRecord), 1, lStream))
     {
         /*
-        ** validate that the node values are correct
+        ** the replay ends at the first record torn by a crash
         */
 
-        if (0 > NodeCompare(pTree, pRoot, pRoot->lesser))
+        if (motelTreeLogOperation_Insert > lRecord->operation || motelTreeLogOperation_ <= lRecord->operation)
         {
-            pTree->result = motelResult_Structure;
-
-            return (FALSE); // set breakpoint here for debugging
+            break;
         }
 
-        /*
-        ** validate that the node weights are correct
-        */
+        lLength = LogRecordSize(pTree, lRecord->operation);
 
-        if (NULL != pRoot->lesser && pRoot->lesserNullNodes != pRoot->lesser->lesserNullNodes + pRoot->lesser->greaterNullNodes)
+        if (lLength - sizeof(motelTreeLogRecord) != fread(LogRecordKey(lRecord), 1, lLength - sizeof(motelTreeLogRecord), lStream))
         {
-            pTree->result = motelResult_NodeCount;
-
-            return (FALSE); // set breakpoint here for debugging
+            break;
         }
 
-        /*
-        ** validate the lesser subtree
-        */
+        lChecksum = lRecord->checksum;
 
-        if (!ValidateSubtree(pTree, pRoot->lesser))
+        lRecord->checksum = 0;
+
+        if (lChecksum != LogChecksum((const byte *) lRecord, lLength))
         {
-            return (FALSE); // pass through result code
+            break;
         }
-    }
-    
-    if (NULL != pRoot->greater)
-    {
+
         /*
-        ** validate that the node values are correct
+        ** the checkpoint already holds the change, or the record was left by
+        ** an earlier log
         */
 
-        if (0 < NodeCompare(pTree, pRoot, pRoot->greater))
+        if (lRecord->sequence <= * pSequence)
         {
-            pTree->result = motelResult_Structure;
+            continue;
+        }
 
-            return (FALSE); // set breakpoint here for debugging
+        if (lRecord->sequence != * pSequence + 1)
+        {
+            break;
         }
 
         /*
-        ** validate that the node weights are correct
+        ** make the change
         */
 
-        if (pRoot->greaterNullNodes != pRoot->greater->lesserNullNodes + pRoot->greater->greaterNullNodes)
+        if (motelTreeLogOperation_Insert == lRecord->operation)
         {
-            pTree->result = motelResult_NodeCount;
-
-            return (FALSE); // set breakpoint here for debugging
+            lReplayed = InsertTreeNode(pTree, LogRecordData(pTree, lRecord), LogRecordKey(lRecord));
         }
+        else
+        {
+            pTree->cursor = GetEqualNode(pTree, (const void *) LogRecordKey(lRecord), (unsigned long) lRecord->instance);
 
-        /*
-        ** validate the greater subtree
-        */
+            SetCursorOccurrence(pTree, FALSE);
+
+            if (NULL == pTree->cursor)
+            {
+                pTree->result = motelResult_Corrupted;
+
+                lReplayed = FALSE;
+            }
+            else if (motelTreeLogOperation_Update == lRecord->operation)
+            {
+                lReplayed = UpdateTreeNode(pTree, LogRecordData(pTree, lRecord));
+            }
+            else
+            {
+                lReplayed = DeleteTreeNode(pTree);
+            }
+        }
 
-        if (!ValidateSubtree(pTree, pRoot->greater))
+        if (lReplayed)
         {
-            return (FALSE); // pass through result code
+            * pSequence = lRecord->sequence;
         }
     }
 
-    return (TRUE);
+    SafeFreeBlock((void **) &lRecord);
+
+    fclose(lStream);
+
+    return (lReplayed); // pass through result code
 }
 
-static boolean ConstructNode
+static bits32 LogChecksum
 (
-    motelTreeHandle pTree,
-    void * pKey,
-    void * pData,
-    motelTreeNodeHandle * pNode
+    const byte * pRecord,
+    size_t pLength
 )
 {
-    motelTreeNodeHandle lNode = (motelTreeNodeHandle) NULL;
+    bits64 lHash;
+    bits64 lWord;
 
-    void * lNodeKey = (void *) NULL;
-    void * lNodeData = (void *) NULL;
+    lHash = 14695981039346656037ULL;
 
-    pTree->result = motelResult_OK;
+    for (; sizeof(bits64) <= pLength; pRecord += sizeof(bits64), pLength -= sizeof(bits64))
+    {
+        memcpy(&lWord, pRecord, sizeof(bits64));
 
-    /*
-    ** there isn't room for a new node
-    */
+        lHash = (lHash ^ lWord) * 1099511628211ULL;
+    }
 
-    if (pTree->maximumSize > 0 && pTree->maximumSize < pTree->size + sizeof(motelTreeNode) + pTree->keySize + pTree->dataSize)
+    for (; 0 < pLength; pRecord++, pLength--)
     {
-        pTree->result = motelResult_MaximumSize;
+        lHash = (lHash ^ * pRecord) * 1099511628211ULL;
+    }
 
-        * pNode = (motelTreeNodeHandle) NULL;
+    return ((bits32) (lHash ^ (lHash >> 32)));
+}
 
+static boolean SyncFileStream
+(
+    FILE * pStream
+)
+{
+    if (0 != fflush(pStream))
+    {
         return (FALSE);
     }
 
-    /*
-    ** allocate memory for the objects
-    */
+#if defined _WIN32 || defined _WIN64
 
-    if (!ManagedMallocBlock((void **) &lNode, sizeof(motelTreeNode), &pTree->size))
-    {
-        pTree->result = motelResult_MemoryAllocation;
+    return (0 == _commit(_fileno(pStream)));
 
-        * pNode = (motelTreeNodeHandle) NULL;
+#else
 
-        return (FALSE);
-    }
+    return (0 == fsync(fileno(pStream)));
 
-    if (!ManagedMallocBlock((void **) &lNodeKey, pTree->keySize, &pTree->size))
-    {
-        ManagedFreeBlock((void **) &lNode, sizeof(motelTreeNode), &pTree->size);
+#endif
+}
 
-        pTree->result = motelResult_MemoryAllocation;
+static bits64 GetLogClock
+(
+    void
+)
+{
+#if defined _WIN32 || defined _WIN64
 
-        * pNode = (motelTreeNodeHandle) NULL;
+    return ((bits64) GetTickCount64());
 
-        return (FALSE);
-    }
+#else
 
-    if (!ManagedMallocBlock((void **) &lNodeData, pTree->dataSize, &pTree->size))
-    {
-        ManagedFreeBlock((void **) &lNodeKey, pTree->keySize, &pTree->size);
-        ManagedFreeBlock((void **) &lNode, sizeof(motelTreeNode), &pTree->size);
+    struct timespec lTime;
 
-        pTree->result = motelResult_MemoryAllocation;
+    clock_gettime(CLOCK_MONOTONIC, &lTime);
 
-        * pNode = (motelTreeNodeHandle) NULL;
+    return ((bits64) lTime.tv_sec * 1000 + (bits64) lTime.tv_nsec / 1000000);
+
+#endif
+}
+
+static boolean ReplaceFilePath
+(
+    const char * pPath,
+    const char * pNewPath
+)
+{
+#if defined _WIN32 || defined _WIN64
+
+    return (MoveFileExA(pPath, pNewPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH));
 
+#else
+
+    char * lDirectory = (char *) NULL;
+    char * lSeparator;
+
+    int lFile;
+
+    boolean lSynced;
+
+    if (0 != rename(pPath, pNewPath))
+    {
         return (FALSE);
     }
 
     /*
-    ** copy the key and data into the new node
+    ** the renaming is committed with the directory that holds the file
     */
 
-    memcpy((void *) lNodeKey, (const void *) pKey, pTree->keySize);
-    memcpy((void *) lNodeData, (const void *) pData, pTree->dataSize);
+    if (!SafeMallocBlock((void **) &lDirectory, strlen(pNewPath) + sizeof(".")))
+    {
+        return (FALSE);
+    }
 
-    /*
-    ** initialize the node
-    */
+    strcpy(lDirectory, pNewPath);
 
-    lNode->instance = 1;
+    lSeparator = strrchr(lDirectory, '/');
 
-    lNode->parent = (motelTreeNodeHandle) NULL;
-    
-    lNode->lesser = (motelTreeNodeHandle) NULL;
-    lNode->lesserNullNodes = 1;
-    
-    lNode->greater = (motelTreeNodeHandle) NULL;
-    lNode->greaterNullNodes = 1;
+    if (NULL == lSeparator)
+    {
+        strcpy(lDirectory, ".");
+    }
+    else if (lSeparator == lDirectory)
+    {
+        lSeparator[1] = '\0';
+    }
+    else
+    {
+        lSeparator[0] = '\0';
+    }
 
-    lNode->key = lNodeKey;
-    lNode->data = lNodeData;
+    lFile = open(lDirectory, O_RDONLY);
 
-    /*
-    ** return the new node
-    */
+    SafeFreeBlock((void **) &lDirectory);
 
-    * pNode = lNode;
+    if (0 > lFile)
+    {
+        return (FALSE);
+    }
 
-    return (TRUE);
+    lSynced = 0 == fsync(lFile);
+
+    close(lFile);
+
+    return (lSynced);
+
+#endif
 }
 
-static boolean DestructNode
+static unsigned long BeginTreeRead
 (
     motelTreeHandle pTree
 )
 {
-    motelTreeNodeHandle lCurrentNode;
+    unsigned long lSequence;
+
+    if (!pTree->concurrent)
+    {
+        return (0);
+    }
 
     /*
-    ** there is no tree
+    ** wait out any writer holding the tree lock
     */
 
-    if (NULL == pTree)
+    for (;;)
     {
-        return (FALSE);
+        lSequence = (unsigned long) AtomicRead(&pTree->sequence);
+
+        if (0 == (lSequence & 1))
+        {
+            break;
+        }
+
+        YieldThread();
     }
 
-    pTree->result = motelResult_OK;
+    MemoryFence();
 
-    if (NULL == pTree->cursor)
-    {
-        pTree->result = motelResult_NotFound;
+    return (lSequence);
+}
 
-        return (FALSE);
+static boolean EndTreeRead
+(
+    motelTreeHandle pTree,
+    unsigned long pSequence
+)
+{
+    if (!pTree->concurrent)
+    {
+        return (TRUE);
     }
 
-    lCurrentNode = pTree->cursor;
+    MemoryFence();
 
-    if (!ManagedFreeBlock((void **) &lCurrentNode->data, pTree->dataSize, &pTree->size))
-    {
-        pTree->result = motelResult_MemoryDeallocation;
+    return (pSequence == (unsigned long) AtomicRead(&pTree->sequence));
+}
 
-        return (FALSE);
+static unsigned long EnterTreeEpoch
+(
+    motelTreeHandle pTree
+)
+{
+    unsigned long lEpoch;
+
+    if (!pTree->concurrent)
+    {
+        return (0);
     }
 
-    if (!ManagedFreeBlock((void **) &lCurrentNode->key, pTree->keySize, &pTree->size))
+    /*
+    ** count the reader within the current epoch, retrying should the epoch
+    ** advance before the count is seen
+    */
+
+    for (;;)
     {
-        pTree->result = motelResult_MemoryDeallocation;
+        lEpoch = (unsigned long) AtomicRead(&pTree->epoch);
 
-        return (FALSE);
+        AtomicIncrement(&pTree->readers[lEpoch & 1]);
+
+        if (lEpoch == (unsigned long) AtomicRead(&pTree->epoch))
+        {
+            break;
+        }
+
+        AtomicDecrement(&pTree->readers[lEpoch & 1]);
     }
 
-    if (!ManagedFreeBlock((void **) &lCurrentNode, sizeof(motelTreeNode), &pTree->size))
-    {
-        pTree->result = motelResult_MemoryDeallocation;
+    return (lEpoch);
+}
 
-        return (FALSE);
+static void ExitTreeEpoch
+(
+    motelTreeHandle pTree,
+    unsigned long pEpoch
+)
+{
+    if (!pTree->concurrent)
+    {
+        return;
     }
 
-    pTree->cursor = (motelTreeNodeHandle) NULL;
-
-    return (TRUE);
+    AtomicDecrement(&pTree->readers[pEpoch & 1]);
 }
 
-static motelTreeNodeHandle GetEqualNode
+static void RetireNode
 (
     motelTreeHandle pTree,
-    const void * pKey,
-    unsigned long pInstance
+    motelTreeNodeHandle pNode
 )
 {
-    motelTreeNodeHandle lNode;
-
-    long lComparisonResult;
+    unsigned long lParity;
 
-    pTree->result = motelResult_NotFound;
+    lParity = (unsigned long) pTree->epoch & 1;
 
     /*
-    ** there is no key
+    ** the retired nodes are chained through their lesser links, which a reader
+    ** still on one may follow only to other nodes retired alongside it
     */
 
-    if (NULL == pKey)
-    {
-        return (NULL);
-    }
+    SetNodeLesser(pTree, pNode, pTree->retired[lParity]);
 
-    /*
-    ** traverse towards the node that matches the key object value
-    */
+    pTree->retired[lParity] = pNode;
+}
+
+static boolean ReclaimRetiredNodes
+(
+    motelTreeHandle pTree,
+    boolean pAll
+)
+{
+    motelTreeNodeHandle lNode;
 
-    lNode = pTree->root;
+    unsigned long lParity;
+    unsigned long lPass;
 
-    while (NULL != lNode)
+    for (lPass = 0; lPass < 2; lPass++)
     {
-        lComparisonResult = pTree->compareKeyFunction((const void *) pKey, (const void *) lNode->key);
+        /*
+        ** the previous epoch shares its parity with the next epoch
+        */
 
-        if (0 == lComparisonResult)
+        lParity = ((unsigned long) pTree->epoch + 1) & 1;
+
+        if (!pAll)
         {
-            /*
-            ** find the least instance of a potential duplicate
-            */
-            
-            if (0 == pInstance)
+            if (NULL == pTree->retired[0] && NULL == pTree->retired[1])
             {
-                while (NULL != lNode->lesser && 0 == pTree->compareKeyFunction((const void *) pKey, (const void *) lNode->lesser->key))
-                {
-                    lNode = lNode->lesser;
-                }
-
-                pTree->result = motelResult_OK;
-
                 break;
             }
-            else
+
+            if (0 != AtomicRead(&pTree->readers[lParity]))
             {
-                lComparisonResult = pInstance - lNode->instance;
+                break;
             }
         }
 
-        if (0 > lComparisonResult)
-        {
-            lNode = lNode->lesser; /* traverse lesser */
-        }
-        else if (0 < lComparisonResult)
+        /*
+        ** destruct the nodes retired during the previous epoch
+        */
+
+        while (NULL != pTree->retired[lParity])
         {
-            lNode = lNode->greater; /* traverse greater */
+            lNode = pTree->retired[lParity];
+
+            pTree->retired[lParity] = NodeLesser(pTree, lNode);
+
+            if (!DestructNode(pTree, lNode))
+            {
+                return (FALSE); // pass through result code
+            }
         }
-        else /* (0 == lComparisonResult) */
+
+        /*
+        ** new readers enter the next epoch
+        */
+
+        AtomicIncrement(&pTree->epoch);
+
+        /*
+        ** a single advance is enough for an ordinary reclamation
+        */
+
+        if (!pAll)
         {
-            pTree->result = motelResult_OK;
             break;
         }
     }
 
-    return (lNode);
+    return (TRUE);
 }
 
-static long NodeCompare
+static boolean ReadBoundNode
 (
     motelTreeHandle pTree,
-    motelTreeNodeHandle pNode1,
-    motelTreeNodeHandle pNode2
+    const void * pKey,
+    unsigned long pInstance,
+    unsigned long pSequence,
+    motelTreeNodeHandle * pNode
 )
 {
-    long lComparisonResult;
-
-    lComparisonResult = pTree->compareKeyFunction((const void *) pNode1->key, (const void *) pNode2->key);
-
-    if (0 == lComparisonResult)
-    {
-        lComparisonResult = pNode1->instance - pNode2->instance;
-    }
-
-    return (lComparisonResult);
-}
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lBoundNode = (motelTreeNodeHandle) NULL;
 
-static motelTreeNodeHandle GetLeastNode
-(
-    motelTreeHandle pTree
-)
-{
-    motelTreeNodeHandle lNode = (motelTreeNodeHandle) NULL;
-    motelTreeNodeHandle lChild;
+    long lComparisonResult;
 
-    pTree->result = motelResult_NotFound;
+    unsigned long lSteps = 0;
 
     /*
-    ** traverse towards the most lesser leaf
+    ** traverse towards the bound remembering the last node passed on the greater side
     */
 
-    lChild = pTree->root;
-
-    while (NULL != lChild)
-    {
-        lNode = lChild;
-        lChild = lNode->lesser;
-    }
+    lNode = TreeRoot(pTree);
 
-    if (NULL != lNode)
+    while (NULL != lNode)
     {
-        pTree->result = motelResult_OK;
-    }
-
-    return (lNode);
-}
-
-static motelTreeNodeHandle GetGreatestNode
-(
-    motelTreeHandle pTree
-)
-{
-    motelTreeNodeHandle lNode = (motelTreeNodeHandle) NULL;
-    motelTreeNodeHandle lChild;
+        if (0 == ++lSteps % READ_CHECK_INTERVAL && !EndTreeRead(pTree, pSequence))
+        {
+            return (FALSE);
+        }
 
-    pTree->result = motelResult_NotFound;
+        if (NULL == pKey)
+        {
+            lComparisonResult = LESS_THAN;
+        }
+        else
+        {
+            lComparisonResult = CompareReadKeys(pTree, pKey, NodeKey(lNode));
 
-    /*
-    ** traverse towards the most greater leaf
-    */
+            if (0 == lComparisonResult)
+            {
+                lComparisonResult = (pInstance < lNode->instance) ? LESS_THAN : MORE_THAN;
+            }
+        }
 
-    lChild = pTree->root;
+        if (0 > lComparisonResult)
+        {
+            lBoundNode = lNode; /* the node is after the bound */
 
-    while (NULL != lChild)
-    {
-        lNode = lChild;
-        lChild = lNode->greater;
+            lNode = NodeLesser(pTree, lNode);
+        }
+        else
+        {
+            lNode = NodeGreater(pTree, lNode);
+        }
     }
 
-    if (NULL != lNode)
-    {
-        pTree->result = motelResult_OK;
-    }
+    * pNode = lBoundNode;
 
-    return (lNode);
+    return (TRUE);
 }
 
-static motelTreeNodeHandle GetLesserNode
+static boolean ReadGreaterNode
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    unsigned long pSequence,
+    motelTreeNodeHandle * pNext
 )
-{ 
-    motelTreeNodeHandle lCurrentNode;
+{
+    motelTreeNodeHandle lCurrentNode = pNode;
 
     motelTreeNodeHandle lChild;
 
-    pTree->result = motelResult_NotFound;
-
-    lCurrentNode = pTree->cursor;
-
-    /*
-    ** there is no node
-    */
-
-    if (NULL == lCurrentNode)
-    {
-        return (NULL);
-    }
-
-    /*
-    ** traverse to the next lesser node in the tree
-    */
+    unsigned long lSteps = 0;
 
-    lChild = lCurrentNode->lesser;
+    lChild = NodeGreater(pTree, lCurrentNode);
 
     if (NULL != lChild)
     {
         /*
-        ** get the greater node of the lesser branch of the node passed
+        ** get the lesser node of the greater branch of the node passed
         */
 
         do
         {
+            if (0 == ++lSteps % READ_CHECK_INTERVAL && !EndTreeRead(pTree, pSequence))
+            {
+                return (FALSE);
+            }
+
             lCurrentNode = lChild;
-            lChild = lCurrentNode->greater; /* traverse towards a leaf */
+            lChild = NodeLesser(pTree, lCurrentNode); /* traverse towards a leaf */
         } 
         while (NULL != lChild);
     }
@@ -1759,379 +10440,472 @@ static motelTreeNodeHandle GetLesserNode
     {
         /*
         ** get the first ancestor of the node passed that references the node's
-        ** subtree via a greater branch
+        ** subtree via a lesser branch
         */
 
         do
         {
+            if (0 == ++lSteps % READ_CHECK_INTERVAL && !EndTreeRead(pTree, pSequence))
+            {
+                return (FALSE);
+            }
+
             lChild = lCurrentNode;
-            lCurrentNode = lChild->parent; /* traverse towards the root */
+            lCurrentNode = NodeParent(pTree, lChild); /* traverse towards the root */
         }
-        while (NULL != lCurrentNode && lChild != lCurrentNode->greater);
+        while (NULL != lCurrentNode && lChild != NodeLesser(pTree, lCurrentNode));
     }
 
-    /*
-    ** node not found
-    */
+    * pNext = lCurrentNode;
 
-    if (NULL != lCurrentNode)
+    return (TRUE);
+}
+
+static void CopyReadNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    void * pKey,
+    void * pData,
+    unsigned long * pInstance
+)
+{
+    if (NULL != pKey)
     {
-        pTree->result = motelResult_OK;
+        memcpy(pKey, NodeKey(pNode), pTree->keySize);
     }
 
-    return (lCurrentNode);
+    if (NULL != pData)
+    {
+        memcpy(pData, NodeData(pTree, pNode), pTree->dataSize);
+    }
+
+    if (NULL != pInstance)
+    {
+        * pInstance = pNode->instance;
+    }
 }
 
-static motelTreeNodeHandle GetGreaterNode
+static boolean ScanConcurrentRange
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    const void * pLeast,
+    const void * pGreatest,
+    boolean (* pScanFunction)(void * pContext, const void * pKey, const void * pData, unsigned long pInstance),
+    void * pContext
 )
 {
-    motelTreeNodeHandle lCurrentNode;
+    motelTreeNodeHandle lNode = (motelTreeNodeHandle) NULL;
+    motelTreeNodeHandle lNextNode;
 
-    motelTreeNodeHandle lChild;
+    byte * lCopies = (byte *) NULL;
 
-    pTree->result = motelResult_NotFound;
+    byte * lKey;
+    byte * lNextKey;
+    byte * lData;
+    byte * lSwap;
 
-    lCurrentNode = pTree->cursor;
+    unsigned long lInstance = 0;
+    unsigned long lNextInstance = 0;
+
+    unsigned long lEpoch;
+    unsigned long lSequence;
+    unsigned long lNodeSequence = 0;
+
+    boolean lStarted = FALSE;
+    boolean lCompleted;
 
     /*
-    ** there is no node
+    ** there is no scan function
     */
 
-    if (NULL == lCurrentNode)
+    if (NULL == pScanFunction)
     {
-        return (NULL);
+        return (FALSE);
     }
 
     /*
-    ** traverse to the next greater node in the tree
+    ** the scan function is handed confirmed copies of the key and data, with
+    ** a second key copy remembering where to resume
     */
 
-    lChild = lCurrentNode->greater;
+    if (!SafeMallocBlock((void **) &lCopies, 2 * AlignedNodeSize(pTree->keySize) + pTree->dataSize))
+    {
+        return (FALSE);
+    }
+
+    lKey = lCopies;
+    lNextKey = lCopies + AlignedNodeSize(pTree->keySize);
+    lData = lCopies + 2 * AlignedNodeSize(pTree->keySize);
 
-    if (NULL != lChild)
+    lEpoch = EnterTreeEpoch(pTree);
+
+    for (;;)
     {
+        lSequence = BeginTreeRead(pTree);
+
         /*
-        ** get the lesser node of the greater branch of the node passed
+        ** step on from the last node when no writer has intervened since it was
+        ** read and the tree has parent links to step through, otherwise seek
+        ** past the last key and instance visited
         */
 
-        do
+        if (NULL != lNode && lSequence == lNodeSequence && !pTree->parentless)
         {
-            lCurrentNode = lChild;
-            lChild = lCurrentNode->lesser; /* traverse towards a leaf */
-        } 
-        while (NULL != lChild);
-    }
-    else
-    {
+            lCompleted = ReadGreaterNode(pTree, lNode, lSequence, &lNextNode);
+        }
+        else if (lStarted)
+        {
+            lCompleted = ReadBoundNode(pTree, (const void *) lKey, lInstance, lSequence, &lNextNode);
+        }
+        else
+        {
+            lCompleted = ReadBoundNode(pTree, pLeast, 0, lSequence, &lNextNode);
+        }
+
+        if (!lCompleted)
+        {
+            lNode = (motelTreeNodeHandle) NULL;
+
+            continue;
+        }
+
         /*
-        ** get the first ancestor of the node passed that references the node's
-        ** subtree via a lesser branch
+        ** copy the next node
+        */
+
+        if (NULL != lNextNode)
+        {
+            CopyReadNode(pTree, lNextNode, lNextKey, lData, &lNextInstance);
+        }
+
+        if (!EndTreeRead(pTree, lSequence))
+        {
+            lNode = (motelTreeNodeHandle) NULL;
+
+            continue;
+        }
+
+        /*
+        ** the range is exhausted
         */
 
-        do
+        if (NULL == lNextNode)
         {
-            lChild = lCurrentNode;
-            lCurrentNode = lChild->parent; /* traverse towards the root */
+            break;
         }
-        while (NULL != lCurrentNode && lChild != lCurrentNode->lesser);
-    }
 
-    if (NULL != lCurrentNode)
-    {
-        pTree->result = motelResult_OK;
-    }
+        if (NULL != pGreatest && 0 < CompareReadKeys(pTree, (const void *) lNextKey, pGreatest))
+        {
+            break;
+        }
 
-    return (lCurrentNode);
-}
+        /*
+        ** the copy becomes the position to resume from
+        */
 
-static motelTreeNodeHandle GetRootNode
-(
-    motelTreeHandle pTree
-)
-{
-    motelTreeNodeHandle lNode;
+        lSwap = lKey;
+        lKey = lNextKey;
+        lNextKey = lSwap;
 
-    pTree->result = motelResult_NotFound;
+        lInstance = lNextInstance;
 
-    lNode = pTree->root;
+        lNode = lNextNode;
+        lNodeSequence = lSequence;
 
-    if (NULL != lNode)
-    {
-        pTree->result = motelResult_OK;
+        lStarted = TRUE;
+
+        if (!pScanFunction(pContext, (const void *) lKey, (const void *) lData, lInstance))
+        {
+            break;
+        }
     }
 
-    return (lNode);
+    ExitTreeEpoch(pTree, lEpoch);
+
+    SafeFreeBlock((void **) &lCopies);
+
+    return (TRUE);
 }
 
-static motelTreeNodeHandle GetParentNode
+static boolean PruneSubtree
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot
 )
 {
-    motelTreeNodeHandle lCurrentNode;
-
-    pTree->result = motelResult_OK;
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lParent;
 
-    lCurrentNode = pTree->cursor;
+    lNode = pRoot;
 
     /*
-    ** there is no node
+    ** without parent links each lesser child is rotated up in turn, so that
+    ** the node released never has one
     */
 
-    if (NULL == lCurrentNode)
+    if (pTree->parentless)
     {
-        pTree->result = motelResult_NullPointer;
-
-        return (NULL);
-    }
+        while (NULL != lNode)
+        {
+            if (NULL != NodeLesser(pTree, lNode))
+            {
+                lParent = NodeLesser(pTree, lNode);
 
-    return (lCurrentNode->parent);
-}
+                SetNodeLesser(pTree, lNode, NodeGreater(pTree, lParent));
+                SetNodeGreater(pTree, lParent, lNode);
 
-static motelTreeNodeHandle GetLesserChildNode
-(
-    motelTreeHandle pTree
-)
-{
-    motelTreeNodeHandle lCurrentNode;
+                lNode = lParent;
 
-    pTree->result = motelResult_OK;
+                continue;
+            }
 
-    lCurrentNode = pTree->cursor;
+            lParent = NodeGreater(pTree, lNode);
 
-    /*
-    ** there is no node
-    */
+            if (!DestructNode(pTree, lNode))
+            {
+                return (FALSE); // pass through result code
+            }
 
-    if (NULL == lCurrentNode)
-    {
-        pTree->result = motelResult_NullPointer;
+            lNode = lParent;
+        }
 
-        return (NULL);
+        return (TRUE);
     }
 
-    return (lCurrentNode->lesser);
-}
+    while (NULL != lNode)
+    {
+        /*
+        ** descend to a node whose children have been released
+        */
 
-static motelTreeNodeHandle GetGreaterChildNode
-(
-    motelTreeHandle pTree
-)
-{
-    motelTreeNodeHandle lCurrentNode;
+        if (NULL != NodeLesser(pTree, lNode))
+        {
+            lNode = NodeLesser(pTree, lNode);
 
-    pTree->result = motelResult_OK;
+            continue;
+        }
 
-    lCurrentNode = pTree->cursor;
+        if (NULL != NodeGreater(pTree, lNode))
+        {
+            lNode = NodeGreater(pTree, lNode);
 
-    /*
-    ** there is no node
-    */
+            continue;
+        }
 
-    if (NULL == lCurrentNode)
-    {
-        pTree->result = motelResult_NullPointer;
+        /*
+        ** detach the childless node from its parent (the subtree root's parent is left intact)
+        */
 
-        return (NULL);
-    }
+        if (pRoot == lNode)
+        {
+            lParent = (motelTreeNodeHandle) NULL;
+        }
+        else
+        {
+            lParent = NodeParent(pTree, lNode);
 
-    return (lCurrentNode->greater);
-}
+            if (lNode == NodeLesser(pTree, lParent))
+            {
+                SetNodeLesser(pTree, lParent, (motelTreeNodeHandle) NULL);
+            }
+            else
+            {
+                SetNodeGreater(pTree, lParent, (motelTreeNodeHandle) NULL);
+            }
+        }
 
-static unsigned long GetTreeLevelCount
-(
-    motelTreeHandle pTree
-)
-{  
-    motelTreeNodeHandle lRoot;
+        if (!DestructNode(pTree, lNode))
+        {
+            return (FALSE); // pass through result code
+        }
 
-    if (NULL == pTree)
-    {
-        return (0);
+        lNode = lParent;
     }
 
-    lRoot = pTree->root;
-
-    if (NULL == lRoot)
-    {
-        return (0);
-    }  
-
-    return (GetSubtreeLevelCount(lRoot));
+    return (TRUE);
 }
 
-static unsigned long GetSubtreeLevelCount
-(
-    motelTreeNodeHandle pRoot
-)
-{  
-    long lLesserDepth;
-    long lGreaterDepth;
-
-    if (NULL == pRoot)
-    {
-        return (0);
-    }  
-
-    lLesserDepth = GetSubtreeLevelCount(pRoot->lesser);
-    lGreaterDepth = GetSubtreeLevelCount(pRoot->greater);
-
-    return ((lLesserDepth > lGreaterDepth) ? (1 + lLesserDepth) : (1 + lGreaterDepth));
-}
+#if !defined COMPACT_TREE_NODES
 
-static void PivotLesserToGreater
+static boolean PruneTreeInParallel
 (
-    motelTreeHandle pTree,
-    motelTreeNodeHandle * pRoot
+    motelTreeHandle pTree
 )
 {
-    motelTreeNodeHandle lOldRoot = * pRoot;
-    motelTreeNodeHandle lNewRoot = lOldRoot->lesser;
+    motelTreeTeardown lTeardowns[MAXIMUM_TEARDOWN_THREADS + 1];
+    motelTreeNodeHandle lNode;
+    unsigned long lTeardownCount;
+    unsigned long lLargest;
+    unsigned long lIndex;
+    boolean lSuccess;
 
-    lNewRoot->parent = lOldRoot->parent;
+    lTeardowns[0].root = TreeRoot(pTree);
+    lTeardownCount = 1;
 
-    if (pTree->root == lOldRoot)
-    {
-        pTree->root = lNewRoot;
-    }
-    else
+    SetTreeRoot(pTree, (motelTreeNodeHandle) NULL);
+    pTree->cursor = (motelTreeNodeHandle) NULL;
+
+    /*
+    ** split the largest subtree at its root until there is a subtree for every thread
+    */
+
+    while (lTeardownCount < pTree->teardownThreads)
     {
-        if (lOldRoot->parent->lesser == lOldRoot)
+        lLargest = 0;
+
+        for (lIndex = 1; lIndex < lTeardownCount; lIndex++)
         {
-            lOldRoot->parent->lesser = lNewRoot;
+            if (lTeardowns[lLargest].root->lesserNullNodes + lTeardowns[lLargest].root->greaterNullNodes <
+                lTeardowns[lIndex].root->lesserNullNodes + lTeardowns[lIndex].root->greaterNullNodes)
+            {
+                lLargest = lIndex;
+            }
         }
-        else
+
+        lNode = lTeardowns[lLargest].root;
+
+        if (NULL == NodeLesser(pTree, lNode) || NULL == NodeGreater(pTree, lNode))
         {
-            lOldRoot->parent->greater = lNewRoot;
+            break;
         }
-    }
 
-    lOldRoot->parent = lNewRoot;
+        lTeardowns[lLargest].root = NodeLesser(pTree, lNode);
+        lTeardowns[lTeardownCount].root = NodeGreater(pTree, lNode);
+        lTeardownCount++;
 
-    lOldRoot->lesser = lNewRoot->greater;
+        SetNodeParent(pTree, NodeLesser(pTree, lNode), (motelTreeNodeHandle) NULL);
+        SetNodeParent(pTree, NodeGreater(pTree, lNode), (motelTreeNodeHandle) NULL);
 
-    if (NULL != lNewRoot->greater)
-    {
-        lNewRoot->greater->parent = lOldRoot;
-    }
+        SetNodeLesser(pTree, lNode, (motelTreeNodeHandle) NULL);
+        SetNodeGreater(pTree, lNode, (motelTreeNodeHandle) NULL);
 
-    lNewRoot->greater = lOldRoot;
+        if (!DestructNode(pTree, lNode))
+        {
+            /*
+            ** the subtrees already split off are no longer reachable from the tree, so they are released here
+            */
 
-    /*
-    ** update child node counts for the new and old parent working from lower to higher in the subtree
-    */
+            for (lIndex = 0; lIndex < lTeardownCount; lIndex++)
+            {
+                PruneSubtree(pTree, lTeardowns[lIndex].root);
+            }
 
-    if (NULL == lOldRoot->lesser)
-    {
-        lOldRoot->lesserNullNodes = 1;
-    }
-    else
-    {
-        lOldRoot->lesserNullNodes = lOldRoot->lesser->lesserNullNodes + lOldRoot->lesser->greaterNullNodes;
+            return (FALSE);
+        }
     }
 
-    lNewRoot->greaterNullNodes = lOldRoot->lesserNullNodes + lOldRoot->greaterNullNodes;
-
     /*
-    ** set the new parent in the calling function's variable so that in process tree traversals can continue
+    ** each thread reduces its own share of the tree's size so that no member is written by two threads
     */
 
-    (* pRoot) = lNewRoot;
-}
-
-static void PivotGreaterToLesser
-(
-    motelTreeHandle pTree,
-    motelTreeNodeHandle * pRoot
-)
-{
-    motelTreeNodeHandle lOldRoot = (* pRoot);
-    motelTreeNodeHandle lNewRoot = lOldRoot->greater;
+    for (lIndex = 1; lIndex < lTeardownCount; lIndex++)
+    {
+        lTeardowns[lIndex].nodeSize = pTree->nodeSize;
+        lTeardowns[lIndex].size = pTree->nodeSize * (lTeardowns[lIndex].root->lesserNullNodes + lTeardowns[lIndex].root->greaterNullNodes - 1);
+        lTeardowns[lIndex].success = FALSE;
 
-    lNewRoot->parent = lOldRoot->parent;
+        lTeardowns[lIndex].started = StartThread(&lTeardowns[lIndex].thread, PruneTeardownSubtree, (void *) &lTeardowns[lIndex]);
 
-    if (pTree->root == lOldRoot)
-    {
-        pTree->root = lNewRoot;
-    }
-    else
-    {
-        if (lOldRoot->parent->lesser == lOldRoot)
+        if (lTeardowns[lIndex].started)
         {
-            lOldRoot->parent->lesser = lNewRoot;
-        }
-        else
-        {
-            lOldRoot->parent->greater = lNewRoot;
+            pTree->size -= lTeardowns[lIndex].size;
         }
     }
 
-    lOldRoot->parent = lNewRoot;
+    lTeardowns[0].started = FALSE;
+
+    /*
+    ** the calling thread prunes the first subtree and any subtree whose thread did not start, keeping
+    ** the tree's own size current as it goes
+    */
 
-    lOldRoot->greater = lNewRoot->lesser;
+    lSuccess = TRUE;
 
-    if (NULL != lNewRoot->lesser)
+    for (lIndex = 0; lIndex < lTeardownCount; lIndex++)
     {
-        lNewRoot->lesser->parent = lOldRoot;
+        if (!lTeardowns[lIndex].started && !PruneSubtree(pTree, lTeardowns[lIndex].root))
+        {
+            lSuccess = FALSE;
+        }
     }
 
-    lNewRoot->lesser = lOldRoot;
-
     /*
-    ** update child node counts for the new and old parent working from lower to higher in the subtree
+    ** only the threads that started are joined
     */
 
-    if (NULL == lOldRoot->greater)
-    {
-        lOldRoot->greaterNullNodes = 1;
-    }
-    else
+    for (lIndex = 1; lIndex < lTeardownCount; lIndex++)
     {
-        lOldRoot->greaterNullNodes = lOldRoot->greater->lesserNullNodes + lOldRoot->greater->greaterNullNodes;
-    }
+        if (!lTeardowns[lIndex].started)
+        {
+            continue;
+        }
 
-    lNewRoot->lesserNullNodes = lOldRoot->lesserNullNodes + lOldRoot->greaterNullNodes;
+        if (!JoinThread(lTeardowns[lIndex].thread) || !lTeardowns[lIndex].success)
+        {
+            lSuccess = FALSE;
+        }
 
-    /*
-    ** set the new parent in the calling function's variable so that in process tree traversals can continue
-    */
+        pTree->size += lTeardowns[lIndex].size;
+    }
 
-    (* pRoot) = lNewRoot;
+    return (lSuccess);
 }
 
-static boolean PruneSubtree
+static motelThreadResult THREAD_CALLING_CONVENTION PruneTeardownSubtree
 (
-    motelTreeHandle pTree,
-    motelTreeNodeHandle pRoot
+    void * pTeardown
 )
 {
-    if (NULL != pRoot)
+    motelTreeTeardown * lTeardown;
+    motelTreeNodeHandle lNode;
+    motelTreeNodeHandle lParent;
+
+    lTeardown = (motelTreeTeardown *) pTeardown;
+
+    lNode = lTeardown->root;
+
+    while (NULL != lNode)
     {
-        if (NULL != pRoot->lesser)
+        if (NULL != NodeLesser(pTree, lNode))
         {
-            if (!PruneSubtree(pTree, pRoot->lesser))
-            {
-                return (FALSE); // pass through result code
-            }
+            lNode = NodeLesser(pTree, lNode);
+
+            continue;
+        }
+
+        if (NULL != NodeGreater(pTree, lNode))
+        {
+            lNode = NodeGreater(pTree, lNode);
+
+            continue;
         }
 
-        if (NULL != pRoot->greater)
+        lParent = NodeParent(pTree, lNode);
+
+        if (NULL != lParent)
         {
-            if (!PruneSubtree(pTree, pRoot->greater))
+            if (lNode == NodeLesser(pTree, lParent))
             {
-                return (FALSE); // pass through result code
+                SetNodeLesser(pTree, lParent, (motelTreeNodeHandle) NULL);
+            }
+            else
+            {
+                SetNodeGreater(pTree, lParent, (motelTreeNodeHandle) NULL);
             }
         }
 
-        pTree->cursor = pRoot;
-
-        if (!DestructNode(pTree))
+        if (!ManagedFreeBlock((void **) &lNode, lTeardown->nodeSize, &lTeardown->size))
         {
-            return (FALSE); // pass through result code
+            return ((motelThreadResult) 0);
         }
+
+        lNode = lParent;
     }
 
-    return (TRUE);
+    lTeardown->success = TRUE;
+
+    return ((motelThreadResult) 0);
 }
+
+#endif
@@ -38,13 +38,37 @@
 #define MUTABILITY
 
 #include <memory.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "../Motel/motel.compilation.t.h"
 #include "../Motel/motel.types.t.h"
 #include "../Motel/motel.results.t.h"
+#include "../Motel/motel.thread.t.h"
 
 #include "../Motel.Memory/motel.memory.i.h"
 
+#include "../Motel.Pool/motel.pool.t.h"
+#include "../Motel.Pool/motel.pool.i.h"
+
+/*
+** redo log durability
+*/
+
+#if defined _WIN32 || defined _WIN64
+
+#include <io.h>
+#include <windows.h>
+
+#else
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#endif
+
 /*----------------------------------------------------------------------------
   Public macros and data types
   ----------------------------------------------------------------------------*/
@@ -57,10 +81,570 @@
 
 #define REBALANCE_THRESHOLD 3
 
+/*
+** a branch is out of balance once its weight reaches the threshold ratio
+** (numerator / denominator) of its sibling's weight; the products are taken
+** in 64 bits so that they cannot overflow a 32 bit unsigned long, and the
+** limits keep the ratio between 2 and 16 so that a pivot always moves a
+** subtree toward balance and the depth stays within the path stacks
+*/
+
+#define MINIMUM_BALANCE_THRESHOLD 2
+#define MAXIMUM_BALANCE_THRESHOLD 16
+#define MAXIMUM_BALANCE_DENOMINATOR 256
+
+#define ReachesThreshold(pHeavy, pLight, pNumerator, pDenominator) ((bits64) (pHeavy) * (pDenominator) >= (bits64) (pLight) * (pNumerator))
+
+#define OutOfBalance(pTree, pHeavy, pLight) ReachesThreshold(pHeavy, pLight, (pTree)->balance.numerator, (pTree)->balance.denominator)
+
+/*
+** a node's key and data objects are stored in the same memory block as the
+** node, immediately following the node structure
+*/
+
+#define NODE_ALIGNMENT sizeof(double)
+
+#define AlignedNodeSize(pSize) ((((pSize) + NODE_ALIGNMENT - 1) / NODE_ALIGNMENT) * NODE_ALIGNMENT)
+
+#define TreeNodeSize AlignedNodeSize(sizeof(motelTreeNode))
+
+/*
+** lock-free readers confirm that no writer has intervened after this many
+** steps so that a traversal caught mid-pivot cannot circle indefinitely
+*/
+
+#define READ_CHECK_INTERVAL 32
+
+/*
+** a heap allocated tree is released by several threads only when each thread
+** has enough nodes to outweigh the cost of starting it
+*/
+
+#define MAXIMUM_TEARDOWN_THREADS 64
+#define PARALLEL_TEARDOWN_NODES 65536
+
+/*
+** the number of lookups whose descents SelectTreeNodes() interleaves so that
+** the cache misses of one are overlapped with the comparisons of the others
+*/
+
+#define SELECT_LANES 16
+
+/*
+** the set operations hand the greater half of a division to another thread
+** only when it holds enough nodes to outweigh the cost of starting it
+*/
+
+#define MAXIMUM_COMBINE_THREADS 64
+#define PARALLEL_COMBINE_NODES 65536
+
+/*
+** ValidateTree() hands subtrees to other threads only when the tree holds
+** enough nodes to outweigh the cost of starting them; each walk's path of
+** lesser ancestors begins with room for this many nodes and doubles as needed
+*/
+
+#define MAXIMUM_VALIDATE_THREADS 64
+#define PARALLEL_VALIDATE_NODES 65536
+#define VALIDATE_PATH_NODES 64
+
+/*
+** a snapshot's search entries begin on a cache line; each lookup prefetches
+** the entries of the node's grandchildren, which lie side by side
+*/
+
+#define CACHE_LINE_SIZE 64
+
+#define SnapshotEntrySize(pKeySize) (AlignedNodeSize(pKeySize) + 2 * sizeof(unsigned long))
+#define SnapshotRecordSize(pKeySize, pDataSize) (AlignedNodeSize(AlignedNodeSize(pKeySize) + sizeof(unsigned long) + (pDataSize)))
+
+#define EntryKey(pSnapshot, pIndex) ((void *) ((pSnapshot)->entries + (pIndex) * (pSnapshot)->entrySize))
+#define EntryInstance(pSnapshot, pIndex) (* (unsigned long *) ((pSnapshot)->entries + (pIndex) * (pSnapshot)->entrySize + AlignedNodeSize((pSnapshot)->keySize)))
+#define EntryRank(pSnapshot, pIndex) (* (unsigned long *) ((pSnapshot)->entries + (pIndex) * (pSnapshot)->entrySize + AlignedNodeSize((pSnapshot)->keySize) + sizeof(unsigned long)))
+
+#define RecordKey(pSnapshot, pRank) ((void *) ((pSnapshot)->records + ((pRank) - 1) * (pSnapshot)->recordSize))
+#define RecordInstance(pSnapshot, pRank) (* (unsigned long *) ((pSnapshot)->records + ((pRank) - 1) * (pSnapshot)->recordSize + AlignedNodeSize((pSnapshot)->keySize)))
+#define RecordData(pSnapshot, pRank) ((void *) ((pSnapshot)->records + ((pRank) - 1) * (pSnapshot)->recordSize + AlignedNodeSize((pSnapshot)->keySize) + sizeof(unsigned long)))
+
+/*
+** a saved tree file begins with its header, followed on the next cache line
+** by the search entries and then by the records of a snapshot; the
+** signature reads differently on a machine of the other byte order
+*/
+
+#define TREE_FILE_SIGNATURE 0x4D544C54
+#define TREE_FILE_VERSION 1
+
+#define TREE_FILE_ENTRIES ((sizeof(motelTreeFile) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE)
+
+/*
+** a saved tree is written through buffers of this many bytes in all rather
+** than copied whole
+*/
+
+#define TREE_FILE_BUFFER_SIZE 1048576
+
+/*
+** a redo log begins with its header, followed by a record of each change
+** made to the tree since its last checkpoint; a record holds the key object
+** and instance of the node changed, followed by the node's new data object
+** unless the node was deleted
+*/
+
+#define TREE_LOG_SIGNATURE 0x4D544C47
+#define TREE_LOG_VERSION 1
+
+/*
+** a change waits at most about a tenth of a second to be committed, so a busy
+** tree syncs its log a few times a second whatever its rate of change; the
+** group size bounds the changes a crash may lose should the changes come
+** faster than they can be synced
+*/
+
+#define DEFAULT_LOG_COMMIT_RECORDS 65536
+#define DEFAULT_LOG_COMMIT_MILLISECONDS 100
+#define DEFAULT_LOG_CHECKPOINT_RECORDS 1048576
+
+/* records are written to the log a buffer at a time */
+
+#define LOG_BUFFER_SIZE 65536
+
+#define LogRecordKey(pRecord) ((void *) ((byte *) (pRecord) + sizeof(motelTreeLogRecord)))
+#define LogRecordData(pTree, pRecord) ((void *) ((byte *) (pRecord) + sizeof(motelTreeLogRecord) + (pTree)->keySize))
+
+#define LogRecordSize(pTree, pOperation) (sizeof(motelTreeLogRecord) + (pTree)->keySize + (motelTreeLogOperation_Delete == (pOperation) ? 0 : (pTree)->dataSize))
+
+/*
+** the work counted for motelTreeMember_Statistics, which costs nothing unless
+** the tree is built with TREE_STATISTICS defined; only the thread changing the
+** tree counts into it, so lock-free reads go uncounted and the threads of a
+** set operation count their comparisons apart, adding them up once joined
+*/
+
+#if defined TREE_STATISTICS
+
+#define CountTreeStatistic(pTree, pCounter, pCount) ((pTree)->statistics.pCounter += (pCount))
+#define CountTreeDescent(pTree, pDepth) ((pTree)->statistics.descents[(TREE_STATISTICS_DEPTHS <= (pDepth)) ? TREE_STATISTICS_DEPTHS - 1 : (pDepth)] += 1)
+
+#else
+
+#define CountTreeStatistic(pTree, pCounter, pCount) ((void) (pCount))
+#define CountTreeDescent(pTree, pDepth)
+
+#endif
+
+/*
+** the in-order scans of a parentless tree hold the nodes still to be visited
+** on a path stack; weight balance keeps any tree that fits in memory well
+** below this height, and a deeper path falls back to descents from the root
+*/
+
+#define MAXIMUM_TREE_PATH 256
+
+/*
+** a pivot that lowers a branch of no more than this many nodes toward the
+** deepest level counts the branch's levels to keep the tree's level bound;
+** a larger branch is bounded by its weight instead
+*/
+
+#define TRACKED_BRANCH_NODES 64
+
+/*
+** a branch whose heavier to lighter weights stay below r holds no more than
+** log2(w) / log2(1 + 1/r) levels for a weight of w, which is less than
+** 0.7 * (r + 1/2) levels for each bit of w; the scale is that many
+** twentieths of a level for a ratio a whole step above the balance ratio,
+** allowing for the weight a descent adds below a node it has checked
+*/
+
+#define LevelScale(pNumerator, pDenominator) ((7 * (2 * (pNumerator) + 3 * (pDenominator)) + (pDenominator) - 1) / (pDenominator))
+
+/*
+** a tree built with COMPACT_TREE_NODES defined reserves this much address
+** space for its node arena, the most that 32-bit links can reach, and
+** commits it a step at a time; a compact node's instance is no greater than
+** the largest 32-bit count
+*/
+
+#if defined COMPACT_TREE_NODES
+
+#if SIZE_MAX > 0xFFFFFFFF
+
+#define TREE_ARENA_SIZE (((size_t) 1 << 32) * NODE_ALIGNMENT)
+
+#else
+
+#define TREE_ARENA_SIZE ((size_t) 1 << 28)
+
+#endif
+
+#define TREE_ARENA_COMMIT_SIZE ((size_t) 1 << 20)
+
+#define MAXIMUM_COMPACT_INSTANCE 0xFFFFFFFFul
+
+#endif
+
+/*
+** the links of a node and of the tree's root are read and written through
+** these; a compact tree's links are turned into node handles and back by
+** ArenaNode() and ArenaLink(), and the links of any other tree are the node
+** handles themselves
+*/
+
+#if !defined COMPACT_TREE_NODES
+
+#define ArenaNode(pTree, pLink) (pLink)
+#define ArenaLink(pTree, pNode) (pNode)
+
+#endif
+
+#define NodeLesser(pTree, pNode) ArenaNode(pTree, (pNode)->lesser)
+#define NodeGreater(pTree, pNode) ArenaNode(pTree, (pNode)->greater)
+
+#define SetNodeLesser(pTree, pNode, pLesser) ((pNode)->lesser = ArenaLink(pTree, pLesser))
+#define SetNodeGreater(pTree, pNode, pGreater) ((pNode)->greater = ArenaLink(pTree, pGreater))
+
+#define TreeRoot(pTree) ArenaNode(pTree, (pTree)->root)
+#define SetTreeRoot(pTree, pRoot) ((pTree)->root = ArenaLink(pTree, pRoot))
+
+#define LinkedNode(pTree, pLink) ArenaNode(pTree, * (pLink))
+#define SetLinkedNode(pTree, pLink, pNode) (* (pLink) = ArenaLink(pTree, pNode))
+
+/*
+** a node built with PARENTLESS_TREE_NODES defined has no parent link, its
+** parent reading as none and the link left unset; every such tree is
+** parentless, so that the operations needing the links take another way
+*/
+
+#if defined PARENTLESS_TREE_NODES
+
+#define NodeParent(pTree, pNode) ((motelTreeNodeHandle) NULL)
+#define SetNodeParent(pTree, pNode, pParent) ((void) (pParent))
+
+#else
+
+#define NodeParent(pTree, pNode) ArenaNode(pTree, (pNode)->parent)
+#define SetNodeParent(pTree, pNode, pParent) ((pNode)->parent = ArenaLink(pTree, pParent))
+
+#endif
+
+#define NodeKey(pNode) ((void *) ((byte *) (pNode) + TreeNodeSize))
+#define NodeData(pTree, pNode) ((void *) ((byte *) (pNode) + TreeNodeSize + AlignedNodeSize((pTree)->keySize)))
+
+/*
+** a tree that groups duplicates keeps, in place of each node's data, the
+** node's list of occurrences; an occurrence is an instance followed by its
+** data, and a list holds its occurrences in ascending instance order
+*/
+
+#define NodeOccurrences(pTree, pNode) (* (motelTreeOccurrences **) NodeData(pTree, pNode))
+
+#define OccurrenceSize(pTree) (AlignedNodeSize(sizeof(unsigned long) + (pTree)->dataSize))
+#define OccurrenceListSize(pTree, pCapacity) (sizeof(motelTreeOccurrences) + (pCapacity) * OccurrenceSize(pTree))
+
+#define Occurrence(pTree, pList, pIndex) ((byte *) (pList) + sizeof(motelTreeOccurrences) + (pIndex) * OccurrenceSize(pTree))
+
+#define OccurrenceInstance(pTree, pList, pIndex) (* (unsigned long *) Occurrence(pTree, pList, pIndex))
+#define OccurrenceData(pTree, pList, pIndex) ((void *) (Occurrence(pTree, pList, pIndex) + sizeof(unsigned long)))
+
+/*
+** a persistent tree's nodes may be shared among its versions; a count of the
+** links and versions holding each node follows the node's data, and then the
+** identity of the version whose size the node is charged to (0 for none)
+*/
+
+#define NodeReferences(pTree, pNode) ((motelAtomic *) ((byte *) (pNode) + TreeNodeSize + AlignedNodeSize((pTree)->keySize) + AlignedNodeSize((pTree)->dataSize)))
+#define NodeOwner(pTree, pNode) ((motelAtomic *) ((byte *) NodeReferences(pTree, pNode) + AlignedNodeSize(sizeof(motelAtomic))))
+
+#define SubtreeNullNodes(pNode) (NULL == (pNode) ? 1 : (pNode)->lesserNullNodes + (pNode)->greaterNullNodes)
+
 /*----------------------------------------------------------------------------
   Private data types
   ----------------------------------------------------------------------------*/
 
+/*
+** the progress of a BulkLoadTree() through its key and data arrays
+*/
+
+typedef struct motelTreeLoad motelTreeLoad;
+
+struct motelTreeLoad
+{
+    byte * data;
+    byte * keys;
+
+    size_t dataStride;
+    size_t keyStride;
+
+    /* the instances loaded from a checkpoint, which are otherwise numbered afresh */
+
+    byte * instances;
+    size_t instanceStride;
+
+    motelTreeNodeHandle previous;
+};
+
+/*
+** the progress of an InsertTreeNodes() rebuild through a subtree's existing
+** nodes (linked in key order through their greater branches) and the new ones
+*/
+
+typedef struct motelTreeMerge motelTreeMerge;
+
+struct motelTreeMerge
+{
+    motelTreeNodeHandle vine;
+
+    motelTreeNodeHandle * nodes;
+    unsigned long count;
+
+    motelTreeNodeHandle previous;
+};
+
+/*
+** a subtree released by one of the threads of a parallel DestructTree()
+*/
+
+typedef struct motelTreeTeardown motelTreeTeardown;
+
+struct motelTreeTeardown
+{
+    motelTreeNodeHandle root;
+
+    size_t nodeSize;
+    size_t size;
+
+    boolean started;
+    boolean success;
+
+    motelThread thread;
+};
+
+/*
+** a subtree, or a lone node, checked by ValidateTree(); a subtree reports the
+** least and greatest nodes it walked so that its neighbours can be compared
+*/
+
+typedef struct motelTreeValidation motelTreeValidation;
+
+struct motelTreeValidation
+{
+    motelTreeHandle tree;
+
+    motelTreeNodeHandle root;
+
+    boolean subtree;
+
+    motelTreeNodeHandle least;
+    motelTreeNodeHandle greatest;
+
+    motelTreeNodeHandle failure;
+    motelResult result;
+
+    boolean started;
+
+    motelThread thread;
+};
+
+/*
+** the nodes an in-order scan of a parentless tree has passed on its way
+** lesser, and so has still to visit
+*/
+
+typedef struct motelTreePath motelTreePath;
+
+struct motelTreePath
+{
+    unsigned long depth;
+
+    motelTreeNodeHandle nodes[MAXIMUM_TREE_PATH];
+};
+
+/*
+** the occurrences of a key within a tree that groups duplicates, which follow
+** the list within the same memory block
+*/
+
+typedef struct motelTreeOccurrences motelTreeOccurrences;
+
+struct motelTreeOccurrences
+{
+    unsigned long count;
+    unsigned long capacity;
+};
+
+/*
+** the header of a saved tree file; offsets are from the start of the file
+*/
+
+typedef struct motelTreeFile motelTreeFile;
+
+struct motelTreeFile
+{
+    bits32 signature;
+    bits32 version;
+
+    bits32 keyType;
+    bits32 instanceSize;
+
+    bits64 keySize;
+    bits64 dataSize;
+
+    bits64 entrySize;
+    bits64 recordSize;
+
+    bits64 nodes;
+
+    bits64 entries;
+    bits64 records;
+
+    /* the sequence number of the last logged change a checkpoint holds */
+
+    bits64 sequence;
+};
+
+/*
+** a buffer through which WriteTreeFile() writes a region of a saved tree,
+** and the offset within the file at which its bytes are next written
+*/
+
+typedef struct motelTreeFileBuffer motelTreeFileBuffer;
+
+struct motelTreeFileBuffer
+{
+    FILE * stream;
+
+    byte * bytes;
+
+    size_t capacity;
+    size_t used;
+
+    bits64 offset;
+
+    boolean * written;
+};
+
+/*
+** the header of a redo log
+*/
+
+typedef struct motelTreeLogFile motelTreeLogFile;
+
+struct motelTreeLogFile
+{
+    bits32 signature;
+    bits32 version;
+
+    bits32 keyType;
+    bits32 reserved;
+
+    bits64 keySize;
+    bits64 dataSize;
+};
+
+/*
+** the changes held by a redo log; they are numbered from 1 so that a record
+** of zeros is not taken for a change
+*/
+
+typedef enum motelTreeLogOperation motelTreeLogOperation;
+
+enum motelTreeLogOperation
+{
+    motelTreeLogOperation_Insert = 1,
+    motelTreeLogOperation_Update,
+    motelTreeLogOperation_Delete,
+
+    motelTreeLogOperation_
+};
+
+/*
+** the fixed part of a redo log record; the checksum is taken over the whole
+** record with the checksum itself taken as 0, so that a record torn by a
+** crash ends the replay
+*/
+
+typedef struct motelTreeLogRecord motelTreeLogRecord;
+
+struct motelTreeLogRecord
+{
+    bits64 sequence;
+    bits64 instance;
+
+    bits32 operation;
+    bits32 checksum;
+};
+
+/*
+** a tree's redo log: the records gathered to be written together (the last
+** of them being the record under composition), the changes written but not
+** yet committed, those written since the last checkpoint, and when the log
+** was last committed
+*/
+
+struct motelTreeLog
+{
+    FILE * stream;
+
+    char * path;
+    char * checkpointPath;
+    char * temporaryPath;
+
+    byte * buffer;
+    size_t capacity;
+    size_t used;
+
+    size_t length;
+
+    unsigned long pending;
+    unsigned long records;
+
+    bits64 committed;
+
+    boolean failed;
+};
+
+/*
+** the set operation carried out by CombineTrees()
+*/
+
+typedef enum motelTreeCombination motelTreeCombination;
+
+enum motelTreeCombination
+{
+    motelTreeCombination_Union,
+    motelTreeCombination_Intersection,
+    motelTreeCombination_Difference
+};
+
+/*
+** a pair of detached subtrees being combined and the subtrees discarded
+** along the way (chained through their roots' parent links)
+*/
+
+typedef struct motelTreeCombine motelTreeCombine;
+
+struct motelTreeCombine
+{
+    motelTreeHandle tree;
+
+    motelTreeCombination combination;
+
+    motelTreeNodeHandle root;
+    motelTreeNodeHandle other;
+
+    motelTreeNodeHandle discards;
+    motelTreeNodeHandle lastDiscard; /* the least node of the last discarded subtree, whose lesser link continues the chain */
+
+    unsigned long threads;
+
+    unsigned long comparisons; /* the key comparisons made, added up from the branches once joined */
+
+    boolean success;
+
+    motelThread thread;
+};
+
 /*----------------------------------------------------------------------------
   Public function prototypes
   ----------------------------------------------------------------------------*/
@@ -71,10 +655,114 @@
   Private function prototypes
   ----------------------------------------------------------------------------*/
 
+#if defined COMPACT_TREE_NODES
+
+/*----------------------------------------------------------------------------
+  ArenaNode()
+  ----------------------------------------------------------------------------
+  Find the node that a compact tree's link reaches.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pLink - (I) The link, read once
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - The link reaches no node
+
+  motelTreeNodeHandle - The node within the tree's arena
+  ----------------------------------------------------------------------------*/
+
+static FORCE_INLINE motelTreeNodeHandle ArenaNode
+(
+    motelTreeHandle pTree,
+    motelTreeLink pLink
+);
+
+/*----------------------------------------------------------------------------
+  ArenaLink()
+  ----------------------------------------------------------------------------
+  Find the link by which a compact tree reaches a node.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pNode - (I) A node within the tree's arena, or NULL
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The node's offset from the arena in units of the node alignment, 0 for none
+  ----------------------------------------------------------------------------*/
+
+static FORCE_INLINE motelTreeLink ArenaLink
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+);
+
+/*----------------------------------------------------------------------------
+  AllocateArenaNode()
+  ----------------------------------------------------------------------------
+  Take the memory for a node from a compact tree's arena, reusing a released
+  node before extending the arena.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pNode - (O) The node's memory
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node memory was taken from the arena
+
+  False - Node memory was not taken from the arena due to:
+
+          1. The arena's address space could not be reserved or committed
+             (motelResult_MemoryAllocation)
+          2. The arena is full (motelResult_MaximumSize)
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The arena is reserved when the tree's first node is constructed, so an
+  empty tree holds no address space. Every node of the tree is the same size
+  until the tree is empty again.
+  ----------------------------------------------------------------------------*/
+
+static boolean AllocateArenaNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pNode
+);
+
+/*----------------------------------------------------------------------------
+  ReleaseArenaNode()
+  ----------------------------------------------------------------------------
+  Return a node's memory to a compact tree's arena.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pNode - (I) The node to release
+  ----------------------------------------------------------------------------*/
+
+static void ReleaseArenaNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+);
+
+#endif
+
 /*----------------------------------------------------------------------------
   ConstructNode()
   ----------------------------------------------------------------------------
   Construct a tree node.
+
+  The node, a copy of its key object and a copy of its data object occupy a
+  single memory block so that a key comparison touches the same block as the
+  node's branch pointers. The block is taken from the tree's memory pool when
+  the tree has one.
   ----------------------------------------------------------------------------
   Parameters:
 
@@ -91,7 +779,7 @@
           1. The tree handle was invalid
           2. The pointer to the key object handle was invalid
           3. The pointer to the data object handle was invalid
-          4. ManagedMallocBlock() failed
+          4. ManagedMallocBlock() or AllocatePoolMemory() failed
           5. Would make the tree exceed its maximum number of bytes
   ----------------------------------------------------------------------------*/
 
@@ -104,462 +792,2806 @@ static boolean ConstructNode
 );
 
 /*----------------------------------------------------------------------------
-  DestructNode()
+  DestructNode()
+  ----------------------------------------------------------------------------
+  Destruct a node that has been disconnected from the tree.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of the tree in which the node exists
+  pNode - (I) The node to destruct
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully destructed
+
+  False - Node was not successfully destructed due to:
+
+          1. The pTree handle was NULL
+          2. The pNode handle was NULL
+          3. The node destruction failed
+  ----------------------------------------------------------------------------*/
+
+static boolean DestructNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+);
+
+/*----------------------------------------------------------------------------
+  DeleteNode()
+  ----------------------------------------------------------------------------
+  Disconnect a node from the tree, rebalancing along the way, and destruct it.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree       - (I) Handle of the tree in which the node exists
+  pDeleteNode - (I) The node to delete
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully deleted
+
+  False - Node was not successfully deleted due to:
+
+          1. The node was not encountered in the tree
+          2. The node destruction failed
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The tree cursor and any registered cursors that reference the node are
+  cleared.
+  ----------------------------------------------------------------------------*/
+
+static boolean DeleteNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pDeleteNode
+);
+
+/*----------------------------------------------------------------------------
+  AddOccurrence()
+  ----------------------------------------------------------------------------
+  Append an occurrence of a node's key, numbered one past the key's greatest
+  instance, to the node's occurrence list, constructing or growing the list
+  as needed.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of a tree that groups duplicates
+  pNode - (I) The node of the key
+  pData - (I) The data object of the occurrence
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Occurrence was succesfully added
+
+  False - Occurrence was not successfully added due to:
+
+          1. SafeReallocBlock() failed
+          2. Would make the tree exceed its maximum number of bytes
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A full list doubles its capacity, so appends take amortized constant time.
+  ----------------------------------------------------------------------------*/
+
+static boolean AddOccurrence
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    void * pData
+);
+
+/*----------------------------------------------------------------------------
+  RemoveOccurrence()
+  ----------------------------------------------------------------------------
+  Remove an occurrence from a node's occurrence list, deleting the node along
+  with the key's last occurrence.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree       - (I) Handle of a tree that groups duplicates
+  pNode       - (I) The node of the key
+  pOccurrence - (I) The position of the occurrence within the list
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Occurrence was succesfully removed
+
+  False - Occurrence was not successfully removed due to:
+
+          1. The node deletion failed
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The tree cursor is cleared when it references the node. A list that falls
+  to a quarter of its capacity gives back half of it.
+  ----------------------------------------------------------------------------*/
+
+static boolean RemoveOccurrence
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    unsigned long pOccurrence
+);
+
+/*----------------------------------------------------------------------------
+  FindOccurrence()
+  ----------------------------------------------------------------------------
+  Find the position of an instance within a node's occurrence list.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I) Handle of a tree that groups duplicates
+  pNode     - (I) The node of the key
+  pInstance - (I) The instance to find (0 finds the least instance)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The position of the occurrence, or the number of occurrences in the list
+  when the instance is not among them
+  ----------------------------------------------------------------------------*/
+
+static unsigned long FindOccurrence
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    unsigned long pInstance
+);
+
+/*----------------------------------------------------------------------------
+  ScanOccurrences()
+  ----------------------------------------------------------------------------
+  Pass each occurrence of a node's key, in instance order, to a scan function.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree         - (I) Handle of a tree that groups duplicates
+  pNode         - (I) The node of the key
+  pScanFunction - (I) The function to which each occurrence is passed
+  pContext      - (I) The caller's context passed through to pScanFunction
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Every occurrence was passed to the scan function
+
+  False - The scan function declined to continue
+  ----------------------------------------------------------------------------*/
+
+static boolean ScanOccurrences
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    boolean (* pScanFunction)(void * pContext, const void * pKey, const void * pData, unsigned long pInstance),
+    void * pContext
+);
+
+/*----------------------------------------------------------------------------
+  SetCursorOccurrence()
+  ----------------------------------------------------------------------------
+  Place the tree cursor on the least or greatest occurrence of its node's key
+  after the cursor has moved to another node.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I) Tree handle
+  pGreatest - (I) Whether to place the cursor on the greatest occurrence
+  ----------------------------------------------------------------------------*/
+
+static void SetCursorOccurrence
+(
+    motelTreeHandle pTree,
+    boolean pGreatest
+);
+
+/*----------------------------------------------------------------------------
+  GetCursorData()
+  ----------------------------------------------------------------------------
+  Get the data object of the node, or of the occurrence, under the tree
+  cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of a tree with its cursor set
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The address of the data object
+  ----------------------------------------------------------------------------*/
+
+static void * GetCursorData
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetCursorInstance()
+  ----------------------------------------------------------------------------
+  Get the instance of the node, or of the occurrence, under the tree cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of a tree with its cursor set
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The instance
+  ----------------------------------------------------------------------------*/
+
+static unsigned long GetCursorInstance
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  OwnNode()
+  ----------------------------------------------------------------------------
+  Make the node held by a link private to the tree, copying it when other
+  versions share it.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I)   Handle of a persistent tree
+  pLink - (I/O) The link, within the tree's own nodes, holding the node
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The node now held by the link (NULL if the copy could not be allocated)
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The copy holds its own reference to each of the node's children, and the
+  link's reference to the original is released. The tree cursor and any
+  registered cursors on the original are moved to the copy.
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle OwnNode
+(
+    motelTreeHandle pTree,
+    motelTreeLink * pLink
+);
+
+/*----------------------------------------------------------------------------
+  OwnKeyPath()
+  ----------------------------------------------------------------------------
+  Make private to a persistent tree every node on the path that an insertion
+  of a key object would descend.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of a persistent tree
+  pKey  - (I) The key object
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The path was succesfully made private
+
+  False - The path was not made private due to:
+
+          1. A copy could not be allocated
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A pivot keeps the descent within the path and the nodes it pivots, so an
+  update that has made its path private and then owns the nodes it pivots
+  never changes a node that another version shares. A path left partly
+  private holds the same nodes in the same order as before.
+  ----------------------------------------------------------------------------*/
+
+static boolean OwnKeyPath
+(
+    motelTreeHandle pTree,
+    const void * pKey
+);
+
+/*----------------------------------------------------------------------------
+  OwnNodePath()
+  ----------------------------------------------------------------------------
+  Make private to a persistent tree every node on the path to a node and,
+  for a deletion, on onward to the node that DeleteNode() would promote.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree      - (I)   Handle of a persistent tree
+  pNode      - (I/O) The node, replaced by its private copy
+  pPromotion - (I)   Whether to continue on to the promoted node
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The path was succesfully made private
+
+  False - The path was not made private due to:
+
+          1. A copy could not be allocated
+  ----------------------------------------------------------------------------
+  Notes:
+
+  See OwnKeyPath().
+  ----------------------------------------------------------------------------*/
+
+static boolean OwnNodePath
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pNode,
+    boolean pPromotion
+);
+
+/*----------------------------------------------------------------------------
+  ReleaseNode()
+  ----------------------------------------------------------------------------
+  Release a reference to a persistent tree's node, destructing the node and
+  releasing its children once no link or version holds it.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of the persistent tree releasing the node
+  pNode - (I) The node (may be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The reference was succesfully released
+
+  False - A node could not be destructed
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The counts are changed atomically, so versions sharing nodes may be
+  updated and destructed by different threads.
+  ----------------------------------------------------------------------------*/
+
+static boolean ReleaseNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+);
+
+/*----------------------------------------------------------------------------
+  GetEqualNode()
+  ----------------------------------------------------------------------------
+  Get a node that matches the provided key object from the tree.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I) Tree handle
+  pKey      - (I) The key object to use to find a node in the tree
+  pInstance - (I) The instance of the key object in the tree
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - No node was found that matched the value of the key object
+
+  motelTreeNodeHandle - A node from the tree that matched the value of the
+                        provided key object
+  ----------------------------------------------------------------------------
+  Note:
+
+  For nodes with duplicated key values the eariliest entered instance of the
+  node will be returned from the tree.
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetEqualNode
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    unsigned long pInstance
+);
+
+/*----------------------------------------------------------------------------
+  FindEqualNode()
+  ----------------------------------------------------------------------------
+  Find a node that matches the provided key object without altering the tree
+  result code.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I) Tree handle
+  pKey      - (I) The key object to use to find a node in the tree
+  pInstance - (I) The instance of the key object in the tree
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - No node was found that matched the value of the key object
+
+  motelTreeNodeHandle - A node from the tree that matched the value of the
+                        provided key object
+  ----------------------------------------------------------------------------
+  Note:
+
+  The tree is only read, allowing cursors to search it side by side.
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle FindEqualNode
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    unsigned long pInstance
+);
+
+/*----------------------------------------------------------------------------
+  DescendEqualNode()
+  ----------------------------------------------------------------------------
+  Descend the tree to a node that matches the provided key object, comparing
+  the keys as the provided key type.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I) Tree handle
+  pKey      - (I) The key object to use to find a node in the tree
+  pInstance - (I) The instance of the key object in the tree
+  pKeyType  - (I) The tree's key type
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - No node was found that matched the value of the key object
+
+  motelTreeNodeHandle - A node from the tree that matched the value of the
+                        provided key object
+  ----------------------------------------------------------------------------
+  Notes:
+
+  FindEqualNode() passes the key type as a constant so that each key type
+  gets its own loop with the comparison expanded in place.
+  ----------------------------------------------------------------------------*/
+
+static FORCE_INLINE motelTreeNodeHandle DescendEqualNode
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    unsigned long pInstance,
+    motelTreeKeyType pKeyType
+);
+
+/*----------------------------------------------------------------------------
+  DescendInsertNode()
+  ----------------------------------------------------------------------------
+  Descend a non-empty tree to the insertion point of a new node, counting it
+  in the null node counts of the nodes passed and pivoting the nodes that
+  reach the balance threshold, then link it below the last node passed.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree        - (I) Tree handle
+  pInsertNode  - (I) The node to insert
+  pRebuildLink - (O) The link to the highest subtree to rebuild, or left
+                     unchanged when no subtree is to be rebuilt
+  pKeyType     - (I) The tree's key type
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The depth of the new node's parent
+  ----------------------------------------------------------------------------
+  Notes:
+
+  InsertTreeNode() passes the key type as a constant so that each key type
+  gets its own loop with the comparison expanded in place.
+  ----------------------------------------------------------------------------*/
+
+static FORCE_INLINE unsigned long DescendInsertNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pInsertNode,
+    motelTreeLink ** pRebuildLink,
+    motelTreeKeyType pKeyType
+);
+
+/*----------------------------------------------------------------------------
+  CompareKeyObjects()
+  ----------------------------------------------------------------------------
+  Compare two key objects according to a key type.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pKeyType            - (I) How the key objects are compared
+  pKeySize            - (I) The size of the key objects
+  pCompareKeyFunction - (I) The key comparison function for custom keys
+  pKey1               - (I) The first key object
+  pKey2               - (I) The second key object
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  <  0 - pKey1 is less than pKey2
+  == 0 - pKey1 is equal to pKey2
+  >  0 - pKey1 is greater than pKey2
+  ----------------------------------------------------------------------------*/
+
+static FORCE_INLINE long CompareKeyObjects
+(
+    motelTreeKeyType pKeyType,
+    size_t pKeySize,
+    long (* pCompareKeyFunction)(const void * pKey1, const void * pKey2),
+    const void * pKey1,
+    const void * pKey2
+);
+
+/*----------------------------------------------------------------------------
+  CompareKeys()
+  ----------------------------------------------------------------------------
+  Compare two key objects according to the tree's key type.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pKey1 - (I) The first key object
+  pKey2 - (I) The second key object
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  <  0 - pKey1 is less than pKey2
+  == 0 - pKey1 is equal to pKey2
+  >  0 - pKey1 is greater than pKey2
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The built-in key types are compared in place so that the descent loops
+  calling this function make no indirect call. Only motelTreeKeyType_Custom
+  calls through the tree's key comparison function.
+  ----------------------------------------------------------------------------*/
+
+static INLINE long CompareKeys
+(
+    motelTreeHandle pTree,
+    const void * pKey1,
+    const void * pKey2
+);
+
+/*----------------------------------------------------------------------------
+  CompareTypedKeys()
+  ----------------------------------------------------------------------------
+  Compare two key objects according to the provided key type.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree    - (I) Tree handle
+  pKeyType - (I) The tree's key type
+  pKey1    - (I) The first key object
+  pKey2    - (I) The second key object
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  <  0 - pKey1 is less than pKey2
+  == 0 - pKey1 is equal to pKey2
+  >  0 - pKey1 is greater than pKey2
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A constant key type folds the key type switch away, leaving only the
+  comparison of that type.
+  ----------------------------------------------------------------------------*/
+
+static FORCE_INLINE long CompareTypedKeys
+(
+    motelTreeHandle pTree,
+    motelTreeKeyType pKeyType,
+    const void * pKey1,
+    const void * pKey2
+);
+
+/*----------------------------------------------------------------------------
+  CompareReadKeys()
+  ----------------------------------------------------------------------------
+  Compare two key objects according to the tree's key type without counting
+  the comparison.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pKey1 - (I) The first key object
+  pKey2 - (I) The second key object
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  <  0 - pKey1 is less than pKey2
+  == 0 - pKey1 is equal to pKey2
+  >  0 - pKey1 is greater than pKey2
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Used by lock-free readers and by the threads of a set operation, which
+  must not write to the tree's statistics.
+  ----------------------------------------------------------------------------*/
+
+static INLINE long CompareReadKeys
+(
+    motelTreeHandle pTree,
+    const void * pKey1,
+    const void * pKey2
+);
+
+/*----------------------------------------------------------------------------
+  NodeCompare()
+  ----------------------------------------------------------------------------
+  Compare the key values of a pair of nodes
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I) The tree handle
+  pNode1 - (I) The first node to compare
+  pNode2 - (I) The second node to compare
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  < 0   means pNode1->key is less than pNode2->key
+  > 0   means pNode1->key is greater than pNode2->key
+  
+  ----------------------------------------------------------------------------
+  Notes:
+
+  This function uses the key comparison function established by the calling
+  system when the tree that the node resides in was constructed. By definition
+  this function must adhere to the behavior of the standard C function
+  strcmp(), mathematically returning (pNode1->key - pNode2->key).
+
+  In the case where node keys are duplicated within the tree (e.g. logically 
+  pNode1->key == pNode2->key) the node instance values are compared to
+  distinguish the relative value of the nodes.
+  ----------------------------------------------------------------------------*/
+
+static long NodeCompare
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode1,
+    motelTreeNodeHandle pNode2
+);
+
+/*----------------------------------------------------------------------------
+  GetLeastNode()
+  ----------------------------------------------------------------------------
+  Get the node with the lowest key value from the tree without altering
+  the node cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - There is no tree or there are no nodes are in the tree
+
+  motelTreeNodeHandle - The lowest key valued node in the tree
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetLeastNode
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetGreatestNode()
+  ----------------------------------------------------------------------------
+  Get the node with the highest key value from the tree without altering
+  the node cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - There is no tree or there are no nodes are in the tree
+
+  motelTreeNodeHandle - The highest key valued node in the tree
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetGreatestNode
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetLesserNode()
+  ----------------------------------------------------------------------------
+  Get the node with the next lower key value in the tree without altering
+  the node cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - There is no tree or there is no lower node in the tree
+
+  motelTreeNodeHandle - The next lower key valued node in the tree
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetLesserNode
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetGreaterNode()
+  ----------------------------------------------------------------------------
+  Get the node with the next higher key value in the tree without altering
+  the node cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - There is no tree or there is no higher node in the tree
+
+  motelTreeNodeHandle - The next higher key valued node in the tree
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetGreaterNode
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  StepLesserNode()
+  ----------------------------------------------------------------------------
+  Get the node with the next lower key value than a given node.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pNode - (I) The node to step from
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - There is no lower node in the tree
+
+  motelTreeNodeHandle - The next lower key valued node in the tree
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle StepLesserNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+);
+
+/*----------------------------------------------------------------------------
+  StepGreaterNode()
+  ----------------------------------------------------------------------------
+  Get the node with the next higher key value than a given node.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pNode - (I) The node to step from
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - There is no higher node in the tree
+
+  motelTreeNodeHandle - The next higher key valued node in the tree
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle StepGreaterNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+);
+
+/*----------------------------------------------------------------------------
+  SeekLesserNode()
+  ----------------------------------------------------------------------------
+  Find the next lesser node in a tree
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  pNode - (I) The node from which to step
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  motelTreeNodeHandle - The next lesser node (NULL when pNode is the least)
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Steps through the parent links with StepLesserNode(), or for a parentless
+  tree descends from the root, remembering the last node passed on the way
+  greater.
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle SeekLesserNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+);
+
+/*----------------------------------------------------------------------------
+  SeekGreaterNode()
+  ----------------------------------------------------------------------------
+  Find the next greater node in a tree
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  pNode - (I) The node from which to step
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  motelTreeNodeHandle - The next greater node (NULL when pNode is the greatest)
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Steps through the parent links with StepGreaterNode(), or for a parentless
+  tree descends from the root, remembering the last node passed on the way
+  lesser.
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle SeekGreaterNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
+);
+
+/*----------------------------------------------------------------------------
+  SeekPath()
+  ----------------------------------------------------------------------------
+  Begin an in-order scan at a node
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  pPath - (O) The path of the scan
+  pNode - (I) The node at which the scan begins
+  ----------------------------------------------------------------------------
+  Notes:
+
+  For a parentless tree the path receives the nodes passed on the way
+  lesser while descending from the root to pNode.
+  ----------------------------------------------------------------------------*/
+
+static void SeekPath
+(
+    motelTreeHandle pTree,
+    motelTreePath * pPath,
+    motelTreeNodeHandle pNode
+);
+
+/*----------------------------------------------------------------------------
+  StepPathGreater()
+  ----------------------------------------------------------------------------
+  Step an in-order scan to the next greater node
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I)   The tree handle
+  pPath - (I/O) The path of the scan
+  pNode - (I)   The node most recently visited by the scan
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  motelTreeNodeHandle - The next greater node (NULL when pNode is the greatest)
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A parentless tree's scan takes the least node of pNode's greater branch,
+  or else the node at the top of the path, so each step costs constant time
+  on average just as StepGreaterNode() does.
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle StepPathGreater
+(
+    motelTreeHandle pTree,
+    motelTreePath * pPath,
+    motelTreeNodeHandle pNode
+);
+
+/*----------------------------------------------------------------------------
+  GetRootNode()
+  ----------------------------------------------------------------------------
+  Get the root node of the tree without altering the node cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - There is no tree or there is no root node in the tree
+
+  motelTreeNodeHandle - The root node of the tree
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetRootNode
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetParentNode()
+  ----------------------------------------------------------------------------
+  Get the physical parent node of the passed node without altering the node
+  cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of the tree in which the node exists
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - The current node is NULL or it is the root node of the tree
+
+  motelTreeNodeHandle - The parent node of the node passed
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetParentNode
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetLesserChildNode()
+  ----------------------------------------------------------------------------
+  Get the physical lesser child node of the passed node without altering the
+  node cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of the tree in which the node exists
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - The current node is NULL or it is a leaf node in the tree
+
+  motelTreeNodeHandle - The lesser child node of the node passed
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetLesserChildNode
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetGreaterChildNode()
+  ----------------------------------------------------------------------------
+  Get the physical greater child node of the passed node without altering the
+  node cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of the tree in which the node exists
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - The current node is NULL or it is a leaf node in the tree
+
+  motelTreeNodeHandle - The greater child node of the node passed
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetGreaterChildNode
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetTreeLevelCount()
+  ----------------------------------------------------------------------------
+  Determine the maximum level depth of a tree.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I/O) Handle of the tree
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  unsigned long - The maximum level depth within the tree
+  ----------------------------------------------------------------------------
+  Note:
+
+  This function determines the branch length of the longest route from the
+  root to a leaf node. Each node within the longest route from the root to
+  a leaf node is considered a level within the tree.
+
+  The count is tracked in the tree's levels member rather than walked, as
+  a bound that never falls below the levels held: an insertion raises it to
+  the new node's level, a pivot made while inserting or deleting raises it
+  to the level the branch it lowers may reach (see TrackPivotLevels()), and
+  a deletion otherwise leaves it be, so it may stand above the levels left.
+  The operations that rebuild the tree wholesale set the bound afresh, a
+  bulk load to the levels its even division fills (see GetLoadedLevelCount())
+  and the others to the bound of the tree's weight (see GetTreeLevelBound()).
+  Each call holds the tracked bound to the weight's bound, so that it falls
+  as deletions leave fewer nodes. Nothing here walks the tree, keeping the
+  cost O(1); the levels are counted exactly by GetSubtreeLevelCount() only
+  when motelTreeMember_ExactLevelCount is asked for.
+  ----------------------------------------------------------------------------*/
+
+static unsigned long GetTreeLevelCount
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetTreeLevelBound()
+  ----------------------------------------------------------------------------
+  Bound the levels of a tree from its weight.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Handle of the tree
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  unsigned long - The most levels the tree may hold, 0 when it is empty
+  ----------------------------------------------------------------------------
+  Note:
+
+  The tree is bounded as a branch of its weight (see GetBranchLevelBound()),
+  and never above its number of nodes, in O(1) time.
+  ----------------------------------------------------------------------------*/
+
+static unsigned long GetTreeLevelBound
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  GetLoadedLevelCount()
+  ----------------------------------------------------------------------------
+  Determine the levels of a subtree built by LoadSubtree().
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCount - (I) The number of nodes loaded
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  unsigned long - The levels of the loaded subtree
+  ----------------------------------------------------------------------------*/
+
+static unsigned long GetLoadedLevelCount
+(
+    unsigned long pCount
+);
+
+/*----------------------------------------------------------------------------
+  GetSubtreeLevelCount()
+  ----------------------------------------------------------------------------
+  Determine the maximum level depth of a subtree.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pRoot - (I) The root of the subtree to measure
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  unsigned long - The maximum level depth within the subtree
+  ----------------------------------------------------------------------------
+  Note:
+
+  This function determines the branch length of the longest route from the
+  subtree root to a leaf node. Each node within the longest route from the
+  subtree root to a leaf node is considered a level within the subtree.
+  ----------------------------------------------------------------------------*/
+
+static unsigned long GetSubtreeLevelCount
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot
+);
+
+/*----------------------------------------------------------------------------
+  GetRankNode()
+  ----------------------------------------------------------------------------
+  Get the node at an ordinal position within the tree without altering the
+  node cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pRank - (I) The ordinal position of the node (1 is the least node)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - There is no node at the ordinal position
+
+  motelTreeNodeHandle - The node at the ordinal position
+  ----------------------------------------------------------------------------
+  Note:
+
+  A node's lesser branch weight is one more than the number of nodes on its
+  lesser branch, which is the node's rank within its own subtree.
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetRankNode
+(
+    motelTreeHandle pTree,
+    unsigned long pRank
+);
+
+/*----------------------------------------------------------------------------
+  CountLesserNodes()
+  ----------------------------------------------------------------------------
+  Count the nodes with a key value less than (or equal to) a key object.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree      - (I) Tree handle
+  pKey       - (I) The key object to count against
+  pInclusive - (I) Also count the nodes with a key value equal to pKey
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  unsigned long - The number of nodes
+  ----------------------------------------------------------------------------*/
+
+static unsigned long CountLesserNodes
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    boolean pInclusive
+);
+
+/*----------------------------------------------------------------------------
+  GetBoundNode()
+  ----------------------------------------------------------------------------
+  Get the least node with a key value greater than (or equal to) a key
+  object without altering the node cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree      - (I) Tree handle
+  pKey       - (I) The key object bounding the node
+  pInclusive - (I) Also accept a node with a key value equal to pKey
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  NULL - There is no node within the bound
+
+  motelTreeNodeHandle - The least instance of the least node within the bound
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle GetBoundNode
+(
+    motelTreeHandle pTree,
+    const void * pKey,
+    boolean pInclusive
+);
+
+/*----------------------------------------------------------------------------
+  PivotLesserToGreater()
+  ----------------------------------------------------------------------------
+  Pivot a subtree moving nodes from the lesser side of the subtree to the
+  greater side of the subtree
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  pRoot - (I) The root of the subtree to rebalance
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  None
+  ----------------------------------------------------------------------------
+  Notes:
+
+  1. Make the lesser child of the old root the new root
+  2. Make the old root the greater child of the new root
+  3. Make the greater child of the new root the lesser child of the old root
+
+                 Old                           New
+
+                  Y                             W.
+                 / \                          /   \
+                W   Z     -- Becomes ->     U       Y.
+               / \                         / \     / \     
+              U   X                       T   V   X.  Z
+             / \               
+            T   V               Altered nodes denoted with a period
+
+  The old root's (Y) lesser and new root's (W) greater children were altered
+  as a result weights on these branches must be recalculated
+  ----------------------------------------------------------------------------*/
+
+static void PivotLesserToGreater
+(
+    motelTreeHandle pTree, 
+    motelTreeNodeHandle * pRoot
+);
+
+/*----------------------------------------------------------------------------
+  PivotGreaterToLesser()
+  ----------------------------------------------------------------------------
+  Pivot a subtree moving nodes from the greater side of the subtree to the
+  lesser side of the subtree
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  pRoot - (I) The root of the subtree to rebalance
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  None
+  ----------------------------------------------------------------------------
+  Notes:
+
+  1. Make the greater child of the old root the new root
+  2. Make the old root the lesser child of the new root
+  3. Make the lesser child of the new root the greater child of the old root
+
+                 Old                           New
+
+                  B                             D.
+                 / \                          /   \
+                A   D     -- Becomes ->     B.      F
+                   / \                     / \     / \     
+                  C   F                   A   C.  E   G
+                     / \               
+                    E   G       Altered nodes denoted with a period
+
+  The old root's (B) greater and new root's (D) lesser children were altered
+  as a result weights on these branches must be recalculated
+  ----------------------------------------------------------------------------*/
+
+static void PivotGreaterToLesser
+(
+    motelTreeHandle pTree, 
+    motelTreeNodeHandle * pRoot
+);
+
+/*----------------------------------------------------------------------------
+  RebalanceLesserToGreater()
+  ----------------------------------------------------------------------------
+  Rebalance a subtree whose lesser branch is too heavy according to the
+  tree's balance mode
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I/O) The tree handle
+  pRoot  - (I/O) The root of the subtree to rebalance
+  pLevel - (I)   The level of the subtree root (the tree root being level 1)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The number of pivots made: 1, or 2 for a double pivot, with 0 meaning
+  the nodes of a persistent tree could not be made private
+  ----------------------------------------------------------------------------
+  Notes:
+
+  With motelTreeBalanceMode_DoublePivot a lesser child whose greater branch
+  outweighs its lesser branch is first pivoted greater to lesser, so that
+  the lesser child's greater child (X below) becomes the subtree root rather
+  than being passed from one side of the subtree to the other:
+
+                 Old                           New
+
+                  Y                             X.
+                 / \                          /   \
+                W   Z     -- Becomes ->     W.      Y.
+               / \                         / \     / \
+              U   X                       U   V   S   Z
+                 / \
+                V   S           Altered nodes denoted with a period
+
+  Otherwise the subtree is pivoted by PivotLesserToGreater() alone.
+
+  A persistent tree first makes private the nodes to be pivoted. Should a
+  copy fail, the subtree is left as it is, as balance is never required for
+  the tree's correctness.
+  ----------------------------------------------------------------------------*/
+
+static unsigned long RebalanceLesserToGreater
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pRoot,
+    unsigned long pLevel
+);
+
+/*----------------------------------------------------------------------------
+  RebalanceGreaterToLesser()
+  ----------------------------------------------------------------------------
+  Rebalance a subtree whose greater branch is too heavy according to the
+  tree's balance mode
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I/O) The tree handle
+  pRoot  - (I/O) The root of the subtree to rebalance
+  pLevel - (I)   The level of the subtree root (the tree root being level 1)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The number of pivots made: 1, or 2 for a double pivot, with 0 meaning
+  the nodes of a persistent tree could not be made private
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The mirror image of RebalanceLesserToGreater().
+  ----------------------------------------------------------------------------*/
+
+static unsigned long RebalanceGreaterToLesser
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pRoot,
+    unsigned long pLevel
+);
+
+/*----------------------------------------------------------------------------
+  TrackPivotLevels()
+  ----------------------------------------------------------------------------
+  Raise the tree's level count for a pivot about to lower a branch of a
+  subtree by a level.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree   - (I/O) The tree handle
+  pLevel  - (I)   The level of the subtree root being pivoted
+  pBranch - (I)   The lighter branch of the subtree root that will be lowered
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A pivot, single or double, lowers only the lighter branch of the subtree
+  root, whose root lands two levels below pLevel. Most pivots are made near
+  the leaves, where the branch either holds too few nodes to reach the
+  deepest level or few enough (TRACKED_BRANCH_NODES) to count its levels
+  outright. A larger branch would cost a walk of its nodes, so its levels
+  are bounded in O(1) time from its weight and the tree's levelScale (see
+  GetBranchLevelBound()). Since the branch sinks by a single level, the
+  bound is raised by no more than one level for it.
+  ----------------------------------------------------------------------------*/
+
+static void TrackPivotLevels
+(
+    motelTreeHandle pTree,
+    unsigned long pLevel,
+    motelTreeNodeHandle pBranch
+);
+
+/*----------------------------------------------------------------------------
+  GetBranchLevelBound()
+  ----------------------------------------------------------------------------
+  Bound the levels of a branch from its weight.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree      - (I) The tree handle
+  pNullNodes - (I) The weight of the branch (its null nodes)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  unsigned long - The most levels the branch may hold
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The bound is the tree's levelScale, in twentieths of a level, for each bit
+  of the weight. The scale is taken from the loosest balance ratio the
+  tree's nodes may have been kept to since the tree was last empty.
+  ----------------------------------------------------------------------------*/
+
+static unsigned long GetBranchLevelBound
+(
+    motelTreeHandle pTree,
+    unsigned long pNullNodes
+);
+
+/*----------------------------------------------------------------------------
+  LoadSubtree()
+  ----------------------------------------------------------------------------
+  Build a balanced subtree from the next nodes of a bulk load
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I)   The tree handle
+  pLoad  - (I/O) The progress of the bulk load
+  pCount - (I)   The number of nodes to place within the subtree
+  pRoot  - (O)   The root of the subtree
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Subtree was succesfully built
+
+  False - Subtree was not successfully built due to one of the following:
+
+          1. A key object was less than the key object preceding it
+          2. A node construction failed
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The lesser branch is built first so that nodes are constructed in key
+  order. A subtree that cannot be completed is pruned before returning.
+  ----------------------------------------------------------------------------*/
+
+static boolean LoadSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeLoad * pLoad,
+    unsigned long pCount,
+    motelTreeNodeHandle * pRoot
+);
+
+/*----------------------------------------------------------------------------
+  SortNodes()
+  ----------------------------------------------------------------------------
+  Order an array of unlinked nodes by key value
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree    - (I)   The tree handle
+  pNodes   - (I/O) The array of node handles to order
+  pScratch - (I)   An array of pCount node handles used while merging
+  pCount   - (I)   The number of nodes
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Always
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The sort is a stable merge sort, so nodes with equal key values keep their
+  array order. Runs already in order are copied without further comparison.
+  ----------------------------------------------------------------------------*/
+
+static boolean SortNodes
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pNodes,
+    motelTreeNodeHandle * pScratch,
+    unsigned long pCount
+);
+
+/*----------------------------------------------------------------------------
+  MergeSubtree()
+  ----------------------------------------------------------------------------
+  Merge an ordered array of unlinked nodes into a subtree
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I)   The tree handle
+  pSubtree  - (I/O) The link holding the subtree root (NULL when empty)
+  pParent   - (I)   The parent of the subtree root
+  pPrevious - (I)   The greatest node preceding the subtree (NULL if none)
+  pNodes    - (I)   The nodes in key order
+  pCount    - (I)   The number of nodes
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Always
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The nodes are divided about the subtree root with a binary search and the
+  root's branch weights are updated once for all of them. A subtree that
+  the nodes would put out of balance is rebuilt instead of pivoted.
+  ----------------------------------------------------------------------------*/
+
+static boolean MergeSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeLink * pSubtree,
+    motelTreeNodeHandle pParent,
+    motelTreeNodeHandle pPrevious,
+    motelTreeNodeHandle * pNodes,
+    unsigned long pCount
+);
+
+/*----------------------------------------------------------------------------
+  FlattenSubtree()
+  ----------------------------------------------------------------------------
+  Relink a subtree's nodes into a list in key order through their greater
+  branches
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pRoot - (I) The root of the subtree
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The least node of the list (NULL if the subtree is empty)
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Only the lesser and greater links are maintained; the list is rebuilt into
+  a subtree by RebuildSubtree(). No stack or memory is needed.
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle FlattenSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot
+);
+
+/*----------------------------------------------------------------------------
+  RebuildSubtree()
+  ----------------------------------------------------------------------------
+  Build a balanced subtree from the next nodes of a merge
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I)   The tree handle
+  pMerge - (I/O) The progress of the merge
+  pCount - (I)   The number of nodes to place within the subtree
+  pRoot  - (O)   The root of the subtree
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Always
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A new node with a key value equal to its predecessor's is given the next
+  instance number. The subtree root's parent is left for the caller to set.
+  ----------------------------------------------------------------------------*/
+
+static boolean RebuildSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeMerge * pMerge,
+    unsigned long pCount,
+    motelTreeNodeHandle * pRoot
+);
+
+/*----------------------------------------------------------------------------
+  RestoreSubtreeBalance()
+  ----------------------------------------------------------------------------
+  Rebuild a subtree of the tree in perfect balance from its own nodes
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree    - (I)   The tree handle
+  pSubtree - (I/O) The link holding the subtree root
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  None
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Used by motelTreeBalanceMode_Rebuild in place of the pivots of the other
+  modes. The cost is linear in the size of the subtree, but a rebuilt
+  subtree of n nodes cannot fall out of balance again until on the order of
+  n nodes have been inserted into or deleted from it.
+  ----------------------------------------------------------------------------*/
+
+static void RestoreSubtreeBalance
+(
+    motelTreeHandle pTree,
+    motelTreeLink * pSubtree
+);
+
+/*----------------------------------------------------------------------------
+  SplitSubtree()
+  ----------------------------------------------------------------------------
+  Divide a detached subtree into the nodes preceding a key object (or equal
+  to it) and the rest
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree      - (I) The tree handle
+  pRoot      - (I) The root of the subtree (its parent must be NULL)
+  pKey       - (I) The key object
+  pInclusive - (I) Whether nodes with key values equal to the key object
+                   are placed with the lesser nodes
+  pLesser    - (O) The root of the nodes whose key values precede the key
+                   object
+  pGreater   - (O) The root of the remaining nodes
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The number of key comparisons made
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Each level of the descent toward the key object rejoins the subtree root
+  to the branch it does not descend, so the split takes O(log n) time.
+
+  The comparisons are returned rather than counted, as the splits of a set
+  operation may run on several threads at once.
+  ----------------------------------------------------------------------------*/
+
+static unsigned long SplitSubtree
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot,
+    const void * pKey,
+    boolean pInclusive,
+    motelTreeNodeHandle * pLesser,
+    motelTreeNodeHandle * pGreater
+);
+
+/*----------------------------------------------------------------------------
+  JoinSubtrees()
+  ----------------------------------------------------------------------------
+  Join two detached subtrees and a node whose key value falls between them
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree    - (I) The tree handle
+  pLesser  - (I) The root of the lesser subtree (may be NULL)
+  pNode    - (I) The unlinked joining node
+  pGreater - (I) The root of the greater subtree (may be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The root of the joined subtree
+  ----------------------------------------------------------------------------
+  Notes:
+
+  When one subtree is much heavier the node is placed along its nearer edge
+  at the first branch that balances the lighter subtree, and the weights
+  back up the edge are restored with a pivot wherever the branch has grown
+  too heavy. The time taken is proportional to the difference in height.
+
+  The edge is recorded in a motelTreePath on the way down rather than
+  climbed through the parent links, so parentless subtrees are joined alike.
+  An edge longer than the path is restored a path's length at a time from
+  its lower end, re-descending from the root for each part.
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle JoinSubtrees
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pLesser,
+    motelTreeNodeHandle pNode,
+    motelTreeNodeHandle pGreater
+);
+
+/*----------------------------------------------------------------------------
+  UnlinkLeastNode()
+  ----------------------------------------------------------------------------
+  Remove the least node from a detached subtree without destructing it
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pRoot - (I/O) The root of the subtree (its parent must be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The unlinked node
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle UnlinkLeastNode
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle * pRoot
+);
+
+/*----------------------------------------------------------------------------
+  OffsetLeastInstances()
+  ----------------------------------------------------------------------------
+  Add an offset to the instance of each of a detached subtree's nodes whose
+  key value is equal to the key object, which are its least nodes
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree   - (I) The tree handle
+  pRoot   - (I) The root of the subtree (may be NULL)
+  pKey    - (I) The key object
+  pOffset - (I) The offset to add to each instance
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Compares key values alone, so the instances already offset do not mislead
+  it, and needs no parent links.
+  ----------------------------------------------------------------------------*/
+
+static void OffsetLeastInstances
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot,
+    const void * pKey,
+    unsigned long pOffset
+);
+
+/*----------------------------------------------------------------------------
+  ClearTreeCursors()
+  ----------------------------------------------------------------------------
+  Unset the node cursor and every cursor constructed over a tree whose nodes
+  have been moved to another tree
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  ----------------------------------------------------------------------------*/
+
+static void ClearTreeCursors
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  CombineTrees()
+  ----------------------------------------------------------------------------
+  Carry out a set operation between the nodes of two trees
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree        - (I) The tree handle to receive the combined nodes
+  pOther       - (I) The tree handle whose nodes are taken
+  pCombination - (I) The set operation
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Trees were succesfully combined
+
+  False - Trees were not successfully combined due to one of the following:
+
+          1. The trees are incompatible
+          2. The tree cannot hold the other tree's nodes
+          3. A combining thread could not be awaited
+          4. A node destruction failed
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The nodes not kept are destructed by the calling thread once the trees
+  are combined, so that no thread but the caller modifies the tree object.
+  ----------------------------------------------------------------------------*/
+
+static boolean CombineTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther,
+    motelTreeCombination pCombination
+);
+
+/*----------------------------------------------------------------------------
+  CombineSubtrees()
+  ----------------------------------------------------------------------------
+  Carry out a set operation between two detached subtrees
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCombine - (I/O) The subtrees to combine; on return root holds the
+                   combined subtree and discards the subtrees not kept
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Subtrees were succesfully combined
+
+  False - A combining thread could not be awaited
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Both subtrees are split about the key value of the other subtree's root,
+  the lesser and greater parts are combined recursively (the greater on
+  another thread while threads remain and the parts are large) and the
+  results are concatenated about the nodes of that key value that are kept.
+  The work is O(m log(n/m + 1)) for subtrees of m and n nodes, m <= n.
+  ----------------------------------------------------------------------------*/
+
+static boolean CombineSubtrees
+(
+    motelTreeCombine * pCombine
+);
+
+/*----------------------------------------------------------------------------
+  CombineSubtreesThread()
+  ----------------------------------------------------------------------------
+  The thread routine of CombineSubtrees() that combines the greater parts.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCombine - (I/O) The motelTreeCombine of the greater parts
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  Zero
+  ----------------------------------------------------------------------------*/
+
+static motelThreadResult THREAD_CALLING_CONVENTION CombineSubtreesThread
+(
+    void * pCombine
+);
+
+/*----------------------------------------------------------------------------
+  ConcatenateSubtrees()
+  ----------------------------------------------------------------------------
+  Join two detached subtrees whose key values do not overlap
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree    - (I) The tree handle
+  pLesser  - (I) The root of the lesser subtree (may be NULL)
+  pGreater - (I) The root of the greater subtree (may be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The root of the concatenated subtree
+  ----------------------------------------------------------------------------*/
+
+static motelTreeNodeHandle ConcatenateSubtrees
+(
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pLesser,
+    motelTreeNodeHandle pGreater
+);
+
+/*----------------------------------------------------------------------------
+  DiscardSubtree()
+  ----------------------------------------------------------------------------
+  Set aside a detached subtree to be destructed once a combination is done
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCombine - (I/O) The combination
+  pRoot    - (I)   The root of the subtree (may be NULL)
+  ----------------------------------------------------------------------------*/
+
+static void DiscardSubtree
+(
+    motelTreeCombine * pCombine,
+    motelTreeNodeHandle pRoot
+);
+
+/*----------------------------------------------------------------------------
+  DiscardSubtrees()
+  ----------------------------------------------------------------------------
+  Gather the subtrees discarded by a branch of a combination
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCombine - (I/O) The combination
+  pBranch  - (I)   The combination of one of its branches
+  ----------------------------------------------------------------------------*/
+
+static void DiscardSubtrees
+(
+    motelTreeCombine * pCombine,
+    motelTreeCombine * pBranch
+);
+
+/*----------------------------------------------------------------------------
+  FillSnapshot()
+  ----------------------------------------------------------------------------
+  Copy successive nodes into the search entries of a snapshot subtree and
+  into their records
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pSnapshot - (I/O) The snapshot handle
+  pTree     - (I)   The tree handle
+  pIndex    - (I)   The index of the subtree's root entry
+  pPath     - (I/O) The path of the scan through the tree's nodes
+  pNode     - (I/O) The next node to copy; advanced past the copied nodes
+  pRank     - (I/O) The rank of the next node; advanced past the copied nodes
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The entries of the subtree rooted at pIndex are filled in key order, so the
+  children of the entry at i lie at 2i and 2i + 1.
+  ----------------------------------------------------------------------------*/
+
+static void FillSnapshot
+(
+    motelTreeSnapshotHandle pSnapshot,
+    motelTreeHandle pTree,
+    unsigned long pIndex,
+    motelTreePath * pPath,
+    motelTreeNodeHandle * pNode,
+    unsigned long * pRank
+);
+
+/*----------------------------------------------------------------------------
+  FindSnapshotBound()
+  ----------------------------------------------------------------------------
+  Find the least record ordered at or after a key object and instance
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pSnapshot - (I) The snapshot handle
+  pKey      - (I) The key object
+  pInstance - (I) The instance of the key object
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  unsigned long - The rank of the record (one more than the number of
+                  records when every record is ordered before the key)
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The descent takes one comparison per level and chooses the next entry by
+  arithmetic rather than by a branch, then recovers the bounding entry from
+  the final index. Instance 0 orders before every instance of a key value and
+  the largest unsigned long after every instance.
+  ----------------------------------------------------------------------------*/
+
+static unsigned long FindSnapshotBound
+(
+    motelTreeSnapshotHandle pSnapshot,
+    const void * pKey,
+    unsigned long pInstance
+);
+
+/*----------------------------------------------------------------------------
+  GetRankLevel()
+  ----------------------------------------------------------------------------
+  Determine the depth of the search entry holding the node of a rank
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pRank   - (I) The rank of the node
+  pLevels - (I) The levels of the entries (see GetLoadedLevelCount())
+  pNodes  - (I) The number of entries
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  unsigned long - The depth of the entry (0 for the entry at index 1)
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The entries fill every level but the last, whose entries are packed to
+  the lesser side. Of the in-order positions of the full tree of pLevels
+  levels, the entries above the last level hold the even ones and those of
+  the last level the least odd ones; the node's position is found from its
+  rank, and its depth from the trailing zero bits of the position.
+  ----------------------------------------------------------------------------*/
+
+static unsigned long GetRankLevel
+(
+    unsigned long pRank,
+    unsigned long pLevels,
+    unsigned long pNodes
+);
+
+/*----------------------------------------------------------------------------
+  FindSnapshotRecord()
+  ----------------------------------------------------------------------------
+  Find the record of a key object and instance
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pSnapshot - (I) The snapshot handle
+  pKey      - (I) The key object
+  pInstance - (I) The instance of the key object (0 for the least)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  unsigned long - The rank of the record (0 when it is not in the snapshot)
+  ----------------------------------------------------------------------------*/
+
+static unsigned long FindSnapshotRecord
+(
+    motelTreeSnapshotHandle pSnapshot,
+    const void * pKey,
+    unsigned long pInstance
+);
+
+/*----------------------------------------------------------------------------
+  WriteTreeFile()
+  ----------------------------------------------------------------------------
+  Write a tree to a file that MapTree() can map.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I) The tree handle
+  pPath     - (I) The path of the file
+  pSequence - (I) The sequence number of the last logged change the tree
+                  holds (0 when the tree is not logged)
+  pSync     - (I) Whether the file is committed to the disk before it is
+                  closed
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The file was successfully written
+
+  False - The file was not successfully written due to:
+
+          1. The tree groups duplicates
+          2. Memory for the write buffers could not be allocated
+          3. The file could not be opened, written, committed or closed
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The file holds what FreezeTree() would build, but it is written from the
+  nodes in a single in-order scan through buffers of TREE_FILE_BUFFER_SIZE
+  bytes in all, so that saving or checkpointing a large tree does not double
+  its memory. The nodes of each level of the search entries follow one
+  another in key order, so each node's entry is added to the buffer of its
+  level (see GetRankLevel()) and its record to that of the records, and
+  each buffer is written at its own place in the file as it fills.
+  ----------------------------------------------------------------------------*/
+
+static boolean WriteTreeFile
+(
+    motelTreeHandle pTree,
+    const char * pPath,
+    bits64 pSequence,
+    boolean pSync
+);
+
+/*----------------------------------------------------------------------------
+  StageFileBytes()
+  ----------------------------------------------------------------------------
+  Reserve cleared room in a file buffer, first writing out what it holds
+  should it lack the room
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pBuffer - (I/O) The file buffer
+  pSize   - (I)   The number of bytes to reserve (no more than the buffer's
+                  capacity)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  byte * - The room reserved
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A failed write is recorded through the buffer's written member rather than
+  returned, so the bytes are still staged and the failure is reported once
+  the file is complete.
+  ----------------------------------------------------------------------------*/
+
+static byte * StageFileBytes
+(
+    motelTreeFileBuffer * pBuffer,
+    size_t pSize
+);
+
+/*----------------------------------------------------------------------------
+  FlushFileBuffer()
+  ----------------------------------------------------------------------------
+  Write out the bytes a file buffer holds at its place in the file
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pBuffer - (I/O) The file buffer
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A failed write is recorded through the buffer's written member.
+  ----------------------------------------------------------------------------*/
+
+static void FlushFileBuffer
+(
+    motelTreeFileBuffer * pBuffer
+);
+
+/*----------------------------------------------------------------------------
+  FillLogRecord()
+  ----------------------------------------------------------------------------
+  Compose the redo log record of a change to be written by AppendLogRecord()
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree      - (I) The tree handle
+  pOperation - (I) The change
+  pKey       - (I) The key object of the node changed
+  pInstance  - (I) The instance of the node changed
+  pData      - (I) The node's new data object (ignored for a deletion)
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A deletion's record is composed before the node is deleted, and written
+  only once the deletion has succeeded.
+  ----------------------------------------------------------------------------*/
+
+static void FillLogRecord
+(
+    motelTreeHandle pTree,
+    motelTreeLogOperation pOperation,
+    const void * pKey,
+    unsigned long pInstance,
+    const void * pData
+);
+
+/*----------------------------------------------------------------------------
+  AppendLogRecord()
+  ----------------------------------------------------------------------------
+  Write the record composed by FillLogRecord() to the tree's redo log,
+  committing the log once it holds a group of changes and checkpointing the
+  tree once the log holds enough of them.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The record was successfully written
+
+  False - The record was not successfully written or committed; the log
+          refuses further changes until the tree is checkpointed
+  ----------------------------------------------------------------------------
+  Notes:
+
+  A failed checkpoint leaves the log whole and is retried once the log holds
+  another interval of changes.
+  ----------------------------------------------------------------------------*/
+
+static boolean AppendLogRecord
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  WriteLogBuffer()
+  ----------------------------------------------------------------------------
+  Write the records gathered in the tree's redo log buffer to the log.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The records were successfully written
+
+  False - The records were not successfully written; the log refuses
+          further changes until the tree is checkpointed
+  ----------------------------------------------------------------------------*/
+
+static boolean WriteLogBuffer
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  CommitLog()
+  ----------------------------------------------------------------------------
+  Commit the records written to the tree's redo log to the disk.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The records were successfully committed
+
+  False - The records were not successfully committed; the log refuses
+          further changes until the tree is checkpointed
+  ----------------------------------------------------------------------------*/
+
+static boolean CommitLog
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  WriteCheckpoint()
+  ----------------------------------------------------------------------------
+  Write the tree to its checkpoint file and start its redo log afresh.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The checkpoint was successfully written
+
+  False - The checkpoint was not successfully written due to:
+
+          1. WriteTreeFile() failed
+          2. The checkpoint file could not replace the previous one
+          3. The log could not be started afresh
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The checkpoint is written beside the previous one and replaces it only
+  once it is on the disk, and the log is emptied only once the replacement
+  is on the disk. A crash at any point leaves a checkpoint whose sequence
+  number tells RecoverTree() which of the logged changes it already holds.
+
+  WriteTreeFile() streams the nodes through buffers of a fixed size, so the
+  writers held back by a checkpoint wait on the disk alone, without the
+  tree's memory being doubled by a snapshot of it.
+  ----------------------------------------------------------------------------*/
+
+static boolean WriteCheckpoint
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  CloseLog()
+  ----------------------------------------------------------------------------
+  Commit and close the tree's redo log and release it.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) The tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The log was successfully committed and closed
+
+  False - The log could not be committed or closed; it is released anyway
+  ----------------------------------------------------------------------------*/
+
+static boolean CloseLog
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  ReplayLog()
+  ----------------------------------------------------------------------------
+  Make the changes held by a redo log that follow a checkpoint.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I)   The tree handle
+  pPath     - (I)   The path of the log
+  pSequence - (I/O) The sequence number of the last change the tree holds;
+                    advanced past the changes made
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The log was successfully replayed, or does not exist
+
+  False - The log was not successfully replayed due to:
+
+          1. The log was written for a different kind of tree
+          2. A logged change could not be made
+          3. A logged node is not within the tree
+  ----------------------------------------------------------------------------
+  Notes:
+
+  The replay ends at the first record that is torn or does not follow the
+  last change made, which is where a crash interrupted the log.
+  ----------------------------------------------------------------------------*/
+
+static boolean ReplayLog
+(
+    motelTreeHandle pTree,
+    const char * pPath,
+    bits64 * pSequence
+);
+
+/*----------------------------------------------------------------------------
+  LogChecksum()
+  ----------------------------------------------------------------------------
+  Take a 32 bit hash of a redo log record, folded from an FNV-1a hash
+  taken over 64 bit words rather than bytes.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pRecord - (I) The record
+  pLength - (I) The number of bytes in the record
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  bits32 - The hash
+  ----------------------------------------------------------------------------*/
+
+static bits32 LogChecksum
+(
+    const byte * pRecord,
+    size_t pLength
+);
+
+/*----------------------------------------------------------------------------
+  SyncFileStream()
+  ----------------------------------------------------------------------------
+  Flush a file stream and commit its file to the disk.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pStream - (I) The file stream
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The file was successfully committed
+
+  False - The file was not successfully committed
+  ----------------------------------------------------------------------------*/
+
+static boolean SyncFileStream
+(
+    FILE * pStream
+);
+
+/*----------------------------------------------------------------------------
+  GetLogClock()
+  ----------------------------------------------------------------------------
+  Read a clock of milliseconds that only moves forward.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  None
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  The milliseconds since an arbitrary moment
+  ----------------------------------------------------------------------------*/
+
+static bits64 GetLogClock
+(
+    void
+);
+
+/*----------------------------------------------------------------------------
+  ReplaceFilePath()
   ----------------------------------------------------------------------------
-  Destruct the current node.
+  Rename a file over another and commit the renaming to the disk.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Handle of the tree in which the node exists
+  pPath    - (I) The path of the file
+  pNewPath - (I) The path of the file to be replaced
   ----------------------------------------------------------------------------
   Return Values:
 
-  True  - Node was succesfully destructed
-
-  False - Node was not successfully destructed due to:
+  True  - The file was successfully renamed
 
-          1. The pTree handle was NULL
-          2. No current node was set
-          3. The node data destruction failed
-          4. The node key destruction failed
-          5. The node destruction failed
+  False - The file was not successfully renamed, or the renaming was not
+          committed to the disk
   ----------------------------------------------------------------------------*/
 
-static boolean DestructNode
+static boolean ReplaceFilePath
 (
-    motelTreeHandle pTree
+    const char * pPath,
+    const char * pNewPath
 );
 
 /*----------------------------------------------------------------------------
-  GetEqualNode()
+  BeginTreeRead()
   ----------------------------------------------------------------------------
-  Get a node that matches the provided key object from the tree.
+  Begin a lock-free read of a concurrent tree.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree     - (I) Tree handle
-  pKey      - (I) The key object to use to find a node in the tree
-  pInstance - (I) The instance of the key object in the tree
+  pTree - (I) The tree handle
   ----------------------------------------------------------------------------
   Return Values:
 
-  NULL - No node was found that matched the value of the key object
-
-  motelTreeNodeHandle - A node from the tree that matched the value of the
-                        provided key object
+  unsigned long - The write sequence number to be confirmed by EndTreeRead()
   ----------------------------------------------------------------------------
-  Note:
+  Notes:
 
-  For nodes with duplicated key values the eariliest entered instance of the
-  node will be returned from the tree.
+  Waits while a writer holds the tree lock. Returns 0 immediately for a tree
+  that is not concurrent.
   ----------------------------------------------------------------------------*/
 
-static motelTreeNodeHandle GetEqualNode
+static unsigned long BeginTreeRead
 (
-    motelTreeHandle pTree,
-    const void * pKey,
-    unsigned long pInstance
+    motelTreeHandle pTree
 );
 
 /*----------------------------------------------------------------------------
-  NodeCompare()
+  EndTreeRead()
   ----------------------------------------------------------------------------
-  Compare the key values of a pair of nodes
+  Confirm that no writer modified the tree during a lock-free read.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree  - (I) The tree handle
-  pNode1 - (I) The first node to compare
-  pNode2 - (I) The second node to compare
+  pTree     - (I) The tree handle
+  pSequence - (I) The write sequence number returned by BeginTreeRead()
   ----------------------------------------------------------------------------
   Return Values:
 
-  < 0   means pNode1->key is less than pNode2->key
-  > 0   means pNode1->key is greater than pNode2->key
-  
-  ----------------------------------------------------------------------------
-  Notes:
-
-  This function uses the key comparison function established by the calling
-  system when the tree that the node resides in was constructed. By definition
-  this function must adhere to the behavior of the standard C function
-  strcmp(), mathematically returning (pNode1->key - pNode2->key).
+  True  - Everything read from the tree is consistent
 
-  In the case where node keys are duplicated within the tree (e.g. logically 
-  pNode1->key == pNode2->key) the node instance values are compared to
-  distinguish the relative value of the nodes.
+  False - A writer intervened and the read must be repeated
   ----------------------------------------------------------------------------*/
 
-static long NodeCompare
+static boolean EndTreeRead
 (
     motelTreeHandle pTree,
-    motelTreeNodeHandle pNode1,
-    motelTreeNodeHandle pNode2
+    unsigned long pSequence
 );
 
 /*----------------------------------------------------------------------------
-  GetLeastNode()
+  EnterTreeEpoch()
   ----------------------------------------------------------------------------
-  Get the node with the lowest key value from the tree without altering
-  the node cursor.
+  Register a reader so that nodes it may reach are not freed beneath it.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Tree handle
+  pTree - (I) The tree handle
   ----------------------------------------------------------------------------
   Return Values:
 
-  NULL - There is no tree or there are no nodes are in the tree
-
-  motelTreeNodeHandle - The lowest key valued node in the tree
+  unsigned long - The epoch entered, to be passed to ExitTreeEpoch()
   ----------------------------------------------------------------------------*/
 
-static motelTreeNodeHandle GetLeastNode
+static unsigned long EnterTreeEpoch
 (
     motelTreeHandle pTree
 );
 
 /*----------------------------------------------------------------------------
-  GetGreatestNode()
+  ExitTreeEpoch()
   ----------------------------------------------------------------------------
-  Get the node with the highest key value from the tree without altering
-  the node cursor.
+  Unregister a reader registered by EnterTreeEpoch().
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Tree handle
+  pTree  - (I) The tree handle
+  pEpoch - (I) The epoch returned by EnterTreeEpoch()
   ----------------------------------------------------------------------------
   Return Values:
 
-  NULL - There is no tree or there are no nodes are in the tree
-
-  motelTreeNodeHandle - The highest key valued node in the tree
+  None
   ----------------------------------------------------------------------------*/
 
-static motelTreeNodeHandle GetGreatestNode
+static void ExitTreeEpoch
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    unsigned long pEpoch
 );
 
 /*----------------------------------------------------------------------------
-  GetLesserNode()
+  RetireNode()
   ----------------------------------------------------------------------------
-  Get the node with the next lower key value in the tree without altering
-  the node cursor.
+  Defer the destruction of a node deleted from a concurrent tree until no
+  reader can still be traversing it.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Tree handle
+  pTree - (I) The tree handle
+  pNode - (I) The disconnected node
   ----------------------------------------------------------------------------
   Return Values:
 
-  NULL - There is no tree or there is no lower node in the tree
+  None
+  ----------------------------------------------------------------------------
+  Notes:
 
-  motelTreeNodeHandle - The next lower key valued node in the tree
+  The node's parent link is reused to chain it into the retired list of the
+  current epoch.
   ----------------------------------------------------------------------------*/
 
-static motelTreeNodeHandle GetLesserNode
+static void RetireNode
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode
 );
 
 /*----------------------------------------------------------------------------
-  GetGreaterNode()
+  ReclaimRetiredNodes()
   ----------------------------------------------------------------------------
-  Get the node with the next higher key value in the tree without altering
-  the node cursor.
+  Destruct the retired nodes that no reader can reach.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Tree handle
+  pTree - (I) The tree handle
+  pAll  - (I) Destruct every retired node (there must be no readers)
   ----------------------------------------------------------------------------
   Return Values:
 
-  NULL - There is no tree or there is no higher node in the tree
+  True  - Retired nodes were succesfully reclaimed
 
-  motelTreeNodeHandle - The next higher key valued node in the tree
+  False - Retired nodes were not successfully reclaimed due to:
+
+          1. A node destruction failed
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Nodes retired during the previous epoch are destructed, and the epoch
+  advanced, once the last reader that entered the previous epoch has exited.
+  Readers that entered the current epoch began after those nodes were
+  disconnected and so cannot reach them.
   ----------------------------------------------------------------------------*/
 
-static motelTreeNodeHandle GetGreaterNode
+static boolean ReclaimRetiredNodes
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    boolean pAll
 );
 
 /*----------------------------------------------------------------------------
-  GetRootNode()
+  ReadBoundNode()
   ----------------------------------------------------------------------------
-  Get the root node of the tree without altering the node cursor.
+  Find, without locks, the least node ordered after a key object and
+  instance.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Tree handle
+  pTree     - (I) The tree handle
+  pKey      - (I) The key object bounding the node (NULL for the least node)
+  pInstance - (I) The instance bounding the node (0 to accept any instance)
+  pSequence - (I) The write sequence number returned by BeginTreeRead()
+  pNode     - (O) The node found, or NULL when there is none
   ----------------------------------------------------------------------------
   Return Values:
 
-  NULL - There is no tree or there is no root node in the tree
+  True  - The traversal completed
 
-  motelTreeNodeHandle - The root node of the tree
+  False - A writer intervened and the traversal was abandoned
   ----------------------------------------------------------------------------*/
 
-static motelTreeNodeHandle GetRootNode
+static boolean ReadBoundNode
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    const void * pKey,
+    unsigned long pInstance,
+    unsigned long pSequence,
+    motelTreeNodeHandle * pNode
 );
 
 /*----------------------------------------------------------------------------
-  GetParentNode()
+  ReadGreaterNode()
   ----------------------------------------------------------------------------
-  Get the physical parent node of the passed node without altering the node
-  cursor.
+  Step, without locks, to the node with the next higher key value.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Handle of the tree in which the node exists
+  pTree     - (I) The tree handle
+  pNode     - (I) The node to step from
+  pSequence - (I) The write sequence number under which pNode was read
+  pNext     - (O) The next node, or NULL when there is none
   ----------------------------------------------------------------------------
   Return Values:
 
-  NULL - The current node is NULL or it is the root node of the tree
+  True  - The traversal completed
 
-  motelTreeNodeHandle - The parent node of the node passed
+  False - A writer intervened and the traversal was abandoned
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Steps up through the parent links, so a parentless tree's scan seeks past
+  the last node visited with ReadBoundNode() instead.
   ----------------------------------------------------------------------------*/
 
-static motelTreeNodeHandle GetParentNode
+static boolean ReadGreaterNode
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    unsigned long pSequence,
+    motelTreeNodeHandle * pNext
 );
 
 /*----------------------------------------------------------------------------
-  GetLesserChildNode()
+  CopyReadNode()
   ----------------------------------------------------------------------------
-  Get the physical lesser child node of the passed node without altering the
-  node cursor.
+  Copy, without locks, the key, data and instance of a node.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Handle of the tree in which the node exists
+  pTree     - (I) The tree handle
+  pNode     - (I) The node to copy
+  pKey      - (O) Pointer to the key object copy (may be NULL)
+  pData     - (O) Pointer to the data object copy (may be NULL)
+  pInstance - (O) Pointer to the node instance copy (may be NULL)
   ----------------------------------------------------------------------------
   Return Values:
 
-  NULL - The current node is NULL or it is a leaf node in the tree
+  None
+  ----------------------------------------------------------------------------
+  Notes:
 
-  motelTreeNodeHandle - The lesser child node of the node passed
+  A writer may be changing the node, so the copy only stands once
+  EndTreeRead() confirms it. The lock-free reads are gathered here, in
+  ReadBoundNode(), in ReadGreaterNode() and in CompareReadKeys(), which are
+  the functions named by Motel.Tree.Test/motel.tree.test.tsan.
   ----------------------------------------------------------------------------*/
 
-static motelTreeNodeHandle GetLesserChildNode
+static void CopyReadNode
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pNode,
+    void * pKey,
+    void * pData,
+    unsigned long * pInstance
 );
 
 /*----------------------------------------------------------------------------
-  GetGreaterChildNode()
+  ScanConcurrentRange()
   ----------------------------------------------------------------------------
-  Get the physical greater child node of the passed node without altering the
-  node cursor.
+  Visit the nodes within a key range of a concurrent tree without locks.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Handle of the tree in which the node exists
+  pTree         - (I) The tree handle
+  pLeast        - (I) The least key object of the range (may be NULL)
+  pGreatest     - (I) The greatest key object of the range (may be NULL)
+  pScanFunction - (I) Function called for each node within the range
+  pContext      - (I) Caller's context passed through to pScanFunction
   ----------------------------------------------------------------------------
   Return Values:
 
-  NULL - The current node is NULL or it is a leaf node in the tree
+  True  - Range was succesfully scanned
 
-  motelTreeNodeHandle - The greater child node of the node passed
+  False - Range was not successfully scanned due to:
+
+          1. The pScanFunction handle was NULL
+          2. Copies of the key and data could not be allocated
+  ----------------------------------------------------------------------------
+  Notes:
+
+  Each node's key and data are copied and confirmed before the scan function
+  sees them. When a writer intervenes, the scan resumes from the last key and
+  instance visited.
   ----------------------------------------------------------------------------*/
 
-static motelTreeNodeHandle GetGreaterChildNode
+static boolean ScanConcurrentRange
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    const void * pLeast,
+    const void * pGreatest,
+    boolean (* pScanFunction)(void * pContext, const void * pKey, const void * pData, unsigned long pInstance),
+    void * pContext
 );
 
 /*----------------------------------------------------------------------------
-  GetTreeLevelCount()
+  PruneSubtree()
   ----------------------------------------------------------------------------
-  Determine the maximum level depth of a tree.
+  Delete all nodes from a subtree without recursion; each node is released
+  once its children are, stepping back up through the parent links.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) Handle of the tree
+  pTree - (I) The tree handle
+  pRoot - (I) The root of the subtree to prune
   ----------------------------------------------------------------------------
   Return Values:
 
-  unsigned long - The maximum level depth within the tree
-  ----------------------------------------------------------------------------
-  Note:
+  True  - Subtree was succesfully pruned
 
-  This function determines the branch length of the longest route from the
-  root to a leaf node. Each node within the longest route from the root to
-  a leaf node is considered a level within the tree.
+  False - Subtree was not successfully pruned due to one of the following:
+
+          1. A node destruction failed
+          2. A SafeFreeBlock() failed
   ----------------------------------------------------------------------------*/
 
-static unsigned long GetTreeLevelCount
+static boolean PruneSubtree
 (
-    motelTreeHandle pTree
+    motelTreeHandle pTree,
+    motelTreeNodeHandle pRoot
 );
 
+/*
+** a compact tree's nodes are released all at once along with its arena
+*/
+
+#if !defined COMPACT_TREE_NODES
+
 /*----------------------------------------------------------------------------
-  GetSubtreeLevelCount()
+  PruneTreeInParallel()
   ----------------------------------------------------------------------------
-  Determine the maximum level depth of a subtree.
+  Delete all nodes from a heap allocated tree by dividing it into as many
+  subtrees as there are teardown threads and pruning each on its own thread.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pRoot - (I) The root of the subtree to measure
+  pTree - (I) The tree handle
   ----------------------------------------------------------------------------
   Return Values:
 
-  unsigned long - The maximum level depth within the subtree
+  True  - Tree was succesfully pruned
+
+  False - Tree was not successfully pruned due to one of the following:
+
+          1. A node destruction failed
+          2. A SafeFreeBlock() failed
   ----------------------------------------------------------------------------
   Note:
 
-  This function determines the branch length of the longest route from the
-  subtree root to a leaf node. Each node within the longest route from the
-  subtree root to a leaf node is considered a level within the subtree.
+  A subtree whose thread cannot be started is pruned by the calling thread
+  with PruneSubtree(), and only the threads that started are joined. If the
+  tree cannot be divided, the subtrees already split off are pruned before
+  returning.
   ----------------------------------------------------------------------------*/
 
-static unsigned long GetSubtreeLevelCount
+static boolean PruneTreeInParallel
 (
-    motelTreeNodeHandle pRoot
+    motelTreeHandle pTree
 );
 
 /*----------------------------------------------------------------------------
-  PivotLesserToGreater()
+  PruneTeardownSubtree()
   ----------------------------------------------------------------------------
-  Pivot a subtree moving nodes from the lesser side of the subtree to the
-  greater side of the subtree
+  The thread routine of PruneTreeInParallel() that releases one subtree.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) The tree handle
-  pRoot - (I) The root of the subtree to rebalance
+  pTeardown - (I/O) The motelTreeTeardown describing the subtree; its size
+                    is reduced by the memory released
   ----------------------------------------------------------------------------
   Return Values:
 
-  None
+  Zero
   ----------------------------------------------------------------------------
-  Notes:
-
-  1. Make the lesser child of the old root the new root
-  2. Make the old root the greater child of the new root
-  3. Make the greater child of the new root the lesser child of the old root
-
-                 Old                           New
-
-                  Y                             W.
-                 / \                          /   \
-                W   Z     -- Becomes ->     U       Y.
-               / \                         / \     / \     
-              U   X                       T   V   X.  Z
-             / \               
-            T   V               Altered nodes denoted with a period
+  Note:
 
-  The old root's (Y) lesser and new root's (W) greater children were altered
-  as a result weights on these branches must be recalculated
+  The tree object is not touched so that any number of these routines may
+  run at once; the success member reports the outcome.
   ----------------------------------------------------------------------------*/
 
-static void PivotLesserToGreater
+static motelThreadResult THREAD_CALLING_CONVENTION PruneTeardownSubtree
 (
-    motelTreeHandle pTree, 
-    motelTreeNodeHandle * pRoot
+    void * pTeardown
 );
 
+#endif
+
 /*----------------------------------------------------------------------------
-  PivotGreaterToLesser()
+  ValidateSubtree()
   ----------------------------------------------------------------------------
-  Pivot a subtree moving nodes from the greater side of the subtree to the
-  lesser side of the subtree
+  Walk a subtree in key order without recursion, checking each node with
+  ValidateNode() against the node before it.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) The tree handle
-  pRoot - (I) The root of the subtree to rebalance
+  pValidation - (I/O) The motelTreeValidation naming the subtree; its least,
+                      greatest, failure and result members are set
   ----------------------------------------------------------------------------
   Return Values:
 
-  None
+  Zero
   ----------------------------------------------------------------------------
-  Notes:
-
-  1. Make the greater child of the old root the new root
-  2. Make the old root the lesser child of the new root
-  3. Make the lesser child of the new root the greater child of the old root
-
-                 Old                           New
+  Note:
 
-                  B                             D.
-                 / \                          /   \
-                A   D     -- Becomes ->     B.      F
-                   / \                     / \     / \     
-                  C   F                   A   C.  E   G
-                     / \               
-                    E   G       Altered nodes denoted with a period
+  The tree object is not touched so that any number of these routines may
+  run at once. The walk keeps its own path of lesser ancestors, so a deep or
+  damaged subtree cannot exhaust the stack, and a walk that would pass more
+  nodes than the subtree's weight claims stops, so a cycle cannot hold it.
 
-  The old root's (B) greater and new root's (D) lesser children were altered
-  as a result weights on these branches must be recalculated
+  The failure member is left NULL, with a result of
+  motelResult_MemoryAllocation, when the path could not be allocated.
   ----------------------------------------------------------------------------*/
 
-static void PivotGreaterToLesser
+static motelThreadResult THREAD_CALLING_CONVENTION ValidateSubtree
 (
-    motelTreeHandle pTree, 
-    motelTreeNodeHandle * pRoot
+    void * pValidation
 );
 
 /*----------------------------------------------------------------------------
-  PruneSubtree()
+  ValidateTreeInParallel()
   ----------------------------------------------------------------------------
-  Delete all nodes from a subtree 
+  Validate a large tree by dividing it into as many subtrees as there are
+  validate threads and walking each on its own thread.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) The tree handle
-  pRoot - (I) The root of the subtree to prune
+  pTree       - (I) The tree handle
+  pValidation - (O) The first failing node, in key order, and its result
   ----------------------------------------------------------------------------
   Return Values:
 
-  True  - Subtree was succesfully pruned
+  True  - Tree passed the validity check
 
-  False - Subtree was not successfully pruned due to one of the following:
+  False - Tree did not pass the validity check, see pValidation
+  ----------------------------------------------------------------------------
+  Note:
 
-          1. A node destruction failed
-          2. A SafeFreeBlock() failed
+  The nodes above the subtrees are checked by the calling thread once the
+  subtrees have been walked, as are the boundaries between neighbouring
+  subtrees, so the failure reported is the one a single walk would report.
+  A subtree whose thread cannot be started is walked by the calling thread.
   ----------------------------------------------------------------------------*/
 
-static boolean PruneSubtree
+static boolean ValidateTreeInParallel
 (
     motelTreeHandle pTree,
-    motelTreeNodeHandle pRoot
+    motelTreeValidation * pValidation
 );
 
 /*----------------------------------------------------------------------------
-  ValidateSubtree()
+  ValidateNode()
   ----------------------------------------------------------------------------
-  Test every node within a subtree to assure that the structure is correct.
+  Test one node of a tree against the node before it in key order and
+  against its children.
   ----------------------------------------------------------------------------
   Parameters:
 
-  pTree - (I) The tree handle
-  pRoot - (I) The root of the subtree to check
+  pTree     - (I) The tree handle
+  pNode     - (I) The node to check
+  pPrevious - (I) The node before pNode in key order, or NULL
+  pResult   - (O) The reason the node failed
   ----------------------------------------------------------------------------
   Return Values:
 
-  True  - Subtree passed the validity check
+  True  - Node passed the validity check
 
-  False - Subtree did not pass the validity check due to one of the following:
+  False - Node did not pass the validity check due to one of the following:
 
-          1. A node had a greater value that is located on a lesser branch
-          2. A node had a lesser value that is located on a greater branch
-          3. A node had branch weight that was incorrect
+          1. A grouped key's occurrences were missing or out of instance
+             order (motelResult_Structure)
+          2. The node's value was less than pPrevious's value
+             (motelResult_Structure)
+          3. A child's parent link did not lead back to the node
+             (motelResult_Structure)
+          4. A branch weight was not one more than the branch's node count
+             (motelResult_NodeCount)
   ----------------------------------------------------------------------------
   Note:
 
-  This function is primarily used for debugging of the motelTree module. A
-  validity check failure suggests a bug in the motelTree implementation.
+  The tree object is not touched, and the keys are compared without counting
+  the comparisons, so that any number of threads may check nodes at once.
   ----------------------------------------------------------------------------*/
 
-static boolean ValidateSubtree
+static boolean ValidateNode
 (
     motelTreeHandle pTree,
-    motelTreeNodeHandle pRoot
+    motelTreeNodeHandle pNode,
+    motelTreeNodeHandle pPrevious,
+    motelResult * pResult
 );
 
 #endif
@@ -52,12 +52,30 @@
 
           1. A node had a greater value located on a lesser branch
           2. A node had a lesser value located on a greater branch
-          3. A node had branch weight that was incorrect
+          3. A node's parent link did not lead to its parent
+          4. A grouped key's occurrences were missing or out of order
+          5. A node had branch weight that was incorrect
+             (motelResult_NodeCount)
+          6. The nodes could not be walked for want of memory
+             (motelResult_MemoryAllocation)
+          7. A thread walking part of the tree could not be joined
+             (motelResult_Undefined)
+
+          the result being motelResult_Structure unless noted
   ----------------------------------------------------------------------------
   Note:
 
   This function is primarily used for debugging of the motelTree module. A
   validity check failure suggests a bug in the motelTree implementation.
+
+  The nodes are walked in key order without recursion, each checked against
+  the node before it, its children and their weights in a single pass. When
+  a check fails the node cursor is left on the first node, in key order, to
+  fail, so that the node may be fetched or its neighbours examined.
+
+  Setting motelTreeMember_ValidateThreads divides the walk of a large tree
+  among that many threads, each walking a disjoint subtree. The tree must
+  not be changed while it is validated.
   ----------------------------------------------------------------------------*/
 
 EXPORT_STORAGE_CLASS success CALLING_CONVENTION ValidateTree
@@ -73,7 +91,7 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ValidateTree
   Parameters:
 
   pTree               - (I/O) Pointer to recieve the tree handle
-  pCompareKeyFunction - (I)   Pointer to the node key comparison function
+  pCompareKeyFunction - (I)   Pointer to the node key comparison function (may be NULL)
   pTreeMaximumSize    - (I)   The maximum number of bytes used by the tree
   ----------------------------------------------------------------------------
   Return Values:
@@ -82,8 +100,7 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ValidateTree
 
   False - Tree was not successfully constructed due to:
 
-          1. The ComparisonKeyFunction was NULL
-          2. The SafeMallocBlock() failed
+          1. The SafeMallocBlock() failed
   ----------------------------------------------------------------------------
   Notes:
 
@@ -93,14 +110,18 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ValidateTree
   overwritting this pointer with a new value would orphan the previously
   allocated memory block.
 
-  The key comparison function is required. This function must adhere to the
-  behavior of the standard C function strcmp(), mathematically returning
-  (pKey1 - pKey2) where:
+  The key comparison function must adhere to the behavior of the standard C
+  function strcmp(), mathematically returning (pKey1 - pKey2) where:
 
                   <  0   means pKey1 is less than pKey2
                   == 0   means pKey1 is equal to pKey2
                   >  0   means pKey1 is greater than pKey2
 
+  When no key comparison function is provided the key objects are compared
+  byte by byte (motelTreeKeyType_Bytes). Integer key objects are compared
+  fastest by setting motelTreeMember_KeyType to one of the built-in integer
+  key types, which are compared without calling through a function pointer.
+
   The maximum memory paramter may be set to zero to allow the tree to grow to
   the operating system controlled process memory limit.
   ----------------------------------------------------------------------------*/
@@ -130,10 +151,24 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION ConstructTree
   False - Tree was not successfully destructed due to:
 
           1. The pTree handle pointer was NULL
-          2. The destruction of a node key object failed
-          3. The destruction of a node data object failed
-          4. The SafeFreeBlock() of a node failed
-          5. The SafeFreeBlock() of the tree failed
+          2. The SafeFreeBlock() of a node failed
+          3. The DestructPool() of the tree's memory pool failed
+          4. The SafeFreeBlock() of the tree failed
+  ----------------------------------------------------------------------------
+  Note:
+
+  The nodes of a tree with a memory pool (see motelTreeMember_MemoryPool) are
+  not visited; the pool's blocks are released as a whole. Likewise the nodes
+  of a tree built with COMPACT_TREE_NODES defined are released along with
+  its node arena.
+
+  Otherwise the nodes are released iteratively through their parent links,
+  so no stack space or memory is needed however deep the tree. A parentless
+  tree (see motelTreeMember_Parentless) is instead unwound by rotating each
+  node's lesser branch upward, likewise without a stack. A large tree
+  is divided among motelTreeMember_TeardownThreads threads (default 1), each
+  releasing one subtree; this shortens the teardown of multi-gigabyte trees
+  when the heap allocator scales across threads.
   ----------------------------------------------------------------------------*/
 
 EXPORT_STORAGE_CLASS success CALLING_CONVENTION DestructTree
@@ -166,6 +201,14 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION DestructTree
   Check the comments within motel.tree.t.h of the member variable to learn
   the memory and data type requirements of each.
 
+  motelTreeMember_LevelCount is a bound kept as the tree changes, and it may
+  report more levels than the tree holds, never fewer (see motel.tree.t.h).
+
+  When built with COMPACT_TREE_NODES defined, setting a nonzero
+  motelTreeMember_MemoryPool or setting motelTreeMember_Persistent fails with
+  motelResult_Incompatible; the nodes are allocated from the tree's own
+  arena instead.
+
   This function will corrupt user memory when pValue is of insufficient size
   to hold the value of a given member variable.
 
@@ -205,6 +248,11 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SetTreeMember
   Check the comments within motel.tree.t.h of the member variable to learn
   the memory and data type requirements of each.
 
+  motelTreeMember_LevelCount is a bound kept as the tree changes, and it may
+  report more levels than the tree holds, never fewer (see motel.tree.t.h).
+  motelTreeMember_ExactLevelCount walks every node to count the levels held,
+  taking O(n) time.
+
   Sufficient memory must be allocated to retrieve string (char *) member
   variables. These values are string copied (strcpy) to the buffer provided by
   the calling application.
@@ -243,6 +291,11 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetTreeMember
           1. The pTree handle was NULL.
           2. The pNode handle was NULL.
           3. The pKey handle was NULL.
+          4. The tree's redo log could not be written (motelResult_Writing);
+             the node is inserted when it is the logging that failed
+          5. The tree was built with COMPACT_TREE_NODES defined and its node
+             arena is full, or the key value already has an instance of
+             4,294,967,295 (motelResult_MaximumSize)
   ----------------------------------------------------------------------------
   Operational Note:
   
@@ -253,6 +306,18 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetTreeMember
   ratio of "lesser to greater" or "greater to lesser" branch weights is
   permitted before rebalancing.
 
+  The ratio and the manner of rebalancing may be changed per tree through
+  motelTreeMember_Balance. A lower ratio keeps the tree shallower at the
+  cost of more pivots; a higher ratio pivots less often but lets the tree
+  grow deeper. motelTreeBalanceMode_DoublePivot pivots an inner grandchild
+  up ahead of a heavy child, and motelTreeBalanceMode_Rebuild pivots nothing
+  during the descent, instead rebuilding the highest subtree found out of
+  balance once the node is in place (or gone, for DeleteTreeNode()).
+
+  A persistent tree (see motelTreeMember_Persistent) first copies each node
+  on the insertion path that a version taken by SnapshotTree() still holds,
+  and pivots only copies of its own, so the versions are never changed.
+
   Usage Note:
 
   The MotelTree supports insertion of duplicate key values. Differentiation of
@@ -260,6 +325,13 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetTreeMember
   version number for duplicate keys. Calling applications that wish to handle
   duplicate key insertion as an error, a data overwrite or as ingorable are
   responsible for searching for duplicates prior to attempting an insert.
+
+  A tree with motelTreeMember_GroupDuplicates set keeps every instance of a
+  key within the key's one node, as a list of the instances and their data,
+  so a duplicate is appended to the list rather than inserted as a node. The
+  nodes, depth and key comparisons then grow with the number of distinct
+  keys rather than with the number of instances. The node cursor moves
+  through a key's instances in order before moving to the next key.
   ----------------------------------------------------------------------------*/
 
 EXPORT_STORAGE_CLASS success CALLING_CONVENTION InsertTreeNode
@@ -269,6 +341,106 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION InsertTreeNode
     void * pKey
 );
 
+/*----------------------------------------------------------------------------
+  BulkLoadTree()
+  ----------------------------------------------------------------------------
+  Load an empty tree from arrays of key and data objects that are already in
+  key order.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I) Tree handle
+  pData  - (I) Pointer to an array of pCount data objects
+  pKeys  - (I) Pointer to an array of pCount key objects
+  pCount - (I) The number of nodes to load
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Nodes were succesfully loaded
+
+  False - Nodes were not successfully loaded due to:
+
+          1. The pTree handle was NULL
+          2. The pData or pKeys handle was NULL
+          3. The tree was not empty
+          4. A key object was less than the key object preceding it
+          5. A node could not be constructed
+          6. The tree groups duplicates or is logged
+             (motelResult_Incompatible)
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  The tree is built bottom-up in O(n) time without key comparisons beyond
+  those needed to verify the order of the keys and without pivots. Each
+  node's lesser and greater branch weights differ by at most one.
+
+  Duplicate key values are assigned ascending instance numbers in array
+  order, just as InsertTreeNode() would have assigned them.
+
+  When loading fails the tree is left empty.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION BulkLoadTree
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKeys,
+    unsigned long pCount
+);
+
+/*----------------------------------------------------------------------------
+  InsertTreeNodes()
+  ----------------------------------------------------------------------------
+  Insert (add) a batch of nodes from arrays of key and data objects in any
+  order.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I) Tree handle
+  pData  - (I) Pointer to an array of pCount data objects
+  pKeys  - (I) Pointer to an array of pCount key objects
+  pCount - (I) The number of nodes to insert
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Nodes were succesfully inserted
+
+  False - Nodes were not successfully inserted due to:
+
+          1. The pTree handle was NULL
+          2. The pData or pKeys handle was NULL
+          3. A node could not be constructed
+          4. The SafeMallocBlock() of the working arrays failed
+          5. The tree groups duplicates, is persistent or is logged
+             (motelResult_Incompatible)
+          6. The tree was built with COMPACT_TREE_NODES defined and pCount
+             more instances could pass 4,294,967,295
+             (motelResult_MaximumSize)
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  The nodes are sorted and then merged into the tree from the root down, so
+  a path shared by several keys is walked once and each node's branch
+  weights are updated once per batch rather than once per key. A subtree
+  the batch would put out of balance is rebuilt from its existing and new
+  nodes in linear time instead of being pivoted.
+
+  Duplicate key values are assigned ascending instance numbers after any
+  existing nodes with the same key value, in array order, just as repeated
+  calls to InsertTreeNode() would have assigned them.
+
+  When insertion fails the tree is left unchanged. The node cursor is
+  cleared.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION InsertTreeNodes
+(
+    motelTreeHandle pTree,
+    void * pData,
+    void * pKeys,
+    unsigned long pCount
+);
+
 /*----------------------------------------------------------------------------
   SelectTreeNode()
   ----------------------------------------------------------------------------
@@ -299,6 +471,9 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION InsertTreeNode
 
   Passing 0 as pInstance will cause the an aribtrary instance of the node to
   the returned (e.g. the one presently nearest the tree root).
+
+  On a tree that groups duplicates (see motelTreeMember_GroupDuplicates),
+  passing 0 as pInstance selects the least instance.
   ----------------------------------------------------------------------------*/
 
 EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNode
@@ -308,6 +483,59 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNode
     unsigned long pInstance
 );
 
+/*----------------------------------------------------------------------------
+  SelectTreeNodes()
+  ----------------------------------------------------------------------------
+  Select (find) a batch of nodes within the tree - copying their data objects
+  to an array without changing the cursor location.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree      - (I) Tree handle
+  pKeys      - (I) Pointer to an array of pCount key objects
+  pInstances - (I) Pointer to an array of pCount instances of the key objects
+                   in the tree (NULL selects instance 0 for every key object)
+  pCount     - (I) The number of nodes to select
+  pData      - (O) Pointer to an array of pCount data objects to receive the
+                   data of the selected nodes (may be NULL)
+  pFound     - (O) Pointer to an array of pCount booleans to receive whether
+                   each node was found
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Every node was succesfully selected
+
+  False - Every node was not successfully selected due to:
+
+          1. The pTree handle was NULL
+          2. The pKeys or pFound handle was NULL
+          3. One or more key objects were not found (motelResult_NotFound);
+             the pFound and pData arrays are complete
+          4. The tree groups duplicates (motelResult_Incompatible)
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  The descents of up to 16 keys are interleaved, each advancing one level
+  per pass with the next node of its path prefetched, so that the cache
+  misses of one descent are overlapped with the comparisons of the others.
+  This hides much of the memory latency of trees far larger than the
+  processor's cache. A lane whose descent ends immediately starts the next
+  key of the batch.
+
+  Instances are selected as by SelectTreeNode(). The data objects of nodes
+  that are not found are left unchanged.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNodes
+(
+    motelTreeHandle pTree,
+    void * pKeys,
+    unsigned long * pInstances,
+    unsigned long pCount,
+    void * pData,
+    boolean * pFound
+);
+
 /*----------------------------------------------------------------------------
   FetchTreeNode()
   ----------------------------------------------------------------------------
@@ -364,6 +592,8 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION FetchTreeNode
           1. The pTree handle was NULL.
           2. The pData handle was NULL.
           3. The tree cursor was NULL
+          4. The tree's redo log could not be written (motelResult_Writing);
+             the node is updated when it is the logging that failed
   ----------------------------------------------------------------------------*/
 
 EXPORT_STORAGE_CLASS success CALLING_CONVENTION UpdateTreeNode
@@ -390,6 +620,12 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION UpdateTreeNode
           1. The pTree handle was NULL
           2. The tree is empty
           3. The tree cursor was NULL
+          4. The tree's redo log could not be written (motelResult_Writing);
+             the node is deleted when it is the logging that failed
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  Any tree cursor objects positioned on the deleted node are left unset.
   ----------------------------------------------------------------------------*/
 
 EXPORT_STORAGE_CLASS success CALLING_CONVENTION DeleteTreeNode
@@ -565,4 +801,1317 @@ EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekGreaterTreeNode
     unsigned long * pInstance
 );
 
+/*****************************************************************************
+                         Order statistic operations
+  *****************************************************************************/
+
+/*----------------------------------------------------------------------------
+  SelectTreeNodeByRank()
+  ----------------------------------------------------------------------------
+  Select (find) the node at an ordinal position within the tree - changing
+  the cursor location.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pRank - (I) The ordinal position of the node (1 is the least node)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully selected
+
+  False - Node was not successfully selected due to:
+
+          1. The pTree handle was NULL
+          2. The tree is empty
+          3. The rank was zero or greater than the number of nodes
+          4. The tree groups duplicates (motelResult_Incompatible)
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  Duplicate key values each occupy their own position, ordered by instance.
+
+  The node is located in O(log n) time using the branch weights of the nodes
+  on the route from the root.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNodeByRank
+(
+    motelTreeHandle pTree,
+    unsigned long pRank
+);
+
+/*----------------------------------------------------------------------------
+  GetTreeNodeRank()
+  ----------------------------------------------------------------------------
+  Get the ordinal position of the node at the current cursor location.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pRank - (O) Pointer to receive the ordinal position (1 is the least node)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Rank was succesfully determined
+
+  False - Rank was not successfully determined due to:
+
+          1. The pTree handle was NULL
+          2. The pRank pointer was NULL
+          3. The tree is empty
+          4. The tree cursor was NULL
+          5. The tree groups duplicates (motelResult_Incompatible)
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetTreeNodeRank
+(
+    motelTreeHandle pTree,
+    unsigned long * pRank
+);
+
+/*----------------------------------------------------------------------------
+  CountTreeNodesInKeyRange()
+  ----------------------------------------------------------------------------
+  Count the nodes whose key values fall within an inclusive range.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I) Tree handle
+  pLeast    - (I) Pointer to the least key object of the range (may be NULL)
+  pGreatest - (I) Pointer to the greatest key object of the range (may be NULL)
+  pCount    - (O) Pointer to receive the number of nodes within the range
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Nodes were succesfully counted
+
+  False - Nodes were not successfully counted due to:
+
+          1. The pTree handle was NULL
+          2. The pCount pointer was NULL
+          3. The tree groups duplicates (motelResult_Incompatible)
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  A NULL pLeast or pGreatest leaves that end of the range unbounded. Every
+  instance of a duplicated key value is counted. The cursor is not moved.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION CountTreeNodesInKeyRange
+(
+    motelTreeHandle pTree,
+    void * pLeast,
+    void * pGreatest,
+    unsigned long * pCount
+);
+
+/*****************************************************************************
+                              Range operations
+  *****************************************************************************/
+
+/*----------------------------------------------------------------------------
+  SelectTreeNodeLowerBound()
+  ----------------------------------------------------------------------------
+  Select the least node with a key value greater than or equal to a key
+  object - changing the cursor location.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pKey  - (I) Pointer to the bounding key object
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully selected
+
+  False - Node was not successfully selected due to:
+
+          1. The pTree handle was NULL
+          2. The pKey handle was NULL
+          3. The tree is empty
+          4. Every key value in the tree is less than pKey
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  When the key value is duplicated the least instance is selected. Unlike
+  SelectTreeNode() the key object need not be present in the tree, making
+  this the starting point of a range walk with PeekGreaterTreeNode().
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNodeLowerBound
+(
+    motelTreeHandle pTree,
+    void * pKey
+);
+
+/*----------------------------------------------------------------------------
+  SelectTreeNodeUpperBound()
+  ----------------------------------------------------------------------------
+  Select the least node with a key value greater than a key object -
+  changing the cursor location.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pKey  - (I) Pointer to the bounding key object
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully selected
+
+  False - Node was not successfully selected due to:
+
+          1. The pTree handle was NULL
+          2. The pKey handle was NULL
+          3. The tree is empty
+          4. Every key value in the tree is less than or equal to pKey
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeNodeUpperBound
+(
+    motelTreeHandle pTree,
+    void * pKey
+);
+
+/*----------------------------------------------------------------------------
+  ScanTreeRange()
+  ----------------------------------------------------------------------------
+  Visit, in key order, the nodes whose key values fall within an inclusive
+  range.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree         - (I) Tree handle
+  pLeast        - (I) Pointer to the least key object of the range (may be NULL)
+  pGreatest     - (I) Pointer to the greatest key object of the range (may be NULL)
+  pScanFunction - (I) Function called for each node within the range
+  pContext      - (I) Caller's context passed through to pScanFunction
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Range was succesfully scanned
+
+  False - Range was not successfully scanned due to:
+
+          1. The pTree handle was NULL
+          2. The pScanFunction handle was NULL
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  A NULL pLeast or pGreatest leaves that end of the range unbounded. The
+  scan function receives pointers to the key and data objects held within
+  the node; these must be treated as read-only and are only valid for the
+  duration of the call. Returning FALSE from the scan function ends the scan
+  early. The cursor is not moved and the tree must not be modified by the
+  scan function.
+
+  On a concurrent tree the scan takes no lock and runs alongside writers. The
+  scan function then receives copies of each node's key and data, and sees
+  each node in key order at most once; nodes inserted or deleted by writers
+  during the scan may or may not be visited.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ScanTreeRange
+(
+    motelTreeHandle pTree,
+    void * pLeast,
+    void * pGreatest,
+    boolean (* pScanFunction)(void * pContext, const void * pKey, const void * pData, unsigned long pInstance),
+    void * pContext
+);
+
+/*****************************************************************************
+                            Concurrent operations
+  *****************************************************************************/
+
+/*----------------------------------------------------------------------------
+  LockTree()
+  ----------------------------------------------------------------------------
+  Acquire exclusive use of a concurrent tree for a writer.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Tree was succesfully locked
+
+  False - Tree was not successfully locked due to:
+
+          1. The pTree handle was NULL
+          2. The tree is not concurrent
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  A tree becomes concurrent by setting motelTreeMember_Concurrent to TRUE,
+  which must be done before the tree is shared between threads.
+
+  On a concurrent tree only ReadTreeNode() and ScanTreeRange() may be called
+  without holding the lock; every other function, including those that only
+  move the tree cursor, must be called between LockTree() and UnlockTree().
+  Lock-free readers wait while the lock is held, so it should be held only
+  for as long as the modifications take.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION LockTree
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  UnlockTree()
+  ----------------------------------------------------------------------------
+  Release a concurrent tree locked by LockTree().
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Tree was succesfully unlocked
+
+  False - Tree was not successfully unlocked due to:
+
+          1. The pTree handle was NULL
+          2. The tree is not concurrent
+          3. A deleted node could not be destructed (the tree is unlocked)
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  Nodes deleted from a concurrent tree are not destructed until every lock-
+  free reader that might still reach them has finished. The reclamation is
+  done here, without waiting on readers.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION UnlockTree
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  ReadTreeNode()
+  ----------------------------------------------------------------------------
+  Look up a node and copy its data value without moving the cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I) Tree handle
+  pKey      - (I) Pointer to the key object handle
+  pInstance - (I) The instance of the key object in the tree (0 for the least)
+  pData     - (O) Pointer to the data object handle (may be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was found and its data copied
+
+  False - Node was not found or the pTree or pKey handle was NULL
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  The tree result code is not set, allowing any number of threads to read a
+  concurrent tree without a lock while writers modify it; a read that is
+  overlapped by a writer is transparently repeated.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReadTreeNode
+(
+    motelTreeHandle pTree,
+    void * pKey,
+    unsigned long pInstance,
+    void * pData
+);
+
+/*****************************************************************************
+                              Cursor operations
+  *****************************************************************************/
+
+/*----------------------------------------------------------------------------
+  ConstructTreeCursor()
+  ----------------------------------------------------------------------------
+  Construct a cursor that holds a position within a tree independently of the
+  tree's own cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCursor - (O) Pointer to the cursor handle
+  pTree   - (I) Handle of the tree to traverse
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Cursor was succesfully constructed
+
+  False - Cursor was not successfully constructed due to:
+
+          1. The pCursor handle pointer was NULL
+          2. The pTree handle was NULL
+          3. The cursor could not be allocated
+          4. The tree groups duplicates (motelResult_Incompatible)
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  A tree may have any number of cursors. The result code of a cursor
+  operation is held in the cursor's result member rather than the tree's.
+
+  Cursors only read the tree when selecting, fetching and peeking, so any
+  number of threads may do so side by side through their own cursors while
+  no thread modifies the tree. Inserting or deleting nodes, and constructing
+  or destructing cursors, modify the tree.
+
+  A cursor positioned on a node that is deleted, by any means, is left
+  unset. A cursor over a tree that is destructed is orphaned and must still
+  be destructed.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ConstructTreeCursor
+(
+    motelTreeCursorHandle * pCursor,
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  DestructTreeCursor()
+  ----------------------------------------------------------------------------
+  Destruct a tree cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCursor - (I/O) Pointer to the cursor handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Cursor was succesfully destructed
+
+  False - Cursor was not successfully destructed due to:
+
+          1. The pCursor handle pointer or handle was NULL
+          2. The cursor could not be deallocated
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION DestructTreeCursor
+(
+    motelTreeCursorHandle * pCursor
+);
+
+/*----------------------------------------------------------------------------
+  SelectTreeCursorNode()
+  ----------------------------------------------------------------------------
+  Select (find) a node within the tree - changing the location of a cursor.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCursor   - (I) Cursor handle
+  pKey      - (I) Pointer to the key object handle
+  pInstance - (I) The instance of the key object in the tree
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully selected
+
+  False - Node was not successfully selected due to:
+
+          1. The pCursor handle was NULL
+          2. The tree was destructed
+          3. The tree is empty
+          4. The pKey handle was NULL or no node matched it
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  Passing 0 as pInstance selects the least instance of a duplicated key.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SelectTreeCursorNode
+(
+    motelTreeCursorHandle pCursor,
+    void * pKey,
+    unsigned long pInstance
+);
+
+/*----------------------------------------------------------------------------
+  FetchTreeCursorNode()
+  ----------------------------------------------------------------------------
+  Fetch the node at a cursor's location.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCursor   - (I) Cursor handle
+  pData     - (O) Pointer to the data object handle (may be NULL)
+  pKey      - (O) Pointer to the key object handle (may be NULL)
+  pInstance - (O) Pointer to the node instance (may be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully fetched
+
+  False - Node was not successfully fetched due to:
+
+          1. The pCursor handle was NULL
+          2. The tree was destructed
+          3. The tree is empty
+          4. The cursor was not set
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION FetchTreeCursorNode
+(
+    motelTreeCursorHandle pCursor,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+);
+
+/*----------------------------------------------------------------------------
+  PeekLesserTreeCursorNode()
+  ----------------------------------------------------------------------------
+  Move a cursor to the node with the next lower key value and copy the
+  key and data values from the node.
+
+  Calling this function when the cursor is not set will result in the
+  Greatest node being returned.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCursor   - (I) Cursor handle
+  pData     - (O) Pointer to the data object handle (may be NULL)
+  pKey      - (O) Pointer to the key object handle (may be NULL)
+  pInstance - (O) Pointer to the node instance (may be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully peeked
+
+  False - Node was not successfully peeked due to:
+
+          1. The pCursor handle was NULL
+          2. The tree was destructed
+          3. The tree is empty
+          4. There is no lower node
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekLesserTreeCursorNode
+(
+    motelTreeCursorHandle pCursor,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+);
+
+/*----------------------------------------------------------------------------
+  PeekGreaterTreeCursorNode()
+  ----------------------------------------------------------------------------
+  Move a cursor to the node with the next higher key value and copy the
+  key and data values from the node.
+
+  Calling this function when the cursor is not set will result in the
+  Least node being returned.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCursor   - (I) Cursor handle
+  pData     - (O) Pointer to the data object handle (may be NULL)
+  pKey      - (O) Pointer to the key object handle (may be NULL)
+  pInstance - (O) Pointer to the node instance (may be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully peeked
+
+  False - Node was not successfully peeked due to:
+
+          1. The pCursor handle was NULL
+          2. The tree was destructed
+          3. The tree is empty
+          4. There is no higher node
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION PeekGreaterTreeCursorNode
+(
+    motelTreeCursorHandle pCursor,
+    void * pData,
+    void * pKey,
+    unsigned long * pInstance
+);
+
+/*----------------------------------------------------------------------------
+  DeleteTreeCursorNode()
+  ----------------------------------------------------------------------------
+  Delete the node at a cursor's location from the tree.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pCursor - (I) Cursor handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully deleted
+
+  False - Node was not successfully deleted due to:
+
+          1. The pCursor handle was NULL
+          2. The tree was destructed
+          3. The tree is empty
+          4. The cursor was not set
+          5. The tree's redo log could not be written (motelResult_Writing);
+             the node is deleted when it is the logging that failed
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  The cursor, along with the tree cursor and any other cursors positioned
+  on the node, is left unset.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION DeleteTreeCursorNode
+(
+    motelTreeCursorHandle pCursor
+);
+
+/*****************************************************************************
+                          Split and join operations
+  *****************************************************************************/
+
+/*----------------------------------------------------------------------------
+  SplitTree()
+  ----------------------------------------------------------------------------
+  Move the nodes of a tree into two new trees divided at a key object.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree    - (I) Tree handle
+  pKey     - (I) Pointer to the key object at which to divide the nodes
+  pLesser  - (O) Pointer to a NULL tree handle to receive the tree of nodes
+                 whose key values are less than the key object
+  pGreater - (O) Pointer to a NULL tree handle to receive the tree of nodes
+                 whose key values are equal to or greater than the key object
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Tree was succesfully split
+
+  False - Tree was not successfully split due to:
+
+          1. The pTree handle was NULL
+          2. The pKey, pLesser or pGreater handle was NULL
+          3. The tree has a memory pool, is concurrent, is persistent, groups
+             duplicates or is logged, or the tree was built with
+             COMPACT_TREE_NODES defined (motelResult_Incompatible)
+          4. A new tree could not be constructed
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  The nodes are relinked rather than copied and the split takes O(log n)
+  time. The new trees take the maximum size, key type, balance policy and
+  thread counts of the tree, which is left empty. The node cursor and every
+  cursor over the tree are left unset.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SplitTree
+(
+    motelTreeHandle pTree,
+    void * pKey,
+    motelTreeHandle * pLesser,
+    motelTreeHandle * pGreater
+);
+
+/*----------------------------------------------------------------------------
+  JoinTrees()
+  ----------------------------------------------------------------------------
+  Move the nodes of a tree into a tree whose key values all precede them.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pLesser  - (I) Handle of the tree to receive the nodes
+  pGreater - (I) Handle of the tree whose nodes are moved
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Trees were succesfully joined
+
+  False - Trees were not successfully joined due to:
+
+          1. The pLesser or pGreater handle was NULL
+          2. The trees are the same tree, differ in key size, data size,
+             key comparison or parentless setting, or either has a memory
+             pool, is concurrent, is persistent, groups duplicates or is
+             logged, or the trees were built with COMPACT_TREE_NODES
+             defined (motelResult_Incompatible)
+          3. A key value of pGreater precedes one of pLesser
+             (motelResult_InvalidValue)
+          4. The joined nodes would exceed pLesser's maximum size
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  The nodes are relinked rather than copied and the join takes O(log n)
+  time. The least key value of pGreater may equal the greatest of pLesser;
+  the instances of those duplicates in pGreater are renumbered to follow
+  the instances in pLesser.
+
+  pGreater is left empty and its node cursor and cursors unset, as is the
+  node cursor of pLesser. The result code is set within pLesser.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION JoinTrees
+(
+    motelTreeHandle pLesser,
+    motelTreeHandle pGreater
+);
+
+/*****************************************************************************
+                               Set operations
+  *****************************************************************************/
+
+/*----------------------------------------------------------------------------
+  UnionTrees()
+  ----------------------------------------------------------------------------
+  Add to a tree the nodes of another tree whose key values it lacks.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I) Handle of the tree to receive the result
+  pOther - (I) Handle of the tree whose nodes are taken
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Trees were succesfully combined
+
+  False - Trees were not successfully combined due to:
+
+          1. The pTree or pOther handle was NULL
+          2. The trees are the same tree, differ in key size, data size,
+             key comparison or parentless setting, or either has a memory
+             pool, is concurrent, is persistent, groups duplicates or is
+             logged, or the trees were built with COMPACT_TREE_NODES
+             defined (motelResult_Incompatible)
+          3. pOther's nodes would exceed pTree's maximum size
+          4. A node could not be destructed
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  Every node of pOther is taken, leaving it empty. Nodes whose key value is
+  already within pTree are destructed, so pTree's data objects are kept;
+  the other nodes are relinked into pTree with their instances unchanged.
+
+  The set operations work by key value: every instance of a key value is
+  kept or every instance is destructed. Both trees are split about the key
+  values of pOther and rejoined (see SplitTree() and JoinTrees()), taking
+  O(m log(n/m + 1)) time for trees of m and n nodes, m <= n. Setting
+  motelTreeMember_CombineThreads divides the work of large trees among
+  that many threads.
+
+  pOther's cursors are left unset, as are pTree's node cursor and cursors.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION UnionTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther
+);
+
+/*----------------------------------------------------------------------------
+  IntersectTrees()
+  ----------------------------------------------------------------------------
+  Keep within a tree only the nodes whose key values another tree holds.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I) Handle of the tree to receive the result
+  pOther - (I) Handle of the tree whose nodes are taken
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Trees were succesfully combined
+
+  False - Trees were not successfully combined due to:
+
+          1. The pTree or pOther handle was NULL
+          2. The trees are the same tree, differ in key size, data size,
+             key comparison or parentless setting, or either has a memory
+             pool, is concurrent, is persistent, groups duplicates or is
+             logged, or the trees were built with COMPACT_TREE_NODES
+             defined (motelResult_Incompatible)
+          3. pOther's nodes would exceed pTree's maximum size
+          4. A node could not be destructed
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  Every node of pOther is destructed, as are the nodes of pTree whose key
+  value pOther lacks, leaving pOther empty (see UnionTrees()).
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION IntersectTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther
+);
+
+/*----------------------------------------------------------------------------
+  DifferenceTrees()
+  ----------------------------------------------------------------------------
+  Remove from a tree the nodes whose key values another tree holds.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree  - (I) Handle of the tree to receive the result
+  pOther - (I) Handle of the tree whose nodes are taken
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Trees were succesfully combined
+
+  False - Trees were not successfully combined due to:
+
+          1. The pTree or pOther handle was NULL
+          2. The trees are the same tree, differ in key size, data size,
+             key comparison or parentless setting, or either has a memory
+             pool, is concurrent, is persistent, groups duplicates or is
+             logged, or the trees were built with COMPACT_TREE_NODES
+             defined (motelResult_Incompatible)
+          3. pOther's nodes would exceed pTree's maximum size
+          4. A node could not be destructed
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  Every node of pOther is destructed, as are the nodes of pTree whose key
+  value pOther holds, leaving pOther empty (see UnionTrees()).
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION DifferenceTrees
+(
+    motelTreeHandle pTree,
+    motelTreeHandle pOther
+);
+
+/*****************************************************************************
+                             Snapshot operations
+  *****************************************************************************/
+
+/*----------------------------------------------------------------------------
+  SnapshotTree()
+  ----------------------------------------------------------------------------
+  Construct a version of a persistent tree that shares the tree's nodes and
+  is unaffected by the tree's later updates.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree    - (I) Handle of a persistent tree
+  pVersion - (O) Pointer to receive the version's tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Version was succesfully constructed
+
+  False - Version was not successfully constructed due to:
+
+          1. The pTree handle was NULL
+          2. The pVersion pointer was NULL
+          3. The tree is not persistent (motelResult_Incompatible)
+          4. The SafeMallocBlock() of the version failed
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  The version takes constant time to construct: it is a tree of its own
+  holding a reference to the tree's root. Each InsertTreeNode(),
+  UpdateTreeNode() and DeleteTreeNode() thereafter copies only the nodes on
+  its path, and those it pivots, that another version still holds, so an
+  update costs O(log n) copies and leaves every version as it was taken.
+
+  The version is read with the usual tree functions and released with
+  DestructTree(); a node is destructed when the last version holding it
+  lets go of it. The reference counts are kept atomically, so a version may
+  be read and destructed by one thread while another thread updates the
+  tree or another version, without locks and without copying. A version is
+  itself persistent and may be updated or have versions taken of its own.
+
+  A node is charged to the size of the version that constructs or copies
+  it, until that version lets go of it. A node that other versions go on
+  holding is then charged to none of them, until one of them holds it alone
+  and changes it.
+
+  As with ConstructTree(), the contents of the pVersion handle must be
+  initialized to NULL prior to calling this function.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SnapshotTree
+(
+    motelTreeHandle pTree,
+    motelTreeHandle * pVersion
+);
+
+/*----------------------------------------------------------------------------
+  FreezeTree()
+  ----------------------------------------------------------------------------
+  Construct an immutable, contiguous snapshot of a tree's nodes for
+  read-only lookups, rank queries and range scans.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree     - (I) Tree handle
+  pSnapshot - (O) Pointer to the snapshot handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Snapshot was succesfully constructed
+
+  False - Snapshot was not successfully constructed due to:
+
+          1. The pTree handle was NULL
+          2. The pSnapshot pointer was NULL
+          3. Memory for the snapshot could not be allocated
+          4. The tree groups duplicates (motelResult_Incompatible)
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  The snapshot is a single memory block holding a copy of every key in
+  Eytzinger (breadth first) order, so that a lookup's first levels share a
+  few cache lines, and a copy of every key and data object in key order, so
+  that range scans read consecutive memory. Lookups descend without
+  branching on the comparison and prefetch two levels ahead.
+
+  The snapshot is independent of the tree, which may afterwards be modified
+  or destructed. On a concurrent tree the tree lock must be held while the
+  snapshot is taken. No snapshot function modifies the snapshot, so any
+  number of threads may query it at once.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION FreezeTree
+(
+    motelTreeHandle pTree,
+    motelTreeSnapshotHandle * pSnapshot
+);
+
+/*----------------------------------------------------------------------------
+  DestructTreeSnapshot()
+  ----------------------------------------------------------------------------
+  Destruct a snapshot constructed by FreezeTree() or MapTree().
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pSnapshot - (I/O) Pointer to the snapshot handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Snapshot was succesfully destructed
+
+  False - Snapshot was not successfully destructed due to:
+
+          1. The pSnapshot pointer or handle was NULL
+          2. The snapshot's memory or file mapping could not be released
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION DestructTreeSnapshot
+(
+    motelTreeSnapshotHandle * pSnapshot
+);
+
+/*----------------------------------------------------------------------------
+  ReadTreeSnapshotNode()
+  ----------------------------------------------------------------------------
+  Look up a node within a snapshot and copy its data value.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pSnapshot - (I) Snapshot handle
+  pKey      - (I) Pointer to the key object
+  pInstance - (I) The instance of the key object (0 for the least)
+  pData     - (O) Pointer to the data object handle (may be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was found and its data copied
+
+  False - Node was not found or the pSnapshot or pKey handle was NULL
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReadTreeSnapshotNode
+(
+    motelTreeSnapshotHandle pSnapshot,
+    void * pKey,
+    unsigned long pInstance,
+    void * pData
+);
+
+/*----------------------------------------------------------------------------
+  GetTreeSnapshotNodeRank()
+  ----------------------------------------------------------------------------
+  Get the ordinal position of a node within a snapshot.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pSnapshot - (I) Snapshot handle
+  pKey      - (I) Pointer to the key object
+  pInstance - (I) The instance of the key object (0 for the least)
+  pRank     - (O) Pointer to receive the ordinal position (1 is the least node)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Rank was succesfully determined
+
+  False - Node was not found or the pSnapshot, pKey or pRank handle was NULL
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION GetTreeSnapshotNodeRank
+(
+    motelTreeSnapshotHandle pSnapshot,
+    void * pKey,
+    unsigned long pInstance,
+    unsigned long * pRank
+);
+
+/*----------------------------------------------------------------------------
+  ReadTreeSnapshotNodeByRank()
+  ----------------------------------------------------------------------------
+  Copy the key, data and instance of the node at an ordinal position within
+  a snapshot.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pSnapshot - (I) Snapshot handle
+  pRank     - (I) The ordinal position of the node (1 is the least node)
+  pKey      - (O) Pointer to the key object handle (may be NULL)
+  pData     - (O) Pointer to the data object handle (may be NULL)
+  pInstance - (O) Pointer to receive the key object's instance (may be NULL)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Node was succesfully read
+
+  False - Node was not successfully read due to:
+
+          1. The pSnapshot handle was NULL
+          2. The rank was zero or greater than the number of nodes
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ReadTreeSnapshotNodeByRank
+(
+    motelTreeSnapshotHandle pSnapshot,
+    unsigned long pRank,
+    void * pKey,
+    void * pData,
+    unsigned long * pInstance
+);
+
+/*----------------------------------------------------------------------------
+  ScanTreeSnapshotRange()
+  ----------------------------------------------------------------------------
+  Visit, in key order, the nodes of a snapshot whose key values fall within
+  an inclusive range.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pSnapshot     - (I) Snapshot handle
+  pLeast        - (I) Pointer to the least key object of the range (may be NULL)
+  pGreatest     - (I) Pointer to the greatest key object of the range (may be NULL)
+  pScanFunction - (I) Function called for each node within the range
+  pContext      - (I) Caller's context passed through to pScanFunction
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Range was succesfully scanned
+
+  False - Range was not successfully scanned due to:
+
+          1. The pSnapshot handle was NULL
+          2. The pScanFunction handle was NULL
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  A NULL pLeast or pGreatest leaves that end of the range unbounded. The
+  scan function receives pointers to the key and data objects held within
+  the snapshot; these must be treated as read-only. Returning FALSE from the
+  scan function ends the scan early.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION ScanTreeSnapshotRange
+(
+    motelTreeSnapshotHandle pSnapshot,
+    void * pLeast,
+    void * pGreatest,
+    boolean (* pScanFunction)(void * pContext, const void * pKey, const void * pData, unsigned long pInstance),
+    void * pContext
+);
+
+/*----------------------------------------------------------------------------
+  SaveTree()
+  ----------------------------------------------------------------------------
+  Write a tree's nodes to a file that MapTree() can open in place.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  pPath - (I) The path of the file to create or replace
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Tree was succesfully saved
+
+  False - Tree was not successfully saved due to:
+
+          1. The pTree handle was NULL
+          2. The pPath pointer was NULL
+          3. The tree groups duplicates (motelResult_Incompatible)
+          4. Memory for the write buffers could not be allocated
+          5. The file could not be opened (motelResult_Opening), written
+             (motelResult_Writing) or closed (motelResult_Closing)
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  The file holds the tree's snapshot (see FreezeTree()) behind a short
+  header, with every position recorded as an offset from the start of the
+  file. The snapshot is written straight from the nodes through buffers of
+  a fixed size rather than built in memory, so saving a tree takes little
+  memory beyond the tree itself.
+
+  The file may only be mapped on a machine with the same byte order and
+  the same size of unsigned long. Key and data objects are written as they
+  are held in memory, so they must not contain pointers.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION SaveTree
+(
+    motelTreeHandle pTree,
+    const char * pPath
+);
+
+/*----------------------------------------------------------------------------
+  MapTree()
+  ----------------------------------------------------------------------------
+  Construct a snapshot from a file written by SaveTree() by mapping the file
+  into memory.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pSnapshot           - (O) Pointer to the snapshot handle
+  pPath               - (I) The path of the file
+  pCompareKeyFunction - (I) The key comparison function (may be NULL unless
+                            the saved tree used a custom key comparison)
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Snapshot was succesfully constructed
+
+  False - Snapshot was not successfully constructed due to:
+
+          1. The pSnapshot or pPath pointer was NULL
+          2. The file could not be opened or mapped
+          3. The file was not written by SaveTree() on a compatible machine,
+             has been truncated, or its header gives sizes that do not fit
+             the file
+          4. The tree used a custom key comparison and pCompareKeyFunction
+             was NULL
+          5. Memory for the snapshot structure could not be allocated
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  Nothing is read or converted beyond the file's header: lookups, rank
+  queries and scans work on the mapped file directly, and the operating
+  system reads each page as it is first touched. The mapping is read-only
+  and shared, so processes that map the same file share its pages.
+
+  A mapped file must not be overwritten; save to a new file and rename it
+  over the old one instead. DestructTreeSnapshot() unmaps the file.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION MapTree
+(
+    motelTreeSnapshotHandle * pSnapshot,
+    const char * pPath,
+    long (* pCompareKeyFunction)(const void * pKey1, const void * pKey2)
+);
+
+/*----------------------------------------------------------------------------
+  LogTree()
+  ----------------------------------------------------------------------------
+  Start (or stop) logging the changes made to a tree so that RecoverTree()
+  can restore it after a crash.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree           - (I) Tree handle
+  pLogPath        - (I) The path of the redo log (NULL, with pCheckpointPath,
+                        to stop logging)
+  pCheckpointPath - (I) The path of the checkpoint file
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Logging was succesfully started or stopped
+
+  False - Logging was not successfully started or stopped due to:
+
+          1. The pTree handle was NULL
+          2. Only one of pLogPath and pCheckpointPath was NULL
+          3. The tree is already logged (motelResult_InvalidState)
+          4. The tree groups duplicates (motelResult_Incompatible)
+          5. Memory for the log could not be allocated
+          6. The checkpoint or the log could not be written
+          7. The pending changes could not be committed when stopping
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  Logging begins with a checkpoint: the tree is saved (see SaveTree()) to
+  pCheckpointPath and the log at pLogPath is started afresh. InsertTreeNode(),
+  UpdateTreeNode(), DeleteTreeNode() and DeleteTreeCursorNode() then append
+  a record of each change they make to the log, holding the node's key
+  object, instance and new data object.
+
+  Records are committed to the disk in groups: the log is flushed and synced
+  by the first change made once motelTreeMember_LogInterval milliseconds
+  (100 by default) have passed since the last commit, or once
+  motelTreeMember_LogCommit changes (65536 by default) are pending, so a
+  crash loses at most the changes of the group still pending. A busy tree
+  thus syncs a few times a second, and the syncs cost a few percent of its
+  throughput; a shorter interval or smaller group loses fewer changes to a
+  crash at the cost of more syncs, down to a sync for every change with a
+  group of 1. The interval is measured only as changes are made, so the last
+  changes made before a tree falls idle wait for CommitTree(), which commits
+  the pending group at once. Once the log holds motelTreeMember_LogCheckpoint
+  changes (1048576 by default) the tree is checkpointed again and the log
+  emptied, so that recovery never replays more than that many changes.
+
+  A checkpoint is written beside pCheckpointPath and renamed over it only once
+  it is on the disk, and carries the sequence number of the last change it
+  holds; the log is emptied only after the rename. A crash at any moment
+  therefore leaves a checkpoint and a log that RecoverTree() can combine.
+
+  A tree that was not recovered by RecoverTree() replaces any log already at
+  pLogPath. A recovered tree keeps numbering its changes after those it
+  recovered, so a tree is restarted by RecoverTree() followed by LogTree()
+  with the same paths.
+
+  Should a record fail to be written or committed, the change is made but
+  the log refuses every later change (motelResult_Writing) until
+  CheckpointTree() succeeds. DestructTree() commits the pending changes of a
+  logged tree but cannot report a failure to do so; stop logging first to
+  learn of one.
+
+  BulkLoadTree(), InsertTreeNodes(), SplitTree(), JoinTrees() and the set
+  operations are not logged and refuse a logged tree; load a tree before
+  logging it. Key and data objects are logged as they are held in memory, so
+  they must not contain pointers.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION LogTree
+(
+    motelTreeHandle pTree,
+    const char * pLogPath,
+    const char * pCheckpointPath
+);
+
+/*----------------------------------------------------------------------------
+  CommitTree()
+  ----------------------------------------------------------------------------
+  Commit the changes pending in a tree's redo log to the disk.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The changes were succesfully committed
+
+  False - The changes were not successfully committed due to:
+
+          1. The pTree handle was NULL
+          2. The tree is not logged (motelResult_InvalidState)
+          3. The log could not be flushed or synced (motelResult_Writing)
+  ----------------------------------------------------------------------------
+  Usage Note:
+
+  An application that must not acknowledge a change until it is durable
+  either sets motelTreeMember_LogCommit to 1, committing every change, or
+  makes a batch of changes and then commits them together with CommitTree(),
+  which costs one sync for the batch.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION CommitTree
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  CheckpointTree()
+  ----------------------------------------------------------------------------
+  Save a logged tree to its checkpoint file and empty its redo log.
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree - (I) Tree handle
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - The tree was succesfully checkpointed
+
+  False - The tree was not successfully checkpointed due to:
+
+          1. The pTree handle was NULL
+          2. The tree is not logged (motelResult_InvalidState)
+          3. Memory for the checkpoint's write buffers could not be
+             allocated
+          4. The checkpoint or the log could not be written
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  A checkpoint takes time in proportion to the number of nodes; applications
+  that would rather choose when it happens set motelTreeMember_LogCheckpoint
+  to 0 and call CheckpointTree() themselves. The nodes are written straight
+  to the checkpoint file as SaveTree() writes them, so a checkpoint needs no
+  copy of the tree and its memory stays bounded however large the tree. A
+  successful checkpoint also clears a log that has refused changes after a
+  failure.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION CheckpointTree
+(
+    motelTreeHandle pTree
+);
+
+/*----------------------------------------------------------------------------
+  RecoverTree()
+  ----------------------------------------------------------------------------
+  Restore an empty tree from the checkpoint file and redo log written by
+  LogTree().
+  ----------------------------------------------------------------------------
+  Parameters:
+
+  pTree           - (I) Tree handle
+  pLogPath        - (I) The path of the redo log
+  pCheckpointPath - (I) The path of the checkpoint file
+  ----------------------------------------------------------------------------
+  Return Values:
+
+  True  - Tree was succesfully recovered
+
+  False - Tree was not successfully recovered due to:
+
+          1. The pTree handle was NULL
+          2. The pLogPath or pCheckpointPath pointer was NULL
+          3. The tree is not empty or is already logged
+             (motelResult_InvalidState)
+          4. The tree groups duplicates (motelResult_Incompatible)
+          5. The checkpoint could not be mapped (motelResult_Reading)
+          6. The checkpoint or log was written for a tree of another key
+             type, key size or data size (motelResult_InvalidValue)
+          7. A logged node is not within the tree (motelResult_Corrupted)
+          8. A node could not be constructed
+  ----------------------------------------------------------------------------
+  Operational Note:
+
+  The checkpoint is loaded as BulkLoadTree() would load it, keeping the
+  instance numbers of its nodes, and the logged changes that follow it are
+  then made in order. A missing checkpoint or log is taken as empty. The
+  replay ends quietly at the first record torn by a crash.
+
+  The tree must be constructed with the same key and data sizes and key
+  comparison as the logged tree, and its members set alike, before it is
+  recovered. It is not logged afterward until LogTree() is called. When
+  recovery fails the tree holds the changes recovered so far.
+  ----------------------------------------------------------------------------*/
+
+EXPORT_STORAGE_CLASS success CALLING_CONVENTION RecoverTree
+(
+    motelTreeHandle pTree,
+    const char * pLogPath,
+    const char * pCheckpointPath
+);
+
 #endif
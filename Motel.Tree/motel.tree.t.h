@@ -58,11 +58,88 @@ enum motelTreeMember
                                           Description: Memory currently allocated by the tree object */
 
     motelTreeMember_LevelCount,      /*!< Data type:   (unsigned long *)
-                                          Description: The highest number of nodes from the root to a leaf */
+                                          Description: A bound on the highest number of nodes from the root to a
+                                                       leaf, tracked as the tree changes rather than counted; it
+                                                       never falls below the levels held, and deletions, pivots and
+                                                       the operations that rebuild the tree wholesale may leave it
+                                                       above them. Kept in O(1) time */
 
     motelTreeMember_Nodes,           /*!< Data type:   (unsigned long *)
                                           Description: The number of nodes in the tree */
 
+    motelTreeMember_MemoryPool,      /*!< Data type:   (size_t *)
+                                          Description: The block size of the private memory pool from which
+                                                       the nodes are allocated (0 allocates from the heap).
+                                                       May only be set while the tree is empty */
+
+    motelTreeMember_KeyType,         /*!< Data type:   (motelTreeKeyType *)
+                                          Description: How key objects are compared (see motelTreeKeyType).
+                                                       May only be set while the tree is empty */
+
+    motelTreeMember_Concurrent,      /*!< Data type:   (boolean *)
+                                          Description: Whether lookups and range scans may run without locks
+                                                       alongside writers that serialize through LockTree() */
+
+    motelTreeMember_TeardownThreads, /*!< Data type:   (unsigned long *)
+                                          Description: The number of threads among which DestructTree() divides
+                                                       the release of a large heap allocated tree's nodes */
+
+    motelTreeMember_CombineThreads,  /*!< Data type:   (unsigned long *)
+                                          Description: The number of threads among which UnionTrees(),
+                                                       IntersectTrees() and DifferenceTrees() divide their work */
+
+    motelTreeMember_ValidateThreads, /*!< Data type:   (unsigned long *)
+                                          Description: The number of threads among which ValidateTree() divides
+                                                       the walk of a large tree */
+
+    motelTreeMember_Parentless,      /*!< Data type:   (boolean *)
+                                          Description: Whether the nodes' parent links are left unmaintained, with
+                                                       in-order steps found by descending from the root instead.
+                                                       May only be set while the tree is empty, and is always set
+                                                       when the nodes are built without parent links */
+
+    motelTreeMember_GroupDuplicates, /*!< Data type:   (boolean *)
+                                          Description: Whether the instances of a key share one node holding a list
+                                                       of the instances and their data, rather than a node each.
+                                                       May only be set while the tree is empty */
+
+    motelTreeMember_Balance,         /*!< Data type:   (motelTreeBalance *)
+                                          Description: The branch weight ratio at which the tree is rebalanced
+                                                       and how InsertTreeNode() and DeleteTreeNode() restore
+                                                       balance (see motelTreeBalance) */
+
+    motelTreeMember_Persistent,      /*!< Data type:   (boolean *)
+                                          Description: Whether updates copy the nodes they change rather than
+                                                       modify them, so that versions taken by SnapshotTree()
+                                                       share the unchanged nodes. Also makes the tree parentless
+                                                       while it is persistent.
+                                                       May only be set while the tree is empty */
+
+    motelTreeMember_LogCommit,       /*!< Data type:   (unsigned long *)
+                                          Description: The most changes written to the log started by LogTree()
+                                                       before they are committed to the disk together */
+
+    motelTreeMember_LogInterval,     /*!< Data type:   (unsigned long *)
+                                          Description: The milliseconds after a commit of the log started by
+                                                       LogTree() from which the next change is committed to the
+                                                       disk together with those pending (0 commits by the number
+                                                       of changes alone) */
+
+    motelTreeMember_LogCheckpoint,   /*!< Data type:   (unsigned long *)
+                                          Description: The number of changes written to the log started by LogTree()
+                                                       between checkpoints of the tree (0 checkpoints the tree only
+                                                       when CheckpointTree() is called) */
+
+    motelTreeMember_Statistics,      /*!< Data type:   (motelTreeStatistics *)
+                                          Description: The counts of the work done by the tree's operations (see
+                                                       motelTreeStatistics); setting them, typically to zero, starts
+                                                       a new count. Only built with TREE_STATISTICS defined */
+
+    motelTreeMember_ExactLevelCount, /*!< Data type:   (unsigned long *)
+                                          Description: The highest number of nodes from the root to a leaf, counted
+                                                       by walking every node; the count also tightens the bound
+                                                       reported by motelTreeMember_LevelCount */
+
     motelTreeMember_Least,           /*!< Data type:   NULL
                                           Description: Move the node cursor to lowest key value */
 
@@ -90,28 +167,164 @@ enum motelTreeMember
     motelTreeMember_
 };
 
+/*
+** Built-in key types
+*/
+
+typedef enum motelTreeKeyType motelTreeKeyType;
+
+enum motelTreeKeyType
+{
+    motelTreeKeyType_Custom,         /*!< Key objects are compared by the function passed to ConstructTree() */
+
+    motelTreeKeyType_Signed32,       /*!< Key objects are integer32 values */
+    motelTreeKeyType_Unsigned32,     /*!< Key objects are bits32 values */
+    motelTreeKeyType_Signed64,       /*!< Key objects are integer64 values */
+    motelTreeKeyType_Unsigned64,     /*!< Key objects are bits64 values */
+
+    motelTreeKeyType_Bytes,          /*!< Key objects are compared byte by byte as unsigned values (memcmp) */
+
+    motelTreeKeyType_
+};
+
+/*
+** Balance policies
+*/
+
+typedef enum motelTreeBalanceMode motelTreeBalanceMode;
+
+enum motelTreeBalanceMode
+{
+    motelTreeBalanceMode_Pivot,       /*!< A node out of balance is pivoted toward its lighter branch */
+
+    motelTreeBalanceMode_DoublePivot, /*!< As motelTreeBalanceMode_Pivot, except that a heavier inner grandchild
+                                           is first pivoted up so that it becomes the subtree root */
+
+    motelTreeBalanceMode_Rebuild,     /*!< Nodes are left out of balance during the descent and the highest
+                                           subtree found out of balance is rebuilt in perfect balance afterward */
+
+    motelTreeBalanceMode_
+};
+
+typedef struct motelTreeBalance motelTreeBalance;
+
+struct motelTreeBalance
+{
+    unsigned long numerator;          /*!< The heavier to lighter branch weight ratio, as numerator / denominator, */
+    unsigned long denominator;        /*!< at which a node is out of balance (3 / 1 by default) */
+
+    motelTreeBalanceMode mode;        /*!< How balance is restored (motelTreeBalanceMode_Pivot by default) */
+};
+
+/*
+** defining TREE_STATISTICS has each tree count the work done by its
+** operations; lookups and scans made without locks alongside the writers of a
+** concurrent tree, and reads through ReadTreeNode(), are not counted
+*/
+
+#define TREE_STATISTICS_DEPTHS 64
+
+typedef struct motelTreeStatistics motelTreeStatistics;
+
+struct motelTreeStatistics
+{
+    bits64 comparisons;                     /*!< Key comparisons */
+
+    bits64 insertPivots;                    /*!< Pivots made to restore balance while inserting nodes */
+    bits64 deletePivots;                    /*!< Pivots made to restore balance while deleting nodes */
+
+    bits64 insertRebuilds;                  /*!< Subtrees rebuilt while inserting nodes (motelTreeBalanceMode_Rebuild) */
+    bits64 deleteRebuilds;                  /*!< Subtrees rebuilt while deleting nodes (motelTreeBalanceMode_Rebuild) */
+
+    bits64 allocations;                     /*!< Node and occurrence list allocations */
+    bits64 allocationBytes;                 /*!< The bytes requested by those allocations */
+
+    bits64 reseeks;                         /*!< Descents from the root to find a cursor's or scan's place again */
+
+    bits64 descents[TREE_STATISTICS_DEPTHS]; /*!< Insert and delete descents by the number of nodes passed, the
+                                                  last counting those passing as many nodes or more */
+};
+
 typedef struct motelTreeNode motelTreeNode;
 typedef MUTABILITY motelTreeNode * motelTreeNodeHandle;
 
+/*
+** defining COMPACT_TREE_NODES links the nodes by 32-bit indexes into a node
+** arena private to the tree (see motelTreeArena) and holds each node's
+** instance and weights in 32 bits, halving a node's links and counts
+*/
+
+#if defined COMPACT_TREE_NODES
+
+typedef bits32 motelTreeLink;
+typedef bits32 motelTreeCount;
+
+#else
+
+typedef motelTreeNodeHandle motelTreeLink;
+typedef unsigned long motelTreeCount;
+
+#endif
+
+/*
+** defining PARENTLESS_TREE_NODES drops each node's parent link, making every
+** tree parentless (see motelTreeMember_Parentless)
+*/
+
 struct motelTreeNode
 {
-    MUTABILITY unsigned long instance;
+#if !defined PARENTLESS_TREE_NODES
+
+    MUTABILITY motelTreeLink parent;
+
+#endif
+
+    MUTABILITY motelTreeLink lesser;
+    MUTABILITY motelTreeLink greater;
 
-    MUTABILITY motelTreeNodeHandle parent;
-  
-    MUTABILITY motelTreeNodeHandle lesser;
-    MUTABILITY unsigned long lesserNullNodes;
+    MUTABILITY motelTreeCount instance;
 
-    MUTABILITY motelTreeNodeHandle greater;
-    MUTABILITY unsigned long greaterNullNodes;
+    MUTABILITY motelTreeCount lesserNullNodes;
+    MUTABILITY motelTreeCount greaterNullNodes;
 
-    MUTABILITY void * MUTABILITY key;
-    MUTABILITY void * MUTABILITY data;
+    /* the key and data objects follow the node within the same memory block */
 };
 
 typedef struct motelTree motelTree;
 typedef MUTABILITY motelTree * motelTreeHandle;
 
+typedef struct motelTreeCursor motelTreeCursor;
+typedef MUTABILITY motelTreeCursor * motelTreeCursorHandle;
+
+/* the redo log started by LogTree(), which is private to the tree */
+
+typedef struct motelTreeLog motelTreeLog;
+typedef MUTABILITY motelTreeLog * motelTreeLogHandle;
+
+#if defined COMPACT_TREE_NODES
+
+/*
+** the address space reserved for a compact tree's nodes, committed as it
+** fills; a link is a node's offset from the base in units of the node
+** alignment, 0 linking no node, and the free list is threaded through the
+** lesser links of the released nodes
+*/
+
+typedef struct motelTreeArena motelTreeArena;
+
+struct motelTreeArena
+{
+    MUTABILITY byte * base;
+
+    MUTABILITY size_t reserved;
+    MUTABILITY size_t committed;
+    MUTABILITY size_t used;
+
+    MUTABILITY motelTreeLink free;
+};
+
+#endif
+
 struct motelTree
 {
     MUTABILITY motelResult result;
@@ -120,13 +333,117 @@ struct motelTree
     MUTABILITY size_t size;
 
     MUTABILITY long (* compareKeyFunction)(const void * pKey1, const void * pKey2);
+
+    MUTABILITY motelTreeKeyType keyType;
     
     MUTABILITY size_t keySize;
     MUTABILITY size_t dataSize;
 
-    MUTABILITY motelTreeNodeHandle root;
+    MUTABILITY size_t nodeSize;
+
+    MUTABILITY motelMemoryHandle pool;
+
+#if defined COMPACT_TREE_NODES
+
+    MUTABILITY motelTreeArena arena;
+
+    MUTABILITY motelTreeCount greatestInstance; /* no node has held a greater instance */
+
+#endif
+
+    MUTABILITY motelTreeLink root;
+
+    MUTABILITY unsigned long levels;     /* the tracked level bound, 0 when the tree is empty */
+    MUTABILITY unsigned long levelScale; /* the levels a large branch may hold per bit of its weight (see LevelScale()) */
 
     MUTABILITY motelTreeNodeHandle cursor;
+
+    MUTABILITY motelTreeCursorHandle cursors;
+
+    MUTABILITY boolean concurrent;
+
+    MUTABILITY motelLock lock;
+
+    MUTABILITY motelAtomic sequence;
+
+    MUTABILITY motelAtomic epoch;
+    MUTABILITY motelAtomic readers[2];
+
+    MUTABILITY motelTreeNodeHandle retired[2];
+
+    MUTABILITY unsigned long teardownThreads;
+    MUTABILITY unsigned long combineThreads;
+    MUTABILITY unsigned long validateThreads;
+
+    MUTABILITY boolean parentless;
+
+    MUTABILITY boolean groupDuplicates;
+
+    MUTABILITY unsigned long occurrence;
+
+    MUTABILITY motelTreeBalance balance;
+
+    MUTABILITY boolean persistent;
+    MUTABILITY boolean persistentParentless; /* the parentless setting to restore once the tree is no longer persistent */
+
+    MUTABILITY long version;                 /* the persistent version's identity, charged with the nodes it owns */
+
+    MUTABILITY motelTreeLogHandle log;
+
+    MUTABILITY unsigned long logCommitRecords;
+    MUTABILITY unsigned long logCommitMilliseconds;
+    MUTABILITY unsigned long logCheckpointRecords;
+
+    MUTABILITY bits64 logSequence;
+
+#if defined TREE_STATISTICS
+
+    MUTABILITY motelTreeStatistics statistics;
+
+#endif
+};
+
+struct motelTreeCursor
+{
+    MUTABILITY motelResult result;
+
+    MUTABILITY motelTreeHandle tree;
+
+    MUTABILITY motelTreeNodeHandle node;
+
+    MUTABILITY motelTreeCursorHandle next;
+};
+
+/*
+** an immutable copy of a tree's nodes; the search entries hold the keys in
+** Eytzinger (breadth first) order and the records hold the keys and data in
+** key order, both within the same memory block as the snapshot structure or
+** within a file mapped by MapTree()
+*/
+
+typedef struct motelTreeSnapshot motelTreeSnapshot;
+typedef MUTABILITY motelTreeSnapshot * motelTreeSnapshotHandle;
+
+struct motelTreeSnapshot
+{
+    MUTABILITY size_t size;
+
+    MUTABILITY long (* compareKeyFunction)(const void * pKey1, const void * pKey2);
+
+    MUTABILITY motelTreeKeyType keyType;
+
+    MUTABILITY size_t keySize;
+    MUTABILITY size_t dataSize;
+
+    MUTABILITY size_t entrySize;
+    MUTABILITY size_t recordSize;
+
+    MUTABILITY unsigned long nodes;
+
+    MUTABILITY byte * entries;
+    MUTABILITY byte * records;
+
+    MUTABILITY void * mapping;
 };
 
 #endif
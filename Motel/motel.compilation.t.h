@@ -87,4 +87,54 @@
 
 #endif
 
+/* Place INLINE before the type of a private function that should be expanded in place. */
+
+#if defined _MSC_VER
+
+#define INLINE __inline
+
+#elif defined __GNUC__
+
+#define INLINE __inline__
+
+#else
+
+#define INLINE
+
+#endif
+
+/* Place FORCE_INLINE before the type of a private function that must be expanded in place, so that each caller gets a copy specialized to its constant arguments. */
+
+#if defined _MSC_VER
+
+#define FORCE_INLINE __forceinline
+
+#elif defined __GNUC__
+
+#define FORCE_INLINE __inline__ __attribute__ ((always_inline))
+
+#else
+
+#define FORCE_INLINE INLINE
+
+#endif
+
+/* Hint that the memory at an address will soon be read so that it may be fetched into the cache. */
+
+#if defined _MSC_VER && (defined _M_IX86 || defined _M_X64)
+
+#include <xmmintrin.h>
+
+#define PrefetchMemory(pAddress) _mm_prefetch((const char *) (pAddress), _MM_HINT_T0)
+
+#elif defined __GNUC__
+
+#define PrefetchMemory(pAddress) __builtin_prefetch(pAddress)
+
+#else
+
+#define PrefetchMemory(pAddress)
+
+#endif
+
 #endif
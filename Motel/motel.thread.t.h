@@ -0,0 +1,129 @@
+/*----------------------------------------------------------------------------
+  Motel Thread
+  
+  application programmer's types (APT) header file
+  ----------------------------------------------------------------------------
+  Copyright 2010-2012 John L. Hart IV. All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain all copyright notices,
+     this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce all copyright
+     notices, this list of conditions and the following disclaimer in the
+     documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY John L. Hart IV "AS IS" AND ANY EXPRESS OR
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+  NO EVENT SHALL John L. Hart IV OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+  DAMAGE.
+
+  The views and conclusions contained in the software and documentation are
+  those of the authors and should not be interpreted as representing official
+  policies, either expressed or implied, of John L Hart IV.
+  ----------------------------------------------------------------------------*/
+
+#ifndef MOTEL_THREAD_T_H
+#define MOTEL_THREAD_T_H
+
+/*----------------------------------------------------------------------------
+  Platform specific threads, locks, atomic operations and memory fences
+  ----------------------------------------------------------------------------*/
+
+#if defined _WIN32 || defined _WIN64
+
+#include <windows.h>
+
+/* A mutual exclusion lock held by one thread at a time. */
+
+typedef CRITICAL_SECTION motelLock;
+
+#define InitializeLock(pLock) InitializeCriticalSection(pLock)
+#define DeleteLock(pLock) DeleteCriticalSection(pLock)
+#define AcquireLock(pLock) EnterCriticalSection(pLock)
+#define ReleaseLock(pLock) LeaveCriticalSection(pLock)
+
+/* A counter that is read and modified atomically; modification is a full fence. */
+
+typedef volatile LONG motelAtomic;
+
+#define AtomicIncrement(pAtomic) InterlockedIncrement(pAtomic)
+#define AtomicDecrement(pAtomic) InterlockedDecrement(pAtomic)
+#define AtomicRead(pAtomic) (* (pAtomic))
+
+/* Order all memory accesses before the fence ahead of all accesses after it. */
+
+#define MemoryFence() MemoryBarrier()
+
+/* Give up the remainder of the thread's time slice. */
+
+#define YieldThread() SwitchToThread()
+
+/* A thread of execution started by StartThread() and awaited by JoinThread(). */
+
+typedef HANDLE motelThread;
+
+/* Thread routines are declared: motelThreadResult THREAD_CALLING_CONVENTION Routine(void * pArgument) */
+
+typedef DWORD motelThreadResult;
+
+#define THREAD_CALLING_CONVENTION WINAPI
+
+#define StartThread(pThread, pRoutine, pArgument) (NULL != (* (pThread) = CreateThread(NULL, 0, pRoutine, pArgument, 0, NULL)))
+#define JoinThread(pThread) (WAIT_OBJECT_0 == WaitForSingleObject(pThread, INFINITE) && CloseHandle(pThread))
+
+#else
+
+#include <pthread.h>
+#include <sched.h>
+
+/* A mutual exclusion lock held by one thread at a time. */
+
+typedef pthread_mutex_t motelLock;
+
+#define InitializeLock(pLock) pthread_mutex_init(pLock, NULL)
+#define DeleteLock(pLock) pthread_mutex_destroy(pLock)
+#define AcquireLock(pLock) pthread_mutex_lock(pLock)
+#define ReleaseLock(pLock) pthread_mutex_unlock(pLock)
+
+/* A counter that is read and modified atomically; modification is a full fence. */
+
+typedef volatile long motelAtomic;
+
+#define AtomicIncrement(pAtomic) __sync_add_and_fetch(pAtomic, 1)
+#define AtomicDecrement(pAtomic) __sync_sub_and_fetch(pAtomic, 1)
+#define AtomicRead(pAtomic) __atomic_load_n(pAtomic, __ATOMIC_SEQ_CST)
+
+/* Order all memory accesses before the fence ahead of all accesses after it. */
+
+#define MemoryFence() __sync_synchronize()
+
+/* Give up the remainder of the thread's time slice. */
+
+#define YieldThread() sched_yield()
+
+/* A thread of execution started by StartThread() and awaited by JoinThread(). */
+
+typedef pthread_t motelThread;
+
+/* Thread routines are declared: motelThreadResult THREAD_CALLING_CONVENTION Routine(void * pArgument) */
+
+typedef void * motelThreadResult;
+
+#define THREAD_CALLING_CONVENTION
+
+#define StartThread(pThread, pRoutine, pArgument) (0 == pthread_create(pThread, NULL, pRoutine, pArgument))
+#define JoinThread(pThread) (0 == pthread_join(pThread, NULL))
+
+#endif
+
+#endif
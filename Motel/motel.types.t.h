@@ -61,12 +61,43 @@ typedef unsigned short     bits16;
 typedef unsigned long      bits32;
 typedef unsigned long long bits64;
 
+#elif defined __GNUC__
+
+typedef unsigned char      bits8;
+typedef unsigned short     bits16;
+typedef unsigned int       bits32;
+typedef unsigned long long bits64;
+
 #else
 
 #error need to define bit bucket types for this compiler/architecture
 
 #endif
 
+/*
+** signed integer types
+*/
+
+#if defined _WIN32 || defined _WIN64
+
+typedef signed char        integer8;
+typedef signed short       integer16;
+typedef signed long        integer32;
+typedef signed long long   integer64;
+
+#elif defined __GNUC__
+
+typedef signed char        integer8;
+typedef signed short       integer16;
+typedef signed int         integer32;
+typedef signed long long   integer64;
+
+#else
+
+#error need to define signed integer types for this compiler/architecture
+
+#endif
+
 /*
 ** Used to reference an item count
 */